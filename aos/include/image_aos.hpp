@@ -1,8 +1,10 @@
 #pragma once
 
+#include "huge_page_allocator.hpp"
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
 #include <cstdint>
-#include <fstream>
-#include <iostream>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -15,12 +17,14 @@ namespace render {
     std::uint8_t b{};
   };
 
+  static_assert(sizeof(Pixel) == 3, "ImageAOS::data se escribe como un búfer r, g, b");
+
   // ImageAOS: Array of Structures
   class ImageAOS {
   public:
     int width{};
     int height{};
-    std::vector<Pixel> data;
+    huge_vector<Pixel> data;
 
     explicit ImageAOS(int w, int h)
         : width{w}, height{h}, data(static_cast<size_t>(w) * static_cast<size_t>(h)) { }
@@ -32,33 +36,33 @@ namespace render {
 
     void set_b(size_t idx, std::uint8_t b) noexcept { data[idx].b = b; }
 
+    // Escribe de una vez n píxeles de la fila y desde la columna x0. rgb tiene 3 * n floats
+    // entrelazados con la gamma ya aplicada; se cuantizan directamente sobre el búfer.
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      auto const first = static_cast<size_t>(y) * static_cast<size_t>(width) +
+                         static_cast<size_t>(x0);
+      quantize(rgb, reinterpret_cast<std::uint8_t *>(data.data() + first),
+               3 * static_cast<size_t>(n));
+    }
+
     [[nodiscard]] uint8_t get_r(size_t idx) const noexcept { return data[idx].r; }
 
     [[nodiscard]] uint8_t get_g(size_t idx) const noexcept { return data[idx].g; }
 
     [[nodiscard]] uint8_t get_b(size_t idx) const noexcept { return data[idx].b; }
 
-    // Guardar PPM (P3, texto)
-    void save_to_ppm(std::string const & filename) const {
-      std::ofstream out(filename);
-      if (!out.is_open()) {
-        std::cerr << "Error: cannot open output file: " << filename << '\n';
-        return;
-      }
-
-      constexpr int max_color = 255;
-      out << "P3\n" << width << ' ' << height << '\n' << max_color << '\n';
-
-      for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-          auto const idx =
-              static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
-          out << static_cast<int>(get_r(idx)) << ' ' << static_cast<int>(get_g(idx)) << ' '
-              << static_cast<int>(get_b(idx)) << '\n';
-        }
-      }
-
-      std::cout << "Image saved to " << filename << '\n';
+    // Guardar PPM (P3, texto, por defecto; P6, binario, escribe el búfer tal cual), QOI o PNG
+    void save_to_ppm(std::string const & filename, ImageFormat format = ImageFormat::p3,
+                     OutputBackend backend = OutputBackend::ofstream) const {
+      write_image(filename, width, height,
+                  std::span(reinterpret_cast<std::uint8_t const *>(data.data()), data.size() * 3),
+                  format, backend);
+    }
+
+    // Alias de save_to_ppm con un nombre que no depende del formato
+    void save(std::string const & filename, ImageFormat format = ImageFormat::p3,
+              OutputBackend backend = OutputBackend::ofstream) const {
+      save_to_ppm(filename, format, backend);
     }
   };
 
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "huge_page_allocator.hpp"
+#include "image_aos.hpp"
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // ImageHdrAOS: framebuffer float con los canales entrelazados (r, g, b por píxel). Guarda
+  // la radiancia lineal, sin gamma ni recorte; tone_map la convierte después a ImageAOS.
+  class ImageHdrAOS {
+  public:
+    int width{};
+    int height{};
+    huge_vector<float> data;
+
+    explicit ImageHdrAOS(int w, int h)
+        : width{w}, height{h}, data(3 * static_cast<size_t>(w) * static_cast<size_t>(h)) { }
+
+    // Color lineal de un píxel (lo usa store_pixel en lugar de set_r/g/b)
+    void set_linear(size_t idx, float r, float g, float b) noexcept {
+      data[3 * idx]     = r;
+      data[3 * idx + 1] = g;
+      data[3 * idx + 2] = b;
+    }
+
+    // Colores lineales de n píxeles de la fila y desde x0 (rgb entrelazado, 3 * n floats)
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      auto const first = static_cast<size_t>(y) * static_cast<size_t>(width) +
+                         static_cast<size_t>(x0);
+      std::copy_n(rgb, 3 * static_cast<size_t>(n), data.data() + 3 * first);
+    }
+
+    [[nodiscard]] float get_r(size_t idx) const noexcept { return data[3 * idx]; }
+
+    [[nodiscard]] float get_g(size_t idx) const noexcept { return data[3 * idx + 1]; }
+
+    [[nodiscard]] float get_b(size_t idx) const noexcept { return data[3 * idx + 2]; }
+
+    // Gamma y cuantización a 8 bits, por bloques de filas en paralelo (threads = 0 usa
+    // todos los núcleos). Da los mismos bytes que renderizar directamente en ImageAOS.
+    void tone_map(ImageAOS & out, float inv_gamma, int threads = 0) const {
+      GammaTable const table(inv_gamma);
+      auto const row_values = 3 * static_cast<size_t>(width);
+      auto * const bytes    = reinterpret_cast<std::uint8_t *>(out.data.data());
+      parallel_rows(height, threads, [&](int y0, int y1) {
+        size_t const first = static_cast<size_t>(y0) * row_values;
+        table.apply(data.data() + first, bytes + first,
+                    static_cast<size_t>(y1 - y0) * row_values);
+      });
+    }
+
+    // Guardar PFM (floats lineales)
+    void save_to_pfm(std::string const & filename) const {
+      write_pfm(filename, width, height, data);
+    }
+  };
+
+}  // namespace render
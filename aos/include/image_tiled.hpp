@@ -0,0 +1,113 @@
+#pragma once
+
+#include "huge_page_allocator.hpp"
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // ImageTiled: píxeles entrelazados (r, g, b) agrupados por teselas de tile x tile. Cada
+  // tesela ocupa un bloque contiguo (las del borde se rellenan hasta el tamaño completo) y
+  // las teselas van en orden de filas. Con el mismo tamaño que Config::tile_size, cada hilo
+  // de run_tiled_loop escribe en su propio bloque en lugar de en tile filas separadas por
+  // el ancho de la imagen. Los bloques se rellenan hasta un múltiplo de 64 bytes y el búfer
+  // está alineado a 64, así que cada tesela empieza en una línea de caché y dos teselas
+  // vecinas no comparten ninguna.
+  class ImageTiled {
+  public:
+    static constexpr size_t cache_line = 64;
+
+    int width{};
+    int height{};
+
+    explicit ImageTiled(int w, int h, int tile = 32)
+        : width{w}, height{h}, m_tile{static_cast<size_t>(std::max(tile, 1))},
+          m_tiles_x{(static_cast<size_t>(w) + m_tile - 1) / m_tile},
+          m_tile_bytes{(m_tile * m_tile * 3 + cache_line - 1) / cache_line * cache_line},
+          m_data(m_tiles_x * ((static_cast<size_t>(h) + m_tile - 1) / m_tile) *
+                 m_tile_bytes) { }
+
+    void set_r(size_t idx, std::uint8_t r) noexcept { m_data[offset(idx)] = r; }
+
+    void set_g(size_t idx, std::uint8_t g) noexcept { m_data[offset(idx) + 1] = g; }
+
+    void set_b(size_t idx, std::uint8_t b) noexcept { m_data[offset(idx) + 2] = b; }
+
+    // Escribe n píxeles de la fila y desde x0 (rgb entrelazado, gamma aplicada). La fila se
+    // parte en los tramos de cada tesela, que son contiguos, y cada uno se cuantiza de una vez.
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      auto x         = static_cast<size_t>(x0);
+      auto const end = x + static_cast<size_t>(n);
+      while (x < end) {
+        size_t const count = std::min(end, (x / m_tile + 1) * m_tile) - x;
+        quantize(rgb, m_data.data() + offset(x, static_cast<size_t>(y)), 3 * count);
+        rgb += 3 * count;
+        x   += count;
+      }
+    }
+
+    [[nodiscard]] uint8_t get_r(size_t idx) const noexcept { return m_data[offset(idx)]; }
+
+    [[nodiscard]] uint8_t get_g(size_t idx) const noexcept { return m_data[offset(idx) + 1]; }
+
+    [[nodiscard]] uint8_t get_b(size_t idx) const noexcept { return m_data[offset(idx) + 2]; }
+
+    [[nodiscard]] int tile_size() const noexcept { return static_cast<int>(m_tile); }
+
+    // Primer byte de la tesela (tx, ty)
+    [[nodiscard]] std::uint8_t const * tile_data(int tx, int ty) const noexcept {
+      return m_data.data() + offset(static_cast<size_t>(tx) * m_tile,
+                                    static_cast<size_t>(ty) * m_tile);
+    }
+
+    // Copia la imagen en orden de filas (el búfer que guarda ImageAOS)
+    [[nodiscard]] std::vector<std::uint8_t> to_interleaved() const {
+      auto const w = static_cast<size_t>(width);
+      std::vector<std::uint8_t> rgb(3 * w * static_cast<size_t>(height));
+      for (size_t y = 0; y < static_cast<size_t>(height); ++y) {
+        for (size_t x = 0; x < w; x += m_tile) {
+          size_t const count = std::min(m_tile, w - x);
+          std::memcpy(rgb.data() + 3 * (y * w + x), m_data.data() + offset(x, y), 3 * count);
+        }
+      }
+      return rgb;
+    }
+
+    // Guardar (P3 por defecto): las teselas se copian antes a un búfer en orden de filas
+    void save_to_ppm(std::string const & filename, ImageFormat format = ImageFormat::p3,
+                     OutputBackend backend = OutputBackend::ofstream) const {
+      std::vector<std::uint8_t> const rgb = to_interleaved();
+      write_image(filename, width, height, rgb, format, backend);
+    }
+
+    // Alias de save_to_ppm con un nombre que no depende del formato
+    void save(std::string const & filename, ImageFormat format = ImageFormat::p3,
+              OutputBackend backend = OutputBackend::ofstream) const {
+      save_to_ppm(filename, format, backend);
+    }
+
+  private:
+    // Posición del byte r del píxel (x, y)
+    [[nodiscard]] size_t offset(size_t x, size_t y) const noexcept {
+      size_t const tile = (y / m_tile) * m_tiles_x + x / m_tile;
+      return tile * m_tile_bytes + 3 * ((y % m_tile) * m_tile + x % m_tile);
+    }
+
+    [[nodiscard]] size_t offset(size_t idx) const noexcept {
+      auto const w = static_cast<size_t>(width);
+      return offset(idx % w, idx / w);
+    }
+
+    size_t m_tile;
+    size_t m_tiles_x;
+    size_t m_tile_bytes;  // Bytes de cada tesela, redondeados a un múltiplo de cache_line
+    huge_vector<std::uint8_t> m_data;
+  };
+
+}  // namespace render
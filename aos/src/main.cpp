@@ -1,9 +1,17 @@
+#include "bvh.hpp"
 #include "config.hpp"
+#include "huge_page_allocator.hpp"
+#include "image_hdr_aos.hpp"
 #include "image_aos.hpp"  // <-- Solo incluye el tipo de imagen
+#include "mapped_image.hpp"
 #include "renderer.hpp"   // <-- Incluye toda la lógica
 #include "scene.hpp"
+#include "streaming_image.hpp"
+#include <algorithm>
 #include <iostream>
+#include <optional>
 #include <print>
+#include <stdexcept>
 #include <string>
 
 int main(int argc, char * argv[]) {
@@ -19,8 +27,18 @@ int main(int argc, char * argv[]) {
     std::string const output_file{args[3]};
 
     // 1. Cargar Config y Escena
-    render::Config const cfg  = render::read_config(config_file);
-    render::Scene const scene = render::read_scene(scene_file);
+    render::Config const cfg = render::read_config(config_file);
+    render::set_huge_page_policy(render::huge_page_policy_for(cfg.huge_pages));
+    render::Scene scene = render::read_scene(scene_file);
+    render::BVHStats const bvh_stats = render::build_accelerator(scene, cfg);
+    if (bvh_stats.nodes > 0) {
+      std::cout << bvh_stats << '\n';
+    }
+    if (not scene.bvh4.empty()) {
+      std::println(std::cout, "BVH4: {} nodes", scene.bvh4.nodes.size());
+    } else if (not scene.bvh8.empty()) {
+      std::println(std::cout, "BVH8: {} nodes", scene.bvh8.nodes.size());
+    }
 
     // 2. Calcular dimensiones
     int const width     = cfg.image_width;
@@ -28,17 +46,65 @@ int main(int argc, char * argv[]) {
     auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
     auto const height   = static_cast<int>(static_cast<float>(width) / (aspect_w / aspect_h));
 
-    // 3. Crear la imagen específica (AOS)
-    render::ImageAOS image(width, height);
+    render::ImageFormat const format = render::image_format_for(output_file, cfg.image_format);
+    std::optional<render::SampleMap> sample_map;
+    if (not cfg.sample_map.empty()) {
+      sample_map.emplace(width, height);
+    }
+
+    render::PathStats stats;
 
-    std::println(std::cout, "Starting AOS rendering ({}x{})...", width, height);
+    if (cfg.framebuffer == "hdr" or output_file.ends_with(".pfm")) {
+      // 3-5. Framebuffer float: PFM con la radiancia lineal, o gamma y cuantización en un
+      // paso aparte y guardado normal (sin escritura durante el render)
+      render::ImageHdrAOS hdr_image(width, height);
+      std::println(std::cout, "Starting AOS HDR rendering ({}x{})...", width, height);
+      stats = render::run_render_loop(hdr_image, cfg, scene, sample_map ? &*sample_map : nullptr);
 
-    // 4. Ejecutar el bucle de renderizado común
-    render::run_render_loop(image, cfg, scene);
+      std::println(std::cout, "Saving to {}", output_file);
+      if (output_file.ends_with(".pfm")) {
+        hdr_image.save_to_pfm(output_file);
+      } else {
+        render::ImageAOS image(width, height);
+        hdr_image.tone_map(image, 1.0F / cfg.gamma, cfg.threads);
+        image.save(output_file, format, render::output_backend_for(cfg.output_backend));
+      }
+    } else if (cfg.framebuffer == "mapped") {
+      // 3-5. El render escribe directamente en el archivo P6 proyectado en memoria
+      if (format != render::ImageFormat::p6) {
+        throw std::runtime_error(
+            "framebuffer mapped writes binary PPM only (use image_format: p6)");
+      }
+      render::MappedImage image(output_file, width, height);
+      std::println(std::cout, "Starting mapped rendering ({}x{}) to {}...", width, height,
+                   output_file);
+      stats = render::run_render_loop(image, cfg, scene, sample_map ? &*sample_map : nullptr);
+      image.finish();
+    } else if (cfg.stream_rows > 0) {
+      // 3-5. Las filas se escriben según se terminan, sin guardar la imagen completa
+      render::StreamingImage image(output_file, width, height, format,
+                                   std::max(cfg.stream_rows, cfg.tile_size));
+      std::println(std::cout, "Starting streaming rendering ({}x{}) to {}...", width, height,
+                   output_file);
+      stats = render::run_render_loop(image, cfg, scene, sample_map ? &*sample_map : nullptr);
+      image.finish();
+    } else {
+      // 3. Crear la imagen específica (AOS)
+      render::ImageAOS image(width, height);
 
-    // 5. Guardar la imagen
-    std::println(std::cout, "Saving to {}", output_file);
-    image.save_to_ppm(output_file);
+      std::println(std::cout, "Starting AOS rendering ({}x{})...", width, height);
+
+      // 4. Ejecutar el bucle de renderizado común
+      stats = render::run_render_loop(image, cfg, scene, sample_map ? &*sample_map : nullptr);
+
+      // 5. Guardar la imagen
+      std::println(std::cout, "Saving to {}", output_file);
+      image.save(output_file, format, render::output_backend_for(cfg.output_backend));
+    }
+    std::cout << stats << '\n';
+    if (sample_map) {
+      sample_map->save_to_pgm(cfg.sample_map);
+    }
 
   } catch (std::exception const & e) {
     std::cerr << "Error: " << e.what() << '\n';
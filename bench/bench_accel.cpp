@@ -0,0 +1,137 @@
+// Compara las estructuras de aceleración de hit_scene (lineal, BVH binaria, BVH4, BVH8 y
+// esferas en SoA con el núcleo SIMD) sobre los rayos primarios de una configuración y un
+// rebote difuso por impacto.
+//
+// Uso: bench-accel <config> <scene> [<scene> ...]
+// Ejemplo: bench-accel render-2025/config4.txt render-2025/scene*.txt
+
+#include "bvh.hpp"
+#include "config.hpp"
+#include "hittable.hpp"
+#include "ray.hpp"
+#include "renderer.hpp"
+#include "rng.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+  constexpr int repetitions = 3;
+
+  // Rayos primarios por el centro de cada píxel y, para los que impactan, un rebote
+  // difuso desde el punto de impacto (calculado con el recorrido lineal de referencia)
+  std::vector<render::Ray> make_rays(render::Config const & cfg, render::Scene const & scene) {
+    render::Camera const camera(cfg);
+    int const width     = cfg.image_width;
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    auto const height   = static_cast<int>(static_cast<float>(width) / (aspect_w / aspect_h));
+    float const infinity = std::numeric_limits<float>::infinity();
+    render::RNG rng(static_cast<uint64_t>(cfg.material_rng_seed));
+
+    std::vector<render::Ray> rays;
+    rays.reserve(2 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height));
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        render::Ray const primary = camera.get_ray(static_cast<float>(x), static_cast<float>(y));
+        rays.push_back(primary);
+        if (auto hit = render::hit_scene_linear(scene, primary, 0.001F, infinity)) {
+          render::vector const bounce = hit->normal + rng.random_in_unit_sphere();
+          rays.emplace_back(hit->point, bounce.normalized());
+        }
+      }
+    }
+    return rays;
+  }
+
+  struct Result {
+    double best_ms{std::numeric_limits<double>::infinity()};
+    std::size_t hits{0};
+    double lambda_sum{0.0};
+  };
+
+  // Lanza todos los rayos 'repetitions' veces y se queda con el tiempo mínimo
+  Result trace_all(render::Scene const & scene, std::vector<render::Ray> const & rays) {
+    float const infinity = std::numeric_limits<float>::infinity();
+    Result result;
+    for (int rep = 0; rep < repetitions; ++rep) {
+      std::size_t hits  = 0;
+      double lambda_sum = 0.0;
+      auto const start  = std::chrono::steady_clock::now();
+      for (auto const & ray : rays) {
+        if (auto hit = render::hit_scene(scene, ray, 0.001F, infinity)) {
+          ++hits;
+          lambda_sum += static_cast<double>(hit->lambda);
+        }
+      }
+      auto const elapsed = std::chrono::steady_clock::now() - start;
+      result.best_ms =
+          std::min(result.best_ms, std::chrono::duration<double, std::milli>(elapsed).count());
+      result.hits       = hits;
+      result.lambda_sum = lambda_sum;
+    }
+    return result;
+  }
+
+  void bench_scene(render::Config cfg, std::string const & scene_file) {
+    render::Scene scene = render::read_scene(scene_file);
+    std::vector<render::Ray> const rays = make_rays(cfg, scene);
+    std::println(std::cout, "\n{}: {} spheres, {} cylinders, {} rays", scene_file,
+                 scene.spheres.size(), scene.cylinders.size(), rays.size());
+
+    std::array<std::string, 5> const accelerators{"linear", "bvh", "bvh4", "bvh8", "simd"};
+    std::array<Result, 5> results{};
+    for (std::size_t i = 0; i < accelerators.size(); ++i) {
+      cfg.accelerator = accelerators[i];
+      render::BVHStats const stats = render::build_accelerator(scene, cfg);
+      if (accelerators[i] == "bvh") {
+        std::cout << "  " << stats << '\n';
+      }
+      results[i] = trace_all(scene, rays);
+    }
+
+    // El recorrido lineal es la referencia de corrección; la BVH binaria, la de velocidad
+    Result const & reference = results[0];
+    double const bvh_ms      = results[1].best_ms;
+    for (std::size_t i = 0; i < accelerators.size(); ++i) {
+      Result const & result = results[i];
+      double const mrays    = static_cast<double>(rays.size()) / (result.best_ms * 1'000.0);
+      bool const matches =
+          result.hits == reference.hits and result.lambda_sum == reference.lambda_sum;
+      std::println(std::cout, "  {:<7}{:>10.2f} ms {:>9.2f} Mrays/s {:>7.2f}x vs bvh  {}",
+                   accelerators[i], result.best_ms, mrays, bvh_ms / result.best_ms,
+                   matches ? "ok" : "MISMATCH");
+    }
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc < 3) {
+      std::cerr << "Usage: " << args[0] << " <config> <scene> [<scene> ...]\n";
+      return 1;
+    }
+
+    render::Config const cfg = render::read_config(args[1]);
+    for (std::size_t i = 2; i < args.size(); ++i) {
+      bench_scene(cfg, args[i]);
+    }
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,194 @@
+// Compara los dos métodos de muestreo de la bola unidad (ball_sampling): por rechazo
+// (random_in_unit_sphere) y directo (random_in_unit_ball). Para cada motor de números
+// aleatorios muestra el coste por punto, cuántos números consume cada punto y si la
+// distribución es uniforme: media de r^3 (0.5), E[x^2] (0.2) y chi-cuadrado sobre 32
+// celdas de igual volumen (8 octantes x 4 capas). Con 31 grados de libertad, valores por
+// encima de ~52 indicarían una distribución sesgada (p < 0.01).
+// Con una configuración y una escena, además renderiza la imagen con cada método.
+//
+// Uso: bench-ball [<config> <scene>]
+// Ejemplo: bench-ball render-2025/config4.txt render-2025/scene4.txt
+
+#include "batch_rng.hpp"
+#include "bvh.hpp"
+#include "config.hpp"
+#include "renderer.hpp"
+#include "rng.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+  constexpr int repetitions = 5;
+  constexpr int points      = 4'000'000;
+
+  // Cuenta los números que pide cada punto
+  template <typename Engine>
+  class CountingEngine {
+  public:
+    explicit CountingEngine(uint64_t seed) : m_engine(seed) { }
+
+    float next_float() {
+      ++draws;
+      return m_engine.next_float();
+    }
+
+    uint64_t draws{0};
+
+  private:
+    Engine m_engine;
+  };
+
+  struct Stats {
+    double ns_per_point{std::numeric_limits<double>::infinity()};
+    double draws_per_point{};
+    double mean_radius_cubed{};
+    double mean_x_squared{};
+    double chi_square{};
+    float checksum{};  // Se imprime para que el compilador no elimine el bucle
+  };
+
+  // Celda de igual volumen: octante (3 bits) y capa de r^3 en cuartos
+  std::size_t cell_of(render::vector const & p) {
+    std::size_t const octant = (p.x() < 0.0F ? 1U : 0U) | (p.y() < 0.0F ? 2U : 0U) |
+                               (p.z() < 0.0F ? 4U : 0U);
+    float const r3           = p.length_squared() * p.magnitude();
+    auto const shell         = std::min<std::size_t>(3, static_cast<std::size_t>(r3 * 4.0F));
+    return octant * 4 + shell;
+  }
+
+  template <typename R, typename Sample>
+  Stats measure(Sample sample) {
+    Stats stats;
+    for (int rep = 0; rep < repetitions; ++rep) {
+      R rng(19);
+      auto const start = std::chrono::steady_clock::now();
+      for (int i = 0; i < points; ++i) {
+        stats.checksum += sample(rng).x();
+      }
+      std::chrono::duration<double, std::nano> const elapsed =
+          std::chrono::steady_clock::now() - start;
+      stats.ns_per_point = std::min(stats.ns_per_point, elapsed.count() / points);
+    }
+
+    // Distribución y números consumidos, con un motor que cuenta las llamadas
+    render::BasicRNG<CountingEngine<typename R::engine_type>> counted(19);
+    std::array<int, 32> cells{};
+    for (int i = 0; i < points; ++i) {
+      render::vector const p = sample(counted);
+      float const r          = p.magnitude();
+      stats.mean_radius_cubed += static_cast<double>(r * r * r);
+      stats.mean_x_squared    += static_cast<double>(p.x() * p.x());
+      ++cells[cell_of(p)];
+    }
+    double const expected = static_cast<double>(points) / static_cast<double>(cells.size());
+    for (int const count : cells) {
+      double const diff  = static_cast<double>(count) - expected;
+      stats.chi_square  += diff * diff / expected;
+    }
+    stats.mean_radius_cubed /= points;
+    stats.mean_x_squared    /= points;
+    stats.draws_per_point    = static_cast<double>(counted.engine().draws) / points;
+    return stats;
+  }
+
+  void print_row(std::string_view engine, std::string_view method, Stats const & s) {
+    std::println(std::cout,
+                 "{:<8} {:<10} {:>8.2f} {:>8.3f} {:>8.4f} {:>8.4f} {:>8.1f}   ({:.0f})", engine,
+                 method, s.ns_per_point, s.draws_per_point, s.mean_radius_cubed, s.mean_x_squared,
+                 s.chi_square, s.checksum);
+  }
+
+  template <typename R>
+  void bench_engine(std::string_view name) {
+    print_row(name, "rejection",
+              measure<R>([](auto & rng) { return rng.random_in_unit_sphere(); }));
+    print_row(name, "direct", measure<R>([](auto & rng) { return rng.random_in_unit_ball(); }));
+  }
+
+  struct Image {
+    int width{};
+    int height{};
+    std::vector<std::uint8_t> rgb;
+
+    Image(int w, int h)
+        : width{w}, height{h}, rgb(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * 3) {
+    }
+
+    void set_r(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3] = v; }
+
+    void set_g(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 1] = v; }
+
+    void set_b(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 2] = v; }
+  };
+
+  void bench_render(render::Config cfg, render::Scene const & scene) {
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    auto const height =
+        static_cast<int>(static_cast<float>(cfg.image_width) / (aspect_w / aspect_h));
+
+    std::println(std::cout, "\n{:<10} {:<10} {:>10}", "engine", "method", "render ms");
+    for (std::string const engine : {"mt19937", "xoshiro"}) {
+      for (std::string const method : {"rejection", "direct"}) {
+        cfg.rng_engine    = engine;
+        cfg.ball_sampling = method;
+        double best       = std::numeric_limits<double>::infinity();
+        for (int rep = 0; rep < 3; ++rep) {
+          Image image(cfg.image_width, height);
+          auto const start = std::chrono::steady_clock::now();
+          (void) render::run_sequential_loop(image, cfg, scene);
+          std::chrono::duration<double, std::milli> const elapsed =
+              std::chrono::steady_clock::now() - start;
+          best = std::min(best, elapsed.count());
+        }
+        std::println(std::cout, "\r{:<10} {:<10} {:>10.0f}", engine, method, best);
+      }
+    }
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc != 1 and argc != 3) {
+      std::cerr << "Usage: " << args[0] << " [<config> <scene>]\n";
+      return 1;
+    }
+
+    std::println(std::cout, "{:<8} {:<10} {:>8} {:>8} {:>8} {:>8} {:>8}", "engine", "method",
+                 "ns/pt", "draws", "E[r^3]", "E[x^2]", "chi^2");
+    bench_engine<render::RNG>("mt19937");
+    bench_engine<render::XoshiroRNG>("xoshiro");
+    bench_engine<render::PcgRNG>("pcg");
+    bench_engine<render::BatchRNG>("batch");
+    bench_engine<render::StreamRNG>("counter");
+
+    if (argc == 3) {
+      render::Config cfg  = render::read_config(args[1]);
+      render::Scene scene = render::read_scene(args[2]);
+      render::build_accelerator(scene, cfg);
+      cfg.threads  = 1;
+      cfg.rng_mode = "legacy";
+      cfg.sampler  = "random";
+      bench_render(cfg, scene);
+    }
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,182 @@
+// Compara las políticas de páginas enormes (huge_pages: off, thp y hugetlb) renderizando
+// la misma escena: para cada una se vuelven a crear la escena, la BVH y la imagen, y se
+// mide el tiempo y los fallos de la TLB de datos en lecturas (perf_event_open, contando
+// también los hilos del render). Muestra además cuántos bytes se asignaron de cada forma
+// (MAP_HUGETLB, MADV_HUGEPAGE u operator new, que es lo que usa off) y los KB de páginas
+// enormes transparentes del proceso (AnonHugePages). Si el núcleo no deja abrir el
+// contador (perf_event_paranoid), la columna sale como "n/a".
+//
+// Uso: bench-hugepages <config> <scene> [<threads>]
+// Ejemplo: bench-hugepages render-2025/config4.txt render-2025/scene4.txt 8
+
+#include "bvh.hpp"
+#include "config.hpp"
+#include "huge_page_allocator.hpp"
+#include "image_aos.hpp"
+#include "renderer.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+
+  constexpr int repetitions = 3;
+
+  // Contador de fallos de dTLB en lecturas del proceso y de los hilos que cree después
+  class DtlbCounter {
+  public:
+    DtlbCounter() {
+#if defined(__linux__)
+      perf_event_attr attr{};
+      attr.size   = sizeof(attr);
+      attr.type   = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+      attr.disabled       = 1;
+      attr.inherit        = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      m_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~DtlbCounter() {
+#if defined(__linux__)
+      if (m_fd >= 0) {
+        ::close(m_fd);
+      }
+#endif
+    }
+
+    DtlbCounter(DtlbCounter const &)             = delete;
+    DtlbCounter & operator=(DtlbCounter const &) = delete;
+
+    [[nodiscard]] bool available() const noexcept { return m_fd >= 0; }
+
+    void start() noexcept {
+#if defined(__linux__)
+      if (m_fd >= 0) {
+        ::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+    }
+
+    // Fallos desde start (con inherit, incluye los hilos ya terminados)
+    [[nodiscard]] std::uint64_t stop() noexcept {
+      std::uint64_t count = 0;
+#if defined(__linux__)
+      if (m_fd >= 0) {
+        ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (::read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) {
+          count = 0;
+        }
+      }
+#endif
+      return count;
+    }
+
+  private:
+    int m_fd{-1};
+  };
+
+  // KB de páginas enormes transparentes del proceso, o -1 si no se puede leer
+  long anon_huge_kb() {
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string key;
+    long value = 0;
+    while (in >> key >> value) {
+      if (key == "AnonHugePages:") {
+        return value;
+      }
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return -1;
+  }
+
+  void bench_policy(std::string_view name, render::Config const & cfg,
+                    std::string const & scene_file, int height) {
+    render::set_huge_page_policy(render::huge_page_policy_for(std::string(name)));
+    render::HugePageStats const before = render::huge_page_stats();
+    render::Scene scene                = render::read_scene(scene_file);
+    render::build_accelerator(scene, cfg);
+
+    DtlbCounter counter;
+    double best_secs          = std::numeric_limits<double>::infinity();
+    std::uint64_t best_misses = 0;
+    long huge_kb              = -1;
+    for (int i = 0; i < repetitions; ++i) {
+      render::ImageAOS image(cfg.image_width, height);
+      counter.start();
+      auto const start = std::chrono::steady_clock::now();
+      (void) render::run_tiled_loop(image, cfg, scene);
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+      std::uint64_t const misses                  = counter.stop();
+      if (elapsed.count() < best_secs) {
+        best_secs   = elapsed.count();
+        best_misses = misses;
+      }
+      huge_kb = anon_huge_kb();
+    }
+
+    render::HugePageStats const after = render::huge_page_stats();
+    auto const mib                    = [](std::size_t a, std::size_t b) {
+      return static_cast<double>(a - b) / (1 << 20);
+    };
+    std::println(std::cout, "\r{:<8} {:>10.0f} {:>14} {:>9.1f} {:>9.1f} {:>9.1f} {:>10}", name,
+                 best_secs * 1e3,
+                 counter.available() ? std::to_string(best_misses) : std::string("n/a"),
+                 mib(after.hugetlb_bytes, before.hugetlb_bytes),
+                 mib(after.advised_bytes, before.advised_bytes),
+                 mib(after.regular_bytes, before.regular_bytes),
+                 huge_kb < 0 ? std::string("n/a") : std::to_string(huge_kb));
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc != 3 and argc != 4) {
+      std::cerr << "Usage: " << args[0] << " <config> <scene> [<threads>]\n";
+      return 1;
+    }
+    render::Config cfg = render::read_config(args[1]);
+    if (argc == 4) {
+      cfg.threads = std::stoi(args[3]);
+    }
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    auto const height =
+        static_cast<int>(static_cast<float>(cfg.image_width) / (aspect_w / aspect_h));
+
+    std::println(std::cout, "render {}x{}, {} threads (best of {})", cfg.image_width, height,
+                 render::resolve_thread_count(cfg.threads), repetitions);
+    std::println(std::cout, "{:<8} {:>10} {:>14} {:>9} {:>9} {:>9} {:>10}", "policy", "ms",
+                 "dTLB misses", "tlb MiB", "thp MiB", "new MiB", "AnonHugeKB");
+    for (std::string_view const policy : {"off", "thp", "hugetlb"}) {
+      bench_policy(policy, cfg, args[2], height);
+    }
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,160 @@
+// Compara las cuatro distribuciones de imagen (ImageAOS, ImageSOA, ImageTiled e
+// ImageAoSoA) con uno y con varios hilos. Primero mide solo la escritura: cada hilo recorre
+// sus teselas y entrega cada fila con write_span, como el bucle de render pero sin trazar
+// rayos, así que el tiempo es el de los accesos a memoria. Con una configuración y una
+// escena, además renderiza la imagen con cada distribución (modo "per_pixel", así que el
+// trabajo y el resultado son los mismos en todas).
+//
+// Uso: bench-layout [<config> <scene> [<threads>]]
+// Ejemplo: bench-layout render-2025/config4.txt render-2025/scene4.txt 8
+
+#include "bvh.hpp"
+#include "config.hpp"
+#include "image_aos.hpp"
+#include "image_aosoa.hpp"
+#include "image_soa.hpp"
+#include "image_tiled.hpp"
+#include "renderer.hpp"
+#include "scene.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+  constexpr int repetitions = 5;
+
+  // Mejor tiempo de 'repetitions' ejecuciones de 'body', en segundos
+  template <typename F>
+  double best_seconds(F && body) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < repetitions; ++i) {
+      auto const start = std::chrono::steady_clock::now();
+      body();
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  }
+
+  // Crea la imagen: ImageTiled usa el tamaño de tesela del render
+  template <typename Image>
+  Image make_image(int width, int height, int tile_size) {
+    if constexpr (std::is_same_v<Image, render::ImageTiled>) {
+      return Image(width, height, tile_size);
+    } else {
+      return Image(width, height);
+    }
+  }
+
+  // Escribe 'frames' veces todas las teselas fila a fila con write_span, repartidas entre
+  // 'threads' hilos. Devuelve los millones de píxeles escritos por segundo.
+  template <typename Image>
+  double write_rate(int width, int height, int tile_size, int threads, int frames) {
+    Image image = make_image<Image>(width, height, tile_size);
+    std::vector<render::Tile> const tiles = render::make_tiles(width, height, tile_size);
+    std::vector<float> const row(3 * static_cast<std::size_t>(tile_size), 0.5F);
+    render::ThreadPool pool(threads);
+    double const secs = best_seconds([&] {
+      for (int frame = 0; frame < frames; ++frame) {
+        pool.parallel_for(tiles.size(), [&](std::size_t index) {
+          render::Tile const & tile = tiles[index];
+          for (int y = tile.y0; y < tile.y1; ++y) {
+            image.write_span(y, tile.x0, row.data(), tile.x1 - tile.x0);
+          }
+        });
+      }
+    });
+    return static_cast<double>(width) * height * frames / secs * 1e-6;
+  }
+
+  template <typename Image>
+  double render_ms(render::Config const & cfg, render::Scene const & scene, int height) {
+    return best_seconds([&] {
+             Image image = make_image<Image>(cfg.image_width, height, cfg.tile_size);
+             (void) render::run_tiled_loop(image, cfg, scene);
+           }) *
+           1e3;
+  }
+
+  void bench_writes(int width, int height, int tile_size, int threads) {
+    constexpr int frames = 20;
+    std::println(std::cout, "write_span, {}x{}, tiles of {} (Mpixel/s)", width, height,
+                 tile_size);
+    std::println(std::cout, "{:<8} {:>12} {:>12}", "layout", "1 thread",
+                 std::to_string(threads) + " threads");
+    auto const row = [&]<typename Image>(std::string_view name, std::type_identity<Image>) {
+      std::println(std::cout, "{:<8} {:>12.1f} {:>12.1f}", name,
+                   write_rate<Image>(width, height, tile_size, 1, frames),
+                   write_rate<Image>(width, height, tile_size, threads, frames));
+    };
+    row("aos", std::type_identity<render::ImageAOS>{});
+    row("soa", std::type_identity<render::ImageSOA>{});
+    row("tiled", std::type_identity<render::ImageTiled>{});
+    row("aosoa", std::type_identity<render::ImageAoSoA>{});
+  }
+
+  void bench_render(render::Config cfg, render::Scene const & scene, int threads) {
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    auto const height =
+        static_cast<int>(static_cast<float>(cfg.image_width) / (aspect_w / aspect_h));
+    cfg.rng_mode = "per_pixel";
+
+    std::println(std::cout, "\nrender, {}x{} (ms)", cfg.image_width, height);
+    std::println(std::cout, "{:<8} {:>12} {:>12}", "layout", "1 thread",
+                 std::to_string(threads) + " threads");
+    auto const row = [&]<typename Image>(std::string_view name, std::type_identity<Image>) {
+      cfg.threads             = 1;
+      double const sequential = render_ms<Image>(cfg, scene, height);
+      cfg.threads             = threads;
+      double const parallel   = render_ms<Image>(cfg, scene, height);
+      std::println(std::cout, "\r{:<8} {:>12.0f} {:>12.0f}", name, sequential, parallel);
+    };
+    row("aos", std::type_identity<render::ImageAOS>{});
+    row("soa", std::type_identity<render::ImageSOA>{});
+    row("tiled", std::type_identity<render::ImageTiled>{});
+    row("aosoa", std::type_identity<render::ImageAoSoA>{});
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc != 1 and argc != 3 and argc != 4) {
+      std::cerr << "Usage: " << args[0] << " [<config> <scene> [<threads>]]\n";
+      return 1;
+    }
+    int const threads = render::resolve_thread_count(argc == 4 ? std::stoi(args[3]) : 0);
+
+    if (argc == 1) {
+      bench_writes(1'800, 1'012, render::Config{}.tile_size, threads);
+      return 0;
+    }
+
+    render::Config const cfg = render::read_config(args[1]);
+    render::Scene scene      = render::read_scene(args[2]);
+    render::build_accelerator(scene, cfg);
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    bench_writes(cfg.image_width,
+                 static_cast<int>(static_cast<float>(cfg.image_width) / (aspect_w / aspect_h)),
+                 cfg.tile_size, threads);
+    bench_render(cfg, scene, threads);
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
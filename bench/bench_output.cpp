@@ -0,0 +1,141 @@
+// Compara los backends de escritura del archivo de salida (std::ofstream, write(2) e
+// io_uring) guardando muchos fotogramas seguidos, como un trabajo por lotes. Por defecto
+// escribe en /dev/shm (tmpfs), donde cuenta el coste de las llamadas y no el del disco.
+// Muestra el tiempo por fotograma y los MB/s para P3 y P6 con ImageAOS e ImageSOA.
+//
+// Uso: bench-output [<width> <height> [<frames> [<dir>]]]
+// Ejemplo: bench-output 1800 1012 100 /dev/shm
+
+#include "async_file_writer.hpp"
+#include "image_aos.hpp"
+#include "image_soa.hpp"
+#include "ppm_writer.hpp"
+#include "rng.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <print>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace {
+
+  // Evita los mensajes "Image saved to" de cada fotograma
+  class MuteCout {
+  public:
+    MuteCout() : m_saved(std::cout.rdbuf(nullptr)) { }
+
+    ~MuteCout() { std::cout.rdbuf(m_saved); }
+
+    MuteCout(MuteCout const &)             = delete;
+    MuteCout & operator=(MuteCout const &) = delete;
+
+  private:
+    std::streambuf * m_saved;
+  };
+
+  // Guarda 'frames' fotogramas en archivos distintos y devuelve los segundos por fotograma
+  template <typename Image>
+  double seconds_per_frame(Image const & image, std::filesystem::path const & dir,
+                           std::string_view extension, int frames,
+                           render::ImageFormat format, render::OutputBackend backend) {
+    MuteCout const mute;
+    auto const start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+      auto const file =
+          dir / ("bench_output_" + std::to_string(frame % 8) + std::string(extension));
+      image.save(file.string(), format, backend);
+    }
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / frames;
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc != 1 and (argc < 3 or argc > 5)) {
+      std::cerr << "Usage: " << args[0] << " [<width> <height> [<frames> [<dir>]]]\n";
+      return 1;
+    }
+    int const width  = argc >= 3 ? std::stoi(args[1]) : 1'800;
+    int const height = argc >= 3 ? std::stoi(args[2]) : 1'012;
+    int const frames = argc >= 4 ? std::stoi(args[3]) : 100;
+    std::filesystem::path const dir =
+        argc == 5                                     ? std::filesystem::path(args[4])
+        : std::filesystem::is_directory("/dev/shm") ? std::filesystem::path("/dev/shm")
+                                                      : std::filesystem::temp_directory_path();
+
+    // Valores aleatorios: en texto ocupan de 1 a 3 cifras, como en una imagen real
+    render::ImageAOS aos(width, height);
+    render::ImageSOA soa(width, height);
+    render::XoshiroRNG rng(19);
+    for (std::size_t idx = 0; idx < aos.data.size(); ++idx) {
+      auto const channel = [&] { return static_cast<std::uint8_t>(rng.random_float() * 256.0F); };
+      aos.set_r(idx, channel());
+      aos.set_g(idx, channel());
+      aos.set_b(idx, channel());
+      soa.set_r(idx, aos.get_r(idx));
+      soa.set_g(idx, aos.get_g(idx));
+      soa.set_b(idx, aos.get_b(idx));
+    }
+
+    {
+      render::AsyncFileWriter const probe((dir / "bench_output_probe").string(),
+                                          render::OutputBackend::io_uring);
+      std::println(std::cout, "{}x{}, {} frames in {} (io_uring {})", width, height, frames,
+                   dir.string(), probe.uses_io_uring() ? "available" : "unavailable: write(2)");
+    }
+    std::println(std::cout, "{:<10} {:<10} {:>10} {:>10}", "image", "backend", "ms/frame",
+                 "MB/s");
+
+    struct Backend {
+      std::string_view name;
+      render::OutputBackend backend;
+    };
+
+    constexpr std::array<Backend, 3> backends{
+      Backend{"ofstream", render::OutputBackend::ofstream},
+      Backend{"write", render::OutputBackend::write},
+      Backend{"io_uring", render::OutputBackend::io_uring},
+    };
+
+    for (render::ImageFormat const format : {render::ImageFormat::p3, render::ImageFormat::p6}) {
+      std::string_view const extension = format == render::ImageFormat::p6 ? ".pnm" : ".ppm";
+      std::string_view const label     = format == render::ImageFormat::p6 ? "P6" : "P3";
+      for (Backend const & backend : backends) {
+        double const aos_seconds =
+            seconds_per_frame(aos, dir, extension, frames, format, backend.backend);
+        auto const bytes =
+            static_cast<double>(std::filesystem::file_size(dir / ("bench_output_0" +
+                                                                   std::string(extension))));
+        double const soa_seconds =
+            seconds_per_frame(soa, dir, extension, frames, format, backend.backend);
+        std::println(std::cout, "{:<10} {:<10} {:>10.2f} {:>10.1f}",
+                     std::string(label) + " AOS", backend.name, aos_seconds * 1e3,
+                     bytes * 1e-6 / aos_seconds);
+        std::println(std::cout, "{:<10} {:<10} {:>10.2f} {:>10.1f}",
+                     std::string(label) + " SOA", backend.name, soa_seconds * 1e3,
+                     bytes * 1e-6 / soa_seconds);
+      }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(dir / "bench_output_probe", ec);
+    for (int i = 0; i < 8; ++i) {
+      std::filesystem::remove(dir / ("bench_output_" + std::to_string(i) + ".ppm"), ec);
+      std::filesystem::remove(dir / ("bench_output_" + std::to_string(i) + ".pnm"), ec);
+    }
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
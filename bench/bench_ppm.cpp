@@ -0,0 +1,167 @@
+// Compara las formas de guardar la imagen: el P3 original (operator<< por número), el P3
+// con tabla y escrituras por bloques, y el P6 binario, para ImageAOS e ImageSOA. Muestra
+// el mejor tiempo, el tamaño del archivo y los MB/s. También mide el entrelazado de los
+// planos de ImageSOA con AVX2 y escalar, sin escribir a disco, y los codificadores QOI y
+// PNG en memoria (MB/s de píxeles de entrada y bytes por píxel de la salida).
+//
+// Uso: bench-ppm [<width> <height>]
+// Ejemplo: bench-ppm 1800 1012
+
+#include "image_aos.hpp"
+#include "image_codecs.hpp"
+#include "image_soa.hpp"
+#include "ppm_writer.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <span>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+  constexpr int repetitions = 5;
+
+  // Mejor tiempo de 'repetitions' ejecuciones de 'body', en segundos
+  template <typename F>
+  double best_seconds(F && body) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < repetitions; ++i) {
+      auto const start = std::chrono::steady_clock::now();
+      body();
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  }
+
+  // Escritor P3 original de ImageAOS, como referencia
+  void save_legacy_p3(render::ImageAOS const & image, std::string const & filename) {
+    std::ofstream out(filename);
+    out << "P3\n" << image.width << ' ' << image.height << '\n' << 255 << '\n';
+    for (std::size_t idx = 0; idx < image.data.size(); ++idx) {
+      out << static_cast<int>(image.get_r(idx)) << ' ' << static_cast<int>(image.get_g(idx))
+          << ' ' << static_cast<int>(image.get_b(idx)) << '\n';
+    }
+  }
+
+  // Evita los mensajes "Image saved to" de cada repetición
+  class MuteCout {
+  public:
+    MuteCout() : m_saved(std::cout.rdbuf(nullptr)) { }
+
+    ~MuteCout() { std::cout.rdbuf(m_saved); }
+
+    MuteCout(MuteCout const &)             = delete;
+    MuteCout & operator=(MuteCout const &) = delete;
+
+  private:
+    std::streambuf * m_saved;
+  };
+
+  void print_row(std::string_view name, double seconds, std::filesystem::path const & file) {
+    auto const bytes = static_cast<double>(std::filesystem::file_size(file));
+    std::println(std::cout, "{:<14} {:>10.1f} {:>10.2f} {:>10.1f}", name, seconds * 1e3,
+                 bytes * 1e-6, bytes * 1e-6 / seconds);
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc != 1 and argc != 3) {
+      std::cerr << "Usage: " << args[0] << " [<width> <height>]\n";
+      return 1;
+    }
+    int const width  = argc == 3 ? std::stoi(args[1]) : 1'800;
+    int const height = argc == 3 ? std::stoi(args[2]) : 1'012;
+
+    // Valores aleatorios: en texto ocupan de 1 a 3 cifras, como en una imagen real
+    render::ImageAOS aos(width, height);
+    render::ImageSOA soa(width, height);
+    render::XoshiroRNG rng(19);
+    for (std::size_t idx = 0; idx < aos.data.size(); ++idx) {
+      auto const channel = [&] { return static_cast<std::uint8_t>(rng.random_float() * 256.0F); };
+      aos.set_r(idx, channel());
+      aos.set_g(idx, channel());
+      aos.set_b(idx, channel());
+      soa.set_r(idx, aos.get_r(idx));
+      soa.set_g(idx, aos.get_g(idx));
+      soa.set_b(idx, aos.get_b(idx));
+    }
+
+    auto const dir = std::filesystem::temp_directory_path();
+    auto const p3  = dir / "bench_ppm.ppm";
+    auto const p6  = dir / "bench_ppm.pnm";
+
+    std::println(std::cout, "{}x{}\n{:<14} {:>10} {:>10} {:>10}", width, height, "writer", "ms",
+                 "MB", "MB/s");
+    auto const muted = [](auto && body) {
+      MuteCout const mute;
+      return best_seconds(body);
+    };
+    print_row("P3 legacy", muted([&] { save_legacy_p3(aos, p3.string()); }), p3);
+    print_row("P3 AOS", muted([&] { aos.save(p3.string()); }), p3);
+    print_row("P3 SOA", muted([&] { soa.save(p3.string()); }), p3);
+    print_row("P6 AOS", muted([&] { aos.save(p6.string(), render::ImageFormat::p6); }),
+              p6);
+    print_row("P6 SOA", muted([&] { soa.save(p6.string(), render::ImageFormat::p6); }),
+              p6);
+
+    // Entrelazado de los planos en memoria
+    std::vector<std::uint8_t> rgb(3 * soa.R.size());
+    double const simd = best_seconds([&] {
+      render::interleave_rgb(soa.R.data(), soa.G.data(), soa.B.data(), rgb.data(), soa.R.size());
+    });
+    double const scalar = best_seconds([&] {
+      render::interleave_rgb_scalar(soa.R.data(), soa.G.data(), soa.B.data(), rgb.data(),
+                                    soa.R.size());
+    });
+    auto const bytes = static_cast<double>(rgb.size());
+    std::println(std::cout, "\n{:<14} {:>10.2f} {:>10} {:>10.1f}", "interleave", simd * 1e3, "",
+                 bytes * 1e-6 / simd);
+    std::println(std::cout, "{:<14} {:>10.2f} {:>10} {:>10.1f}   (checksum {})", "  scalar",
+                 scalar * 1e3, "", bytes * 1e-6 / scalar, rgb[rgb.size() / 2]);
+
+    // Codificadores QOI y PNG, sin escribir a disco
+    std::span<std::uint8_t const> const pixels(
+        reinterpret_cast<std::uint8_t const *>(aos.data.data()), aos.data.size() * 3);
+    std::println(std::cout, "\n{:<14} {:>10} {:>10} {:>10} {:>10}", "encoder", "ms", "MB",
+                 "MB/s", "B/pixel");
+    auto const encoder_row = [&](std::string_view name, auto && encode) {
+      std::size_t size     = 0;
+      double const seconds = best_seconds([&] { size = encode().size(); });
+      auto const bytes     = static_cast<double>(size);
+      std::println(std::cout, "{:<14} {:>10.1f} {:>10.2f} {:>10.1f} {:>10.2f}", name,
+                   seconds * 1e3, bytes * 1e-6, static_cast<double>(pixels.size()) * 1e-6 / seconds,
+                   bytes / static_cast<double>(aos.data.size()));
+    };
+    encoder_row("QOI AOS", [&] { return render::encode_qoi(width, height, pixels); });
+    encoder_row("QOI SOA",
+                [&] { return render::encode_qoi_planar(width, height, soa.R, soa.G, soa.B); });
+    encoder_row("QOI 1 thread", [&] { return render::encode_qoi(width, height, pixels, 1); });
+    encoder_row("PNG AOS", [&] { return render::encode_png(width, height, pixels); });
+    encoder_row("PNG SOA",
+                [&] { return render::encode_png_planar(width, height, soa.R, soa.G, soa.B); });
+    encoder_row("PNG 1 thread", [&] { return render::encode_png(width, height, pixels, 1); });
+
+    std::error_code ec;
+    std::filesystem::remove(p3, ec);
+    std::filesystem::remove(p6, ec);
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
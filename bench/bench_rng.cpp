@@ -0,0 +1,157 @@
+// Compara los motores de números aleatorios: millones de floats y de puntos en la esfera
+// unitaria por segundo, y el tamaño de cada generador. Para el motor por bloques mide
+// también el relleno de un array (fill) y los carriles completos (next_lanes). Con una
+// configuración y una escena, además renderiza la imagen (modo "legacy", un hilo) con cada
+// motor de rng_engine.
+//
+// Uso: bench-rng [<config> <scene>]
+// Ejemplo: bench-rng render-2025/config4.txt render-2025/scene4.txt
+
+#include "batch_rng.hpp"
+#include "bvh.hpp"
+#include "config.hpp"
+#include "renderer.hpp"
+#include "rng.hpp"
+#include "scene.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+  constexpr int repetitions   = 5;
+  constexpr int draws_per_run = 10'000'000;
+
+  // Mejor tiempo de 'repetitions' ejecuciones de 'body', en segundos
+  template <typename F>
+  double best_seconds(F && body) {
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < repetitions; ++i) {
+      auto const start = std::chrono::steady_clock::now();
+      body();
+      std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+      best = std::min(best, elapsed.count());
+    }
+    return best;
+  }
+
+  // La suma se imprime para que el compilador no elimine el bucle
+  template <typename R>
+  void bench_engine(std::string_view name) {
+    float sum           = 0.0F;
+    double const floats = best_seconds([&] {
+      R rng(19);
+      for (int i = 0; i < draws_per_run; ++i) {
+        sum += rng.random_float();
+      }
+    });
+    double const points = best_seconds([&] {
+      R rng(19);
+      for (int i = 0; i < draws_per_run / 4; ++i) {
+        sum += rng.random_in_unit_sphere().x();
+      }
+    });
+    std::println(std::cout, "{:<10} {:>6} B {:>12.1f} {:>12.1f}   (checksum {:.0f})", name,
+                 sizeof(R), draws_per_run / floats * 1e-6, draws_per_run / 4 / points * 1e-6,
+                 sum);
+  }
+
+  // Consumo por bloques: un array de 4096 floats con fill o carriles de 8 con next_lanes
+  void bench_batch_bulk() {
+    std::vector<float> buffer(4'096);
+    float sum           = 0.0F;
+    double const filled = best_seconds([&] {
+      render::BatchEngine engine(19);
+      for (int i = 0; i < draws_per_run; i += static_cast<int>(buffer.size())) {
+        engine.fill(buffer);
+        sum += buffer[0];
+      }
+    });
+    double const lanes = best_seconds([&] {
+      render::BatchEngine engine(19);
+      for (int i = 0; i < draws_per_run; i += static_cast<int>(render::BatchEngine::lanes)) {
+        sum += engine.next_lanes()[7];
+      }
+    });
+    std::println(std::cout, "{:<10} {:>8} {:>12.1f}", "batch fill", "",
+                 draws_per_run / filled * 1e-6);
+    std::println(std::cout, "{:<10} {:>8} {:>12.1f}   (checksum {:.0f})", "batch lane", "",
+                 draws_per_run / lanes * 1e-6, sum);
+  }
+
+  struct Image {
+    int width{};
+    int height{};
+    std::vector<std::uint8_t> rgb;
+
+    Image(int w, int h)
+        : width{w}, height{h}, rgb(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * 3) {
+    }
+
+    void set_r(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3] = v; }
+
+    void set_g(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 1] = v; }
+
+    void set_b(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 2] = v; }
+  };
+
+  void bench_render(render::Config cfg, render::Scene const & scene) {
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    auto const height =
+        static_cast<int>(static_cast<float>(cfg.image_width) / (aspect_w / aspect_h));
+    cfg.threads  = 1;
+    cfg.rng_mode = "legacy";
+    cfg.sampler  = "random";
+
+    std::println(std::cout, "\n{:<10} {:>12}", "render", "ms");
+    for (std::string const engine : {"mt19937", "xoshiro", "pcg", "batch"}) {
+      cfg.rng_engine    = engine;
+      double const secs = best_seconds([&] {
+        Image image(cfg.image_width, height);
+        (void) render::run_sequential_loop(image, cfg, scene);
+      });
+      std::println(std::cout, "\r{:<10} {:>12.0f}", engine, secs * 1e3);
+    }
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc != 1 and argc != 3) {
+      std::cerr << "Usage: " << args[0] << " [<config> <scene>]\n";
+      return 1;
+    }
+
+    std::println(std::cout, "{:<10} {:>8} {:>12} {:>12}", "engine", "size", "Mfloat/s",
+                 "Msphere/s");
+    bench_engine<render::RNG>("mt19937");
+    bench_engine<render::XoshiroRNG>("xoshiro");
+    bench_engine<render::PcgRNG>("pcg");
+    bench_engine<render::StreamRNG>("counter");
+    bench_engine<render::BatchRNG>("batch");
+    bench_batch_bulk();
+
+    if (argc == 3) {
+      render::Config const cfg = render::read_config(args[1]);
+      render::Scene scene      = render::read_scene(args[2]);
+      render::build_accelerator(scene, cfg);
+      bench_render(cfg, scene);
+    }
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+// Convergencia de los muestreadores: renderiza una referencia con muchas muestras y
+// muestra el error (RMSE con la métrica de comparacion.py) de "random", "stratified" y
+// "sobol" para 1, 2, 4, ... muestras por píxel.
+//
+// Uso: bench-sampler <config> <scene> [<spp referencia> [<spp máximo>]]
+// Ejemplo: bench-sampler render-2025/config4.txt render-2025/scene4.txt 1024 64
+
+#include "bvh.hpp"
+#include "config.hpp"
+#include "renderer.hpp"
+#include "scene.hpp"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <print>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // Imagen RGB de 8 bits con la interfaz que usa write_color
+  struct Image {
+    int width{};
+    int height{};
+    std::vector<std::uint8_t> rgb;
+
+    Image(int w, int h)
+        : width{w}, height{h}, rgb(static_cast<std::size_t>(w) * static_cast<std::size_t>(h) * 3) {
+    }
+
+    void set_r(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3] = v; }
+
+    void set_g(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 1] = v; }
+
+    void set_b(std::size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 2] = v; }
+  };
+
+  struct Render {
+    Image image;
+    double ms{};
+  };
+
+  Render render_image(render::Config const & cfg, render::Scene const & scene) {
+    auto const aspect_w = static_cast<float>(cfg.aspect_ratio.first);
+    auto const aspect_h = static_cast<float>(cfg.aspect_ratio.second);
+    auto const height =
+        static_cast<int>(static_cast<float>(cfg.image_width) / (aspect_w / aspect_h));
+    Render result{.image = Image(cfg.image_width, height)};
+    auto const start = std::chrono::steady_clock::now();
+    (void) render::run_tiled_loop(result.image, cfg, scene);
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    result.ms          = std::chrono::duration<double, std::milli>(elapsed).count();
+    return result;
+  }
+
+  // Misma métrica que comparacion.py: diferencia media de los tres canales por píxel y
+  // raíz de la media de sus cuadrados
+  double rmse(Image const & a, Image const & b) {
+    double sum          = 0.0;
+    std::size_t const n = a.rgb.size() / 3;
+    for (std::size_t i = 0; i < n; ++i) {
+      double diff = 0.0;
+      for (std::size_t c = 0; c < 3; ++c) {
+        diff += std::abs(static_cast<double>(a.rgb[i * 3 + c]) -
+                         static_cast<double>(b.rgb[i * 3 + c]));
+      }
+      diff /= 3.0;
+      sum  += diff * diff;
+    }
+    return std::sqrt(sum / static_cast<double>(n));
+  }
+
+}  // namespace
+
+int main(int argc, char * argv[]) {
+  try {
+    std::span<char *> args(argv, static_cast<size_t>(argc));
+    if (argc < 3 or argc > 5) {
+      std::cerr << "Usage: " << args[0] << " <config> <scene> [<reference spp> [<max spp>]]\n";
+      return 1;
+    }
+
+    render::Config cfg  = render::read_config(args[1]);
+    render::Scene scene = render::read_scene(args[2]);
+    render::build_accelerator(scene, cfg);
+    int const reference_spp = argc > 3 ? std::stoi(args[3]) : 1'024;
+    int const max_spp       = argc > 4 ? std::stoi(args[4]) : 64;
+
+    // La referencia usa flujos independientes: no favorece a ningún patrón
+    cfg.rng_mode             = "per_pixel";
+    cfg.adaptive_min_samples = 0;
+    cfg.sampler              = "random";
+    cfg.samples_per_pixel    = reference_spp;
+    Render const reference   = render_image(cfg, scene);
+    std::println(std::cout, "\nReference: {} spp in {:.0f} ms", reference_spp, reference.ms);
+
+    std::array<std::string, 3> const samplers{"random", "stratified", "sobol"};
+    std::println(std::cout, "{:>6} {:>18} {:>18} {:>18}", "spp", samplers[0], samplers[1],
+                 samplers[2]);
+    for (int spp = 1; spp <= max_spp; spp *= 2) {
+      cfg.samples_per_pixel = spp;
+      std::print(std::cout, "{:>6}", spp);
+      for (std::string const & sampler : samplers) {
+        cfg.sampler    = sampler;
+        Render const r = render_image(cfg, scene);
+        std::print(std::cout, " {:>7.3f} ({:>6.0f} ms)", rmse(r.image, reference.image), r.ms);
+      }
+      std::println(std::cout, "");
+    }
+
+  } catch (std::exception const & e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
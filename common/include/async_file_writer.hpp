@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Cómo se escribe el archivo de salida: con std::ofstream (el original), con write(2)
+  // directamente o con io_uring (si el núcleo no lo admite, se usa write(2))
+  enum class OutputBackend { ofstream, write, io_uring };
+
+  // Backend según Config::output_backend ("ofstream", "write" o "io_uring")
+  OutputBackend output_backend_for(std::string const & setting);
+
+  // Escritor de archivos por búferes. Quien escribe pide un búfer con next_buffer, lo
+  // rellena y lo entrega con submit; los datos se escriben seguidos, en el orden de los
+  // submit. Con io_uring la escritura queda en cola (write fijo sobre búferes registrados)
+  // y el que llama sigue codificando el siguiente bloque en otro búfer; las finalizaciones
+  // solo se recogen cuando hace falta un búfer libre o en finish. Con write(2) cada submit
+  // escribe en el momento.
+  class AsyncFileWriter {
+  public:
+    static constexpr std::size_t buffer_size  = std::size_t{256} * 1'024;
+    static constexpr std::size_t buffer_count = 4;
+
+    // Abre (o trunca) el archivo. Con OutputBackend::io_uring prepara el anillo y, si no
+    // puede, usa write(2). Lanza std::runtime_error si no puede abrir el archivo.
+    AsyncFileWriter(std::string const & filename, OutputBackend backend);
+
+    // Si no se ha llamado a finish, espera a las escrituras pendientes sin comprobarlas
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(AsyncFileWriter const &)             = delete;
+    AsyncFileWriter & operator=(AsyncFileWriter const &) = delete;
+    AsyncFileWriter(AsyncFileWriter &&)                  = delete;
+    AsyncFileWriter & operator=(AsyncFileWriter &&)      = delete;
+
+    // Búfer libre de buffer_size bytes (espera a que termine su escritura anterior)
+    [[nodiscard]] std::span<char> next_buffer();
+
+    // Escribe los size primeros bytes del último búfer devuelto por next_buffer
+    void submit(std::size_t size);
+
+    // Espera a todas las escrituras y cierra el archivo. Lanza std::runtime_error si
+    // alguna falló.
+    void finish();
+
+    // Indica si las escrituras van por io_uring (false si se usa write(2))
+    [[nodiscard]] bool uses_io_uring() const noexcept { return m_ring_fd >= 0; }
+
+  private:
+    // Estado de la escritura de un búfer en io_uring (puede completarse en varias partes)
+    struct Pending {
+      std::uint64_t offset{};  // Posición en el archivo del primer byte del búfer
+      std::uint32_t done{};    // Bytes ya escritos
+      std::uint32_t size{};    // Bytes a escribir
+      bool busy{};
+    };
+
+    bool setup_ring(unsigned entries);
+    void close_ring() noexcept;
+    void queue_write(std::size_t buffer);
+    bool wait_completion();
+    void drain_completions() noexcept;
+    void write_all(char const * data, std::size_t size);
+
+    std::string m_filename;
+    int m_fd{-1};
+    std::vector<char> m_storage;  // buffer_count búferes seguidos
+    std::size_t m_current{0};     // Búfer que devolvió el último next_buffer
+    std::uint64_t m_offset{0};    // Posición de la siguiente escritura
+    int m_error{0};               // Primer errno de una escritura fallida
+
+    // io_uring (m_ring_fd < 0 si se usa write(2))
+    int m_ring_fd{-1};
+    bool m_fixed_buffers{false};
+    std::vector<Pending> m_pending;
+    std::size_t m_in_flight{0};
+    void * m_sq_ring{nullptr};
+    void * m_cq_ring{nullptr};
+    void * m_sqes{nullptr};
+    std::size_t m_sq_ring_size{0};
+    std::size_t m_cq_ring_size{0};
+    std::size_t m_sqes_size{0};
+    unsigned * m_sq_tail{nullptr};
+    unsigned * m_sq_mask{nullptr};
+    unsigned * m_sq_array{nullptr};
+    unsigned * m_cq_head{nullptr};
+    unsigned * m_cq_tail{nullptr};
+    unsigned * m_cq_mask{nullptr};
+    void * m_cqes{nullptr};
+  };
+
+}  // namespace render
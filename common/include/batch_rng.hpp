@@ -0,0 +1,74 @@
+#pragma once
+
+#include "rng.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace render {
+
+  // Estado de 8 generadores xoshiro128+: la palabra k de todos los carriles está en
+  // words[k * 8 .. k * 8 + 7], así que cada palabra se carga en un registro AVX2
+  struct alignas(32) BatchState {
+    static constexpr std::size_t lanes = 8;
+    std::array<uint32_t, 4 * lanes> words{};
+  };
+
+  // Avanza los carriles y escribe blocks * 16 floats en [0, 1) en 'out' (dos pasos de los
+  // 8 carriles por bloque). Usa AVX2 si la CPU lo admite.
+  void generate_batch(BatchState & state, float * out, std::size_t blocks) noexcept;
+
+  // Versión escalar, con la misma secuencia (CPUs sin AVX2 y referencia en los tests)
+  void generate_batch_scalar(BatchState & state, float * out, std::size_t blocks) noexcept;
+
+  // Motor por bloques: 8 generadores xoshiro128+ independientes, uno por carril de un
+  // registro AVX2, que avanzan a la vez. Cada recarga produce 'block' floats con dos pasos
+  // de los 8 carriles. El método next_float lee de ese búfer, así que BasicRNG funciona sin
+  // cambios aunque cada llamada consuma un número distinto de valores (rechazo en
+  // random_in_unit_sphere). Los núcleos SIMD pueden pedir un carril completo con
+  // next_lanes o rellenar un array entero con fill.
+  // Sin AVX2 se usa una versión escalar que da exactamente la misma secuencia.
+  class BatchEngine {
+  public:
+    static constexpr std::size_t lanes = BatchState::lanes;
+    static constexpr std::size_t block = 2 * lanes;
+
+    explicit BatchEngine(uint64_t seed) noexcept;
+
+    float next_float() noexcept {
+      if (m_next == block) {
+        refill();
+      }
+      return m_buffer[m_next++];
+    }
+
+    // Devuelve los 8 valores siguientes alineados a 32 bytes (se pueden cargar con
+    // _mm256_load_ps). Si el búfer tenía un grupo de 8 empezado, se descarta su resto.
+    std::span<float const, lanes> next_lanes() noexcept {
+      std::size_t const start = (m_next + lanes - 1) / lanes * lanes;
+      if (start >= block) {
+        refill();
+        m_next = lanes;
+        return std::span<float const, lanes>(m_buffer.data(), lanes);
+      }
+      m_next = start + lanes;
+      return std::span<float const, lanes>(m_buffer.data() + start, lanes);
+    }
+
+    // Rellena 'out' con los valores siguientes de la secuencia (los mismos que darían
+    // out.size() llamadas a next_float)
+    void fill(std::span<float> out) noexcept;
+
+  private:
+    void refill() noexcept;
+
+    BatchState m_state;
+    alignas(32) std::array<float, block> m_buffer{};
+    std::size_t m_next{block};
+  };
+
+  // Generador con el motor por bloques (rng_engine: batch)
+  using BatchRNG = BasicRNG<BatchEngine>;
+
+}  // namespace render
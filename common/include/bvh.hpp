@@ -0,0 +1,91 @@
+#pragma once
+
+#include "huge_page_allocator.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <vector>
+
+namespace render {
+
+  struct Config;
+  struct Cylinder;
+  struct Scene;
+  struct Sphere;
+
+  // Caja alineada con los ejes (vacía por defecto: min = +inf, max = -inf)
+  struct AABB {
+    std::array<float, 3> min{std::numeric_limits<float>::infinity(),
+                             std::numeric_limits<float>::infinity(),
+                             std::numeric_limits<float>::infinity()};
+    std::array<float, 3> max{-std::numeric_limits<float>::infinity(),
+                             -std::numeric_limits<float>::infinity(),
+                             -std::numeric_limits<float>::infinity()};
+
+    void expand(AABB const & other) noexcept;
+    void expand(std::array<float, 3> const & p) noexcept;
+
+    [[nodiscard]] std::array<float, 3> centroid() const noexcept;
+    [[nodiscard]] int longest_axis() const noexcept;
+
+    // Mitad del área de la superficie (0 si la caja está vacía), usada por la SAH
+    [[nodiscard]] float half_area() const noexcept;
+  };
+
+  // Cajas ajustadas de las primitivas (el cilindro admite cualquier orientación del eje)
+  AABB bounds_of(Sphere const & s) noexcept;
+  AABB bounds_of(Cylinder const & c) noexcept;
+
+  // Nodo del árbol. Los nodos se guardan en un único vector en orden de profundidad:
+  // el hijo izquierdo de un nodo interior es el nodo siguiente y el derecho está en
+  // 'right_or_first'. En una hoja, 'right_or_first' es el primer índice en BVH::prims.
+  struct BVHNode {
+    AABB bounds;
+    uint32_t right_or_first{};
+    uint32_t count{};  // Número de primitivas (0 = nodo interior)
+
+    [[nodiscard]] bool is_leaf() const noexcept { return count > 0; }
+  };
+
+  // Métricas de construcción y calidad del árbol
+  struct BVHStats {
+    double build_ms{};     // Tiempo de construcción en milisegundos
+    float sah_cost{};      // Coste SAH esperado por rayo (nodos + primitivas visitadas)
+    int max_depth{};       // Profundidad máxima (la raíz tiene profundidad 0)
+    std::size_t nodes{};   // Número total de nodos
+    std::size_t leaves{};  // Número de hojas
+    std::size_t min_leaf_size{};
+    std::size_t max_leaf_size{};
+    double avg_leaf_size{};
+  };
+
+  // Jerarquía de volúmenes envolventes sobre las esferas y cilindros de la escena
+  struct BVH {
+    // Referencia a primitiva: índice en Scene::spheres, o en Scene::cylinders si
+    // lleva activado el bit cylinder_flag
+    static constexpr uint32_t cylinder_flag = 0x8000'0000U;
+
+    huge_vector<BVHNode> nodes;
+    huge_vector<uint32_t> prims;
+    BVHStats stats;
+
+    [[nodiscard]] bool empty() const noexcept { return nodes.empty(); }
+  };
+
+  // Construye la BVH de la escena con la heurística SAH por bins (se llama una vez,
+  // después de read_scene). 'threads' sigue el convenio de "threads:" (0 = todos).
+  BVH build_bvh(Scene const & scene, int threads = 1);
+
+  // Recorre el árbol y calcula su coste SAH, profundidad y tamaños de hoja
+  BVHStats compute_bvh_stats(BVH const & bvh);
+
+  std::ostream & operator<<(std::ostream & out, BVHStats const & stats);
+
+  // Prepara la estructura de aceleración indicada en "accelerator:" de la configuración.
+  // Devuelve las métricas de la BVH binaria (también cuando se colapsa en bvh4 o bvh8);
+  // sin BVH, nodes es 0. No escribe nada: los programas deciden si mostrarlas.
+  BVHStats build_accelerator(Scene & scene, Config const & cfg);
+
+}  // namespace render
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "bvh.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace render {
+
+  // Nodo de una BVH de W hijos. Las cajas de los hijos se guardan por componentes (SoA)
+  // para probarlas contra el rayo con una sola operación vectorial. Ocupa un número
+  // entero de líneas de caché (128 bytes con W = 4, 256 con W = 8).
+  template <std::size_t W>
+  struct alignas(64) WideBVHNode {
+    static constexpr uint32_t empty_slot = std::numeric_limits<uint32_t>::max();
+
+    // Los huecos sin hijo tienen una caja vacía (min = +inf, max = -inf) que ningún rayo cruza
+    std::array<float, W> min_x, min_y, min_z, max_x, max_y, max_z;
+    // Índice del nodo hijo, o primer índice en WideBVH::prims si el hijo es una hoja
+    std::array<uint32_t, W> child;
+    // Primitivas de la hoja (0 = nodo interior)
+    std::array<uint32_t, W> count;
+
+    WideBVHNode() noexcept {
+      constexpr float inf = std::numeric_limits<float>::infinity();
+      min_x.fill(inf);
+      min_y.fill(inf);
+      min_z.fill(inf);
+      max_x.fill(-inf);
+      max_y.fill(-inf);
+      max_z.fill(-inf);
+      child.fill(empty_slot);
+      count.fill(0);
+    }
+  };
+
+  // BVH ancha: nodos en un único vector en orden de profundidad (la raíz es el nodo 0)
+  template <std::size_t W>
+  struct WideBVH {
+    huge_vector<WideBVHNode<W>> nodes;
+    huge_vector<uint32_t> prims;  // Mismo formato que BVH::prims
+
+    [[nodiscard]] bool empty() const noexcept { return nodes.empty(); }
+  };
+
+  using BVH4 = WideBVH<4>;
+  using BVH8 = WideBVH<8>;
+
+  // Colapsa una BVH binaria: cada nodo absorbe a sus descendientes (abriendo siempre el
+  // de mayor área) hasta tener W hijos. Las hojas se conservan tal cual.
+  // (Instanciada en bvh_wide.cpp para W = 4 y W = 8)
+  template <std::size_t W>
+  WideBVH<W> build_wide_bvh(BVH const & bvh);
+
+}  // namespace render
@@ -21,6 +21,76 @@ namespace render {
 
     std::string background_dark_color{"0.25 0.5 1"};
     std::string background_light_color{"1 1 1"};
+
+    // Render en paralelo: 1 = bucle secuencial original, 0 = todos los núcleos
+    int threads{1};
+    int tile_size{32};
+
+    // Generadores: "legacy" (dos flujos compartidos en orden de filas) o "per_pixel"
+    // (un flujo por píxel y muestra, resultado independiente de hilos y teselas)
+    std::string rng_mode{"legacy"};
+
+    // Motor de los generadores del modo "legacy": "mt19937" (Mersenne Twister de la
+    // biblioteca estándar, reproduce las imágenes de referencia), "xoshiro" (xoshiro256+)
+    // o "pcg" (PCG32), que ocupan 32 y 16 bytes en lugar de ~2.5 KB, o "batch" (8 xoshiro128+
+    // en paralelo con AVX2, leídos de un búfer de 16 valores)
+    std::string rng_engine{"mt19937"};
+
+    // Estructura de aceleración de hit_scene: "bvh" (binaria), "bvh4" o "bvh8" (anchas,
+    // con pruebas SIMD de 4 u 8 cajas), "simd" (todas las esferas en SoA, 8 por
+    // iteración) o "linear" (todos los objetos)
+    std::string accelerator{"bvh"};
+
+    // Terminación de caminos (0 = desactivada, valor por defecto). A partir de
+    // roulette_depth rebotes, cada camino sobrevive con probabilidad igual a la mayor
+    // componente de su throughput (ruleta rusa, sin sesgo); con throughput_threshold > 0
+    // se cortan los caminos cuyo throughput cae por debajo de ese valor
+    int roulette_depth{0};
+    float throughput_threshold{0.0F};
+
+    // Muestreo adaptativo (0 = desactivado, valor por defecto). Cada píxel toma al menos
+    // adaptive_min_samples muestras y sigue hasta samples_per_pixel solo mientras el error
+    // estándar de su luminancia supere adaptive_tolerance. Si sample_map no está vacío, se
+    // guarda ahí un PGM con las muestras de cada píxel
+    int adaptive_min_samples{0};
+    float adaptive_tolerance{0.01F};
+    std::string sample_map;
+
+    // Números del jitter y de los rebotes: "random" (independientes, según rng_mode),
+    // "stratified" (multi-jittered) o "sobol" (Sobol con aleatorización de Owen). Los dos
+    // últimos generan un patrón por píxel, así que usan siempre el bucle por teselas.
+    std::string sampler{"random"};
+
+    // Puntos de la bola unidad en los rebotes mate y metálicos: "rejection" (puntos del
+    // cubo hasta caer dentro, secuencia original) o "direct" (tres números por punto, sin
+    // rechazo ni ramas; cambia la imagen). Los muestreadores usan siempre el directo
+    std::string ball_sampling{"rejection"};
+
+    // Formato de la imagen de salida: "p3" (texto), "p6" (binario, unas 4 veces más pequeño
+    // y sin formatear números), "qoi" (comprimido sin pérdidas), "png" (sin comprimir) o
+    // "auto" (P6, QOI o PNG si el archivo termina en ".pnm", ".qoi" o ".png"; si no, P3).
+    // Se lee de la clave image_format: o de ppm_format:, su nombre original
+    std::string image_format{"auto"};
+
+    // Escritura durante el render (0 = desactivada, valor por defecto): la imagen se guarda
+    // por filas según se terminan, con un anillo de stream_rows filas en memoria (al menos
+    // las de una tesela) en lugar de la imagen completa
+    int stream_rows{0};
+
+    // Escritura del archivo al guardar: "ofstream" (por defecto), "write" (write(2) con
+    // búferes grandes) o "io_uring" (escrituras en cola; si no está disponible, write(2))
+    std::string output_backend{"ofstream"};
+
+    // Framebuffer del render: "ldr" (bytes con gamma, por defecto), "hdr" (floats lineales;
+    // la gamma y la cuantización se aplican después en un paso aparte) o "mapped" (el propio
+    // archivo P6 de salida proyectado en memoria, para imágenes que no caben en RAM). Con
+    // salida ".pfm" se usa siempre "hdr" y se guardan los floats.
+    std::string framebuffer{"ldr"};
+
+    // Páginas de los bloques grandes (framebuffer, BVH, arrays de la escena): "off" (por
+    // defecto), "thp" (páginas enormes transparentes con madvise) o "hugetlb" (páginas de
+    // 2 MB reservadas; si no hay, como "thp")
+    std::string huge_pages{"off"};
   };
 
   Config read_config(std::string const & filename);
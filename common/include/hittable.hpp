@@ -3,28 +3,73 @@
 #include "ray.hpp"     // Para Ray
 #include "scene.hpp"   // Para Sphere y Cylinder
 #include "vector.hpp"  // <-- Incluimos vector
+#include <cstdint>
 #include <optional>
-#include <string>
 
 namespace render {
 
-  // Contiene la información de una intersección
+  // Contiene la información de una intersección (sin memoria dinámica: se copia en cada
+  // candidato más cercano)
   struct HitRecord {
-    float lambda{};  // Distancia 't' o 'λ' a lo largo del rayo
-    vector point;    // <-- Ahora es un render::vector
-    vector normal;   // <-- Ahora es un render::vector
-    std::string material_name;
+    float lambda{};          // Distancia 't' o 'λ' a lo largo del rayo
+    vector point;            // <-- Ahora es un render::vector
+    vector normal;           // <-- Ahora es un render::vector
+    uint32_t material_id{};  // Índice en Scene::material_table
   };
 
-  // ... (Las declaraciones de funciones siguen igual) ...
+  // Error numérico detectado al intersectar un objeto preparado. Las rutinas de
+  // intersección no lanzan: anotan el primero y hit_scene lo lanza al terminar el rayo.
+  enum class HitFault : uint8_t {
+    none,
+    sphere_discriminant,
+    sphere_normal,
+    cylinder_discriminant,
+    cylinder_normal,
+    cap_normal,
+  };
+
+  // Lanza std::runtime_error con el mensaje correspondiente a 'fault'
+  [[noreturn]] void throw_hit_fault(HitFault fault);
+
+  // Intersección con objetos ya preparados (ver prepare_scene): sin validaciones ni
+  // excepciones; un NaN o INF se anota en 'fault' y se trata como fallo del rayo
+  std::optional<HitRecord> hit_sphere(PreparedSphere const & s, Ray const & r, float lambda_min,
+                                      float lambda_max, HitFault & fault) noexcept;
 
+  std::optional<HitRecord> hit_cylinder(PreparedCylinder const & c, Ray const & r,
+                                        float lambda_min, float lambda_max,
+                                        HitFault & fault) noexcept;
+
+  // Preparan el objeto y lo intersectan, lanzando std::runtime_error si no es válido o
+  // hay un error numérico (para pruebas y usos sueltos; la escena usa las de arriba)
   std::optional<HitRecord> hit_sphere(Sphere const & s, Ray const & r, float lambda_min,
                                       float lambda_max);
 
   std::optional<HitRecord> hit_cylinder(Cylinder const & c, Ray const & r, float lambda_min,
                                         float lambda_max);
 
+  // Usa la estructura de aceleración construida en la escena (BVH8, BVH4, BVH binaria o
+  // esferas en SoA); si no hay ninguna, recorre todos los objetos. Todas las variantes
+  // trabajan sobre scene.prepared y lanzan std::runtime_error al final del rayo si algún
+  // objeto dio un error numérico.
   std::optional<HitRecord> hit_scene(Scene const & scene, Ray const & r, float lambda_min,
                                      float lambda_max);
 
+  std::optional<HitRecord> hit_scene_linear(Scene const & scene, Ray const & r, float lambda_min,
+                                            float lambda_max);
+
+  std::optional<HitRecord> hit_scene_bvh(Scene const & scene, Ray const & r, float lambda_min,
+                                         float lambda_max);
+
+  // Recorren las BVH anchas probando las cajas de todos los hijos de un nodo a la vez
+  std::optional<HitRecord> hit_scene_bvh4(Scene const & scene, Ray const & r, float lambda_min,
+                                          float lambda_max);
+
+  std::optional<HitRecord> hit_scene_bvh8(Scene const & scene, Ray const & r, float lambda_min,
+                                          float lambda_max);
+
+  // Prueba todas las esferas y todos los cilindros con los núcleos SIMD de SceneSOA
+  std::optional<HitRecord> hit_scene_simd(Scene const & scene, Ray const & r, float lambda_min,
+                                          float lambda_max);
+
 }  // namespace render
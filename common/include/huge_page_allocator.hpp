@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Cómo se piden los bloques grandes (framebuffers, BVH, arrays de la escena): "off"
+  // (operator new, como el resto de la memoria; la referencia para comparar), "thp"
+  // (madvise(MADV_HUGEPAGE) sobre un bloque alineado a 2 MB, para que el núcleo use
+  // páginas enormes transparentes) o "hugetlb" (mmap con MAP_HUGETLB de páginas de 2 MB
+  // reservadas; si no quedan, se usa "thp")
+  enum class HugePagePolicy { off, thp, hugetlb };
+
+  // Política según Config::huge_pages ("off", "thp" o "hugetlb")
+  HugePagePolicy huge_page_policy_for(std::string const & setting);
+
+  // Política de las asignaciones siguientes (global; por defecto, off). Los bloques ya
+  // asignados se liberan bien aunque cambie.
+  void set_huge_page_policy(HugePagePolicy policy) noexcept;
+  [[nodiscard]] HugePagePolicy huge_page_policy() noexcept;
+
+  // Bytes asignados en bloques grandes desde el inicio, según cómo se obtuvieron
+  struct HugePageStats {
+    std::size_t hugetlb_bytes{};  // Con MAP_HUGETLB
+    std::size_t advised_bytes{};  // Con MADV_HUGEPAGE (política thp o reserva agotada)
+    std::size_t regular_bytes{};  // Con operator new (política off), sin mmap propio
+  };
+
+  [[nodiscard]] HugePageStats huge_page_stats() noexcept;
+
+  // Tamaño de página enorme: con las políticas thp y hugetlb, los bloques de al menos este
+  // tamaño se piden con mmap, redondeados a un múltiplo y alineados a él
+  inline constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+
+  // Asigna y libera un bloque de 'bytes' (>= huge_page_size) con la política actual; con
+  // off, con operator new alineado a 64 bytes. deallocate_huge libera cada bloque como se
+  // asignó aunque la política haya cambiado. allocate_huge lanza std::bad_alloc si falla.
+  [[nodiscard]] void * allocate_huge(std::size_t bytes);
+  void deallocate_huge(void * p, std::size_t bytes) noexcept;
+
+  // Asignador de std::vector que pide los bloques grandes con allocate_huge y los pequeños
+  // alineados a una línea de caché (64 bytes, para las cargas SIMD)
+  template <typename T>
+  struct HugePageAllocator {
+    using value_type = T;
+
+    static constexpr std::size_t small_alignment = 64;
+
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    explicit HugePageAllocator(HugePageAllocator<U> const & /*other*/) noexcept { }
+
+    [[nodiscard]] T * allocate(std::size_t n) {
+      std::size_t const bytes = n * sizeof(T);
+      if (bytes >= huge_page_size) {
+        return static_cast<T *>(allocate_huge(bytes));
+      }
+      return static_cast<T *>(::operator new(bytes, std::align_val_t{small_alignment}));
+    }
+
+    void deallocate(T * p, std::size_t n) noexcept {
+      std::size_t const bytes = n * sizeof(T);
+      if (bytes >= huge_page_size) {
+        deallocate_huge(p, bytes);
+      } else {
+        ::operator delete(p, std::align_val_t{small_alignment});
+      }
+    }
+
+    friend bool operator==(HugePageAllocator const & /*a*/,
+                           HugePageAllocator const & /*b*/) noexcept {
+      return true;
+    }
+  };
+
+  template <typename T>
+  using huge_vector = std::vector<T, HugePageAllocator<T>>;
+
+}  // namespace render
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace render {
+
+  // Codificadores sin dependencias para guardar imágenes más compactas que PPM: QOI (sin
+  // pérdidas, rápido, normalmente entre 1 y 3 bytes por píxel) y PNG con bloques deflate
+  // almacenados (sin comprimir, unos 3 bytes por píxel, pero lo abre cualquier visor).
+  // Las filas se reparten en bloques que se codifican en paralelo (threads = 0 usa todos
+  // los núcleos). Hay una versión para píxeles entrelazados (ImageAOS) y otra para planos
+  // separados (ImageSOA).
+
+  // Filas de cada bloque que se codifica por separado
+  inline constexpr int codec_block_rows = 64;
+
+  std::vector<std::uint8_t> encode_qoi(int width, int height, std::span<std::uint8_t const> rgb,
+                                       int threads = 0);
+
+  std::vector<std::uint8_t> encode_qoi_planar(int width, int height,
+                                              std::span<std::uint8_t const> r,
+                                              std::span<std::uint8_t const> g,
+                                              std::span<std::uint8_t const> b, int threads = 0);
+
+  std::vector<std::uint8_t> encode_png(int width, int height, std::span<std::uint8_t const> rgb,
+                                       int threads = 0);
+
+  std::vector<std::uint8_t> encode_png_planar(int width, int height,
+                                              std::span<std::uint8_t const> r,
+                                              std::span<std::uint8_t const> g,
+                                              std::span<std::uint8_t const> b, int threads = 0);
+
+  // CRC-32 de PNG (polinomio 0xEDB88320), continuando desde crc (0 al empezar)
+  std::uint32_t crc32(std::span<std::uint8_t const> data, std::uint32_t crc = 0) noexcept;
+
+  // Adler-32 de zlib, continuando desde adler (1 al empezar)
+  std::uint32_t adler32(std::span<std::uint8_t const> data, std::uint32_t adler = 1) noexcept;
+
+  // Adler-32 de la concatenación de dos bloques a partir de los de cada uno y el tamaño
+  // del segundo (así cada hilo calcula el de su bloque)
+  std::uint32_t adler32_combine(std::uint32_t first, std::uint32_t second,
+                                std::size_t second_size) noexcept;
+
+}  // namespace render
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "tone_map.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Imagen que vive en el propio archivo de salida: el archivo P6 (cabecera y píxeles) se
+  // proyecta en memoria con mmap y el render escribe los bytes en su posición final. Tiene
+  // la misma interfaz que ImageAOS (width, height, set_r/g/b, write_span), con índices de
+  // 64 bits, así que sirve para imágenes que no caben en RAM (64K x 64K son 12 GiB). Al
+  // terminar cada región (finish_region), las páginas del archivo que ya están completas,
+  // sea cual sea el orden en que acaben las teselas, se mandan a escribir y se liberan, de
+  // modo que solo las páginas en curso ocupan memoria del proceso.
+  class MappedImage {
+  public:
+    int width{};
+    int height{};
+
+    // Crea el archivo con su tamaño final, escribe la cabecera P6 y lo proyecta. Lanza
+    // std::runtime_error si no puede crear, agrandar o proyectar el archivo (y en los dos
+    // últimos casos lo borra).
+    MappedImage(std::string const & filename, int w, int h);
+
+    // Si no se ha llamado a finish, deshace la proyección sin esperar a la escritura
+    ~MappedImage();
+
+    MappedImage(MappedImage const &)             = delete;
+    MappedImage & operator=(MappedImage const &) = delete;
+    MappedImage(MappedImage &&)                  = delete;
+    MappedImage & operator=(MappedImage &&)      = delete;
+
+    void set_r(std::size_t idx, std::uint8_t r) noexcept { m_pixels[3 * idx] = r; }
+
+    void set_g(std::size_t idx, std::uint8_t g) noexcept { m_pixels[3 * idx + 1] = g; }
+
+    void set_b(std::size_t idx, std::uint8_t b) noexcept { m_pixels[3 * idx + 2] = b; }
+
+    // Escribe n píxeles de la fila y desde x0 (rgb entrelazado, gamma aplicada)
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      std::size_t const first =
+          static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+          static_cast<std::size_t>(x0);
+      quantize(rgb, m_pixels + 3 * first, 3 * static_cast<std::size_t>(n));
+    }
+
+    [[nodiscard]] std::uint8_t get_r(std::size_t idx) const noexcept { return m_pixels[3 * idx]; }
+
+    [[nodiscard]] std::uint8_t get_g(std::size_t idx) const noexcept {
+      return m_pixels[3 * idx + 1];
+    }
+
+    [[nodiscard]] std::uint8_t get_b(std::size_t idx) const noexcept {
+      return m_pixels[3 * idx + 2];
+    }
+
+    // Marca como terminados los píxeles [x0, x1) x [y0, y1) y libera las páginas completas
+    void finish_region(int x0, int y0, int x1, int y1);
+
+    // Escribe lo que quede en el archivo, deshace la proyección y lo cierra. Lanza
+    // std::runtime_error si la escritura falla.
+    void finish();
+
+    // Bytes del archivo ya enviados a disco y liberados
+    [[nodiscard]] std::size_t released_bytes() const;
+
+  private:
+    void unmap() noexcept;
+    void discard() noexcept;
+
+    std::string m_filename;
+    int m_fd{-1};
+    std::uint8_t * m_map{};       // Archivo completo proyectado
+    std::size_t m_map_size{};     // Bytes del archivo
+    std::uint8_t * m_pixels{};    // Primer píxel (tras la cabecera)
+
+    mutable std::mutex m_mutex;
+    std::vector<std::uint32_t> m_page_left;  // Bytes sin terminar de cada página del archivo
+    std::vector<std::size_t> m_ready_pages;  // Páginas completas aún sin liberar
+    std::size_t m_pages_left{};              // Páginas con algún byte sin terminar
+    std::size_t m_released_bytes{};          // Bytes ya liberados
+  };
+
+}  // namespace render
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "async_file_writer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+
+namespace render {
+
+  // Formato del archivo de salida: PPM P3 (texto, "r g b" por línea), PPM P6 (binario,
+  // 3 bytes por píxel), QOI o PNG (ver image_codecs.hpp)
+  enum class ImageFormat { p3, p6, qoi, png };
+
+  // Formato de salida según Config::image_format: "p3", "p6", "qoi", "png" o "auto" (P6 si el
+  // archivo termina en ".pnm", QOI en ".qoi", PNG en ".png" y P3 en otro caso, que es el
+  // formato de las imágenes de referencia)
+  ImageFormat image_format_for(std::string const & filename, std::string const & setting);
+
+  // Escribe la cabecera PPM ("P3" o "P6", ancho, alto y valor máximo 255); format debe ser
+  // p3 o p6
+  void write_ppm_header(std::ostream & out, int width, int height, ImageFormat format);
+
+  // Máximo de bytes que encode_ppm_text escribe por píxel ("255 255 255\n"). La salida
+  // necesita además 4 bytes de holgura: cada número se copia como un bloque de 4 bytes.
+  inline constexpr std::size_t ppm_text_max_pixel_bytes = 12;
+
+  // Escribe n píxeles entrelazados (r, g, b) como texto P3, una línea por píxel.
+  // Devuelve el número de bytes escritos.
+  std::size_t encode_ppm_text(std::uint8_t const * rgb, std::size_t n, char * out) noexcept;
+
+  // Entrelaza n píxeles de tres planos en r, g, b, r, g, b... Usa AVX2 si la CPU lo admite.
+  void interleave_rgb(std::uint8_t const * r, std::uint8_t const * g, std::uint8_t const * b,
+                      std::uint8_t * out, std::size_t n) noexcept;
+
+  // Versión escalar, con el mismo resultado (CPUs sin AVX2 y referencia en los tests)
+  void interleave_rgb_scalar(std::uint8_t const * r, std::uint8_t const * g,
+                             std::uint8_t const * b, std::uint8_t * out, std::size_t n) noexcept;
+
+  // Guarda una imagen con los píxeles entrelazados (ImageAOS) en cualquiera de los
+  // formatos. rgb tiene 3 * width * height bytes en orden de filas. Con backend write o
+  // io_uring el archivo se escribe con AsyncFileWriter en lugar de std::ofstream.
+  void write_image(std::string const & filename, int width, int height,
+                   std::span<std::uint8_t const> rgb, ImageFormat format,
+                   OutputBackend backend = OutputBackend::ofstream);
+
+  // Guarda una imagen con un plano por canal (ImageSOA)
+  void write_image_planar(std::string const & filename, int width, int height,
+                          std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                          std::span<std::uint8_t const> b, ImageFormat format,
+                          OutputBackend backend = OutputBackend::ofstream);
+
+  // Guarda una imagen float (HDR) como PFM en color: cabecera "PF", escala negativa
+  // (little-endian) y filas de abajo arriba. rgb tiene 3 * width * height floats lineales.
+  void write_pfm(std::string const & filename, int width, int height,
+                 std::span<float const> rgb);
+
+  // Igual, con un plano float por canal (ImageHdrSOA)
+  void write_pfm_planar(std::string const & filename, int width, int height,
+                        std::span<float const> r, std::span<float const> g,
+                        std::span<float const> b);
+
+}  // namespace render
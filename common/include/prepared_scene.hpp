@@ -0,0 +1,51 @@
+#pragma once
+
+#include "huge_page_allocator.hpp"
+#include "vector.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+  struct Sphere;
+  struct Cylinder;
+  struct Scene;
+
+  // Esfera lista para intersectar: validada y con r² ya calculado
+  struct PreparedSphere {
+    vector center;
+    float radius_sq{};
+    uint32_t material_id{};
+  };
+
+  // Cilindro listo para intersectar: eje unitario, media altura, radio² y centros de las
+  // tapas calculados una sola vez con las mismas operaciones que hacía hit_cylinder
+  struct PreparedCylinder {
+    vector center;
+    vector axis;
+    float half_height{};
+    float radius_sq{};
+    vector top;     // Centro de la tapa superior
+    vector bottom;  // Centro de la tapa inferior
+    uint32_t material_id{};
+  };
+
+  // Objetos de la escena ya validados, en el mismo orden que Scene::spheres y
+  // Scene::cylinders (los índices de la BVH y de SceneSOA valen para ambos)
+  struct PreparedScene {
+    huge_vector<PreparedSphere> spheres;
+    huge_vector<PreparedCylinder> cylinders;
+  };
+
+  // Validan un objeto (radio > 0, material no vacío, eje no nulo) y calculan sus datos
+  // derivados. Lanzan std::runtime_error con el mismo mensaje que antes se daba al
+  // intersectarlo.
+  PreparedSphere prepare_sphere(Sphere const & sphere);
+  PreparedCylinder prepare_cylinder(Cylinder const & cylinder);
+
+  // Rellena scene.prepared a partir de los objetos y sus material_id. read_scene ya la
+  // llama; las escenas construidas o modificadas a mano deben llamarla antes de trazar
+  // rayos. Los errores indican qué objeto es el inválido.
+  void prepare_scene(Scene & scene);
+
+}  // namespace render
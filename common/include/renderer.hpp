@@ -1,22 +1,32 @@
 #pragma once
 
 // Keep all includes
+#include "batch_rng.hpp"
 #include "config.hpp"
 // #include "hittable.hpp"
 #include "ray.hpp"
 #include "rng.hpp"
+#include "sample_map.hpp"
+#include "sampler.hpp"
 #include "scene.hpp"
+#include "thread_pool.hpp"
 #include "vector.hpp"
 
 #include <algorithm>  // Needed for std::clamp in write_color template
+#include <atomic>     // Needed for the tile counter in run_tiled_loop
 #include <cmath>      // Needed for std::pow in write_color template
-// #include <fstream>    // Needed for ImageT::save_to_ppm potentially
+#include <cstdint>
+// #include <fstream>    // Needed for ImageT::save potentially
 #include <iostream>  // Needed for std::cerr, std::println
 // #include <limits>     // Needed for infinity
+#include <mutex>  // Needed for the progress output in run_tiled_loop
 // #include <numbers>    // Needed for pi
 #include <optional>  // Needed for refract
+#include <span>      // Needed for store_span
 // #include <sstream>    // Needed for parse_vector_from_string (in .cpp now)
-#include <string>  // Needed for parse_vector_from_string (in .cpp now)
+#include <string>       // Needed for parse_vector_from_string (in .cpp now)
+#include <type_traits>  // Needed for std::type_identity in with_rng_engine
+#include <vector>       // Needed for make_tiles
 
 namespace render {
 
@@ -44,18 +54,72 @@ namespace render {
     vector m_delta_y;
   };
 
+  // Contadores de los caminos trazados con un contexto
+  struct PathStats {
+    uint64_t paths{};                 // Caminos trazados (uno por muestra)
+    uint64_t segments{};              // Rayos lanzados contra la escena en total
+    uint64_t roulette_terminated{};   // Caminos cortados por la ruleta rusa
+    uint64_t threshold_terminated{};  // Caminos cortados por throughput_threshold
+
+    PathStats & operator+=(PathStats const & other) noexcept {
+      paths                += other.paths;
+      segments             += other.segments;
+      roulette_terminated  += other.roulette_terminated;
+      threshold_terminated += other.threshold_terminated;
+      return *this;
+    }
+
+    // Longitud media de los caminos, en segmentos
+    [[nodiscard]] double average_length() const noexcept {
+      return paths == 0 ? 0.0 : static_cast<double>(segments) / static_cast<double>(paths);
+    }
+  };
+
+  std::ostream & operator<<(std::ostream & out, PathStats const & stats);
+
   // Struct Definition (simple data structure)
-  struct RenderContext {
+  // El tipo de generador es un parámetro: RNG, XoshiroRNG, PcgRNG o BatchRNG para el orden
+  // original, StreamRNG para flujos por píxel y muestra, StratifiedSampler o SobolSampler
+  // para patrones por píxel.
+  template <typename R>
+  struct BasicRenderContext {
     vector bg_dark;
     vector bg_light;
     float inv_gamma{};
     int max_depth{};
-    RNG material_rng;
-    RNG ray_rng;
+    R material_rng;
+    R ray_rng;
+    std::vector<vector> path_attenuation{};  // Albedos del camino en curso (ver trace_path)
+    int roulette_depth{};                    // Ver Config::roulette_depth (0 = sin ruleta)
+    float throughput_threshold{};            // Ver Config::throughput_threshold
+    int min_samples{};                       // Ver Config::adaptive_min_samples (0 = fijo)
+    float sample_tolerance{};                // Ver Config::adaptive_tolerance
+    int pixel_samples{};                     // Muestras tomadas en el último píxel
+    bool direct_ball{};                      // Config::ball_sampling == "direct"
+    PathStats stats{};
+  };
+
+  using RenderContext       = BasicRenderContext<RNG>;
+  using StreamRenderContext = BasicRenderContext<StreamRNG>;
+
+  // Estado de un camino: rayo actual, producto de los albedos recorridos (throughput) y
+  // número de rebotes
+  struct PathState {
+    Ray ray;
+    vector throughput{1.F, 1.F, 1.F};
+    int bounces{};
   };
 
   // --- Main Color Function Declaration ---
-  vector ray_color(Ray const & r, Scene const & scene, RenderContext & ctx, int depth);
+  // (Instanciadas en renderer.cpp para los cuatro motores de RNG, StreamRNG y los dos
+  // muestreadores)
+  // Bucle iterativo de rebotes: devuelve el color del camino y deja en 'path' su estado final
+  template <typename R>
+  vector trace_path(PathState & path, Scene const & scene, BasicRenderContext<R> & ctx,
+                    int max_depth);
+
+  template <typename R>
+  vector ray_color(Ray const & r, Scene const & scene, BasicRenderContext<R> & ctx, int depth);
 
   // --- TEMPLATE DEFINITIONS (Must stay in header) ---
 
@@ -81,48 +145,302 @@ namespace render {
     image.set_b(idx, b_byte);
   }
 
-  // Recorre la imagen y va lanzando rayos
+  // Crea el contexto de render a partir de la configuración y de las semillas dadas
+  // (instanciada para RNG, XoshiroRNG, PcgRNG y BatchRNG)
+  template <typename R = RNG>
+  BasicRenderContext<R> make_render_context(Config const & cfg, uint64_t material_seed,
+                                            uint64_t ray_seed);
+
+  // Llama a 'body' con std::type_identity<R>, donde R es el generador del motor elegido en
+  // cfg.rng_engine, y devuelve su resultado
+  template <typename F>
+  auto with_rng_engine(Config const & cfg, F && body) {
+    if (cfg.rng_engine == "xoshiro") {
+      return body(std::type_identity<XoshiroRNG>{});
+    }
+    if (cfg.rng_engine == "pcg") {
+      return body(std::type_identity<PcgRNG>{});
+    }
+    if (cfg.rng_engine == "batch") {
+      return body(std::type_identity<BatchRNG>{});
+    }
+    return body(std::type_identity<RNG>{});
+  }
+
+  // Crea un contexto cuyos generadores se reinician en cada muestra (modo per_pixel o
+  // muestreador de baja discrepancia)
+  template <typename R = StreamRNG>
+  BasicRenderContext<R> make_stream_context(Config const & cfg);
+
+  // Deriva una semilla independiente para el flujo 'stream' a partir de 'seed'
+  uint64_t derive_seed(uint64_t seed, uint64_t stream) noexcept;
+
+  // Región rectangular [x0, x1) x [y0, y1) de la imagen
+  struct Tile {
+    int x0{}, y0{}, x1{}, y1{};
+  };
+
+  // Divide la imagen en teselas de tile_size x tile_size en orden de filas
+  std::vector<Tile> make_tiles(int width, int height, int tile_size);
+
+  // Promedia samples_per_pixel rayos con jitter sobre el píxel (x, y). Con muestreo
+  // adaptativo (ctx.min_samples > 0) puede parar antes; ctx.pixel_samples indica cuántos
+  template <typename R>
+  vector sample_pixel(Camera const & camera, Scene const & scene, BasicRenderContext<R> & ctx,
+                      int x, int y, int samples_per_pixel);
+
+  // Igual que sample_pixel, pero cada muestra usa sus propios flujos derivados de
+  // (semilla, x, y, muestra): el resultado no depende del orden de render.
+  // Con StratifiedSampler o SobolSampler las muestras del píxel siguen su patrón.
+  template <typename R>
+  vector sample_pixel_streams(Camera const & camera, Scene const & scene,
+                              BasicRenderContext<R> & ctx, int x, int y, Config const & cfg);
+
+  // Corrige gamma y escribe en la imagen el color de un píxel. Las imágenes HDR
+  // (ImageHdrAOS, ImageHdrSOA) guardan el color lineal y la gamma se aplica al mapearlas.
+  template <typename ImageT>
+  void store_pixel(ImageT & image, int x, int y, vector color, float inv_gamma) {
+    if constexpr (requires { image.set_linear(size_t{}, 0.0F, 0.0F, 0.0F); }) {
+      image.set_linear(static_cast<size_t>(y) * static_cast<size_t>(image.width) +
+                           static_cast<size_t>(x),
+                       color.x(), color.y(), color.z());
+    } else {
+      color = render::vector(std::pow(color.x(), inv_gamma), std::pow(color.y(), inv_gamma),
+                             std::pow(color.z(), inv_gamma));
+      write_color(image, x, y, color);
+    }
+  }
+
+  // Escribe de una vez los píxeles [x0, x0 + n) de la fila y. rgb tiene los colores lineales
+  // entrelazados (3 * n floats); en las imágenes de 8 bits se corrige la gamma sobre el
+  // propio búfer. Las imágenes con write_span (ImageAOS, ImageSOA, sus versiones HDR y
+  // StreamingImage) reciben la fila entera; las demás, píxel a píxel como store_pixel.
   template <typename ImageT>
-  void run_render_loop(ImageT & image, render::Config const & cfg, render::Scene const & scene) {
-    int const width  = image.width;
-    int const height = image.height;
-    Camera camera(cfg);
-    RenderContext ctx{.bg_dark      = parse_vector_from_string(cfg.background_dark_color),
-                      .bg_light     = parse_vector_from_string(cfg.background_light_color),
-                      .inv_gamma    = 1.0F / cfg.gamma,
-                      .max_depth    = cfg.max_depth,
-                      .material_rng = RNG(static_cast<uint64_t>(cfg.material_rng_seed)),
-                      .ray_rng      = RNG(static_cast<uint64_t>(cfg.ray_rng_seed))};
-    auto compute_pixel_color = [&](int x, int y) {
-      vector accumulated_color(0, 0, 0);
-
-      for (int s = 0; s < cfg.samples_per_pixel; ++s) {
-        float const delta_x =
-            ctx.ray_rng.random_float() - 0.5F;  // Numero random x entre el intervalo [-0,5;0,5]
-        float const delta_y =
-            ctx.ray_rng.random_float() - 0.5F;  // Numero random y entre el intervalo [-0,5;0,5]
-        float const x_jit = static_cast<float>(x) + delta_x;  // Suma Numero random x y columna
-        float const y_jit = static_cast<float>(y) + delta_y;  // Suma Numero random y y fila
-        Ray r             = camera.get_ray(x_jit, y_jit);
-
-        accumulated_color += ray_color(r, scene, ctx, cfg.max_depth);
+  void store_span(ImageT & image, int y, int x0, std::span<float> rgb, float inv_gamma) {
+    int const n = static_cast<int>(rgb.size() / 3);
+    if constexpr (not requires { image.set_linear(size_t{}, 0.0F, 0.0F, 0.0F); }) {
+      for (float & channel : rgb) {
+        channel = std::pow(channel, inv_gamma);
       }
-      return accumulated_color / static_cast<float>(cfg.samples_per_pixel);
+    }
+    if constexpr (requires { image.write_span(y, x0, rgb.data(), n); }) {
+      image.write_span(y, x0, rgb.data(), n);
+    } else {
+      for (int i = 0; i < n; ++i) {
+        vector const color(rgb[3 * static_cast<size_t>(i)], rgb[3 * static_cast<size_t>(i) + 1],
+                           rgb[3 * static_cast<size_t>(i) + 2]);
+        if constexpr (requires { image.set_linear(size_t{}, 0.0F, 0.0F, 0.0F); }) {
+          image.set_linear(static_cast<size_t>(y) * static_cast<size_t>(image.width) +
+                               static_cast<size_t>(x0 + i),
+                           color.x(), color.y(), color.z());
+        } else {
+          write_color(image, x0 + i, y, color);
+        }
+      }
+    }
+  }
+
+  // Calcula, corrige gamma y escribe en la imagen el color de un píxel
+  template <typename ImageT, typename R>
+  void render_pixel(ImageT & image, Camera const & camera, Scene const & scene,
+                    BasicRenderContext<R> & ctx, int x, int y, int samples_per_pixel) {
+    store_pixel(image, x, y, sample_pixel(camera, scene, ctx, x, y, samples_per_pixel),
+                ctx.inv_gamma);
+  }
+
+  // Anota en el mapa (si lo hay) las muestras que ha tomado el último píxel
+  template <typename R>
+  void record_samples(SampleMap * sample_map, BasicRenderContext<R> const & ctx, int x, int y) {
+    if (sample_map != nullptr) {
+      sample_map->set(x, y, static_cast<uint32_t>(ctx.pixel_samples));
+    }
+  }
+
+  // Calcula con sample(x) el color lineal de los píxeles [x0, x1) de la fila y, anota sus
+  // muestras y los entrega a la imagen de una vez con store_span. 'row' es el búfer de la
+  // fila (3 * (x1 - x0) floats), reutilizado entre filas.
+  template <typename ImageT, typename R, typename SampleFn>
+  void render_row(ImageT & image, BasicRenderContext<R> & ctx, SampleMap * sample_map, int y,
+                  int x0, int x1, std::vector<float> & row, SampleFn && sample) {
+    row.resize(3 * static_cast<size_t>(x1 - x0));
+    for (int x = x0; x < x1; ++x) {
+      vector const color = sample(x);
+      float * const out  = row.data() + 3 * static_cast<size_t>(x - x0);
+      out[0]             = color.x();
+      out[1]             = color.y();
+      out[2]             = color.z();
+      record_samples(sample_map, ctx, x, y);
+    }
+    store_span(image, y, x0, std::span<float>(row), ctx.inv_gamma);
+  }
+
+  // Las imágenes que se escriben durante el render (StreamingImage) necesitan saber qué
+  // filas se van a pintar y qué regiones están terminadas; en las demás no se hace nada
+  template <typename ImageT>
+  void begin_region(ImageT & image, Tile const & region) {
+    if constexpr (requires { image.begin_rows(region.y0, region.y1); }) {
+      image.begin_rows(region.y0, region.y1);
+    }
+  }
+
+  template <typename ImageT>
+  void finish_region(ImageT & image, Tile const & region) {
+    if constexpr (requires { image.finish_region(region.x0, region.y0, region.x1, region.y1); }) {
+      image.finish_region(region.x0, region.y0, region.x1, region.y1);
+    }
+  }
+
+  // Si una región lanza, su finish_region no llega nunca: la imagen se aborta para que los
+  // hilos que esperan en begin_rows no se queden bloqueados y la excepción llegue al llamante
+  template <typename ImageT>
+  void abort_render(ImageT & image) {
+    if constexpr (requires { image.abort(); }) {
+      image.abort();
+    }
+  }
+
+  // Bucle original: una sola pasada por filas compartiendo los dos generadores (del motor
+  // elegido en cfg.rng_engine)
+  template <typename ImageT>
+  PathStats run_sequential_loop(ImageT & image, render::Config const & cfg,
+                                render::Scene const & scene, SampleMap * sample_map = nullptr) {
+    return with_rng_engine(cfg, [&]<typename R>(std::type_identity<R>) {
+      int const width  = image.width;
+      int const height = image.height;
+      Camera const camera(cfg);
+      BasicRenderContext<R> ctx =
+          make_render_context<R>(cfg, static_cast<uint64_t>(cfg.material_rng_seed),
+                                 static_cast<uint64_t>(cfg.ray_rng_seed));
+      std::vector<float> row;
+
+      for (int y = 0; y < height; ++y) {
+        if (y % std::max(1, height / 20) == 0 or y == height - 1) {
+          std::cerr << "\rScanlines remaining: " << (height - 1 - y) << "    ";
+        }
+        Tile const region{.x0 = 0, .y0 = y, .x1 = width, .y1 = y + 1};
+        begin_region(image, region);
+        try {
+          render_row(image, ctx, sample_map, y, 0, width, row, [&](int x) {
+            return sample_pixel(camera, scene, ctx, x, y, cfg.samples_per_pixel);
+          });
+        } catch (...) {
+          abort_render(image);
+          throw;
+        }
+        finish_region(image, region);
+      }
+      return ctx.stats;
+    });
+  }
+
+  // Renderiza una tesela con generadores de tipo R sembrados a partir de su índice
+  template <typename R, typename ImageT>
+  PathStats render_tile_seeded(ImageT & image, Camera const & camera, render::Config const & cfg,
+                               render::Scene const & scene, Tile const & tile,
+                               std::size_t tile_index, SampleMap * sample_map = nullptr) {
+    auto const material_seed  = static_cast<uint64_t>(cfg.material_rng_seed);
+    auto const ray_seed       = static_cast<uint64_t>(cfg.ray_rng_seed);
+    BasicRenderContext<R> ctx = make_render_context<R>(
+        cfg, derive_seed(material_seed, tile_index), derive_seed(ray_seed, tile_index));
+    std::vector<float> row;
+    for (int y = tile.y0; y < tile.y1; ++y) {
+      render_row(image, ctx, sample_map, y, tile.x0, tile.x1, row, [&](int x) {
+        return sample_pixel(camera, scene, ctx, x, y, cfg.samples_per_pixel);
+      });
+    }
+    return ctx.stats;
+  }
+
+  // Renderiza una tesela con flujos aleatorios (o un muestreador) por píxel y muestra
+  template <typename R, typename ImageT>
+  PathStats render_tile_streams(ImageT & image, Camera const & camera, render::Config const & cfg,
+                                render::Scene const & scene, Tile const & tile,
+                                SampleMap * sample_map = nullptr) {
+    BasicRenderContext<R> ctx = make_stream_context<R>(cfg);
+    std::vector<float> row;
+    for (int y = tile.y0; y < tile.y1; ++y) {
+      render_row(image, ctx, sample_map, y, tile.x0, tile.x1, row, [&](int x) {
+        return sample_pixel_streams(camera, scene, ctx, x, y, cfg);
+      });
+    }
+    return ctx.stats;
+  }
+
+  // Bucle por teselas repartidas entre un pool de hilos. En modo "legacy" cada tesela
+  // siembra sus generadores con su índice (el resultado depende del tamaño de tesela);
+  // en modo "per_pixel", o con un muestreador "stratified" o "sobol", cada muestra tiene
+  // su propio flujo y la imagen es idéntica byte a byte sea cual sea el número de hilos,
+  // el tamaño o el orden de las teselas.
+  template <typename ImageT>
+  PathStats run_tiled_loop(ImageT & image, render::Config const & cfg,
+                           render::Scene const & scene, SampleMap * sample_map = nullptr) {
+    Camera const camera(cfg);
+    std::vector<Tile> const tiles = make_tiles(image.width, image.height, cfg.tile_size);
+    bool const per_pixel          = cfg.rng_mode == "per_pixel";
+    ThreadPool pool(cfg.threads);
+
+    // Cada tesela usa el generador que corresponde al muestreador y al modo de RNG
+    auto const render_tile = [&](std::size_t tile_index) {
+      Tile const & tile = tiles[tile_index];
+      if (cfg.sampler == "stratified") {
+        return render_tile_streams<StratifiedSampler>(image, camera, cfg, scene, tile, sample_map);
+      }
+      if (cfg.sampler == "sobol") {
+        return render_tile_streams<SobolSampler>(image, camera, cfg, scene, tile, sample_map);
+      }
+      if (per_pixel) {
+        return render_tile_streams<StreamRNG>(image, camera, cfg, scene, tile, sample_map);
+      }
+      return with_rng_engine(cfg, [&]<typename R>(std::type_identity<R>) {
+        return render_tile_seeded<R>(image, camera, cfg, scene, tile, tile_index, sample_map);
+      });
     };
 
-    for (int y = 0; y < height; ++y) {
-      if (y % (height / 20) == 0 or y == height - 1) {
-        std::cerr << "\rScanlines remaining: " << (height - 1 - y) << "    ";
+    std::atomic<std::size_t> tiles_done{0};
+    std::mutex progress_mutex;
+    std::size_t const report_step = std::max<std::size_t>(1, tiles.size() / 20);
+    // Contadores de cada tesela: cada hilo escribe solo los suyos y se suman al final
+    std::vector<PathStats> tile_stats(tiles.size());
+
+    pool.parallel_for(tiles.size(), [&](std::size_t tile_index) {
+      begin_region(image, tiles[tile_index]);
+      try {
+        tile_stats[tile_index] = render_tile(tile_index);
+      } catch (...) {
+        abort_render(image);
+        throw;
       }
-      for (int x = 0; x < width; ++x) {
-        auto final_color = compute_pixel_color(x, y);
-        final_color      = render::vector(std::pow(final_color.x(), ctx.inv_gamma),
-                                          std::pow(final_color.y(), ctx.inv_gamma),
-                                          std::pow(final_color.z(), ctx.inv_gamma));
-        write_color(image, x, y, final_color);
+      finish_region(image, tiles[tile_index]);
+
+      std::size_t const done = tiles_done.fetch_add(1) + 1;
+      if (done % report_step == 0 or done == tiles.size()) {
+        std::scoped_lock const lock(progress_mutex);
+        std::cerr << "\rTiles remaining: " << (tiles.size() - done) << "    ";
       }
+    });
+
+    PathStats stats;
+    for (PathStats const & partial : tile_stats) {
+      stats += partial;
     }
+    return stats;
+  }
+
+  // Recorre la imagen y va lanzando rayos. Con "threads: 1", "rng_mode: legacy" y
+  // "sampler: random" se conserva el recorrido secuencial original (imágenes de
+  // referencia); en cualquier otro caso se reparte el trabajo por teselas entre un pool
+  // de hilos.
+  // Devuelve los contadores de caminos (los muestran los programas principales). Si se pasa
+  // sample_map (del tamaño de la imagen), se rellena con las muestras de cada píxel.
+  template <typename ImageT>
+  PathStats run_render_loop(ImageT & image, render::Config const & cfg,
+                            render::Scene const & scene, SampleMap * sample_map = nullptr) {
+    bool const sequential =
+        cfg.threads == 1 and cfg.rng_mode == "legacy" and cfg.sampler == "random";
+    PathStats const stats = sequential ? run_sequential_loop(image, cfg, scene, sample_map)
+                                       : run_tiled_loop(image, cfg, scene, sample_map);
     std::cerr << "\nRender complete.\n";
+    return stats;
   }
 
 }  // namespace render
@@ -1,18 +1,176 @@
 #pragma once
 
 #include "vector.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <random>
 
 namespace render {
 
-  // Un generador simple basado en el estándar de C++
-  class RNG {
+  // Finalizador de SplitMix64: mezcla los 64 bits de entrada (biyección)
+  constexpr uint64_t splitmix64(uint64_t z) noexcept {
+    z = (z ^ (z >> 30U)) * 0xBF58'476D'1CE4'E5B9ULL;
+    z = (z ^ (z >> 27U)) * 0x94D0'49BB'1331'11EBULL;
+    return z ^ (z >> 31U);
+  }
+
+  // Clave de un flujo aleatorio independiente para la muestra 'sample' del píxel (x, y)
+  constexpr uint64_t pixel_stream_key(uint64_t seed, uint32_t x, uint32_t y,
+                                      uint32_t sample) noexcept {
+    uint64_t key = splitmix64(seed + 0x9E37'79B9'7F4A'7C15ULL);
+    key          = splitmix64(key ^ ((static_cast<uint64_t>(x) << 32U) | y));
+    return splitmix64(key ^ sample);
+  }
+
+  // 23 bits altos -> [0, 1) sin multiplicar ni convertir a float: se ponen como mantisa de
+  // un float en [1, 2) y se resta 1
+  constexpr float bits_to_unit_float(uint32_t bits) noexcept {
+    return std::bit_cast<float>(0x3F80'0000U | (bits >> 9U)) - 1.0F;
+  }
+
+  // Raíz cúbica de x en [0, 1] sin llamar a std::cbrt: estimación de x^(-1/3) con un truco
+  // de bits, tres iteraciones de Newton sin divisiones y cbrt(x) = x * y². Error relativo
+  // por debajo de 1e-6; cbrt(0) = 0 exactamente.
+  inline float fast_cbrt(float x) noexcept {
+    float y = std::bit_cast<float>(0x54A2'FA8CU - std::bit_cast<uint32_t>(x) / 3U);
+    for (int i = 0; i < 3; ++i) {
+      y = y * (4.0F / 3.0F - (x / 3.0F) * y * y * y);
+    }
+    return x * y * y;
+  }
+
+  // Punto uniforme en la bola unidad a partir de tres valores uniformes en [0, 1), sin
+  // rechazo: z = 1 - 2u y un ángulo uniforme dan una dirección uniforme, y r = cbrt(w)
+  // reparte el volumen. El ángulo se forma con un cuadrante (2 bits de v) y un resto en
+  // [-pi/4, pi/4), donde seno y coseno son polinomios cortos (error < 1e-6). Solo hay
+  // aritmética y selecciones: coste fijo y vectorizable.
+  inline render::vector unit_ball_point(float u, float v, float w) noexcept {
+    float const turn    = v * 4.0F;
+    auto const quadrant = static_cast<uint32_t>(turn);
+    float const a       = (turn - static_cast<float>(quadrant) - 0.5F) * 1.570'796'3F;
+    float const a2      = a * a;
+    // Coeficientes de Taylor: multiplicar por 1/n! en vez de dividir (la división no se
+    // pliega en una constante sin -ffast-math y cuesta tanto como el resto del polinomio)
+    constexpr float s3 = -1.0F / 6.0F;
+    constexpr float s5 = 1.0F / 120.0F;
+    constexpr float s7 = -1.0F / 5'040.0F;
+    constexpr float c4 = 1.0F / 24.0F;
+    constexpr float c6 = -1.0F / 720.0F;
+    constexpr float c8 = 1.0F / 40'320.0F;
+    float const sin_a  = a * (1.0F + a2 * (s3 + a2 * (s5 + a2 * s7)));
+    float const cos_a  = 1.0F + a2 * (-0.5F + a2 * (c4 + a2 * (c6 + a2 * c8)));
+
+    // Giro de (cos a, sin a) por quadrant * pi/2 con operaciones de bits: el cuadrante es
+    // aleatorio, así que con ramas la mitad de los saltos se predecirían mal
+    uint32_t const swap     = 0U - (quadrant & 1U);  // Todo unos en los cuadrantes impares
+    uint32_t const cos_bits = std::bit_cast<uint32_t>(cos_a);
+    uint32_t const sin_bits = std::bit_cast<uint32_t>(sin_a);
+    uint32_t const x_bits   = (cos_bits & ~swap) | (sin_bits & swap);
+    uint32_t const y_bits   = (sin_bits & ~swap) | (cos_bits & swap);
+    float const cos_phi     = std::bit_cast<float>(x_bits ^ (((quadrant + 1U) & 2U) << 30U));
+    float const sin_phi     = std::bit_cast<float>(y_bits ^ ((quadrant & 2U) << 30U));
+
+    float const z      = 1.0F - 2.0F * u;
+    float const ring   = std::sqrt(std::max(0.0F, 1.0F - z * z));
+    float const radius = fast_cbrt(w);
+    return {radius * ring * cos_phi, radius * ring * sin_phi, radius * z};
+  }
+
+  // Motor original: Mersenne Twister + distribución uniforme de la biblioteca estándar
+  class MersenneEngine {
+  public:
+    explicit MersenneEngine(uint64_t seed) : gen(seed) { }
+
+    float next_float() { return dist(gen); }
+
+  private:
+    std::mt19937_64 gen;  // Generador Mersenne Twister
+    std::uniform_real_distribution<float> dist{0.0F, 1.0F};
+  };
+
+  // Motor basado en contador: el valor n-ésimo es un hash de (clave, n), así que no
+  // arrastra estado entre flujos y crear uno nuevo por muestra no cuesta nada.
+  class CounterEngine {
+  public:
+    explicit CounterEngine(uint64_t key) : m_key(key) { }
+
+    float next_float() noexcept {
+      ++m_counter;
+      uint64_t const bits = splitmix64(m_key + m_counter * 0x9E37'79B9'7F4A'7C15ULL);
+      return static_cast<float>(bits >> 40U) * 0x1.0p-24F;  // 24 bits -> [0, 1)
+    }
+
+  private:
+    uint64_t m_key;
+    uint64_t m_counter{0};
+  };
+
+  // xoshiro256+ (Blackman y Vigna): 32 bytes de estado y unas pocas operaciones por número.
+  // Los bits bajos son algo más débiles, pero solo se usan los 23 altos.
+  class XoshiroEngine {
+  public:
+    explicit XoshiroEngine(uint64_t seed) noexcept {
+      // Estado inicial a partir de la semilla con SplitMix64 (nunca queda todo a cero)
+      for (uint64_t & word : m_state) {
+        seed += 0x9E37'79B9'7F4A'7C15ULL;
+        word  = splitmix64(seed);
+      }
+    }
+
+    float next_float() noexcept {
+      uint64_t const result = m_state[0] + m_state[3];
+      uint64_t const t      = m_state[1] << 17U;
+      m_state[2]           ^= m_state[0];
+      m_state[3]           ^= m_state[1];
+      m_state[1]           ^= m_state[2];
+      m_state[0]           ^= m_state[3];
+      m_state[2]           ^= t;
+      m_state[3]            = std::rotl(m_state[3], 45);
+      return bits_to_unit_float(static_cast<uint32_t>(result >> 32U));
+    }
+
+  private:
+    std::array<uint64_t, 4> m_state{};
+  };
+
+  // PCG32 (O'Neill, variante XSH RR): 16 bytes de estado, 32 bits por llamada
+  class PcgEngine {
   public:
+    explicit PcgEngine(uint64_t seed) noexcept : m_increment((splitmix64(seed) << 1U) | 1U) {
+      (void) next_bits();
+      m_state += seed;
+      (void) next_bits();
+    }
+
+    float next_float() noexcept { return bits_to_unit_float(next_bits()); }
+
+  private:
+    uint32_t next_bits() noexcept {
+      uint64_t const old = m_state;
+      m_state            = old * 6'364'136'223'846'793'005ULL + m_increment;
+      auto const xorshifted = static_cast<uint32_t>(((old >> 18U) ^ old) >> 27U);
+      auto const rotation   = static_cast<int>(old >> 59U);
+      return std::rotr(xorshifted, rotation);
+    }
+
+    uint64_t m_state{0};
+    uint64_t m_increment;
+  };
+
+  // Generador aleatorio parametrizado por el motor que produce los floats en [0, 1)
+  template <typename Engine>
+  class BasicRNG {
+  public:
+    using engine_type = Engine;
+
     // Se inicializa con la semilla del config.txt
-    RNG(uint64_t seed) : gen(seed) { }
+    BasicRNG(uint64_t seed) : m_engine(seed) { }
 
     // Devuelve un float aleatorio en [0, 1)
-    float random_float() { return dist(gen); }
+    float random_float() { return m_engine.next_float(); }
 
     // Devuelve un vector aleatorio en [0, 1)
     render::vector random_vector() {
@@ -37,9 +195,30 @@ namespace render {
       }
     }
 
+    // Igual que random_in_unit_sphere, pero sin rechazo: siempre consume tres números
+    // (ver unit_ball_point). Da otra secuencia de puntos, así que cambia las imágenes
+    render::vector random_in_unit_ball() {
+      float const u = random_float();
+      float const v = random_float();
+      float const w = random_float();
+      return unit_ball_point(u, v, w);
+    }
+
+    // Acceso al motor (por ejemplo, para pedir a BatchEngine un carril completo)
+    Engine & engine() noexcept { return m_engine; }
+
   private:
-    std::mt19937_64 gen;  // Generador Mersenne Twister
-    std::uniform_real_distribution<float> dist{0.0F, 1.0F};
+    Engine m_engine;
   };
 
+  // Un generador simple basado en el estándar de C++ (reproduce las imágenes de referencia)
+  using RNG = BasicRNG<MersenneEngine>;
+
+  // Generadores rápidos para el modo "legacy" (ver Config::rng_engine)
+  using XoshiroRNG = BasicRNG<XoshiroEngine>;
+  using PcgRNG     = BasicRNG<PcgEngine>;
+
+  // Generador por píxel y muestra, independiente del orden de render
+  using StreamRNG = BasicRNG<CounterEngine>;
+
 }  // namespace render
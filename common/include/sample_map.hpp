@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // Número de muestras que ha tomado cada píxel (muestreo adaptativo). Cada píxel lo
+  // escribe una sola tesela, así que puede rellenarse desde varios hilos sin bloqueos.
+  class SampleMap {
+  public:
+    int width{};
+    int height{};
+    std::vector<uint32_t> counts;
+
+    SampleMap(int w, int h);
+
+    void set(int x, int y, uint32_t samples) noexcept {
+      counts[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+             static_cast<std::size_t>(x)] = samples;
+    }
+
+    [[nodiscard]] uint32_t at(int x, int y) const noexcept {
+      return counts[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) +
+                    static_cast<std::size_t>(x)];
+    }
+
+    // Suma de las muestras de todos los píxeles
+    [[nodiscard]] uint64_t total() const noexcept;
+
+    // Guarda el mapa como PGM (P2, texto) con el número de muestras en cada píxel
+    void save_to_pgm(std::string const & filename) const;
+  };
+
+}  // namespace render
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "vector.hpp"
+#include <cstdint>
+
+namespace render {
+
+  // Muestras de baja discrepancia para el jitter de los píxeles y los rebotes. En lugar
+  // de números independientes, las 'count' muestras de un píxel reparten cada par de
+  // dimensiones por todo el cuadrado unidad, lo que reduce el ruido a igualdad de spp.
+
+  // Patrón estratificado (multi-jittered correlacionado, Kensler 2013): rejilla de m x n
+  // celdas con un punto por celda y por fila/columna de la subrejilla
+  struct StratifiedPattern {
+    static void point_2d(uint32_t sample, uint32_t count, uint32_t seed, float & u,
+                         float & v) noexcept;
+    static float point_1d(uint32_t sample, uint32_t count, uint32_t seed) noexcept;
+  };
+
+  // Sobol con aleatorización de Owen (Burley 2020). Cada grupo de dimensiones usa las dos
+  // primeras dimensiones de Sobol con su propia semilla, así que no hay límite de rebotes.
+  // No necesita conocer 'count' de antemano: cualquier prefijo de 2^k muestras es una red.
+  struct SobolPattern {
+    static void point_2d(uint32_t sample, uint32_t count, uint32_t seed, float & u,
+                         float & v) noexcept;
+    static float point_1d(uint32_t sample, uint32_t count, uint32_t seed) noexcept;
+  };
+
+  // Muestreador con la misma interfaz que BasicRNG (random_float, random_in_unit_sphere).
+  // Se crea uno por muestra con la clave del píxel, el índice de la muestra y el total de
+  // muestras del píxel. Cada llamada consume un "grupo" de dimensiones con semilla propia:
+  // dos random_float seguidos forman un par 2D (por ejemplo, el jitter del píxel).
+  template <typename Pattern>
+  class BasicSampler {
+  public:
+    explicit BasicSampler(uint64_t pixel_key, uint32_t sample = 0, uint32_t count = 1)
+        : m_key(pixel_key), m_sample(sample), m_count(count == 0 ? 1 : count) { }
+
+    // Devuelve el siguiente valor en [0, 1)
+    float random_float() noexcept {
+      if (m_has_pending) {
+        m_has_pending = false;
+        return m_pending;
+      }
+      float u{};
+      Pattern::point_2d(m_sample, m_count, next_seed(), u, m_pending);
+      m_has_pending = true;
+      return u;
+    }
+
+    // Punto uniforme en la esfera unitaria: dirección a partir de un par 2D y radio a
+    // partir de un valor 1D, sin rechazo (ver unit_ball_point)
+    render::vector random_in_unit_sphere() noexcept;
+
+  private:
+    uint32_t next_seed() noexcept;
+
+    uint64_t m_key;
+    uint32_t m_sample;
+    uint32_t m_count;
+    uint32_t m_group{0};
+    float m_pending{};
+    bool m_has_pending{false};
+  };
+
+  using StratifiedSampler = BasicSampler<StratifiedPattern>;
+  using SobolSampler      = BasicSampler<SobolPattern>;
+
+  // Instanciados en sampler.cpp
+  extern template class BasicSampler<StratifiedPattern>;
+  extern template class BasicSampler<SobolPattern>;
+
+}  // namespace render
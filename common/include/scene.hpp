@@ -1,5 +1,11 @@
 #pragma once
+#include "bvh.hpp"
+#include "bvh_wide.hpp"
+#include "prepared_scene.hpp"
+#include "scene_soa.hpp"
+#include "vector.hpp"
 #include <cmath>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -11,12 +17,26 @@ namespace render {
     std::string name;
     std::string type;           // matte | metal | refractive
     std::vector<float> params;  // reflectancia o índice de refracción
+    uint32_t id{};              // Posición en Scene::material_table (orden de definición)
+  };
+
+  enum class MaterialKind : uint8_t { matte, metal, refractive };
+
+  // Material ya interpretado: lo que ray_color necesita en cada rebote, sin cadenas
+  struct CompiledMaterial {
+    MaterialKind kind{MaterialKind::matte};
+    vector albedo{1.0F, 1.0F, 1.0F};  // Reflectancia (1, 1, 1 en los refractivos)
+    float roughness{};                // Solo metal
+    float ior{1.0F};                  // Solo refractive
   };
 
   // === Tipos de objetos ===
+  // 'material' es el nombre leído de la escena; 'material_id', su índice en
+  // Scene::material_table (lo asigna compile_materials)
   struct Sphere {
     float cx{}, cy{}, cz{}, r{};
     std::string material;
+    uint32_t material_id{};
   };
 
   struct Cylinder {
@@ -24,17 +44,35 @@ namespace render {
     float ax{}, ay{}, az{};
 
     std::string material;
+    uint32_t material_id{};
   };
 
   // === Escena completa ===
   struct Scene {
     std::unordered_map<std::string, Material> materials;
+    std::vector<CompiledMaterial> material_table;  // Indexado por Material::id
     std::vector<Sphere> spheres;
     std::vector<Cylinder> cylinders;
+    PreparedScene prepared;  // Objetos validados y precalculados, ver prepare_scene
+
+    // Estructuras de aceleración (todas vacías = recorrido lineal), ver build_accelerator.
+    // Solo se construye la elegida en "accelerator:".
+    BVH bvh;
+    BVH4 bvh4;
+    BVH8 bvh8;
+    SceneSOA soa;
   };
 
   // === Función de lectura ===
   // ¡Asegúrate de que esta línea es una DECLARACIÓN (termina en ';')!
   Scene read_scene(std::string const & filename);
 
+  // Traduce un material leído a su forma compilada
+  CompiledMaterial compile_material(Material const & material);
+
+  // Rellena material_table (renumerando los materiales por id y nombre) y asigna a cada
+  // objeto el índice de su material. read_scene ya la llama; las escenas construidas a
+  // mano deben llamarla antes de renderizar.
+  void compile_materials(Scene & scene);
+
 }  // namespace render
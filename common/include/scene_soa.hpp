@@ -0,0 +1,75 @@
+#pragma once
+
+#include "huge_page_allocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace render {
+
+  class Ray;
+  struct Scene;
+
+  // Esferas por componentes (centro y radio²)
+  struct SphereSOA {
+    huge_vector<float> cx, cy, cz, r_sq;
+    std::vector<uint32_t> material;  // Índice en Scene::material_table
+    std::size_t count{0};            // Esferas reales (sin el relleno)
+  };
+
+  // Cilindros por componentes, con los datos derivados que hit_cylinder recalcula en cada
+  // rayo ya precalculados (mismas operaciones, mismos resultados)
+  struct CylinderSOA {
+    huge_vector<float> cx, cy, cz;                    // Centro
+    huge_vector<float> ux, uy, uz;                    // Eje unitario
+    huge_vector<float> half_height, r_sq;             // Media altura y radio²
+    huge_vector<float> top_x, top_y, top_z;           // Centro de la tapa superior
+    huge_vector<float> bottom_x, bottom_y, bottom_z;  // Centro de la tapa inferior
+    std::vector<uint32_t> material;                      // Índice en Scene::material_table
+    std::size_t count{0};                                // Cilindros reales (sin el relleno)
+  };
+
+  // Objetos de la escena almacenados por componentes (SoA). Cada array está alineado a
+  // 64 bytes y relleno hasta un múltiplo de lanes, de modo que los núcleos SIMD
+  // recorren bloques completos sin tratar un resto aparte (los huecos nunca impactan).
+  struct SceneSOA {
+    static constexpr std::size_t lanes = 8;
+
+    SphereSOA spheres;
+    CylinderSOA cylinders;
+
+    [[nodiscard]] bool empty() const noexcept {
+      return spheres.count == 0 and cylinders.count == 0;
+    }
+  };
+
+  // Copia los objetos ya preparados de la escena (ver prepare_scene) en formato SoA
+  SceneSOA make_scene_soa(Scene const & scene);
+
+  // Objeto más cercano encontrado por un núcleo
+  struct SoAHit {
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    float lambda{std::numeric_limits<float>::infinity()};
+    uint32_t index{none};  // Índice en Scene::spheres o Scene::cylinders (none = sin impacto)
+    bool invalid{false};   // Algún discriminante dio NaN o INF (la versión escalar lanzaría)
+  };
+
+  // Prueban el rayo contra todas las esferas (o todos los cilindros) y devuelven el más
+  // cercano en [lambda_min, lambda_max], con los mismos cálculos y desempates que
+  // hit_scene_linear. Usan los núcleos AVX2 (8 objetos por iteración) si la CPU lo admite.
+  SoAHit closest_sphere_hit(SceneSOA const & soa, Ray const & r, float lambda_min,
+                            float lambda_max) noexcept;
+
+  SoAHit closest_cylinder_hit(SceneSOA const & soa, Ray const & r, float lambda_min,
+                              float lambda_max) noexcept;
+
+  // Versiones escalares de los núcleos (CPUs sin AVX2 y referencia en los tests)
+  SoAHit closest_sphere_hit_scalar(SceneSOA const & soa, Ray const & r, float lambda_min,
+                                   float lambda_max) noexcept;
+
+  SoAHit closest_cylinder_hit_scalar(SceneSOA const & soa, Ray const & r, float lambda_min,
+                                     float lambda_max) noexcept;
+
+}  // namespace render
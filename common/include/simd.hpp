@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+
+namespace render::simd {
+
+  // Vector de W floats (extensión de GCC/Clang): el compilador lo traduce a registros
+  // SSE (W = 4) o AVX (W = 8) sin escribir intrínsecos de una arquitectura concreta.
+  // No se pasan por valor entre funciones: con W = 8 y sin AVX cambiaría la ABI.
+  template <std::size_t W>
+  struct VectorOf {
+    using type [[gnu::vector_size(W * sizeof(float))]] = float;
+  };
+
+  template <std::size_t W>
+  using f32v = typename VectorOf<W>::type;
+
+  // Indica si la CPU admite AVX2 (los núcleos escritos con intrínsecos eligen su
+  // versión con esto; se consulta una sola vez)
+  inline bool cpu_has_avx2() noexcept {
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+    static bool const supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+}  // namespace render::simd
+
+// Compila la función marcada dos veces (AVX2 y genérica) y elige una al cargar el programa
+// según la CPU, sin cambiar las opciones de compilación del proyecto.
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+  #define RENDER_SIMD_CLONES [[gnu::target_clones("avx2", "default")]]
+#else
+  #define RENDER_SIMD_CLONES
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace render {
+
+  // Imagen que se guarda mientras se renderiza. Tiene la misma interfaz que ImageAOS e
+  // ImageSOA (width, height, set_r/g/b, write_span), así que sirve como ImageT de run_render_loop,
+  // pero solo guarda en memoria un anillo de buffer_rows filas. El bucle de render avisa
+  // con begin_rows antes de pintar unas filas (espera si aún no caben en el anillo) y con
+  // finish_region al terminar una región; un hilo escritor codifica y escribe cada fila
+  // en cuanto está completa y todas las anteriores están en el archivo.
+  // El anillo debe tener al menos las filas de una tesela, y las regiones deben empezarse
+  // en orden de filas (como hacen run_sequential_loop y el pool de run_tiled_loop).
+  class StreamingImage {
+  public:
+    int width{};
+    int height{};
+
+    // Abre el archivo, escribe la cabecera y arranca el hilo escritor. Lanza
+    // std::runtime_error si el formato no es P3 ni P6 o no puede abrir el archivo.
+    StreamingImage(std::string const & filename, int w, int h, ImageFormat format,
+                   int buffer_rows);
+
+    // Si no se ha llamado a finish (por ejemplo, por una excepción durante el render),
+    // detiene el escritor sin esperar a las filas que faltan
+    ~StreamingImage();
+
+    StreamingImage(StreamingImage const &)             = delete;
+    StreamingImage & operator=(StreamingImage const &) = delete;
+    StreamingImage(StreamingImage &&)                  = delete;
+    StreamingImage & operator=(StreamingImage &&)      = delete;
+
+    void set_r(std::size_t idx, std::uint8_t r) noexcept { m_rows[ring_offset(idx)] = r; }
+
+    void set_g(std::size_t idx, std::uint8_t g) noexcept { m_rows[ring_offset(idx) + 1] = g; }
+
+    void set_b(std::size_t idx, std::uint8_t b) noexcept { m_rows[ring_offset(idx) + 2] = b; }
+
+    // Escribe n píxeles de la fila y desde x0 (rgb entrelazado, gamma aplicada): una fila
+    // es contigua en el anillo, así que se cuantizan directamente en él
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      std::size_t const idx =
+          static_cast<std::size_t>(y) * m_row_pixels + static_cast<std::size_t>(x0);
+      quantize(rgb, m_rows.data() + ring_offset(idx), 3 * static_cast<std::size_t>(n));
+    }
+
+    // Bloquea hasta que las filas [y0, y1) caben en el anillo. Lanza std::runtime_error si
+    // el render se ha abortado mientras esperaba.
+    void begin_rows(int y0, int y1);
+
+    // Marca como terminados los píxeles [x0, x1) x [y0, y1)
+    void finish_region(int x0, int y0, int x1, int y1);
+
+    // Espera a que se escriban todas las filas y cierra el archivo
+    void finish();
+
+    // Detiene el escritor y despierta a los hilos que esperan en begin_rows, que lanzan en
+    // lugar de pintar. Lo llama el bucle de render si una región lanza una excepción (sin
+    // su finish_region, el resto de hilos esperarían a esas filas para siempre).
+    void abort();
+
+    [[nodiscard]] int buffer_rows() const noexcept { return static_cast<int>(m_buffer_rows); }
+
+  private:
+    // Posición del píxel idx en el anillo (3 bytes por píxel)
+    [[nodiscard]] std::size_t ring_offset(std::size_t idx) const noexcept {
+      std::size_t const row    = idx / m_row_pixels;
+      std::size_t const column = idx - row * m_row_pixels;
+      return ((row % m_buffer_rows) * m_row_pixels + column) * 3;
+    }
+
+    void writer_loop();
+
+    std::string m_filename;
+    ImageFormat m_format;
+    std::size_t m_row_pixels;
+    std::size_t m_buffer_rows;
+    std::vector<std::uint8_t> m_rows;  // buffer_rows filas entrelazadas (r, g, b)
+    std::vector<int> m_row_done;       // Píxeles terminados de cada fila del anillo
+    std::ofstream m_out;
+
+    std::mutex m_mutex;
+    std::condition_variable m_row_ready;    // Despierta al escritor
+    std::condition_variable m_row_written;  // Despierta a los hilos que esperan en begin_rows
+    int m_written{0};                       // Filas ya escritas en el archivo
+    bool m_stop{false};
+    std::thread m_writer;
+  };
+
+}  // namespace render
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace render {
+
+  // Devuelve el número real de hilos a usar (0 = todos los núcleos disponibles)
+  int resolve_thread_count(int requested) noexcept;
+
+  // Pool de hilos persistente. Los trabajos se expresan como un rango de índices
+  // [0, count) que los hilos (incluido el que llama) se reparten dinámicamente.
+  class ThreadPool {
+  public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const &)             = delete;
+    ThreadPool & operator=(ThreadPool const &) = delete;
+    ThreadPool(ThreadPool &&)                  = delete;
+    ThreadPool & operator=(ThreadPool &&)      = delete;
+
+    // Número total de hilos que participan (trabajadores + hilo llamante)
+    [[nodiscard]] int size() const noexcept { return static_cast<int>(m_workers.size()) + 1; }
+
+    // Ejecuta task(i) para cada i en [0, count) y bloquea hasta que terminen todos.
+    // Si alguna tarea lanza una excepción, se relanza aquí la primera capturada.
+    void parallel_for(std::size_t count, std::function<void(std::size_t)> const & task);
+
+  private:
+    void worker_loop();
+    void drain();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_cv_start;
+    std::condition_variable m_cv_done;
+    std::function<void(std::size_t)> const * m_task{nullptr};
+    std::size_t m_count{0};
+    std::atomic<std::size_t> m_next{0};
+    std::size_t m_generation{0};
+    int m_active{0};
+    bool m_stop{false};
+    std::exception_ptr m_error;
+  };
+
+}  // namespace render
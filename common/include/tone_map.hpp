@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace render {
+
+  // Conversión de radiancia lineal (float) a bytes con corrección gamma, igual que
+  // store_pixel y write_color: byte = (uint8) clamp(pow(c, inv_gamma), 0, 1) * 255.
+  // En lugar de un pow por canal, se guarda para cada byte k el menor valor lineal que da
+  // k o más (255 umbrales, calculados una vez con la misma expresión), y cada valor se
+  // convierte con una búsqueda binaria sin saltos en esa tabla. El resultado es el mismo
+  // byte que con pow, así que una imagen HDR mapeada coincide con la renderizada en 8 bits.
+  class GammaTable {
+  public:
+    explicit GammaTable(float inv_gamma);
+
+    // Byte de un valor lineal (NaN y negativos dan 0)
+    [[nodiscard]] std::uint8_t operator()(float value) const noexcept;
+
+    // Convierte n valores seguidos. Usa AVX2 si la CPU lo admite.
+    void apply(float const * in, std::uint8_t * out, std::size_t n) const noexcept;
+
+    // Versión escalar, con el mismo resultado (CPUs sin AVX2 y referencia en los tests)
+    void apply_scalar(float const * in, std::uint8_t * out, std::size_t n) const noexcept;
+
+    // Menor valor lineal que da el byte k (thresholds[0] es -infinito)
+    [[nodiscard]] std::array<float, 256> const & thresholds() const noexcept {
+      return m_thresholds;
+    }
+
+  private:
+    alignas(32) std::array<float, 256> m_thresholds{};
+  };
+
+  // Byte de un color ya corregido, como write_color: (uint8) clamp(value, 0, 1) * 255 (NaN
+  // da 0)
+  std::uint8_t quantize_byte(float value) noexcept;
+
+  // Cuantiza n valores seguidos con quantize_byte. Usa AVX2 si la CPU lo admite.
+  void quantize(float const * in, std::uint8_t * out, std::size_t n) noexcept;
+
+  // Cuantiza n píxeles entrelazados (r, g, b: 3 * n floats) y los separa en tres planos.
+  // Usa AVX2 si la CPU lo admite.
+  void quantize_planar(float const * rgb, std::uint8_t * r, std::uint8_t * g, std::uint8_t * b,
+                       std::size_t n) noexcept;
+
+  // Byte de un valor lineal calculado con pow, como store_pixel (referencia de GammaTable
+  // para valores no negativos, que es lo que da el render)
+  std::uint8_t gamma_byte(float value, float inv_gamma) noexcept;
+
+  // Reparte las filas [0, height) en bloques entre 'threads' hilos (0 = todos los núcleos)
+  // y llama a body(y0, y1) con cada bloque
+  void parallel_rows(int height, int threads, std::function<void(int, int)> const & body);
+
+}  // namespace render
@@ -0,0 +1,436 @@
+/**
+ * @file async_file_writer.cpp
+ * @brief Escritura del archivo de salida con io_uring, o con write(2) si no está disponible.
+ *
+ * Con std::ofstream cada escritura bloquea al hilo que guarda la imagen hasta que el núcleo
+ * copia los datos. Con io_uring los bloques codificados se dejan en la cola de envío y el
+ * hilo sigue codificando el siguiente; el núcleo los escribe por su cuenta. Los búferes se
+ * registran una vez (IORING_OP_WRITE_FIXED), así que el núcleo no tiene que fijar sus
+ * páginas en cada escritura. Se usan las llamadas al sistema directamente, sin liburing.
+ */
+
+#include "../include/async_file_writer.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) and __has_include(<linux/io_uring.h>)
+  #include <linux/io_uring.h>
+  #include <sys/syscall.h>
+  #define RENDER_HAS_IO_URING 1
+#else
+  #define RENDER_HAS_IO_URING 0
+#endif
+
+namespace render {
+
+  namespace {
+
+#if RENDER_HAS_IO_URING
+
+    int io_uring_setup(unsigned entries, io_uring_params * params) noexcept {
+      return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags) noexcept {
+      return static_cast<int>(
+          syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    int io_uring_register(int ring_fd, unsigned opcode, void const * arg,
+                          unsigned nr_args) noexcept {
+      return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+    }
+
+    // Puntero a un campo del anillo a partir de su desplazamiento en io_uring_params
+    template <typename T>
+    T * ring_field(void * ring, std::uint32_t offset) noexcept {
+      return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+    }
+
+#endif
+
+    std::runtime_error write_error(std::string const & filename, int error) {
+      return std::runtime_error("Error: cannot write output file: " + filename + " (" +
+                                std::strerror(error) + ")");
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Elige el backend de salida.
+   *
+   * @param setting Valor de Config::output_backend.
+   * @return write(2) con "write", io_uring con "io_uring" y std::ofstream en otro caso.
+   */
+
+  OutputBackend output_backend_for(std::string const & setting) {
+    if (setting == "write") {
+      return OutputBackend::write;
+    }
+    if (setting == "io_uring") {
+      return OutputBackend::io_uring;
+    }
+    return OutputBackend::ofstream;
+  }
+
+  /**
+   * @brief Abre el archivo y, si se pide io_uring, prepara el anillo.
+   *
+   * OutputBackend::ofstream se trata como write(2): quien quiera std::ofstream no usa
+   * esta clase.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param backend write(2) o io_uring.
+   * @throws std::runtime_error Si no se puede abrir el archivo.
+   */
+
+  AsyncFileWriter::AsyncFileWriter(std::string const & filename, OutputBackend backend)
+      : m_filename{filename}, m_storage(buffer_size * buffer_count),
+        m_pending(buffer_count) {
+    m_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+      throw std::runtime_error("Error: cannot open output file: " + filename);
+    }
+    if (backend == OutputBackend::io_uring and not setup_ring(buffer_count)) {
+      close_ring();
+    }
+  }
+
+  /**
+   * @brief Espera a las escrituras pendientes y libera el anillo y el archivo.
+   */
+
+  AsyncFileWriter::~AsyncFileWriter() {
+    drain_completions();
+    close_ring();
+    if (m_fd >= 0) {
+      ::close(m_fd);
+    }
+  }
+
+  /**
+   * @brief Devuelve un búfer libre.
+   *
+   * Con io_uring los búferes se usan por turnos; si al que le toca aún se está
+   * escribiendo, se recogen finalizaciones hasta que quede libre.
+   *
+   * @return Búfer de buffer_size bytes.
+   * @throws std::runtime_error Si falló una escritura anterior.
+   */
+
+  std::span<char> AsyncFileWriter::next_buffer() {
+    if (uses_io_uring()) {
+      m_current = (m_current + 1) % buffer_count;
+      while (m_pending[m_current].busy and m_error == 0) {
+        wait_completion();
+      }
+    }
+    if (m_error != 0) {
+      throw write_error(m_filename, m_error);
+    }
+    return {m_storage.data() + m_current * buffer_size, buffer_size};
+  }
+
+  /**
+   * @brief Escribe el búfer actual a continuación de lo ya enviado.
+   *
+   * @param size Bytes a escribir (como mucho buffer_size).
+   * @throws std::runtime_error Si la escritura falla (con io_uring, al detectarlo).
+   */
+
+  void AsyncFileWriter::submit(std::size_t size) {
+    size = std::min(size, buffer_size);
+    if (size == 0) {
+      return;
+    }
+    if (not uses_io_uring()) {
+      write_all(m_storage.data() + m_current * buffer_size, size);
+      m_offset += size;
+      return;
+    }
+
+    Pending & pending = m_pending[m_current];
+    pending           = {.offset = m_offset, .done = 0, .size = static_cast<std::uint32_t>(size),
+                         .busy = true};
+    m_offset += size;
+    queue_write(m_current);
+    if (m_error != 0) {
+      throw write_error(m_filename, m_error);
+    }
+  }
+
+  /**
+   * @brief Espera a todas las escrituras y cierra el archivo.
+   *
+   * @throws std::runtime_error Si alguna escritura o el cierre fallan.
+   */
+
+  void AsyncFileWriter::finish() {
+    drain_completions();
+    close_ring();
+    int const fd = m_fd;
+    m_fd         = -1;
+    if (fd >= 0 and ::close(fd) != 0 and m_error == 0) {
+      m_error = errno;
+    }
+    if (m_error != 0) {
+      throw write_error(m_filename, m_error);
+    }
+  }
+
+  /**
+   * @brief Escribe size bytes con write(2), repitiendo si la escritura es parcial.
+   *
+   * @throws std::runtime_error Si write falla.
+   */
+
+  void AsyncFileWriter::write_all(char const * data, std::size_t size) {
+    while (size > 0) {
+      ssize_t const written = ::write(m_fd, data, size);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        m_error = errno;
+        throw write_error(m_filename, m_error);
+      }
+      data += written;
+      size -= static_cast<std::size_t>(written);
+    }
+  }
+
+#if RENDER_HAS_IO_URING
+
+  /**
+   * @brief Crea el anillo, proyecta sus colas y registra los búferes.
+   *
+   * Si el registro de búferes falla (por ejemplo, por el límite de memoria bloqueada) se
+   * sigue con escrituras normales (IORING_OP_WRITE) en lugar de fijas.
+   *
+   * @param entries Entradas de la cola de envío (una por búfer).
+   * @return false si io_uring no está disponible.
+   */
+
+  bool AsyncFileWriter::setup_ring(unsigned entries) {
+    io_uring_params params{};
+    m_ring_fd = io_uring_setup(entries, &params);
+    if (m_ring_fd < 0) {
+      return false;
+    }
+
+    m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+    }
+
+    m_sq_ring = ::mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQ_RING);
+    if (m_sq_ring == MAP_FAILED) {
+      m_sq_ring = nullptr;
+      return false;
+    }
+    if (single_mmap) {
+      m_cq_ring = m_sq_ring;
+    } else {
+      m_cq_ring = ::mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_CQ_RING);
+      if (m_cq_ring == MAP_FAILED) {
+        m_cq_ring = nullptr;
+        return false;
+      }
+    }
+    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes      = ::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         m_ring_fd, IORING_OFF_SQES);
+    if (m_sqes == MAP_FAILED) {
+      m_sqes = nullptr;
+      return false;
+    }
+
+    m_sq_tail  = ring_field<unsigned>(m_sq_ring, params.sq_off.tail);
+    m_sq_mask  = ring_field<unsigned>(m_sq_ring, params.sq_off.ring_mask);
+    m_sq_array = ring_field<unsigned>(m_sq_ring, params.sq_off.array);
+    m_cq_head  = ring_field<unsigned>(m_cq_ring, params.cq_off.head);
+    m_cq_tail  = ring_field<unsigned>(m_cq_ring, params.cq_off.tail);
+    m_cq_mask  = ring_field<unsigned>(m_cq_ring, params.cq_off.ring_mask);
+    m_cqes     = ring_field<io_uring_cqe>(m_cq_ring, params.cq_off.cqes);
+
+    std::array<iovec, buffer_count> buffers{};
+    for (std::size_t i = 0; i < buffer_count; ++i) {
+      buffers[i] = {.iov_base = m_storage.data() + i * buffer_size, .iov_len = buffer_size};
+    }
+    m_fixed_buffers =
+        io_uring_register(m_ring_fd, IORING_REGISTER_BUFFERS, buffers.data(), buffer_count) == 0;
+    return true;
+  }
+
+  /**
+   * @brief Deshace las proyecciones y cierra el anillo (los búferes registrados se
+   * liberan con él).
+   */
+
+  void AsyncFileWriter::close_ring() noexcept {
+    if (m_sqes != nullptr) {
+      ::munmap(m_sqes, m_sqes_size);
+    }
+    if (m_cq_ring != nullptr and m_cq_ring != m_sq_ring) {
+      ::munmap(m_cq_ring, m_cq_ring_size);
+    }
+    if (m_sq_ring != nullptr) {
+      ::munmap(m_sq_ring, m_sq_ring_size);
+    }
+    m_sqes    = nullptr;
+    m_cq_ring = nullptr;
+    m_sq_ring = nullptr;
+    if (m_ring_fd >= 0) {
+      ::close(m_ring_fd);
+    }
+    m_ring_fd   = -1;
+    m_in_flight = 0;
+  }
+
+  /**
+   * @brief Pone en la cola de envío la parte sin escribir de un búfer y avisa al núcleo.
+   *
+   * Cada búfer tiene como mucho una escritura en curso y hay una entrada por búfer, así
+   * que la cola nunca está llena. IOSQE_ASYNC manda la escritura a un hilo del núcleo: sin
+   * él, una escritura a la caché de páginas se copia dentro de io_uring_enter y el que
+   * llama espera igual que con write(2). Si el aviso falla, el error queda en m_error.
+   *
+   * @param buffer Índice del búfer.
+   */
+
+  void AsyncFileWriter::queue_write(std::size_t buffer) {
+    Pending const & pending = m_pending[buffer];
+    unsigned const tail     = std::atomic_ref(*m_sq_tail).load(std::memory_order_relaxed);
+    unsigned const index    = tail & *m_sq_mask;
+
+    io_uring_sqe & sqe = static_cast<io_uring_sqe *>(m_sqes)[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode    = m_fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe.fd        = m_fd;
+    sqe.addr      = reinterpret_cast<std::uint64_t>(m_storage.data() + buffer * buffer_size +
+                                                    pending.done);
+    sqe.len       = pending.size - pending.done;
+    sqe.off       = pending.offset + pending.done;
+    sqe.buf_index = m_fixed_buffers ? static_cast<std::uint16_t>(buffer) : 0;
+    sqe.flags     = IOSQE_ASYNC;
+    sqe.user_data = buffer;
+
+    m_sq_array[index] = index;
+    std::atomic_ref(*m_sq_tail).store(tail + 1, std::memory_order_release);
+    ++m_in_flight;
+
+    while (io_uring_enter(m_ring_fd, 1, 0, 0) < 0) {
+      if (errno != EINTR) {
+        // El núcleo no ha tomado la entrada: se retira para que no cuente como en curso
+        if (m_error == 0) {
+          m_error = errno;
+        }
+        std::atomic_ref(*m_sq_tail).store(tail, std::memory_order_release);
+        --m_in_flight;
+        m_pending[buffer].busy = false;
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief Espera al menos una finalización y procesa todas las disponibles.
+   *
+   * Una escritura parcial se vuelve a enviar con el resto del búfer, salvo que ya haya
+   * fallado otra; un error se guarda y se notifica en la siguiente llamada a next_buffer
+   * o finish.
+   *
+   * @return false si no se ha podido esperar (io_uring_enter falló).
+   */
+
+  bool AsyncFileWriter::wait_completion() {
+    unsigned head = *m_cq_head;
+    if (head == std::atomic_ref(*m_cq_tail).load(std::memory_order_acquire)) {
+      if (io_uring_enter(m_ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 and errno != EINTR) {
+        if (m_error == 0) {
+          m_error = errno;
+        }
+        return false;
+      }
+    }
+
+    auto * const cqes = static_cast<io_uring_cqe *>(m_cqes);
+    while (head != std::atomic_ref(*m_cq_tail).load(std::memory_order_acquire)) {
+      io_uring_cqe const cqe = cqes[head & *m_cq_mask];
+      ++head;
+      std::atomic_ref(*m_cq_head).store(head, std::memory_order_release);
+      --m_in_flight;
+
+      Pending & pending = m_pending[cqe.user_data];
+      if (cqe.res < 0) {
+        if (m_error == 0) {
+          m_error = -cqe.res;
+        }
+        pending.busy = false;
+        continue;
+      }
+      pending.done += static_cast<std::uint32_t>(cqe.res);
+      pending.busy = pending.done < pending.size;
+      if (pending.busy and cqe.res == 0) {
+        if (m_error == 0) {
+          m_error = EIO;
+        }
+        pending.busy = false;
+      } else if (pending.busy and m_error != 0) {
+        pending.busy = false;
+      } else if (pending.busy) {
+        queue_write(cqe.user_data);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Recoge todas las escrituras en curso, hayan fallado otras o no.
+   *
+   * Los búferes se liberan con el objeto y el núcleo puede seguir leyéndolos mientras
+   * quede una escritura en curso, así que hay que esperarlas todas antes de cerrar el
+   * anillo. Solo se deja de esperar si io_uring_enter falla.
+   */
+
+  void AsyncFileWriter::drain_completions() noexcept {
+    while (m_in_flight > 0) {
+      if (not wait_completion()) {
+        break;
+      }
+    }
+  }
+
+#else
+
+  bool AsyncFileWriter::setup_ring(unsigned /*entries*/) { return false; }
+
+  void AsyncFileWriter::close_ring() noexcept { }
+
+  void AsyncFileWriter::queue_write(std::size_t /*buffer*/) { }
+
+  bool AsyncFileWriter::wait_completion() { return true; }
+
+  void AsyncFileWriter::drain_completions() noexcept { }
+
+#endif
+
+}  // namespace render
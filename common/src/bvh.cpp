@@ -0,0 +1,603 @@
+/**
+ * @file bvh.cpp
+ * @brief Construye la jerarquía de volúmenes envolventes (BVH) de la escena.
+ *
+ * Calcula cajas ajustadas para esferas y cilindros con eje arbitrario y organiza las
+ * primitivas en un árbol binario almacenado en un vector plano, de forma que hit_scene
+ * pueda descartar grupos enteros de objetos con una sola prueba rayo-caja.
+ *
+ * Las divisiones se eligen con la heurística del área de la superficie (SAH) evaluada
+ * sobre bins. Los niveles superiores se dividen primero (repartiendo el binning de los
+ * nodos grandes entre hilos) y los subárboles resultantes se construyen en paralelo.
+ */
+
+#include "../include/bvh.hpp"
+#include "../include/bvh_wide.hpp"
+#include "../include/config.hpp"
+#include "../include/scene.hpp"
+#include "../include/scene_soa.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <utility>
+
+namespace render {
+
+  namespace {
+
+    /// @brief Máximo de primitivas en una hoja.
+    constexpr std::size_t max_leaf_size = 8;
+
+    /// @brief Número de bins por eje para evaluar la SAH.
+    constexpr std::size_t sah_bins = 16;
+
+    /// @brief Coste relativo de visitar un nodo frente a probar una primitiva.
+    constexpr float traversal_cost    = 1.0F;
+    constexpr float intersection_cost = 1.0F;
+
+    /// @brief A partir de esta profundidad se divide por la mediana (acota la pila de recorrido).
+    constexpr int sah_max_depth = 32;
+
+    /// @brief Nodos con menos primitivas no reparten el binning entre hilos.
+    constexpr std::size_t parallel_binning_min = 65'536;
+
+    /// @brief Margen relativo con el que se inflan las cajas para absorber el redondeo.
+    constexpr float bounds_padding = 1e-4F;
+
+    /**
+     * @brief Primitiva durante la construcción: su caja, su centroide y su referencia.
+     */
+
+    struct BuildPrim {
+      AABB box;
+      std::array<float, 3> centroid;
+      uint32_t ref;
+    };
+
+    /**
+     * @brief Infla una caja un margen proporcional a su tamaño y a su posición.
+     *
+     * Las funciones de intersección calculan el punto de impacto en float; sin este
+     * margen un impacto rasante podría quedar unas ulp fuera de la caja y perderse.
+     */
+
+    AABB padded(AABB box) noexcept {
+      for (std::size_t i = 0; i < 3; ++i) {
+        float const magnitude = std::max({std::fabs(box.min[i]), std::fabs(box.max[i]),
+                                          box.max[i] - box.min[i], 1.0F});
+        box.min[i]            -= bounds_padding * magnitude;
+        box.max[i]            += bounds_padding * magnitude;
+      }
+      return box;
+    }
+
+    /**
+     * @brief Acumulador de un bin: caja de sus primitivas y cuántas hay.
+     */
+
+    struct Bin {
+      AABB box;
+      std::size_t count{0};
+    };
+
+    using BinGrid = std::array<std::array<Bin, sah_bins>, 3>;
+
+    /**
+     * @brief División candidata: eje, bin de corte y coste SAH estimado.
+     */
+
+    struct Split {
+      std::size_t axis{0};
+      std::size_t bin{0};  // Van a la izquierda los bins [0, bin)
+      float cost{std::numeric_limits<float>::infinity()};
+
+      [[nodiscard]] bool valid() const noexcept { return std::isfinite(cost); }
+    };
+
+    /**
+     * @brief Estado compartido por toda la construcción.
+     */
+
+    struct Builder {
+      std::vector<BuildPrim> prims;
+      ThreadPool * pool{nullptr};
+
+      /// @brief Bin al que pertenece un centroide en el eje 'axis' (misma cuenta al clasificar
+      /// y al repartir, para que ambas fases coincidan).
+      static std::size_t bin_of(BuildPrim const & p, std::size_t axis,
+                                AABB const & centroid_bounds) noexcept {
+        float const extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+        float const scaled = (p.centroid[axis] - centroid_bounds.min[axis]) *
+                             (static_cast<float>(sah_bins) / extent);
+        auto const bin     = static_cast<std::size_t>(std::max(scaled, 0.0F));
+        return std::min(bin, sah_bins - 1);
+      }
+
+      void fill_bins(std::size_t begin, std::size_t end, AABB const & centroid_bounds,
+                     BinGrid & grid) const {
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+          if (!(centroid_bounds.max[axis] > centroid_bounds.min[axis])) {
+            continue;
+          }
+          for (std::size_t i = begin; i < end; ++i) {
+            Bin & bin = grid[axis][bin_of(prims[i], axis, centroid_bounds)];
+            bin.box.expand(prims[i].box);
+            ++bin.count;
+          }
+        }
+      }
+
+      /// @brief Clasifica [begin, end) en bins; en nodos grandes reparte el trabajo por trozos.
+      BinGrid compute_bins(std::size_t begin, std::size_t end, AABB const & centroid_bounds) {
+        BinGrid grid{};
+        std::size_t const count = end - begin;
+        if (pool == nullptr or pool->size() == 1 or count < parallel_binning_min) {
+          fill_bins(begin, end, centroid_bounds, grid);
+          return grid;
+        }
+
+        std::size_t const chunks = static_cast<std::size_t>(pool->size()) * 4;
+        std::vector<BinGrid> partial(chunks);
+        pool->parallel_for(chunks, [&](std::size_t c) {
+          std::size_t const chunk_begin = begin + count * c / chunks;
+          std::size_t const chunk_end   = begin + count * (c + 1) / chunks;
+          fill_bins(chunk_begin, chunk_end, centroid_bounds, partial[c]);
+        });
+        for (auto const & part : partial) {
+          for (std::size_t axis = 0; axis < 3; ++axis) {
+            for (std::size_t b = 0; b < sah_bins; ++b) {
+              grid[axis][b].box.expand(part[axis][b].box);
+              grid[axis][b].count += part[axis][b].count;
+            }
+          }
+        }
+        return grid;
+      }
+
+      /// @brief Barre los bins de cada eje y devuelve el corte de menor coste SAH.
+      Split find_split(std::size_t begin, std::size_t end, AABB const & bounds,
+                       AABB const & centroid_bounds) {
+        BinGrid const grid      = compute_bins(begin, end, centroid_bounds);
+        float const parent_area = std::max(bounds.half_area(), 1e-20F);
+        Split best;
+
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+          if (!(centroid_bounds.max[axis] > centroid_bounds.min[axis])) {
+            continue;
+          }
+          std::array<float, sah_bins> right_area{};
+          std::array<std::size_t, sah_bins> right_count{};
+          AABB right;
+          std::size_t right_n = 0;
+          for (std::size_t b = sah_bins - 1; b > 0; --b) {
+            right.expand(grid[axis][b].box);
+            right_n        += grid[axis][b].count;
+            right_area[b]   = right.half_area();
+            right_count[b]  = right_n;
+          }
+
+          AABB left;
+          std::size_t left_n = 0;
+          for (std::size_t b = 1; b < sah_bins; ++b) {
+            left.expand(grid[axis][b - 1].box);
+            left_n += grid[axis][b - 1].count;
+            if (left_n == 0 or right_count[b] == 0) {
+              continue;
+            }
+            float const cost = traversal_cost +
+                               intersection_cost *
+                                   (left.half_area() * static_cast<float>(left_n) +
+                                    right_area[b] * static_cast<float>(right_count[b])) /
+                                   parent_area;
+            if (cost < best.cost) {
+              best = Split{.axis = axis, .bin = b, .cost = cost};
+            }
+          }
+        }
+        return best;
+      }
+
+      /// @brief Reparte [begin, end) según el corte y devuelve la posición de separación.
+      /// Si el corte no separa nada (o no es válido) divide por la mediana del eje más largo.
+      std::size_t partition(std::size_t begin, std::size_t end, Split const & split,
+                            AABB const & centroid_bounds) {
+        auto const first = prims.begin() + static_cast<std::ptrdiff_t>(begin);
+        auto const last  = prims.begin() + static_cast<std::ptrdiff_t>(end);
+        if (split.valid()) {
+          auto const middle = std::partition(first, last, [&](BuildPrim const & p) {
+            return bin_of(p, split.axis, centroid_bounds) < split.bin;
+          });
+          std::size_t const mid = begin + static_cast<std::size_t>(middle - first);
+          if (mid != begin and mid != end) {
+            return mid;
+          }
+        }
+        auto const axis       = static_cast<std::size_t>(centroid_bounds.longest_axis());
+        std::size_t const mid = begin + (end - begin) / 2;
+        std::nth_element(first, prims.begin() + static_cast<std::ptrdiff_t>(mid), last,
+                         [axis](BuildPrim const & a, BuildPrim const & b) {
+                           return a.centroid[axis] < b.centroid[axis];
+                         });
+        return mid;
+      }
+
+      void range_bounds(std::size_t begin, std::size_t end, AABB & bounds,
+                        AABB & centroid_bounds) const {
+        for (std::size_t i = begin; i < end; ++i) {
+          bounds.expand(prims[i].box);
+          centroid_bounds.expand(prims[i].centroid);
+        }
+      }
+
+      /// @brief Decide cómo dividir [begin, end): devuelve la separación o 'end' si es hoja.
+      std::size_t choose_split(std::size_t begin, std::size_t end, int depth, AABB const & bounds,
+                               AABB const & centroid_bounds) {
+        std::size_t const count = end - begin;
+        if (count == 1) {
+          return end;
+        }
+        Split split;
+        if (depth < sah_max_depth) {
+          split                 = find_split(begin, end, bounds, centroid_bounds);
+          float const leaf_cost = intersection_cost * static_cast<float>(count);
+          if (count <= max_leaf_size and (!split.valid() or split.cost >= leaf_cost)) {
+            return end;
+          }
+        } else if (count <= max_leaf_size) {
+          return end;
+        }
+        return partition(begin, end, split, centroid_bounds);
+      }
+
+      /// @brief Construye el subárbol de [begin, end) en 'nodes' (orden de profundidad).
+      uint32_t build_subtree(std::size_t begin, std::size_t end, int depth,
+                             huge_vector<BVHNode> & nodes) {
+        auto const node_index = static_cast<uint32_t>(nodes.size());
+        nodes.emplace_back();
+
+        AABB bounds;
+        AABB centroid_bounds;
+        range_bounds(begin, end, bounds, centroid_bounds);
+        nodes[node_index].bounds = bounds;
+
+        std::size_t const mid = choose_split(begin, end, depth, bounds, centroid_bounds);
+        if (mid == end) {
+          nodes[node_index].right_or_first = static_cast<uint32_t>(begin);
+          nodes[node_index].count          = static_cast<uint32_t>(end - begin);
+          return node_index;
+        }
+        build_subtree(begin, mid, depth + 1, nodes);
+        uint32_t const right             = build_subtree(mid, end, depth + 1, nodes);
+        nodes[node_index].right_or_first = right;
+        return node_index;
+      }
+    };
+
+    /**
+     * @brief Nodo de los niveles superiores: o bien se divide en dos, o bien es una tarea
+     * (un subárbol que construirá un hilo por su cuenta).
+     */
+
+    struct TopNode {
+      AABB bounds;
+      std::size_t begin{0};
+      std::size_t end{0};
+      int depth{0};
+      std::size_t left{0};
+      std::size_t right{0};
+      bool is_task{false};
+      huge_vector<BVHNode> subtree;
+    };
+
+    /**
+     * @brief Divide los niveles superiores hasta obtener rangos de tamaño 'task_size' o menos.
+     * @return Índice del nodo creado en 'top'.
+     */
+
+    std::size_t split_top(Builder & builder, std::vector<TopNode> & top, std::size_t begin,
+                          std::size_t end, int depth, std::size_t task_size) {
+      std::size_t const index = top.size();
+      top.emplace_back();
+      top[index].begin = begin;
+      top[index].end   = end;
+      top[index].depth = depth;
+
+      AABB bounds;
+      AABB centroid_bounds;
+      builder.range_bounds(begin, end, bounds, centroid_bounds);
+      top[index].bounds = bounds;
+
+      std::size_t const mid = end - begin > task_size
+                                  ? builder.choose_split(begin, end, depth, bounds, centroid_bounds)
+                                  : end;
+      if (mid == end) {
+        top[index].is_task = true;
+        return index;
+      }
+      std::size_t const left  = split_top(builder, top, begin, mid, depth + 1, task_size);
+      std::size_t const right = split_top(builder, top, mid, end, depth + 1, task_size);
+      top[index].left         = left;
+      top[index].right        = right;
+      return index;
+    }
+
+    /**
+     * @brief Copia el árbol superior y los subárboles en un único vector en orden de
+     * profundidad, corrigiendo los índices de los hijos derechos de cada subárbol.
+     * @return Índice del nodo emitido.
+     */
+
+    uint32_t emit_top(std::vector<TopNode> & top, std::size_t index, huge_vector<BVHNode> & out) {
+      TopNode & node = top[index];
+      auto const at  = static_cast<uint32_t>(out.size());
+      if (node.is_task) {
+        for (BVHNode sub : node.subtree) {
+          if (!sub.is_leaf()) {
+            sub.right_or_first += at;
+          }
+          out.push_back(sub);
+        }
+        return at;
+      }
+      out.push_back(BVHNode{.bounds = node.bounds});
+      emit_top(top, node.left, out);
+      uint32_t const right   = emit_top(top, node.right, out);
+      out[at].right_or_first = right;
+      return at;
+    }
+
+    void collect_stats(BVH const & bvh, uint32_t index, int depth, float root_area,
+                       BVHStats & stats) {
+      BVHNode const & node = bvh.nodes[index];
+      float const weight   = node.bounds.half_area() / root_area;
+      stats.max_depth      = std::max(stats.max_depth, depth);
+      if (node.is_leaf()) {
+        ++stats.leaves;
+        stats.sah_cost      += weight * intersection_cost * static_cast<float>(node.count);
+        stats.min_leaf_size  = std::min<std::size_t>(stats.min_leaf_size, node.count);
+        stats.max_leaf_size  = std::max<std::size_t>(stats.max_leaf_size, node.count);
+        return;
+      }
+      stats.sah_cost += weight * traversal_cost;
+      collect_stats(bvh, index + 1, depth + 1, root_area, stats);
+      collect_stats(bvh, node.right_or_first, depth + 1, root_area, stats);
+    }
+
+  }  // namespace
+
+  void AABB::expand(AABB const & other) noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+      min[i] = std::min(min[i], other.min[i]);
+      max[i] = std::max(max[i], other.max[i]);
+    }
+  }
+
+  void AABB::expand(std::array<float, 3> const & p) noexcept {
+    for (std::size_t i = 0; i < 3; ++i) {
+      min[i] = std::min(min[i], p[i]);
+      max[i] = std::max(max[i], p[i]);
+    }
+  }
+
+  std::array<float, 3> AABB::centroid() const noexcept {
+    return {0.5F * (min[0] + max[0]), 0.5F * (min[1] + max[1]), 0.5F * (min[2] + max[2])};
+  }
+
+  int AABB::longest_axis() const noexcept {
+    float const dx = max[0] - min[0];
+    float const dy = max[1] - min[1];
+    float const dz = max[2] - min[2];
+    if (dx >= dy and dx >= dz) {
+      return 0;
+    }
+    return dy >= dz ? 1 : 2;
+  }
+
+  float AABB::half_area() const noexcept {
+    float const dx = max[0] - min[0];
+    float const dy = max[1] - min[1];
+    float const dz = max[2] - min[2];
+    if (!(dx >= 0.0F and dy >= 0.0F and dz >= 0.0F)) {
+      return 0.0F;
+    }
+    return dx * dy + dy * dz + dz * dx;
+  }
+
+  /**
+   * @brief Caja envolvente de una esfera: el centro más/menos el radio en cada eje.
+   * @param s Esfera de la escena.
+   * @return Caja que contiene la esfera.
+   */
+
+  AABB bounds_of(Sphere const & s) noexcept {
+    AABB box;
+    box.min = {s.cx - s.r, s.cy - s.r, s.cz - s.r};
+    box.max = {s.cx + s.r, s.cy + s.r, s.cz + s.r};
+    return padded(box);
+  }
+
+  /**
+   * @brief Caja ajustada de un cilindro finito con eje arbitrario.
+   *
+   * El cilindro es la envolvente convexa de sus dos tapas, centradas en C ± A/2. Un disco
+   * de radio r con normal unitaria a se extiende r·sqrt(1 - a_i²) en el eje i, así que la
+   * caja es la unión de las cajas de ambos discos. Si el eje es nulo (cilindro inválido)
+   * se usa una caja de lado 2r para que hit_cylinder siga informando del error.
+   *
+   * @param c Cilindro de la escena (eje ax, ay, az; su módulo es la altura).
+   * @return Caja que contiene el cilindro.
+   */
+
+  AABB bounds_of(Cylinder const & c) noexcept {
+    std::array<float, 3> const center{c.cx, c.cy, c.cz};
+    std::array<float, 3> const axis{c.ax, c.ay, c.az};
+    float const height = std::sqrt(c.ax * c.ax + c.ay * c.ay + c.az * c.az);
+
+    AABB box;
+    if (not(height > 0.0F) or std::isinf(height)) {
+      box.min = {c.cx - c.r, c.cy - c.r, c.cz - c.r};
+      box.max = {c.cx + c.r, c.cy + c.r, c.cz + c.r};
+      return padded(box);
+    }
+
+    for (std::size_t i = 0; i < 3; ++i) {
+      float const unit   = axis[i] / height;
+      float const extent = c.r * std::sqrt(std::max(0.0F, 1.0F - unit * unit));
+      float const half   = 0.5F * std::fabs(axis[i]);
+      box.min[i]         = center[i] - half - extent;
+      box.max[i]         = center[i] + half + extent;
+    }
+    return padded(box);
+  }
+
+  /**
+   * @brief Construye la BVH a partir de las esferas y cilindros de la escena.
+   *
+   * Con un solo hilo el árbol se construye recursivamente. Con varios, primero se dividen
+   * los niveles superiores (el binning de los nodos grandes se reparte entre hilos) hasta
+   * tener unas cuatro tareas por hilo; cada tarea construye su subárbol por separado y al
+   * final se concatenan en orden de profundidad. El árbol resultante es el mismo en ambos
+   * casos porque las decisiones de división no dependen del número de hilos.
+   *
+   * @param scene Escena ya leída con read_scene.
+   * @param threads Hilos a usar (0 = todos los núcleos).
+   * @return Árbol con los nodos en orden de profundidad (vacío si la escena no tiene objetos).
+   */
+
+  BVH build_bvh(Scene const & scene, int threads) {
+    auto const start = std::chrono::steady_clock::now();
+
+    Builder builder;
+    builder.prims.reserve(scene.spheres.size() + scene.cylinders.size());
+    for (std::size_t i = 0; i < scene.spheres.size(); ++i) {
+      AABB const box = bounds_of(scene.spheres[i]);
+      builder.prims.push_back(
+          {.box = box, .centroid = box.centroid(), .ref = static_cast<uint32_t>(i)});
+    }
+    for (std::size_t i = 0; i < scene.cylinders.size(); ++i) {
+      AABB const box = bounds_of(scene.cylinders[i]);
+      builder.prims.push_back({.box      = box,
+                               .centroid = box.centroid(),
+                               .ref      = static_cast<uint32_t>(i) | BVH::cylinder_flag});
+    }
+
+    BVH bvh;
+    std::size_t const count = builder.prims.size();
+    if (count == 0) {
+      return bvh;
+    }
+    bvh.nodes.reserve(2 * count / max_leaf_size + 1);
+
+    int const num_threads = resolve_thread_count(threads);
+    if (num_threads == 1) {
+      builder.build_subtree(0, count, 0, bvh.nodes);
+    } else {
+      ThreadPool pool(num_threads);
+      builder.pool                = &pool;
+      std::size_t const task_size = std::max<std::size_t>(
+          max_leaf_size, count / (4 * static_cast<std::size_t>(num_threads)));
+
+      std::vector<TopNode> top;
+      split_top(builder, top, 0, count, 0, task_size);
+      std::vector<std::size_t> tasks;
+      for (std::size_t i = 0; i < top.size(); ++i) {
+        if (top[i].is_task) {
+          tasks.push_back(i);
+        }
+      }
+      builder.pool = nullptr;  // Cada tarea hace su binning en su propio hilo
+      pool.parallel_for(tasks.size(), [&](std::size_t t) {
+        TopNode & node = top[tasks[t]];
+        builder.build_subtree(node.begin, node.end, node.depth, node.subtree);
+      });
+      emit_top(top, 0, bvh.nodes);
+    }
+
+    bvh.prims.reserve(count);
+    for (auto const & p : builder.prims) {
+      bvh.prims.push_back(p.ref);
+    }
+
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    bvh.stats          = compute_bvh_stats(bvh);
+    bvh.stats.build_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    return bvh;
+  }
+
+  /**
+   * @brief Calcula las métricas de calidad de un árbol ya construido.
+   *
+   * El coste SAH es la suma, para cada nodo, de la probabilidad de que un rayo que atraviesa
+   * la raíz atraviese el nodo (cociente de áreas) por su coste: traversal_cost en los nodos
+   * interiores e intersection_cost por primitiva en las hojas.
+   *
+   * @param bvh Árbol a analizar.
+   * @return Métricas del árbol (build_ms queda a 0).
+   */
+
+  BVHStats compute_bvh_stats(BVH const & bvh) {
+    BVHStats stats;
+    if (bvh.empty()) {
+      return stats;
+    }
+    stats.nodes         = bvh.nodes.size();
+    stats.min_leaf_size = std::numeric_limits<std::size_t>::max();
+    float const root    = std::max(bvh.nodes[0].bounds.half_area(), 1e-20F);
+    collect_stats(bvh, 0, 0, root, stats);
+    stats.avg_leaf_size = static_cast<double>(bvh.prims.size()) / static_cast<double>(stats.leaves);
+    return stats;
+  }
+
+  std::ostream & operator<<(std::ostream & out, BVHStats const & stats) {
+    return out << "BVH built in " << stats.build_ms << " ms: " << stats.nodes << " nodes, "
+               << stats.leaves << " leaves (size " << stats.min_leaf_size << "-"
+               << stats.max_leaf_size << ", avg " << stats.avg_leaf_size << "), depth "
+               << stats.max_depth << ", SAH cost " << stats.sah_cost;
+  }
+
+  /**
+   * @brief Construye la estructura de aceleración elegida en la configuración.
+   *
+   * Con "accelerator: linear" no se construye nada y hit_scene recorre todos los objetos,
+   * lo que sirve para validar los resultados de la BVH. Las variantes anchas ("bvh4",
+   * "bvh8") se obtienen colapsando la BVH binaria, que después se descarta. Con "simd" se
+   * copian las esferas en formato SoA y se prueban todas con el núcleo vectorial.
+   *
+   * @param scene Escena ya leída con read_scene.
+   * @param cfg Configuración con la clave "accelerator:" y el número de hilos.
+   * @return Métricas de la BVH binaria construida (vacías si no se construye ninguna).
+   */
+
+  BVHStats build_accelerator(Scene & scene, Config const & cfg) {
+    scene.bvh  = BVH{};
+    scene.bvh4 = BVH4{};
+    scene.bvh8 = BVH8{};
+    scene.soa  = SceneSOA{};
+    if (cfg.accelerator == "linear") {
+      return {};
+    }
+    if (cfg.accelerator == "simd") {
+      scene.soa = make_scene_soa(scene);
+      return {};
+    }
+
+    BVH bvh              = build_bvh(scene, cfg.threads);
+    BVHStats const stats = bvh.stats;
+    if (bvh.empty()) {
+      return stats;
+    }
+    if (cfg.accelerator == "bvh4") {
+      scene.bvh4 = build_wide_bvh<4>(bvh);
+    } else if (cfg.accelerator == "bvh8") {
+      scene.bvh8 = build_wide_bvh<8>(bvh);
+    } else {
+      scene.bvh = std::move(bvh);
+    }
+    return stats;
+  }
+
+}  // namespace render
@@ -0,0 +1,119 @@
+/**
+ * @file bvh_wide.cpp
+ * @brief Construye las BVH anchas (4 y 8 hijos por nodo) a partir de la BVH binaria.
+ *
+ * La BVH binaria ya elige buenas divisiones con la SAH; aquí solo se reagrupan sus nodos
+ * para que cada nodo ancho reúna hasta W cajas hijas, almacenadas por componentes para
+ * que el recorrido las pruebe todas a la vez con instrucciones SIMD.
+ */
+
+#include "../include/bvh_wide.hpp"
+#include <cstddef>
+
+namespace render {
+
+  namespace {
+
+    /**
+     * @brief Copia la caja 'box' en el hueco 'slot' del nodo ancho.
+     */
+
+    template <std::size_t W>
+    void set_child_bounds(WideBVHNode<W> & node, std::size_t slot, AABB const & box) noexcept {
+      node.min_x[slot] = box.min[0];
+      node.min_y[slot] = box.min[1];
+      node.min_z[slot] = box.min[2];
+      node.max_x[slot] = box.max[0];
+      node.max_y[slot] = box.max[1];
+      node.max_z[slot] = box.max[2];
+    }
+
+    /**
+     * @brief Emite en orden de profundidad el nodo ancho equivalente al nodo binario 'index'.
+     *
+     * Parte de los dos hijos del nodo binario y, mientras queden huecos, sustituye el hijo
+     * interior de mayor área por sus dos hijos: así se aplanan primero las cajas que más
+     * rayos atraviesan.
+     *
+     * @return Índice del nodo emitido en 'out.nodes'.
+     */
+
+    template <std::size_t W>
+    uint32_t collapse(BVH const & bvh, uint32_t index, WideBVH<W> & out) {
+      std::array<uint32_t, W> slots{};
+      std::size_t used = 2;
+      slots[0]         = index + 1;
+      slots[1]         = bvh.nodes[index].right_or_first;
+
+      while (used < W) {
+        std::size_t best = W;
+        float best_area  = -1.0F;
+        for (std::size_t i = 0; i < used; ++i) {
+          BVHNode const & candidate = bvh.nodes[slots[i]];
+          if (!candidate.is_leaf() and candidate.bounds.half_area() > best_area) {
+            best      = i;
+            best_area = candidate.bounds.half_area();
+          }
+        }
+        if (best == W) {
+          break;
+        }
+        uint32_t const opened = slots[best];
+        slots[best]           = opened + 1;
+        slots[used++]         = bvh.nodes[opened].right_or_first;
+      }
+
+      auto const node_index = static_cast<uint32_t>(out.nodes.size());
+      out.nodes.emplace_back();
+      for (std::size_t i = 0; i < used; ++i) {
+        BVHNode const & child = bvh.nodes[slots[i]];
+        set_child_bounds(out.nodes[node_index], i, child.bounds);
+        if (child.is_leaf()) {
+          out.nodes[node_index].child[i] = child.right_or_first;
+          out.nodes[node_index].count[i] = child.count;
+        } else {
+          // 'collapse' puede reubicar el vector: se escribe por índice tras la llamada
+          uint32_t const emitted          = collapse(bvh, slots[i], out);
+          out.nodes[node_index].child[i] = emitted;
+        }
+      }
+      return node_index;
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Construye una BVH de W hijos por nodo colapsando la BVH binaria.
+   *
+   * Si la raíz binaria es una hoja, la raíz ancha tiene un único hijo hoja. Las primitivas
+   * se copian en el mismo orden, por lo que las hojas conservan sus rangos.
+   *
+   * @param bvh BVH binaria ya construida con build_bvh.
+   * @return BVH ancha (vacía si la binaria lo está).
+   */
+
+  template <std::size_t W>
+  WideBVH<W> build_wide_bvh(BVH const & bvh) {
+    WideBVH<W> wide;
+    if (bvh.empty()) {
+      return wide;
+    }
+    wide.prims = bvh.prims;
+    wide.nodes.reserve(bvh.nodes.size() / (W - 1) + 1);
+
+    BVHNode const & root = bvh.nodes[0];
+    if (root.is_leaf()) {
+      wide.nodes.emplace_back();
+      set_child_bounds(wide.nodes[0], 0, root.bounds);
+      wide.nodes[0].child[0] = root.right_or_first;
+      wide.nodes[0].count[0] = root.count;
+      return wide;
+    }
+    collapse(bvh, 0, wide);
+    return wide;
+  }
+
+  template WideBVH<4> build_wide_bvh<4>(BVH const & bvh);
+  template WideBVH<8> build_wide_bvh<8>(BVH const & bvh);
+
+}  // namespace render
@@ -208,6 +208,184 @@ namespace render {
         }
       }
 
+      // 10 HILOS Y TAMAÑO DE TESELA
+      else if (key == "threads:")
+      {
+        if (!(iss >> cfg.threads) or cfg.threads < 0) {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [threads:] (must be >= 0)\nLine: \"" + line + "\"");
+        }
+      } else if (key == "tile_size:") {
+        if (!(iss >> cfg.tile_size) or cfg.tile_size <= 0) {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [tile_size:] (must be > 0)\nLine: \"" + line + "\"");
+        }
+      }
+
+      // 11 MODO DE LOS GENERADORES ALEATORIOS
+      else if (key == "rng_mode:")
+      {
+        if (!(iss >> cfg.rng_mode) or (cfg.rng_mode != "legacy" and cfg.rng_mode != "per_pixel"))
+        {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [rng_mode:] (must be legacy or per_pixel)\nLine: \"" +
+              line + "\"");
+        }
+      }
+
+      // 12 ESTRUCTURA DE ACELERACIÓN
+      else if (key == "accelerator:")
+      {
+        if (!(iss >> cfg.accelerator) or
+            (cfg.accelerator != "bvh" and cfg.accelerator != "bvh4" and
+             cfg.accelerator != "bvh8" and cfg.accelerator != "simd" and
+             cfg.accelerator != "linear"))
+        {
+          throw std::runtime_error("Error: Invalid value for key: [accelerator:] (must be bvh, "
+                                   "bvh4, bvh8, simd or linear)\nLine: \"" +
+                                   line + "\"");
+        }
+      }
+
+      // 13 TERMINACIÓN DE CAMINOS
+      else if (key == "roulette_depth:")
+      {
+        if (!(iss >> cfg.roulette_depth) or cfg.roulette_depth < 0) {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [roulette_depth:] (must be >= 0)\nLine: \"" + line +
+              "\"");
+        }
+      } else if (key == "throughput_threshold:") {
+        if (!(iss >> cfg.throughput_threshold) or cfg.throughput_threshold < 0.0F or
+            cfg.throughput_threshold >= 1.0F)
+        {
+          throw std::runtime_error("Error: Invalid value for key: [throughput_threshold:] (must be "
+                                   "in [0, 1))\nLine: \"" +
+                                   line + "\"");
+        }
+      }
+
+      // 14 MUESTREO ADAPTATIVO
+      else if (key == "adaptive_min_samples:")
+      {
+        if (!(iss >> cfg.adaptive_min_samples) or cfg.adaptive_min_samples < 0) {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [adaptive_min_samples:] (must be >= 0)\nLine: \"" +
+              line + "\"");
+        }
+      } else if (key == "adaptive_tolerance:") {
+        if (!(iss >> cfg.adaptive_tolerance) or cfg.adaptive_tolerance <= 0.0F) {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [adaptive_tolerance:] (must be > 0)\nLine: \"" +
+              line + "\"");
+        }
+      } else if (key == "sample_map:") {
+        if (!(iss >> cfg.sample_map)) {
+          throw std::runtime_error("Error: Invalid value for key: [sample_map:]\nLine: \"" + line +
+                                   "\"");
+        }
+      }
+
+      // 15 MUESTREADOR
+      else if (key == "sampler:")
+      {
+        if (!(iss >> cfg.sampler) or
+            (cfg.sampler != "random" and cfg.sampler != "stratified" and cfg.sampler != "sobol"))
+        {
+          throw std::runtime_error("Error: Invalid value for key: [sampler:] (must be random, "
+                                   "stratified or sobol)\nLine: \"" +
+                                   line + "\"");
+        }
+      }
+
+      // 16 MOTOR DE LOS GENERADORES
+      else if (key == "rng_engine:")
+      {
+        if (!(iss >> cfg.rng_engine) or
+            (cfg.rng_engine != "mt19937" and cfg.rng_engine != "xoshiro" and
+             cfg.rng_engine != "pcg" and cfg.rng_engine != "batch"))
+        {
+          throw std::runtime_error("Error: Invalid value for key: [rng_engine:] (must be mt19937, "
+                                   "xoshiro, pcg or batch)\nLine: \"" +
+                                   line + "\"");
+        }
+      }
+
+      // 17 MUESTREO DE LA BOLA UNIDAD
+      else if (key == "ball_sampling:")
+      {
+        if (!(iss >> cfg.ball_sampling) or
+            (cfg.ball_sampling != "rejection" and cfg.ball_sampling != "direct"))
+        {
+          throw std::runtime_error("Error: Invalid value for key: [ball_sampling:] (must be "
+                                   "rejection or direct)\nLine: \"" +
+                                   line + "\"");
+        }
+      }
+
+      // 18 FORMATO DE SALIDA
+      else if (key == "image_format:" or key == "ppm_format:")
+      {
+        if (!(iss >> cfg.image_format) or
+            (cfg.image_format != "auto" and cfg.image_format != "p3" and
+             cfg.image_format != "p6" and cfg.image_format != "qoi" and
+             cfg.image_format != "png"))
+        {
+          throw std::runtime_error("Error: Invalid value for key: [" + key +
+                                   "] (must be auto, p3, p6, qoi or png)\nLine: \"" + line +
+                                   "\"");
+        }
+      }
+
+      // 19 ESCRITURA DURANTE EL RENDER
+      else if (key == "stream_rows:")
+      {
+        if (!(iss >> cfg.stream_rows) or cfg.stream_rows < 0) {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [stream_rows:] (must be >= 0)\nLine: \"" + line +
+              "\"");
+        }
+      }
+
+      // 20 BACKEND DE SALIDA
+      else if (key == "output_backend:")
+      {
+        if (!(iss >> cfg.output_backend) or
+            (cfg.output_backend != "ofstream" and cfg.output_backend != "write" and
+             cfg.output_backend != "io_uring"))
+        {
+          throw std::runtime_error("Error: Invalid value for key: [output_backend:] (must be "
+                                   "ofstream, write or io_uring)\nLine: \"" +
+                                   line + "\"");
+        }
+      }
+
+      // 21 FRAMEBUFFER
+      else if (key == "framebuffer:")
+      {
+        if (!(iss >> cfg.framebuffer) or
+            (cfg.framebuffer != "ldr" and cfg.framebuffer != "hdr" and cfg.framebuffer != "mapped"))
+        {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [framebuffer:] (must be ldr, hdr or mapped)\nLine: "
+              "\"" +
+              line + "\"");
+        }
+      }
+
+      // 22 HUGE PAGES
+      else if (key == "huge_pages:")
+      {
+        if (!(iss >> cfg.huge_pages) or
+            (cfg.huge_pages != "off" and cfg.huge_pages != "thp" and cfg.huge_pages != "hugetlb"))
+        {
+          throw std::runtime_error(
+              "Error: Invalid value for key: [huge_pages:] (must be off, thp or hugetlb)\nLine: "
+              "\"" +
+              line + "\"");
+        }
+      }
+
       // CÁMARA
       else if (key == "camera_position:")
       {
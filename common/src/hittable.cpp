@@ -7,17 +7,72 @@
  * y primitivas de la escena, así como las comprobaciones de errores numéricos y de materiales.
  */
 #include "../include/hittable.hpp"
+#include "../include/bvh_wide.hpp"
 #include "../include/scene.hpp"
+#include "../include/scene_soa.hpp"
+#include "../include/simd.hpp"
 #include "../include/vector.hpp"
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
 
 namespace render {
 
   /// @brief Tolerancia numérica mínima para evitar errores de precisión en comparaciones de floats.
   constexpr float epsilon = 0.00001F;
 
+  namespace {  // Namespace anonimo
+
+    /// @brief Anota el primer error numérico del rayo (los siguientes no cambian el mensaje).
+    void note_fault(HitFault & fault, HitFault detected) noexcept {
+      if (fault == HitFault::none) {
+        fault = detected;
+      }
+    }
+
+    /// @brief Comprueba si alguna componente de la normal es NaN.
+    bool has_nan(vector const & v) noexcept {
+      return std::isnan(v.x()) or std::isnan(v.y()) or std::isnan(v.z());
+    }
+
+  }  // namespace
+
   /**
-   * @brief Calcula la intersección entre un rayo y una esfera.
+   * @brief Lanza el error correspondiente a un fallo numérico anotado durante un rayo.
+   *
+   * Los mensajes son los mismos que daban hit_sphere e hit_cylinder cuando lanzaban
+   * directamente desde el bucle de intersección.
+   *
+   * @param fault Fallo anotado (distinto de HitFault::none).
+   * @throws std::runtime_error siempre.
+   */
+
+  void throw_hit_fault(HitFault fault) {
+    switch (fault) {
+      case HitFault::sphere_discriminant:
+        throw std::runtime_error("Error: Sphere discriminant produced NaN or INF");
+      case HitFault::sphere_normal:
+        throw std::runtime_error("Error: Sphere normal computed as NaN");
+      case HitFault::cylinder_discriminant:
+        throw std::runtime_error("Error: Cylinder discriminant produced NaN or INF");
+      case HitFault::cylinder_normal:
+        throw std::runtime_error("Error: Cylinder Normal computed as Nan");
+      case HitFault::cap_normal:
+        throw std::runtime_error("Error: Cap normal computed as NaN");
+      case HitFault::none:
+        break;
+    }
+    throw std::runtime_error("Error: Unknown intersection error");
+  }
+
+  /**
+   * @brief Calcula la intersección entre un rayo y una esfera preparada.
    *
    * Si el rayo impacta la superficie de la esfera dentro del rango [lambda_min, lambda_max],
    * devuelve un registro de colisión con los datos del punto y la normal. Si no hay colisión,
@@ -27,26 +82,20 @@ namespace render {
    * @param r Rayo incidente.
    * @param lambda_min Límite inferior del rango de intersección válido.
    * @param lambda_max Límite superior del rango de intersección válido.
+   * @param fault Se anota aquí un discriminante o una normal no válidos (NaN o INF).
    * @return std::optional<HitRecord> con los datos de impacto o nullopt si no hay colisión.
-   * @throws std::runtime_error si se detectan valores numéricos inválidos (NaN o INF).
    */
 
-  std::optional<HitRecord> hit_sphere(Sphere const & s, Ray const & r, float lambda_min,
-                                      float lambda_max) {
-    if (s.r <= 0.0F) {
-      throw std::runtime_error("Error: Invalid sphere radius (must be > 0)");
-    }
-    if (s.material.empty()) {
-      throw std::runtime_error("Error: Sphere material name is empty");
-    }
-    vector const center(s.cx, s.cy, s.cz);
-    vector const rc          = r.origin() - center;
+  std::optional<HitRecord> hit_sphere(PreparedSphere const & s, Ray const & r, float lambda_min,
+                                      float lambda_max, HitFault & fault) noexcept {
+    vector const rc          = r.origin() - s.center;
     float const A            = r.direction().length_squared();
     float const B            = 2.0F * dot(rc, r.direction());
-    float const C            = rc.length_squared() - s.r * s.r;
+    float const C            = rc.length_squared() - s.radius_sq;
     float const discriminant = B * B - 4.F * A * C;
     if (std::isnan(discriminant) or std::isinf(discriminant)) {
-      throw std::runtime_error("Error: Sphere discriminant produced NaN or INF");
+      note_fault(fault, HitFault::sphere_discriminant);
+      return std::nullopt;
     }
     if (discriminant < 0.F) {
       return std::nullopt;  // No hay intersección
@@ -60,12 +109,13 @@ namespace render {
       }
     }
     HitRecord rec;
-    rec.lambda        = lambda;
-    rec.point         = r.at(lambda);
-    rec.normal        = (rec.point - center).normalized();
-    rec.material_name = s.material;
-    if (std::isnan(rec.normal.x()) or std::isnan(rec.normal.y()) or std::isnan(rec.normal.z())) {
-      throw std::runtime_error("Error: Sphere normal computed as NaN");
+    rec.lambda      = lambda;
+    rec.point       = r.at(lambda);
+    rec.normal      = (rec.point - s.center).normalized();
+    rec.material_id = s.material_id;
+    if (has_nan(rec.normal)) {
+      note_fault(fault, HitFault::sphere_normal);
+      return std::nullopt;
     }
     if (dot(r.direction(), rec.normal) > 0.F) {
       rec.normal = -rec.normal;
@@ -83,62 +133,51 @@ namespace render {
      */
 
     struct CylinderHitTest {
-      Ray r;
-      vector C;
-      vector axis;
-      float height;
-      float half_height;
-      float radius_sq;
+      Ray const & r;
+      PreparedCylinder const & c;
       float lambda_min;
-      std::string material_name;
       float min_lambda;
+      HitFault & fault;
       std::optional<HitRecord> closest_hit;
 
       // CONSTRUCTOR
-      CylinderHitTest(Cylinder const & c, Ray const & ray, float l_min, float l_max)
-          : r(ray),  // Copia el rayo
-            C(c.cx, c.cy, c.cz), axis(vector(c.ax, c.ay, c.az).normalized()),
-            height(vector(c.ax, c.ay, c.az).magnitude()), half_height(height / 2.0F),
-            radius_sq(c.r * c.r), lambda_min(l_min), material_name(c.material), min_lambda(l_max),
+      CylinderHitTest(PreparedCylinder const & cylinder, Ray const & ray, float l_min,
+                      float l_max, HitFault & hit_fault) noexcept
+          : r(ray), c(cylinder), lambda_min(l_min), min_lambda(l_max), fault(hit_fault),
             closest_hit(std::nullopt)  // <-- Inicializa el 'optional'
-      {
-        // Valida que los parámetros geométricos del cilindro sean válidos antes de continuar.
-        if (std::isnan(height) or height <= 0.0F) {
-          throw std::runtime_error("Error: Cylinder height is invalid or zero");
-        }
-      }
+      { }
 
       /// @brief Comprueba intersección con la superficie lateral del cilindro.
-      void check_body_hit(float lambda) {
+      void check_body_hit(float lambda) noexcept {
         if (lambda < lambda_min or lambda > min_lambda) {
           return;
         }
         vector const Q         = r.at(lambda);
-        float const hit_height = dot(Q - C, axis);
+        float const hit_height = dot(Q - c.center, c.axis);
 
-        if (std::fabs(hit_height) > half_height) {
+        if (std::fabs(hit_height) > c.half_height) {
           return;
         }
 
-        min_lambda = lambda;
         HitRecord rec;
         rec.lambda = lambda;
         rec.point  = Q;
-        rec.normal = (Q - C - hit_height * axis);
+        rec.normal = (Q - c.center - hit_height * c.axis);
 
-        if (std::isnan(rec.normal.x()) or std::isnan(rec.normal.y()) or std::isnan(rec.normal.z()))
-        {
-          throw std::runtime_error("Error: Cylinder Normal computed as Nan");
+        if (has_nan(rec.normal)) {
+          note_fault(fault, HitFault::cylinder_normal);
+          return;
         }
         if (dot(r.direction(), rec.normal) > 0.F) {
           rec.normal = -rec.normal;
         }
-        rec.material_name = material_name;
-        closest_hit       = rec;
+        rec.material_id = c.material_id;
+        min_lambda      = lambda;
+        closest_hit     = rec;
       }
 
       /// @brief Comprueba intersección con las tapas superior e inferior del cilindro.
-      void check_cap_hit(vector const & cap_center, vector const & normal) {
+      void check_cap_hit(vector const & cap_center, vector const & normal) noexcept {
         float dr_dot_normal = dot(r.direction(), normal);
 
         if (std::fabs(dr_dot_normal) < 0.0001F) {
@@ -149,24 +188,22 @@ namespace render {
           return;
         }
         vector const Q = r.at(lambda);
-        if ((Q - cap_center).length_squared() <= radius_sq) {
-          min_lambda = lambda;
+        if ((Q - cap_center).length_squared() <= c.radius_sq) {
           HitRecord rec;
           rec.lambda = lambda;
           rec.point  = Q;
           rec.normal = normal;
 
-          if (std::isnan(rec.normal.x()) or
-              std::isnan(rec.normal.y()) or
-              std::isnan(rec.normal.z()))
-          {
-            throw std::runtime_error("Error: Cap normal computed as NaN");
+          if (has_nan(rec.normal)) {
+            note_fault(fault, HitFault::cap_normal);
+            return;
           }
           if (dot(r.direction(), rec.normal) > 0.F) {
             rec.normal = -rec.normal;
           }
-          rec.material_name = material_name;
-          closest_hit       = rec;
+          rec.material_id = c.material_id;
+          min_lambda      = lambda;
+          closest_hit     = rec;
         }
       }
     };
@@ -174,42 +211,34 @@ namespace render {
   }  // namespace
 
   /**
-   * @brief Calcula la intersección entre un rayo y un cilindro finito.
+   * @brief Calcula la intersección entre un rayo y un cilindro finito preparado.
    *
    * Determina si el rayo intersecta con el cuerpo o las tapas del cilindro dentro del
    * rango especificado. Si hay impacto, devuelve el registro correspondiente.
    *
-   * @param c Cilindro de la escena.
+   * @param c Cilindro con su eje, media altura y tapas ya calculados.
    * @param r Rayo incidente.
    * @param lambda_min Límite inferior del rango de detección.
    * @param lambda_max Límite superior del rango de detección.
+   * @param fault Se anota aquí un discriminante o una normal no válidos (NaN o INF).
    * @return std::optional<HitRecord> con el resultado del impacto o nullopt.
-   * @throws std::runtime_error si se detectan valores no válidos (NaN, radio ≤ 0, etc.).
    */
 
-  std::optional<HitRecord> hit_cylinder(Cylinder const & c, Ray const & r, float lambda_min,
-                                        float lambda_max) {
-    // Validaciones de entrada
-    if (c.r <= 0.0F) {
-      throw std::runtime_error("Error: Invalid cylinder radius (must be > 0)");
-    }
-    if (c.material.empty()) {
-      throw std::runtime_error("Error: Cylinder material name is empty");
-    }
-    if (c.ax == 0 and c.ay == 0 and c.az == 0) {
-      throw std::runtime_error("Error: Cylinder axis vector cannot be zero-length");
-    }
-    CylinderHitTest test_ctx(c, r, lambda_min, lambda_max);
-    vector const OC         = r.origin() - test_ctx.C;
+  std::optional<HitRecord> hit_cylinder(PreparedCylinder const & c, Ray const & r,
+                                        float lambda_min, float lambda_max,
+                                        HitFault & fault) noexcept {
+    CylinderHitTest test_ctx(c, r, lambda_min, lambda_max, fault);
+    vector const OC         = r.origin() - c.center;
     vector const DR         = r.direction();
-    float const dr_dot_axis = dot(DR, test_ctx.axis);
-    float const oc_dot_axis = dot(OC, test_ctx.axis);
+    float const dr_dot_axis = dot(DR, c.axis);
+    float const oc_dot_axis = dot(OC, c.axis);
     float A                 = dot(DR, DR) - dr_dot_axis * dr_dot_axis;
     float B                 = 2.0F * (dot(DR, OC) - dr_dot_axis * oc_dot_axis);
-    float C_body            = dot(OC, OC) - oc_dot_axis * oc_dot_axis - test_ctx.radius_sq;
+    float C_body            = dot(OC, OC) - oc_dot_axis * oc_dot_axis - c.radius_sq;
     float discriminant      = B * B - 4.F * A * C_body;
     if (std::isnan(discriminant) or std::isinf(discriminant)) {
-      throw std::runtime_error("Error: Cylinder discriminant produced NaN or INF");
+      note_fault(fault, HitFault::cylinder_discriminant);
+      return std::nullopt;
     }
     if (discriminant >= 0.F) {
       float sqrt_discriminant = std::sqrtf(discriminant);
@@ -219,18 +248,59 @@ namespace render {
         test_ctx.check_body_hit((-B + sqrt_discriminant) / (2.0F * A));
       }
     }
-    vector const cap_top_center    = test_ctx.C + test_ctx.axis * test_ctx.half_height;
-    vector const cap_bottom_center = test_ctx.C - test_ctx.axis * test_ctx.half_height;
 
-    test_ctx.check_cap_hit(cap_top_center, test_ctx.axis);
-    test_ctx.check_cap_hit(cap_bottom_center, -test_ctx.axis);
+    test_ctx.check_cap_hit(c.top, c.axis);
+    test_ctx.check_cap_hit(c.bottom, -c.axis);
     return test_ctx.closest_hit;
   }
 
+  /**
+   * @brief Prepara una esfera suelta y calcula su intersección con el rayo.
+   *
+   * @param s Esfera a comprobar.
+   * @param r Rayo incidente.
+   * @param lambda_min Límite inferior del rango de intersección válido.
+   * @param lambda_max Límite superior del rango de intersección válido.
+   * @return std::optional<HitRecord> con los datos de impacto o nullopt si no hay colisión.
+   * @throws std::runtime_error si la esfera no es válida o hay valores NaN o INF.
+   */
+
+  std::optional<HitRecord> hit_sphere(Sphere const & s, Ray const & r, float lambda_min,
+                                      float lambda_max) {
+    HitFault fault = HitFault::none;
+    auto hit       = hit_sphere(prepare_sphere(s), r, lambda_min, lambda_max, fault);
+    if (fault != HitFault::none) {
+      throw_hit_fault(fault);
+    }
+    return hit;
+  }
+
+  /**
+   * @brief Prepara un cilindro suelto y calcula su intersección con el rayo.
+   *
+   * @param c Cilindro de la escena.
+   * @param r Rayo incidente.
+   * @param lambda_min Límite inferior del rango de detección.
+   * @param lambda_max Límite superior del rango de detección.
+   * @return std::optional<HitRecord> con el resultado del impacto o nullopt.
+   * @throws std::runtime_error si se detectan valores no válidos (NaN, radio ≤ 0, etc.).
+   */
+
+  std::optional<HitRecord> hit_cylinder(Cylinder const & c, Ray const & r, float lambda_min,
+                                        float lambda_max) {
+    HitFault fault = HitFault::none;
+    auto hit       = hit_cylinder(prepare_cylinder(c), r, lambda_min, lambda_max, fault);
+    if (fault != HitFault::none) {
+      throw_hit_fault(fault);
+    }
+    return hit;
+  }
+
   /**
    * @brief Calcula el primer objeto de la escena intersectado por un rayo.
    *
-   * Itera sobre todas las esferas y cilindros de la escena, devolviendo el impacto más cercano.
+   * Si la escena tiene una estructura de aceleración construida (ver build_accelerator)
+   * la recorre; si no, comprueba todos los objetos uno a uno.
    *
    * @param scene Escena que contiene los objetos a comprobar.
    * @param r Rayo lanzado.
@@ -241,12 +311,44 @@ namespace render {
 
   std::optional<HitRecord> hit_scene(Scene const & scene, Ray const & r, float lambda_min,
                                      float lambda_max) {
+    if (!scene.bvh8.empty()) {
+      return hit_scene_bvh8(scene, r, lambda_min, lambda_max);
+    }
+    if (!scene.bvh4.empty()) {
+      return hit_scene_bvh4(scene, r, lambda_min, lambda_max);
+    }
+    if (!scene.bvh.empty()) {
+      return hit_scene_bvh(scene, r, lambda_min, lambda_max);
+    }
+    if (!scene.soa.empty()) {
+      return hit_scene_simd(scene, r, lambda_min, lambda_max);
+    }
+    return hit_scene_linear(scene, r, lambda_min, lambda_max);
+  }
+
+  /**
+   * @brief Recorre linealmente todas las esferas y cilindros de la escena.
+   *
+   * Itera sobre todas las esferas y cilindros de la escena, devolviendo el impacto más cercano.
+   * Es el camino de referencia con el que se valida la BVH ("accelerator: linear").
+   *
+   * @param scene Escena con los objetos ya preparados (prepare_scene).
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return std::optional<HitRecord> con el impacto más cercano o nullopt si no hay colisión.
+   * @throws std::runtime_error si algún objeto dio un discriminante o una normal NaN o INF.
+   */
+
+  std::optional<HitRecord> hit_scene_linear(Scene const & scene, Ray const & r, float lambda_min,
+                                            float lambda_max) {
     std::optional<HitRecord> closest_hit = std::nullopt;
     float closest_so_far                 = lambda_max;
+    HitFault fault                       = HitFault::none;
 
     // Comprobar todas las esferas
-    for (auto const & sphere : scene.spheres) {
-      auto hit_record = hit_sphere(sphere, r, lambda_min, closest_so_far);
+    for (auto const & sphere : scene.prepared.spheres) {
+      auto hit_record = hit_sphere(sphere, r, lambda_min, closest_so_far, fault);
 
       if (hit_record) {
         closest_so_far = hit_record->lambda;
@@ -255,8 +357,8 @@ namespace render {
     }
 
     // Comprobar todos los cilindros
-    for (auto const & cylinder : scene.cylinders) {
-      auto hit_record = hit_cylinder(cylinder, r, lambda_min, closest_so_far);
+    for (auto const & cylinder : scene.prepared.cylinders) {
+      auto hit_record = hit_cylinder(cylinder, r, lambda_min, closest_so_far, fault);
 
       if (hit_record) {
         closest_so_far = hit_record->lambda;
@@ -264,6 +366,358 @@ namespace render {
       }
     }
 
+    if (fault != HitFault::none) {
+      throw_hit_fault(fault);
+    }
+    return closest_hit;
+  }
+
+  namespace {
+
+    /// @brief Profundidad máxima de la pila de recorrido de la BVH.
+    constexpr std::size_t bvh_stack_size = 64;
+
+    /**
+     * @brief Rayo preparado para la prueba de cajas: origen e inversa de la dirección.
+     */
+
+    struct SlabRay {
+      std::array<float, 3> origin;
+      std::array<float, 3> inv_dir;
+
+      explicit SlabRay(Ray const & r)
+          : origin{r.origin().x(), r.origin().y(), r.origin().z()},
+            inv_dir{1.0F / r.direction().x(), 1.0F / r.direction().y(),
+                    1.0F / r.direction().z()} { }
+    };
+
+    /**
+     * @brief Prueba de las placas (slab test) entre un rayo y una caja.
+     *
+     * Las comparaciones están escritas para que un NaN (dirección nula con el origen
+     * justo en el plano de la caja) no descarte la caja.
+     *
+     * @return Distancia de entrada a la caja dentro de [lambda_min, lambda_max], o +inf si
+     * el rayo no la atraviesa en ese rango.
+     */
+
+    float slab_entry(AABB const & box, SlabRay const & ray, float lambda_min,
+                     float lambda_max) noexcept {
+      float t_enter = lambda_min;
+      float t_exit  = lambda_max;
+      for (std::size_t i = 0; i < 3; ++i) {
+        float t0 = (box.min[i] - ray.origin[i]) * ray.inv_dir[i];
+        float t1 = (box.max[i] - ray.origin[i]) * ray.inv_dir[i];
+        if (ray.inv_dir[i] < 0.0F) {
+          std::swap(t0, t1);
+        }
+        t_enter = t0 > t_enter ? t0 : t_enter;
+        t_exit  = t1 < t_exit ? t1 : t_exit;
+      }
+      return t_enter <= t_exit ? t_enter : std::numeric_limits<float>::infinity();
+    }
+
+    /**
+     * @brief Entrada de la pila de recorrido: nodo pendiente y su distancia de entrada.
+     */
+
+    struct PendingNode {
+      uint32_t node;
+      float t_enter;
+    };
+
+    /**
+     * @brief Prueba las primitivas de una hoja y actualiza el impacto más cercano.
+     *
+     * @param prims Referencias a primitivas (BVH::prims o WideBVH::prims).
+     * @param first Primera referencia de la hoja.
+     * @param count Número de primitivas de la hoja.
+     */
+
+    void hit_leaf(PreparedScene const & scene, huge_vector<uint32_t> const & prims,
+                  uint32_t first, uint32_t count, Ray const & r, float lambda_min,
+                  float & closest_so_far, std::optional<HitRecord> & closest_hit,
+                  HitFault & fault) noexcept {
+      for (uint32_t i = 0; i < count; ++i) {
+        uint32_t const ref = prims[first + i];
+        auto hit_record    = (ref & BVH::cylinder_flag) != 0
+                                 ? hit_cylinder(scene.cylinders[ref & ~BVH::cylinder_flag], r,
+                                                lambda_min, closest_so_far, fault)
+                                 : hit_sphere(scene.spheres[ref], r, lambda_min, closest_so_far,
+                                              fault);
+        if (hit_record) {
+          closest_so_far = hit_record->lambda;
+          closest_hit    = hit_record;
+        }
+      }
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Calcula el impacto más cercano recorriendo la BVH de delante hacia atrás.
+   *
+   * En cada nodo interior se visita primero el hijo cuya caja está más cerca y el otro se
+   * apila con su distancia de entrada; al sacarlo de la pila se descarta si ya hay un
+   * impacto más cercano que esa distancia.
+   *
+   * @param scene Escena con la BVH ya construida.
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return std::optional<HitRecord> con el impacto más cercano o nullopt si no hay colisión.
+   */
+
+  std::optional<HitRecord> hit_scene_bvh(Scene const & scene, Ray const & r, float lambda_min,
+                                         float lambda_max) {
+    if (scene.bvh.empty()) {
+      return hit_scene_linear(scene, r, lambda_min, lambda_max);
+    }
+    auto const & nodes = scene.bvh.nodes;
+    SlabRay const ray(r);
+    std::optional<HitRecord> closest_hit = std::nullopt;
+    float closest_so_far                 = lambda_max;
+    HitFault fault                       = HitFault::none;
+
+    std::array<PendingNode, bvh_stack_size> stack{};
+    std::size_t top    = 0;
+    float const t_root = slab_entry(nodes[0].bounds, ray, lambda_min, lambda_max);
+    if (std::isinf(t_root)) {
+      return std::nullopt;
+    }
+    stack[top++] = {.node = 0, .t_enter = t_root};
+
+    while (top > 0) {
+      PendingNode const pending = stack[--top];
+      if (pending.t_enter > closest_so_far) {
+        continue;
+      }
+      BVHNode const & node = nodes[pending.node];
+
+      if (node.is_leaf()) {
+        hit_leaf(scene.prepared, scene.bvh.prims, node.right_or_first, node.count, r,
+                 lambda_min, closest_so_far, closest_hit, fault);
+        continue;
+      }
+
+      uint32_t near_child = pending.node + 1;
+      uint32_t far_child  = node.right_or_first;
+      float t_near        = slab_entry(nodes[near_child].bounds, ray, lambda_min, closest_so_far);
+      float t_far         = slab_entry(nodes[far_child].bounds, ray, lambda_min, closest_so_far);
+      if (t_far < t_near) {
+        std::swap(near_child, far_child);
+        std::swap(t_near, t_far);
+      }
+      if (!std::isinf(t_far)) {
+        stack[top++] = {.node = far_child, .t_enter = t_far};
+      }
+      if (!std::isinf(t_near)) {
+        stack[top++] = {.node = near_child, .t_enter = t_near};
+      }
+    }
+
+    if (fault != HitFault::none) {
+      throw_hit_fault(fault);
+    }
+    return closest_hit;
+  }
+
+  namespace {
+
+    /**
+     * @brief Entrada de la pila de recorrido de las BVH anchas: un hijo (nodo o hoja) y su
+     * distancia de entrada.
+     */
+
+    struct PendingChild {
+      uint32_t child;
+      uint32_t count;  // 0 = nodo interior
+      float t_enter;
+    };
+
+    /**
+     * @brief Prueba de las placas entre un rayo y las W cajas hijas de un nodo a la vez.
+     *
+     * Para cada eje se elige por el signo de la dirección qué plano es el de entrada, de
+     * modo que las operaciones por carril son exactamente las de slab_entry (mismo manejo
+     * de NaN). Los huecos vacíos nunca se cruzan.
+     *
+     * @param t_enter Distancia de entrada de cada hijo (solo válida en los carriles cruzados).
+     * @return Máscara de bits con los hijos que el rayo atraviesa en [lambda_min, lambda_max].
+     */
+
+    template <std::size_t W>
+    [[gnu::always_inline]] inline unsigned wide_slab_test(WideBVHNode<W> const & node,
+                                                          SlabRay const & ray, float lambda_min,
+                                                          float lambda_max,
+                                                          std::array<float, W> & t_enter) noexcept {
+      using lanes = simd::f32v<W>;
+      std::array<std::array<float, W> const *, 3> const lo{&node.min_x, &node.min_y, &node.min_z};
+      std::array<std::array<float, W> const *, 3> const hi{&node.max_x, &node.max_y, &node.max_z};
+
+      lanes enter = lanes{} + lambda_min;
+      lanes exit  = lanes{} + lambda_max;
+      for (std::size_t i = 0; i < 3; ++i) {
+        bool const negative = ray.inv_dir[i] < 0.0F;
+        lanes near_plane;
+        lanes far_plane;
+        std::memcpy(&near_plane, (negative ? hi[i] : lo[i])->data(), sizeof(lanes));
+        std::memcpy(&far_plane, (negative ? lo[i] : hi[i])->data(), sizeof(lanes));
+        lanes const t0 = (near_plane - ray.origin[i]) * ray.inv_dir[i];
+        lanes const t1 = (far_plane - ray.origin[i]) * ray.inv_dir[i];
+        enter          = t0 > enter ? t0 : enter;
+        exit           = t1 < exit ? t1 : exit;
+      }
+      auto const crossed = enter <= exit;
+      std::memcpy(t_enter.data(), &enter, sizeof(lanes));
+
+      unsigned mask = 0;
+      for (std::size_t i = 0; i < W; ++i) {
+        mask |= (crossed[i] != 0 ? 1U : 0U) << i;
+      }
+      return mask;
+    }
+
+    /**
+     * @brief Recorre una BVH ancha de delante hacia atrás.
+     *
+     * Los hijos cruzados de cada nodo se ordenan por distancia de entrada y se apilan del
+     * más lejano al más cercano; igual que en hit_scene_bvh, al desapilar se descartan los
+     * que empiezan más allá del impacto más cercano encontrado.
+     */
+
+    template <std::size_t W>
+    [[gnu::always_inline]] inline std::optional<HitRecord>
+        hit_scene_wide(Scene const & scene, WideBVH<W> const & bvh, Ray const & r,
+                       float lambda_min, float lambda_max) {
+      if (bvh.empty()) {
+        return hit_scene_linear(scene, r, lambda_min, lambda_max);
+      }
+      SlabRay const ray(r);
+      std::optional<HitRecord> closest_hit = std::nullopt;
+      float closest_so_far                 = lambda_max;
+      HitFault fault                       = HitFault::none;
+
+      // Sin inicializar (son varios KB por rayo): solo se leen las entradas apiladas
+      std::array<PendingChild, bvh_stack_size * W> stack;
+      std::size_t top = 0;
+      stack[top++]    = {.child = 0, .count = 0, .t_enter = lambda_min};
+
+      while (top > 0) {
+        PendingChild const pending = stack[--top];
+        if (pending.t_enter > closest_so_far) {
+          continue;
+        }
+        if (pending.count > 0) {
+          hit_leaf(scene.prepared, bvh.prims, pending.child, pending.count, r, lambda_min,
+                   closest_so_far, closest_hit, fault);
+          continue;
+        }
+
+        WideBVHNode<W> const & node = bvh.nodes[pending.child];
+        std::array<float, W> t_enter{};
+        unsigned const mask = wide_slab_test(node, ray, lambda_min, closest_so_far, t_enter);
+
+        // Ordena los hijos cruzados de más lejano a más cercano (inserción: W es pequeño)
+        std::array<PendingChild, W> crossed{};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < W; ++i) {
+          if ((mask & (1U << i)) == 0) {
+            continue;
+          }
+          PendingChild const entry{.child = node.child[i], .count = node.count[i],
+                                   .t_enter = t_enter[i]};
+          std::size_t j = n++;
+          for (; j > 0 and crossed[j - 1].t_enter < entry.t_enter; --j) {
+            crossed[j] = crossed[j - 1];
+          }
+          crossed[j] = entry;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+          stack[top++] = crossed[i];
+        }
+      }
+
+      if (fault != HitFault::none) {
+        throw_hit_fault(fault);
+      }
+      return closest_hit;
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Calcula el impacto más cercano recorriendo la BVH de 4 hijos por nodo.
+   *
+   * @param scene Escena con la BVH4 ya construida.
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return std::optional<HitRecord> con el impacto más cercano o nullopt si no hay colisión.
+   */
+
+  RENDER_SIMD_CLONES std::optional<HitRecord> hit_scene_bvh4(Scene const & scene, Ray const & r,
+                                                             float lambda_min, float lambda_max) {
+    return hit_scene_wide(scene, scene.bvh4, r, lambda_min, lambda_max);
+  }
+
+  /**
+   * @brief Calcula el impacto más cercano recorriendo la BVH de 8 hijos por nodo.
+   *
+   * Se compila también para AVX2, donde las 8 cajas se prueban con una sola instrucción
+   * por operación; en CPUs sin AVX2 se usa la versión genérica.
+   *
+   * @param scene Escena con la BVH8 ya construida.
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return std::optional<HitRecord> con el impacto más cercano o nullopt si no hay colisión.
+   */
+
+  RENDER_SIMD_CLONES std::optional<HitRecord> hit_scene_bvh8(Scene const & scene, Ray const & r,
+                                                             float lambda_min, float lambda_max) {
+    return hit_scene_wide(scene, scene.bvh8, r, lambda_min, lambda_max);
+  }
+
+  /**
+   * @brief Calcula el impacto más cercano probando esferas y cilindros en bloques de 8.
+   *
+   * Los núcleos de SceneSOA solo devuelven la distancia y el índice del objeto más cercano
+   * de cada tipo; el registro completo (punto, normal, material) se obtiene después con
+   * hit_sphere o hit_cylinder sobre ese único objeto, que repite los mismos cálculos. Como
+   * en hit_scene_linear, un cilindro a la misma distancia que una esfera gana el empate,
+   * así que el resultado es idéntico.
+   *
+   * @param scene Escena con los objetos ya copiados en formato SoA.
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return std::optional<HitRecord> con el impacto más cercano o nullopt si no hay colisión.
+   * @throws std::runtime_error en los mismos casos que hit_scene_linear.
+   */
+
+  std::optional<HitRecord> hit_scene_simd(Scene const & scene, Ray const & r, float lambda_min,
+                                          float lambda_max) {
+    SoAHit const sphere   = closest_sphere_hit(scene.soa, r, lambda_min, lambda_max);
+    SoAHit const cylinder = closest_cylinder_hit(scene.soa, r, lambda_min, lambda_max);
+    if (sphere.invalid or cylinder.invalid) {
+      // El recorrido lineal lanza el mismo error que sin SoA
+      return hit_scene_linear(scene, r, lambda_min, lambda_max);
+    }
+
+    std::optional<HitRecord> closest_hit = std::nullopt;
+    HitFault fault                       = HitFault::none;
+    if (cylinder.index != SoAHit::none and
+        (sphere.index == SoAHit::none or cylinder.lambda <= sphere.lambda)) {
+      closest_hit = hit_cylinder(scene.prepared.cylinders[cylinder.index], r, lambda_min,
+                                 lambda_max, fault);
+    } else if (sphere.index != SoAHit::none) {
+      closest_hit =
+          hit_sphere(scene.prepared.spheres[sphere.index], r, lambda_min, lambda_max, fault);
+    }
+    if (fault != HitFault::none) {
+      throw_hit_fault(fault);
+    }
     return closest_hit;
   }
 
@@ -0,0 +1,187 @@
+/**
+ * @file huge_page_allocator.cpp
+ * @brief Asignación de bloques grandes en páginas enormes de 2 MB.
+ *
+ * Con páginas de 4 KB, un framebuffer de 1800 x 1012 ocupa unas 1300 páginas y los BVH y
+ * arrays de la escena otras tantas; los rayos las recorren en orden casi aleatorio y la
+ * TLB de datos no alcanza. Con páginas de 2 MB cada entrada cubre 512 veces más memoria.
+ * Los bloques de al menos huge_page_size se piden con mmap: con MAP_HUGETLB si la política
+ * es hugetlb (y hay páginas reservadas en /proc/sys/vm/nr_hugepages), o alineados a 2 MB y
+ * marcados con madvise(MADV_HUGEPAGE) para que el núcleo los junte en páginas enormes
+ * transparentes. Si algo de esto no está disponible, se sigue con páginas normales. Con la
+ * política off los bloques se piden con operator new, igual que sin este asignador, para
+ * que sirva de referencia al medir las otras dos.
+ */
+
+#include "../include/huge_page_allocator.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_set>
+
+#include <sys/mman.h>
+
+namespace render {
+
+  namespace {
+
+    std::atomic<HugePagePolicy> current_policy{HugePagePolicy::off};
+
+    std::atomic<std::size_t> hugetlb_bytes{0};
+    std::atomic<std::size_t> advised_bytes{0};
+    std::atomic<std::size_t> regular_bytes{0};
+
+    // Alineación de los bloques de operator new (política off), como los bloques pequeños
+    constexpr std::size_t regular_alignment = 64;
+
+    // Bloques obtenidos con mmap; los demás se asignaron con operator new. Hay pocos (cada
+    // uno ocupa al menos 2 MB), así que un conjunto con cerrojo basta.
+    std::mutex mapped_mutex;
+    std::unordered_set<void *> mapped_blocks;
+
+    // Anota el bloque de mmap (si no se puede, lo libera y lanza std::bad_alloc)
+    void * remember_mapped(void * p, std::size_t length) {
+      try {
+        std::scoped_lock const lock(mapped_mutex);
+        mapped_blocks.insert(p);
+      } catch (...) {
+        ::munmap(p, length);
+        throw std::bad_alloc();
+      }
+      return p;
+    }
+
+    // Olvida el bloque y dice si era de mmap
+    bool forget_mapped(void * p) noexcept {
+      std::scoped_lock const lock(mapped_mutex);
+      return mapped_blocks.erase(p) > 0;
+    }
+
+    // Tamaño del bloque: múltiplo de huge_page_size (lo exige MAP_HUGETLB, y así allocate
+    // y deallocate calculan la misma longitud sea cual sea la política)
+    std::size_t mapped_length(std::size_t bytes) noexcept {
+      return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    // Bloque de páginas enormes reservadas, o nullptr si no se puede
+    void * map_hugetlb(std::size_t length) noexcept {
+#if defined(MAP_HUGETLB) and defined(MAP_HUGE_SHIFT)
+      void * const p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT),
+                              -1, 0);
+      return p == MAP_FAILED ? nullptr : p;
+#else
+      (void) length;
+      return nullptr;
+#endif
+    }
+
+    // Bloque de páginas normales alineado a huge_page_size: se reserva un bloque mayor y
+    // se devuelven al sistema los trozos de antes y después
+    void * map_aligned(std::size_t length) {
+      std::size_t const reserved = length + huge_page_size;
+      void * const raw = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      auto const start   = reinterpret_cast<std::uintptr_t>(raw);
+      auto const aligned = (start + huge_page_size - 1) / huge_page_size * huge_page_size;
+      if (aligned > start) {
+        ::munmap(raw, aligned - start);
+      }
+      std::size_t const tail = start + reserved - (aligned + length);
+      if (tail > 0) {
+        ::munmap(reinterpret_cast<void *>(aligned + length), tail);
+      }
+      return reinterpret_cast<void *>(aligned);
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Elige la política de páginas enormes.
+   *
+   * @param setting Valor de Config::huge_pages.
+   * @return thp, hugetlb u off (cualquier otro valor).
+   */
+
+  HugePagePolicy huge_page_policy_for(std::string const & setting) {
+    if (setting == "thp") {
+      return HugePagePolicy::thp;
+    }
+    if (setting == "hugetlb") {
+      return HugePagePolicy::hugetlb;
+    }
+    return HugePagePolicy::off;
+  }
+
+  void set_huge_page_policy(HugePagePolicy policy) noexcept {
+    current_policy.store(policy, std::memory_order_relaxed);
+  }
+
+  HugePagePolicy huge_page_policy() noexcept {
+    return current_policy.load(std::memory_order_relaxed);
+  }
+
+  HugePageStats huge_page_stats() noexcept {
+    return {.hugetlb_bytes = hugetlb_bytes.load(std::memory_order_relaxed),
+            .advised_bytes = advised_bytes.load(std::memory_order_relaxed),
+            .regular_bytes = regular_bytes.load(std::memory_order_relaxed)};
+  }
+
+  /**
+   * @brief Asigna un bloque grande con la política actual.
+   *
+   * off usa operator new; hugetlb prueba MAP_HUGETLB y, si no hay páginas reservadas,
+   * sigue como thp; thp marca el bloque alineado con MADV_HUGEPAGE (si el núcleo no lo
+   * admite, se queda en páginas normales). Las páginas se reservan al tocarlas por primera
+   * vez.
+   *
+   * @param bytes Tamaño pedido.
+   * @return Bloque alineado a huge_page_size (a 64 bytes con la política off).
+   * @throws std::bad_alloc Si mmap u operator new fallan.
+   */
+
+  void * allocate_huge(std::size_t bytes) {
+    HugePagePolicy const policy = huge_page_policy();
+    if (policy == HugePagePolicy::off) {
+      void * const p = ::operator new(bytes, std::align_val_t{regular_alignment});
+      regular_bytes.fetch_add(bytes, std::memory_order_relaxed);
+      return p;
+    }
+
+    std::size_t const length = mapped_length(bytes);
+    if (policy == HugePagePolicy::hugetlb) {
+      if (void * const p = map_hugetlb(length)) {
+        hugetlb_bytes.fetch_add(length, std::memory_order_relaxed);
+        return remember_mapped(p, length);
+      }
+    }
+    void * const p = map_aligned(length);
+#if defined(MADV_HUGEPAGE)
+    ::madvise(p, length, MADV_HUGEPAGE);
+#endif
+    advised_bytes.fetch_add(length, std::memory_order_relaxed);
+    return remember_mapped(p, length);
+  }
+
+  /**
+   * @brief Libera un bloque de allocate_huge.
+   *
+   * @param p Bloque.
+   * @param bytes Tamaño con el que se pidió.
+   */
+
+  void deallocate_huge(void * p, std::size_t bytes) noexcept {
+    if (forget_mapped(p)) {
+      ::munmap(p, mapped_length(bytes));
+    } else {
+      ::operator delete(p, std::align_val_t{regular_alignment});
+    }
+  }
+
+}  // namespace render
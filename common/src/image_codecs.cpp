@@ -0,0 +1,516 @@
+/**
+ * @file image_codecs.cpp
+ * @brief Codificadores QOI y PNG (deflate almacenado) con bloques de filas en paralelo.
+ *
+ * QOI codifica cada píxel según el anterior y una tabla de 64 colores recientes, así que el
+ * flujo es secuencial. Para repartirlo entre hilos, cada bloque de filas empieza con el
+ * último píxel del bloque anterior (que se conoce sin codificarlo) y con su propia tabla
+ * vacía: solo usa QOI_OP_INDEX con colores que ha escrito él mismo, que son también los
+ * que el decodificador tiene en esa posición. El archivo es QOI válido; solo se pierde
+ * algún índice al principio de cada bloque.
+ *
+ * En PNG los datos van en bloques deflate almacenados (sin comprimir), con filtro 0 en
+ * cada fila. El tamaño de cada bloque de filas se conoce antes de codificar, así que cada
+ * hilo escribe el suyo en su sitio del archivo, en un IDAT propio con su CRC; el Adler-32
+ * de zlib se junta al final a partir de los de cada bloque.
+ */
+
+#include "../include/image_codecs.hpp"
+#include "../include/ppm_writer.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Píxeles de la imagen, entrelazados (ImageAOS) o en tres planos (ImageSOA)
+    struct PixelSource {
+      std::uint8_t const * rgb{nullptr};
+      std::uint8_t const * r{nullptr};
+      std::uint8_t const * g{nullptr};
+      std::uint8_t const * b{nullptr};
+
+      // Píxeles [first, first + n) entrelazados: apunta a la imagen o a scratch
+      std::uint8_t const * pixels(std::size_t first, std::size_t n,
+                                  std::uint8_t * scratch) const noexcept {
+        if (rgb != nullptr) {
+          return rgb + 3 * first;
+        }
+        interleave_rgb(r + first, g + first, b + first, scratch, n);
+        return scratch;
+      }
+
+      [[nodiscard]] std::array<std::uint8_t, 3> pixel(std::size_t idx) const noexcept {
+        if (rgb != nullptr) {
+          return {rgb[3 * idx], rgb[3 * idx + 1], rgb[3 * idx + 2]};
+        }
+        return {r[idx], g[idx], b[idx]};
+      }
+
+      [[nodiscard]] bool interleaved() const noexcept { return rgb != nullptr; }
+    };
+
+    void check_dimensions(int width, int height) {
+      if (width <= 0 or height <= 0) {
+        throw std::runtime_error("Error: image dimensions must be positive");
+      }
+    }
+
+    PixelSource interleaved_source(int width, int height, std::span<std::uint8_t const> rgb) {
+      check_dimensions(width, height);
+      if (rgb.size() < 3 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height)) {
+        throw std::runtime_error("Error: image buffer smaller than its dimensions");
+      }
+      return {.rgb = rgb.data()};
+    }
+
+    PixelSource planar_source(int width, int height, std::span<std::uint8_t const> r,
+                              std::span<std::uint8_t const> g,
+                              std::span<std::uint8_t const> b) {
+      check_dimensions(width, height);
+      std::size_t const pixels = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+      if (std::min({r.size(), g.size(), b.size()}) < pixels) {
+        throw std::runtime_error("Error: image buffer smaller than its dimensions");
+      }
+      return {.r = r.data(), .g = g.data(), .b = b.data()};
+    }
+
+    std::size_t block_count(int height) noexcept {
+      return static_cast<std::size_t>((height + codec_block_rows - 1) / codec_block_rows);
+    }
+
+    // Filas del bloque 'block'
+    std::size_t block_rows(std::size_t block, int height) noexcept {
+      return std::min(static_cast<std::size_t>(codec_block_rows),
+                      static_cast<std::size_t>(height) - block * codec_block_rows);
+    }
+
+    // Hilos para codificar 'blocks' bloques (no más que bloques)
+    int encoder_threads(int threads, std::size_t blocks) noexcept {
+      return static_cast<int>(
+          std::min(static_cast<std::size_t>(resolve_thread_count(threads)), blocks));
+    }
+
+    void put_u32_be(std::uint8_t * out, std::uint32_t value) noexcept {
+      out[0] = static_cast<std::uint8_t>(value >> 24);
+      out[1] = static_cast<std::uint8_t>(value >> 16);
+      out[2] = static_cast<std::uint8_t>(value >> 8);
+      out[3] = static_cast<std::uint8_t>(value);
+    }
+
+    // ---- QOI ----
+
+    constexpr std::uint8_t qoi_op_index = 0x00;
+    constexpr std::uint8_t qoi_op_diff  = 0x40;
+    constexpr std::uint8_t qoi_op_luma  = 0x80;
+    constexpr std::uint8_t qoi_op_run   = 0xc0;
+    constexpr std::uint8_t qoi_op_rgb   = 0xfe;
+
+    constexpr std::size_t qoi_header_size  = 14;
+    constexpr std::size_t qoi_max_run      = 62;
+    constexpr std::size_t qoi_pixel_bytes  = 4;  // Peor caso: QOI_OP_RGB
+    constexpr std::array<std::uint8_t, 8> qoi_end{0, 0, 0, 0, 0, 0, 0, 1};
+
+    using Rgb = std::array<std::uint8_t, 3>;
+
+    // Posición del color en la tabla (el alfa es siempre 255)
+    std::size_t qoi_hash(Rgb const & px) noexcept {
+      return (px[0] * 3U + px[1] * 5U + px[2] * 7U + 255U * 11U) % 64U;
+    }
+
+    /**
+     * @brief Codifica n píxeles seguidos como un tramo de QOI.
+     *
+     * @param rgb Píxeles entrelazados.
+     * @param n Número de píxeles.
+     * @param prev Píxel anterior al primero (negro al principio de la imagen).
+     * @param out Destino de al menos n * qoi_pixel_bytes bytes.
+     * @return Bytes escritos.
+     */
+
+    std::size_t encode_qoi_block(std::uint8_t const * rgb, std::size_t n, Rgb prev,
+                                 std::uint8_t * out) noexcept {
+      std::array<Rgb, 64> index{};
+      std::uint64_t known = 0;  // Posiciones de la tabla escritas en este tramo
+      std::uint8_t * cursor = out;
+      std::size_t run       = 0;
+
+      for (std::size_t i = 0; i < n; ++i) {
+        Rgb const px{rgb[3 * i], rgb[3 * i + 1], rgb[3 * i + 2]};
+        if (px == prev) {
+          ++run;
+          if (run == qoi_max_run or i + 1 == n) {
+            *cursor++ = static_cast<std::uint8_t>(qoi_op_run | (run - 1));
+            run       = 0;
+          }
+          continue;
+        }
+        if (run > 0) {
+          *cursor++ = static_cast<std::uint8_t>(qoi_op_run | (run - 1));
+          run       = 0;
+        }
+
+        std::size_t const slot = qoi_hash(px);
+        if ((known >> slot & 1U) != 0 and index[slot] == px) {
+          *cursor++ = static_cast<std::uint8_t>(qoi_op_index | slot);
+        } else {
+          index[slot] = px;
+          known |= std::uint64_t{1} << slot;
+
+          auto const vr   = static_cast<std::int8_t>(px[0] - prev[0]);
+          auto const vg   = static_cast<std::int8_t>(px[1] - prev[1]);
+          auto const vb   = static_cast<std::int8_t>(px[2] - prev[2]);
+          auto const vg_r = static_cast<std::int8_t>(vr - vg);
+          auto const vg_b = static_cast<std::int8_t>(vb - vg);
+          if (vr > -3 and vr < 2 and vg > -3 and vg < 2 and vb > -3 and vb < 2) {
+            *cursor++ =
+                static_cast<std::uint8_t>(qoi_op_diff | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+          } else if (vg_r > -9 and vg_r < 8 and vg > -33 and vg < 32 and vg_b > -9 and
+                     vg_b < 8) {
+            *cursor++ = static_cast<std::uint8_t>(qoi_op_luma | (vg + 32));
+            *cursor++ = static_cast<std::uint8_t>((vg_r + 8) << 4 | (vg_b + 8));
+          } else {
+            *cursor++ = qoi_op_rgb;
+            *cursor++ = px[0];
+            *cursor++ = px[1];
+            *cursor++ = px[2];
+          }
+        }
+        prev = px;
+      }
+      return static_cast<std::size_t>(cursor - out);
+    }
+
+    std::vector<std::uint8_t> encode_qoi_source(int width, int height, PixelSource const & src,
+                                                int threads) {
+      std::size_t const w      = static_cast<std::size_t>(width);
+      std::size_t const blocks = block_count(height);
+      std::vector<std::vector<std::uint8_t>> parts(blocks);
+
+      ThreadPool pool(encoder_threads(threads, blocks));
+      pool.parallel_for(blocks, [&](std::size_t block) {
+        std::size_t const y0 = block * codec_block_rows;
+        std::size_t const n  = block_rows(block, height) * w;
+        std::vector<std::uint8_t> scratch(src.interleaved() ? 0 : 3 * n);
+        Rgb const prev = y0 == 0 ? Rgb{0, 0, 0} : src.pixel(y0 * w - 1);
+
+        std::vector<std::uint8_t> & part = parts[block];
+        part.resize(n * qoi_pixel_bytes);
+        part.resize(encode_qoi_block(src.pixels(y0 * w, n, scratch.data()), n, prev, part.data()));
+      });
+
+      std::size_t size = qoi_header_size + qoi_end.size();
+      for (auto const & part : parts) {
+        size += part.size();
+      }
+      std::vector<std::uint8_t> out(size);
+      std::memcpy(out.data(), "qoif", 4);
+      put_u32_be(out.data() + 4, static_cast<std::uint32_t>(width));
+      put_u32_be(out.data() + 8, static_cast<std::uint32_t>(height));
+      out[12]               = 3;  // RGB
+      out[13]               = 0;  // sRGB
+      std::uint8_t * cursor = out.data() + qoi_header_size;
+      for (auto const & part : parts) {
+        cursor = std::copy(part.begin(), part.end(), cursor);
+      }
+      std::copy(qoi_end.begin(), qoi_end.end(), cursor);
+      return out;
+    }
+
+    // ---- PNG ----
+
+    constexpr std::array<std::uint8_t, 8> png_signature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a,
+                                                        '\n'};
+    constexpr std::size_t png_chunk_overhead = 12;  // Longitud, tipo y CRC
+    constexpr std::size_t stored_max         = 65'535;
+    constexpr std::size_t stored_header      = 5;  // BFINAL/BTYPE, LEN y NLEN
+
+    constexpr std::array<std::array<std::uint32_t, 256>, 8> make_crc_tables() {
+      std::array<std::array<std::uint32_t, 256>, 8> tables{};
+      for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+          c = (c & 1U) != 0 ? 0xEDB88320U ^ (c >> 1) : c >> 1;
+        }
+        tables[0][i] = c;
+      }
+      for (std::size_t t = 1; t < tables.size(); ++t) {
+        for (std::size_t i = 0; i < 256; ++i) {
+          tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xffU];
+        }
+      }
+      return tables;
+    }
+
+    constexpr auto crc_tables = make_crc_tables();
+
+    std::uint32_t load_u32_le(std::uint8_t const * data) noexcept {
+      std::uint32_t value = 0;
+      std::memcpy(&value, data, sizeof(value));
+      if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+      }
+      return value;
+    }
+
+    // Bytes de raw_size bytes de filas en bloques almacenados
+    std::size_t stored_size(std::size_t raw_size) noexcept {
+      return raw_size + stored_header * ((raw_size + stored_max - 1) / stored_max);
+    }
+
+    // Escribe datos en bloques deflate almacenados de hasta stored_max bytes, añadiendo la
+    // cabecera de cada bloque al empezarlo, y lleva el Adler-32 de lo escrito
+    class StoredWriter {
+    public:
+      StoredWriter(std::uint8_t * out, std::size_t raw_size, bool last) noexcept
+          : m_out{out}, m_total_left{raw_size}, m_last{last} { }
+
+      void put(std::uint8_t const * data, std::size_t n) noexcept {
+        m_adler = adler32({data, n}, m_adler);
+        while (n > 0) {
+          if (m_block_left == 0) {
+            start_block();
+          }
+          std::size_t const k = std::min(n, m_block_left);
+          std::memcpy(m_out, data, k);
+          m_out += k;
+          data += k;
+          n -= k;
+          m_block_left -= k;
+        }
+      }
+
+      [[nodiscard]] std::uint32_t adler() const noexcept { return m_adler; }
+
+    private:
+      void start_block() noexcept {
+        auto const len     = static_cast<std::uint16_t>(std::min(m_total_left, stored_max));
+        bool const is_last = m_last and m_total_left == len;
+        m_out[0]           = is_last ? 1 : 0;
+        m_out[1]           = static_cast<std::uint8_t>(len);
+        m_out[2]           = static_cast<std::uint8_t>(len >> 8);
+        m_out[3]           = static_cast<std::uint8_t>(~len);
+        m_out[4]           = static_cast<std::uint8_t>(~len >> 8);
+        m_out += stored_header;
+        m_total_left -= len;
+        m_block_left = len;
+      }
+
+      std::uint8_t * m_out;
+      std::size_t m_total_left;
+      std::size_t m_block_left{0};
+      bool m_last;
+      std::uint32_t m_adler{1};
+    };
+
+    // Escribe la longitud y el tipo de un chunk cuyos datos ya están detrás, y su CRC
+    std::uint8_t * finish_chunk(std::uint8_t * chunk, char const * type, std::size_t size) {
+      put_u32_be(chunk, static_cast<std::uint32_t>(size));
+      std::memcpy(chunk + 4, type, 4);
+      put_u32_be(chunk + 8 + size, crc32({chunk + 4, size + 4}));
+      return chunk + png_chunk_overhead + size;
+    }
+
+    std::vector<std::uint8_t> encode_png_source(int width, int height, PixelSource const & src,
+                                                int threads) {
+      std::size_t const w         = static_cast<std::size_t>(width);
+      std::size_t const row_bytes = 1 + 3 * w;  // Byte de filtro y píxeles
+      std::size_t const blocks    = block_count(height);
+
+      // Posición de cada IDAT de bloque: firma, IHDR, IDAT con la cabecera zlib, bloques,
+      // IDAT con el Adler-32 e IEND
+      std::vector<std::size_t> offsets(blocks + 1);
+      offsets[0] = png_signature.size() + (png_chunk_overhead + 13) + (png_chunk_overhead + 2);
+      for (std::size_t block = 0; block < blocks; ++block) {
+        offsets[block + 1] = offsets[block] + png_chunk_overhead +
+                             stored_size(block_rows(block, height) * row_bytes);
+      }
+      std::vector<std::uint8_t> out(offsets[blocks] + (png_chunk_overhead + 4) +
+                                    png_chunk_overhead);
+
+      std::uint8_t * cursor = std::copy(png_signature.begin(), png_signature.end(), out.data());
+      put_u32_be(cursor + 8, static_cast<std::uint32_t>(width));
+      put_u32_be(cursor + 12, static_cast<std::uint32_t>(height));
+      cursor[16] = 8;  // Bits por canal
+      cursor[17] = 2;  // RGB
+      cursor[18] = 0;  // Deflate
+      cursor[19] = 0;  // Filtros adaptativos (todas las filas usan el 0)
+      cursor[20] = 0;  // Sin entrelazado
+      cursor     = finish_chunk(cursor, "IHDR", 13);
+      cursor[8]  = 0x78;  // Cabecera zlib: deflate con ventana de 32 KB, sin diccionario
+      cursor[9]  = 0x01;
+      finish_chunk(cursor, "IDAT", 2);
+
+      std::vector<std::uint32_t> adlers(blocks);
+      ThreadPool pool(encoder_threads(threads, blocks));
+      pool.parallel_for(blocks, [&](std::size_t block) {
+        std::size_t const y0       = block * codec_block_rows;
+        std::size_t const y1       = y0 + block_rows(block, height);
+        std::size_t const raw_size = (y1 - y0) * row_bytes;
+        std::vector<std::uint8_t> scratch(src.interleaved() ? 0 : 3 * w);
+
+        std::uint8_t * const chunk = out.data() + offsets[block];
+        StoredWriter writer(chunk + 8, raw_size, block + 1 == blocks);
+        std::uint8_t const filter = 0;
+        for (std::size_t y = y0; y < y1; ++y) {
+          writer.put(&filter, 1);
+          writer.put(src.pixels(y * w, w, scratch.data()), 3 * w);
+        }
+        adlers[block] = writer.adler();
+        finish_chunk(chunk, "IDAT", stored_size(raw_size));
+      });
+
+      std::uint32_t adler = 1;
+      for (std::size_t block = 0; block < blocks; ++block) {
+        adler = adler32_combine(adler, adlers[block], block_rows(block, height) * row_bytes);
+      }
+      cursor = out.data() + offsets[blocks];
+      put_u32_be(cursor + 8, adler);
+      cursor = finish_chunk(cursor, "IDAT", 4);
+      finish_chunk(cursor, "IEND", 0);
+      return out;
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Codifica una imagen con los píxeles entrelazados como QOI.
+   *
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param rgb Píxeles en orden de filas (3 * width * height bytes).
+   * @param threads Hilos (0 = todos los núcleos).
+   * @return Contenido del archivo.
+   * @throws std::runtime_error Si la imagen está vacía o rgb tiene menos píxeles.
+   */
+
+  std::vector<std::uint8_t> encode_qoi(int width, int height, std::span<std::uint8_t const> rgb,
+                                       int threads) {
+    return encode_qoi_source(width, height, interleaved_source(width, height, rgb), threads);
+  }
+
+  /**
+   * @brief Codifica una imagen con un plano por canal como QOI.
+   *
+   * Cada bloque entrelaza sus filas antes de codificarlas.
+   */
+
+  std::vector<std::uint8_t> encode_qoi_planar(int width, int height,
+                                              std::span<std::uint8_t const> r,
+                                              std::span<std::uint8_t const> g,
+                                              std::span<std::uint8_t const> b, int threads) {
+    return encode_qoi_source(width, height, planar_source(width, height, r, g, b), threads);
+  }
+
+  /**
+   * @brief Codifica una imagen con los píxeles entrelazados como PNG sin comprimir.
+   *
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param rgb Píxeles en orden de filas (3 * width * height bytes).
+   * @param threads Hilos (0 = todos los núcleos).
+   * @return Contenido del archivo.
+   * @throws std::runtime_error Si la imagen está vacía o rgb tiene menos píxeles.
+   */
+
+  std::vector<std::uint8_t> encode_png(int width, int height, std::span<std::uint8_t const> rgb,
+                                       int threads) {
+    return encode_png_source(width, height, interleaved_source(width, height, rgb), threads);
+  }
+
+  /**
+   * @brief Codifica una imagen con un plano por canal como PNG sin comprimir.
+   *
+   * Cada fila se entrelaza antes de copiarla a su bloque.
+   */
+
+  std::vector<std::uint8_t> encode_png_planar(int width, int height,
+                                              std::span<std::uint8_t const> r,
+                                              std::span<std::uint8_t const> g,
+                                              std::span<std::uint8_t const> b, int threads) {
+    return encode_png_source(width, height, planar_source(width, height, r, g, b), threads);
+  }
+
+  /**
+   * @brief CRC-32 con tablas de 8 bytes por paso (slicing-by-8).
+   *
+   * @param data Datos.
+   * @param crc CRC de los datos anteriores (0 al empezar).
+   * @return CRC acumulado.
+   */
+
+  std::uint32_t crc32(std::span<std::uint8_t const> data, std::uint32_t crc) noexcept {
+    std::uint32_t c          = ~crc;
+    std::uint8_t const * ptr = data.data();
+    std::size_t n            = data.size();
+    for (; n >= 8; ptr += 8, n -= 8) {
+      std::uint32_t const lo = c ^ load_u32_le(ptr);
+      std::uint32_t const hi = load_u32_le(ptr + 4);
+      c = crc_tables[7][lo & 0xffU] ^ crc_tables[6][(lo >> 8) & 0xffU] ^
+          crc_tables[5][(lo >> 16) & 0xffU] ^ crc_tables[4][lo >> 24] ^
+          crc_tables[3][hi & 0xffU] ^ crc_tables[2][(hi >> 8) & 0xffU] ^
+          crc_tables[1][(hi >> 16) & 0xffU] ^ crc_tables[0][hi >> 24];
+    }
+    for (; n > 0; ++ptr, --n) {
+      c = crc_tables[0][(c ^ *ptr) & 0xffU] ^ (c >> 8);
+    }
+    return ~c;
+  }
+
+  /**
+   * @brief Adler-32, reduciendo el módulo cada 5552 bytes (lo máximo sin desbordar).
+   *
+   * @param data Datos.
+   * @param adler Adler-32 de los datos anteriores (1 al empezar).
+   * @return Adler-32 acumulado.
+   */
+
+  std::uint32_t adler32(std::span<std::uint8_t const> data, std::uint32_t adler) noexcept {
+    constexpr std::uint32_t base = 65'521;
+    constexpr std::size_t nmax   = 5'552;
+    std::uint32_t a              = adler & 0xffffU;
+    std::uint32_t b              = adler >> 16;
+    for (std::size_t first = 0; first < data.size(); first += nmax) {
+      std::size_t const last = std::min(data.size(), first + nmax);
+      for (std::size_t i = first; i < last; ++i) {
+        a += data[i];
+        b += a;
+      }
+      a %= base;
+      b %= base;
+    }
+    return a | b << 16;
+  }
+
+  /**
+   * @brief Junta los Adler-32 de dos bloques seguidos (como adler32_combine de zlib).
+   *
+   * @param first Adler-32 del primer bloque.
+   * @param second Adler-32 del segundo.
+   * @param second_size Bytes del segundo bloque.
+   * @return Adler-32 de los dos bloques seguidos.
+   */
+
+  std::uint32_t adler32_combine(std::uint32_t first, std::uint32_t second,
+                                std::size_t second_size) noexcept {
+    constexpr std::uint64_t base = 65'521;
+    std::uint64_t const rem      = second_size % base;
+    std::uint64_t sum1           = first & 0xffffU;
+    std::uint64_t sum2           = rem * sum1 % base;
+    sum1 += (second & 0xffffU) + base - 1;
+    sum2 += (first >> 16) + (second >> 16) + base - rem;
+    sum1 %= base;
+    sum2 %= base;
+    return static_cast<std::uint32_t>(sum1 | sum2 << 16);
+  }
+
+}  // namespace render
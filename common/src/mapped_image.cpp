@@ -0,0 +1,252 @@
+/**
+ * @file mapped_image.cpp
+ * @brief Imagen proyectada en memoria sobre el archivo P6 de salida.
+ *
+ * ImageAOS e ImageSOA guardan toda la imagen en un std::vector y la escriben al final, así
+ * que una imagen de 64K x 64K necesita 12 GiB de RAM además de la copia que hace el
+ * escritor. MappedImage crea el archivo P6 con su tamaño final y lo proyecta con mmap: el
+ * render escribe cada byte en su sitio y el sistema vuelca las páginas al archivo. Para
+ * que la memoria no crezca con la imagen, se cuentan los bytes que faltan de cada página y,
+ * cuando las teselas terminadas completan una página, se pide su escritura
+ * (sync_file_range en Linux, msync en otros sistemas) y se quita del proceso con
+ * madvise(MADV_DONTNEED), por lotes de al menos release_bytes.
+ */
+
+#include "../include/mapped_image.hpp"
+#include "../include/ppm_writer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace render {
+
+  namespace {
+
+    // Bytes mínimos que se liberan de una vez (salvo al completar la imagen)
+    constexpr std::size_t release_bytes = std::size_t{4} << 20;
+
+    std::runtime_error mapped_error(std::string const & what, std::string const & filename,
+                                    int error) {
+      return std::runtime_error("Error: cannot " + what + " output file: " + filename + " (" +
+                                std::strerror(error) + ")");
+    }
+
+    std::size_t page_size() noexcept {
+      static std::size_t const size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+      return size;
+    }
+
+    // Pide la escritura de [offset, offset + size) del archivo y quita esas páginas del
+    // proceso. Los datos siguen en la caché de páginas hasta que llegan al disco.
+    void release_range(int fd, std::uint8_t * map, std::size_t offset, std::size_t size) {
+#if defined(__linux__)
+      ::sync_file_range(fd, static_cast<off_t>(offset), static_cast<off_t>(size),
+                        SYNC_FILE_RANGE_WRITE);
+#else
+      (void) fd;
+      ::msync(map + offset, size, MS_ASYNC);
+#endif
+      ::madvise(map + offset, size, MADV_DONTNEED);
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Crea el archivo de salida con su tamaño final y lo proyecta en memoria.
+   *
+   * El espacio del archivo se reserva con posix_fallocate (los píxeles quedan a cero): con
+   * un archivo disperso, si el disco se llenara durante el render, la escritura de una
+   * página en la proyección mataría el proceso con SIGBUS en lugar de fallar aquí. En
+   * sistemas sin posix_fallocate se agranda con ftruncate. La cabecera P6 se copia al
+   * principio de la proyección. Si falla la reserva o la proyección, el archivo se borra
+   * para no dejar una salida vacía o a medias.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param w Ancho en píxeles.
+   * @param h Alto en píxeles.
+   * @throws std::runtime_error Si no se puede crear, reservar o proyectar el archivo.
+   */
+
+  MappedImage::MappedImage(std::string const & filename, int w, int h)
+      : width{w}, height{h}, m_filename{filename} {
+    std::ostringstream header;
+    write_ppm_header(header, width, height, ImageFormat::p6);
+    std::string const header_bytes = header.str();
+    m_map_size                     = header_bytes.size() + 3 * static_cast<std::size_t>(w) *
+                                                               static_cast<std::size_t>(h);
+
+    m_fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+      throw std::runtime_error("Error: cannot open output file: " + filename);
+    }
+#if defined(__linux__)
+    // posix_fallocate devuelve el código de error en lugar de usar errno
+    if (int const error = ::posix_fallocate(m_fd, 0, static_cast<off_t>(m_map_size));
+        error != 0) {
+      discard();
+      throw mapped_error("allocate", filename, error);
+    }
+#else
+    if (::ftruncate(m_fd, static_cast<off_t>(m_map_size)) != 0) {
+      int const error = errno;
+      discard();
+      throw mapped_error("resize", filename, error);
+    }
+#endif
+    void * const map = ::mmap(nullptr, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED) {
+      int const error = errno;
+      discard();
+      throw mapped_error("map", filename, error);
+    }
+    m_map    = static_cast<std::uint8_t *>(map);
+    m_pixels = m_map + header_bytes.size();
+    std::memcpy(m_map, header_bytes.data(), header_bytes.size());
+
+    // La última página puede quedar a medias y la cabecera ya está escrita
+    std::size_t const page = page_size();
+    m_pages_left           = (m_map_size + page - 1) / page;
+    m_page_left.assign(m_pages_left, static_cast<std::uint32_t>(page));
+    m_page_left.back() = static_cast<std::uint32_t>(m_map_size - (m_pages_left - 1) * page);
+    for (std::size_t p = 0; p * page < header_bytes.size(); ++p) {
+      m_page_left[p] -= static_cast<std::uint32_t>(
+          std::min(header_bytes.size(), (p + 1) * page) - p * page);
+      if (m_page_left[p] == 0) {
+        m_ready_pages.push_back(p);
+        --m_pages_left;
+      }
+    }
+  }
+
+  MappedImage::~MappedImage() { unmap(); }
+
+  /**
+   * @brief Descuenta los bytes de una región y libera las páginas que quedan completas.
+   *
+   * Cada fila de la región es un tramo contiguo del archivo; una página queda completa
+   * cuando las regiones terminadas cubren todos sus bytes, aunque falten filas anteriores.
+   * Las páginas completas se acumulan hasta sumar al menos release_bytes o hasta que la
+   * imagen está completa, y se liberan en tramos de páginas seguidas. Las llamadas al
+   * sistema se hacen sin el cerrojo (cada página se libera una sola vez).
+   *
+   * @param x0 Primera columna.
+   * @param y0 Primera fila.
+   * @param x1 Columna siguiente a la última.
+   * @param y1 Fila siguiente a la última.
+   */
+
+  void MappedImage::finish_region(int x0, int y0, int x1, int y1) {
+    std::size_t const page   = page_size();
+    std::size_t const header = static_cast<std::size_t>(m_pixels - m_map);
+    std::size_t const row    = 3 * static_cast<std::size_t>(width);
+    std::vector<std::size_t> ready;
+    {
+      std::scoped_lock const lock(m_mutex);
+      for (int y = y0; y < y1; ++y) {
+        std::size_t const first =
+            header + static_cast<std::size_t>(y) * row + 3 * static_cast<std::size_t>(x0);
+        std::size_t const last = first + 3 * static_cast<std::size_t>(x1 - x0);
+        for (std::size_t p = first / page; p * page < last; ++p) {
+          std::size_t const covered = std::min(last, (p + 1) * page) - std::max(first, p * page);
+          m_page_left[p] -= static_cast<std::uint32_t>(covered);
+          if (m_page_left[p] == 0) {
+            m_ready_pages.push_back(p);
+            --m_pages_left;
+          }
+        }
+      }
+      if (not m_ready_pages.empty() and
+          (m_ready_pages.size() * page >= release_bytes or m_pages_left == 0)) {
+        ready.swap(m_ready_pages);
+        for (std::size_t const p : ready) {
+          m_released_bytes += std::min(m_map_size, (p + 1) * page) - p * page;
+        }
+      }
+    }
+
+    std::ranges::sort(ready);
+    for (std::size_t i = 0; i < ready.size();) {
+      std::size_t j = i + 1;
+      while (j < ready.size() and ready[j] == ready[j - 1] + 1) {
+        ++j;
+      }
+      std::size_t const begin = ready[i] * page;
+      std::size_t const end   = std::min(m_map_size, (ready[j - 1] + 1) * page);
+      release_range(m_fd, m_map, begin, end - begin);
+      i = j;
+    }
+  }
+
+  /**
+   * @brief Escribe en el archivo las páginas que falten y lo cierra.
+   *
+   * @throws std::runtime_error Si msync o close fallan.
+   */
+
+  void MappedImage::finish() {
+    if (m_map != nullptr and ::msync(m_map, m_map_size, MS_SYNC) != 0) {
+      int const error = errno;
+      unmap();
+      throw mapped_error("write", m_filename, error);
+    }
+    if (m_map != nullptr) {
+      ::munmap(m_map, m_map_size);
+      m_map    = nullptr;
+      m_pixels = nullptr;
+    }
+    if (m_fd >= 0) {
+      int const result = ::close(m_fd);
+      m_fd             = -1;
+      if (result != 0) {
+        throw mapped_error("write", m_filename, errno);
+      }
+    }
+    std::cout << "Image saved to " << m_filename << '\n';
+  }
+
+  std::size_t MappedImage::released_bytes() const {
+    std::scoped_lock const lock(m_mutex);
+    return m_released_bytes;
+  }
+
+  void MappedImage::unmap() noexcept {
+    if (m_map != nullptr) {
+      ::munmap(m_map, m_map_size);
+      m_map    = nullptr;
+      m_pixels = nullptr;
+    }
+    if (m_fd >= 0) {
+      ::close(m_fd);
+      m_fd = -1;
+    }
+  }
+
+  /**
+   * @brief Cierra y borra el archivo de salida que no se ha podido preparar.
+   *
+   * Solo se borra si es un archivo regular: la ruta puede ser un dispositivo como /dev/full.
+   */
+
+  void MappedImage::discard() noexcept {
+    struct stat info{};
+    bool const regular = m_fd >= 0 and ::fstat(m_fd, &info) == 0 and S_ISREG(info.st_mode);
+    unmap();
+    if (regular) {
+      ::unlink(m_filename.c_str());
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,566 @@
+/**
+ * @file ppm_writer.cpp
+ * @brief Escritura de imágenes PPM en texto (P3) y en binario (P6).
+ *
+ * El formato P3 original se escribía con un operator<< por cada número y un salto de línea
+ * por píxel, y para imágenes grandes eso tardaba más que partes del render. Aquí cada
+ * número sale de una tabla con su texto ya formateado y la salida se escribe en bloques
+ * grandes. El formato P6 es el propio búfer de la imagen: ImageAOS lo escribe tal cual e
+ * ImageSOA entrelaza sus tres planos con AVX2 antes de escribirlos. Con los backends write
+ * e io_uring los bloques se codifican directamente en los búferes de AsyncFileWriter.
+ * QOI y PNG se codifican en memoria (image_codecs.cpp) y se escriben de una vez. Las
+ * imágenes HDR se guardan en PFM, con los floats de cada fila sin convertir.
+ */
+
+#include "../include/ppm_writer.hpp"
+#include "../include/async_file_writer.hpp"
+#include "../include/image_codecs.hpp"
+#include "../include/simd.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__)
+  #include <immintrin.h>
+#endif
+
+namespace render {
+
+  namespace {
+
+    // Píxeles que se codifican antes de cada escritura (~200 KB en texto)
+    constexpr std::size_t chunk_pixels = 16'384;
+
+    // Texto de un número de 0 a 255 seguido de un espacio, y su longitud
+    struct DecimalEntry {
+      std::array<char, 4> text{};
+      std::uint8_t length{};
+    };
+
+    constexpr std::array<DecimalEntry, 256> make_decimal_table() {
+      std::array<DecimalEntry, 256> table{};
+      for (std::size_t value = 0; value < table.size(); ++value) {
+        DecimalEntry & entry = table[value];
+        std::size_t length   = 0;
+        if (value >= 100) {
+          entry.text[length++] = static_cast<char>('0' + value / 100);
+        }
+        if (value >= 10) {
+          entry.text[length++] = static_cast<char>('0' + value / 10 % 10);
+        }
+        entry.text[length++] = static_cast<char>('0' + value % 10);
+        entry.text[length++] = ' ';
+        entry.length         = static_cast<std::uint8_t>(length);
+      }
+      return table;
+    }
+
+    constexpr std::array<DecimalEntry, 256> decimal_table = make_decimal_table();
+
+    void write_bytes(std::ofstream & out, void const * data, std::size_t size) {
+      out.write(static_cast<char const *>(data), static_cast<std::streamsize>(size));
+    }
+
+    /**
+     * @brief Codifica en texto y escribe n píxeles entrelazados.
+     *
+     * @param out Flujo de salida.
+     * @param rgb Píxeles (3 bytes cada uno).
+     * @param n Número de píxeles (como mucho chunk_pixels).
+     * @param text Búfer de al menos chunk_pixels * ppm_text_max_pixel_bytes + 4 bytes.
+     */
+
+    void write_text_chunk(std::ofstream & out, std::uint8_t const * rgb, std::size_t n,
+                          std::vector<char> & text) {
+      std::size_t const size = encode_ppm_text(rgb, n, text.data());
+      write_bytes(out, text.data(), size);
+    }
+
+    /**
+     * @brief Guarda una imagen con AsyncFileWriter (backends write e io_uring).
+     *
+     * Los píxeles se codifican en los búferes del escritor: en P6, tantos como caben en un
+     * búfer; en P3, bloques de chunk_pixels. Con io_uring, mientras se codifica un bloque
+     * los anteriores se están escribiendo.
+     *
+     * @param rgb_chunk Función (first, n, scratch) que devuelve los píxeles [first,
+     * first + n) entrelazados: un puntero a la imagen o a scratch, donde los deja.
+     * @return false si no se pudo escribir el archivo (el error ya se ha mostrado).
+     */
+
+    template <typename RgbChunk>
+    bool write_buffered(std::string const & filename, int width, int height,
+                        std::size_t pixels, ImageFormat format, OutputBackend backend,
+                        RgbChunk && rgb_chunk) {
+      static_assert(chunk_pixels * ppm_text_max_pixel_bytes + 4 <=
+                    AsyncFileWriter::buffer_size);
+      try {
+        AsyncFileWriter writer(filename, backend);
+
+        std::ostringstream header;
+        write_ppm_header(header, width, height, format);
+        std::string const text = header.str();
+        std::span<char> buffer = writer.next_buffer();
+        std::memcpy(buffer.data(), text.data(), text.size());
+        writer.submit(text.size());
+
+        bool const binary         = format == ImageFormat::p6;
+        std::size_t const block   = binary ? AsyncFileWriter::buffer_size / 3 : chunk_pixels;
+        std::vector<std::uint8_t> scratch(binary ? 0 : 3 * block);
+        for (std::size_t first = 0; first < pixels; first += block) {
+          std::size_t const n = std::min(block, pixels - first);
+          buffer              = writer.next_buffer();
+          if (binary) {
+            auto * const out         = reinterpret_cast<std::uint8_t *>(buffer.data());
+            std::uint8_t const * rgb = rgb_chunk(first, n, out);
+            if (rgb != out) {
+              std::memcpy(out, rgb, 3 * n);
+            }
+            writer.submit(3 * n);
+          } else {
+            writer.submit(encode_ppm_text(rgb_chunk(first, n, scratch.data()), n, buffer.data()));
+          }
+        }
+        writer.finish();
+      } catch (std::runtime_error const & e) {
+        std::cerr << e.what() << '\n';
+        return false;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Guarda un archivo ya codificado (QOI o PNG) con el backend elegido.
+     *
+     * @return false si no se pudo escribir (el error ya se ha mostrado).
+     */
+
+    bool write_encoded(std::string const & filename, std::span<std::uint8_t const> bytes,
+                       OutputBackend backend) {
+      if (backend == OutputBackend::ofstream) {
+        std::ofstream out(filename, std::ios::binary);
+        if (!out.is_open()) {
+          std::cerr << "Error: cannot open output file: " << filename << '\n';
+          return false;
+        }
+        write_bytes(out, bytes.data(), bytes.size());
+        return true;
+      }
+      try {
+        AsyncFileWriter writer(filename, backend);
+        for (std::size_t first = 0; first < bytes.size(); first += AsyncFileWriter::buffer_size) {
+          std::size_t const n    = std::min(AsyncFileWriter::buffer_size, bytes.size() - first);
+          std::span<char> buffer = writer.next_buffer();
+          std::memcpy(buffer.data(), bytes.data() + first, n);
+          writer.submit(n);
+        }
+        writer.finish();
+      } catch (std::runtime_error const & e) {
+        std::cerr << e.what() << '\n';
+        return false;
+      }
+      return true;
+    }
+
+    /**
+     * @brief Codifica la imagen como QOI o PNG y la guarda. La velocidad de codificación
+     * se mide en bench-ppm.
+     *
+     * @param encode Función que devuelve el archivo codificado.
+     */
+
+    template <typename Encode>
+    void save_encoded(std::string const & filename, OutputBackend backend, Encode && encode) {
+      std::vector<std::uint8_t> const bytes = encode();
+      if (write_encoded(filename, bytes, backend)) {
+        std::cout << "Image saved to " << filename << '\n';
+      }
+    }
+
+    /**
+     * @brief Guarda una imagen float como PFM en color.
+     *
+     * PFM guarda las filas de abajo arriba, y el signo de la escala indica el orden de
+     * bytes (negativa, little-endian); se usa el de la máquina y los floats se escriben tal
+     * cual.
+     *
+     * @param row Función (y, scratch) que devuelve los 3 * width floats entrelazados de la
+     * fila y: un puntero a la imagen o a scratch, donde los deja.
+     */
+
+    template <typename RowFn>
+    void save_pfm(std::string const & filename, int width, int height, RowFn && row) {
+      std::ofstream out(filename, std::ios::binary);
+      if (!out.is_open()) {
+        std::cerr << "Error: cannot open output file: " << filename << '\n';
+        return;
+      }
+      out << "PF\n"
+          << width << ' ' << height << '\n'
+          << (std::endian::native == std::endian::little ? "-1.0" : "1.0") << '\n';
+      std::vector<float> scratch(3 * static_cast<std::size_t>(width));
+      for (int y = height - 1; y >= 0; --y) {
+        write_bytes(out, row(y, scratch.data()), scratch.size() * sizeof(float));
+      }
+      std::cout << "Image saved to " << filename << '\n';
+    }
+
+#if defined(__x86_64__)
+
+    // Máscaras de _mm_shuffle_epi8 para entrelazar 16 píxeles: el byte j del bloque de
+    // salida k (de 16 bytes) es el canal p % 3 del píxel p / 3, con p = 16 * k + j. La
+    // máscara [k][c] toma los bytes del canal c y deja a cero (0x80) el resto.
+    constexpr std::array<std::array<std::uint8_t, 16>, 9> make_interleave_masks() {
+      std::array<std::array<std::uint8_t, 16>, 9> masks{};
+      for (std::size_t block = 0; block < 3; ++block) {
+        for (std::size_t channel = 0; channel < 3; ++channel) {
+          for (std::size_t j = 0; j < 16; ++j) {
+            std::size_t const p = 16 * block + j;
+            masks[block * 3 + channel][j] =
+                p % 3 == channel ? static_cast<std::uint8_t>(p / 3) : std::uint8_t{0x80};
+          }
+        }
+      }
+      return masks;
+    }
+
+    alignas(16) constexpr std::array<std::array<std::uint8_t, 16>, 9> interleave_masks =
+        make_interleave_masks();
+
+    // Máscara [index] repetida en las dos mitades del registro
+    [[gnu::target("avx2")]] inline __m256i interleave_mask(std::size_t index) noexcept {
+      return _mm256_broadcastsi128_si256(
+          _mm_load_si128(reinterpret_cast<__m128i const *>(interleave_masks[index].data())));
+    }
+
+    // Bloque 'block' de la salida de los 16 píxeles de cada mitad de r, g y b
+    [[gnu::target("avx2")]] inline __m256i interleave_block(__m256i r, __m256i g, __m256i b,
+                                                           std::size_t block) noexcept {
+      return _mm256_or_si256(
+          _mm256_or_si256(_mm256_shuffle_epi8(r, interleave_mask(block * 3)),
+                          _mm256_shuffle_epi8(g, interleave_mask(block * 3 + 1))),
+          _mm256_shuffle_epi8(b, interleave_mask(block * 3 + 2)));
+    }
+
+    /**
+     * @brief Entrelaza grupos de 32 píxeles con AVX2.
+     *
+     * _mm256_shuffle_epi8 no cruza la mitad del registro, así que cada mitad entrelaza 16
+     * píxeles por separado: la mitad baja de part_k es el bloque k de los píxeles 0-15 y
+     * la alta, el bloque k de los píxeles 16-31. Tres permutaciones de mitades los dejan
+     * en el orden de la salida.
+     *
+     * @return Número de píxeles entrelazados (múltiplo de 32); el resto queda para el
+     * bucle escalar.
+     */
+
+    [[gnu::target("avx2")]] std::size_t interleave_avx2(std::uint8_t const * r,
+                                                        std::uint8_t const * g,
+                                                        std::uint8_t const * b,
+                                                        std::uint8_t * out,
+                                                        std::size_t n) noexcept {
+      std::size_t i = 0;
+      for (; i + 32 <= n; i += 32) {
+        __m256i const vr     = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(r + i));
+        __m256i const vg     = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(g + i));
+        __m256i const vb     = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(b + i));
+        __m256i const part_0 = interleave_block(vr, vg, vb, 0);
+        __m256i const part_1 = interleave_block(vr, vg, vb, 1);
+        __m256i const part_2 = interleave_block(vr, vg, vb, 2);
+
+        auto * const dst = reinterpret_cast<__m256i *>(out + 3 * i);
+        _mm256_storeu_si256(dst, _mm256_permute2x128_si256(part_0, part_1, 0x20));
+        _mm256_storeu_si256(dst + 1, _mm256_permute2x128_si256(part_2, part_0, 0x30));
+        _mm256_storeu_si256(dst + 2, _mm256_permute2x128_si256(part_1, part_2, 0x31));
+      }
+      _mm256_zeroupper();
+      return i;
+    }
+
+#endif
+
+  }  // namespace
+
+  /**
+   * @brief Elige el formato de la imagen de salida.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param setting Valor de Config::image_format ("auto", "p3", "p6", "qoi" o "png").
+   * @return El formato pedido; con "auto", P6, QOI o PNG si la ruta termina en ".pnm",
+   * ".qoi" o ".png", y P3 en otro caso.
+   */
+
+  ImageFormat image_format_for(std::string const & filename, std::string const & setting) {
+    if (setting == "p6" or (setting == "auto" and filename.ends_with(".pnm"))) {
+      return ImageFormat::p6;
+    }
+    if (setting == "qoi" or (setting == "auto" and filename.ends_with(".qoi"))) {
+      return ImageFormat::qoi;
+    }
+    if (setting == "png" or (setting == "auto" and filename.ends_with(".png"))) {
+      return ImageFormat::png;
+    }
+    return ImageFormat::p3;
+  }
+
+  /**
+   * @brief Escribe la cabecera PPM ("P3" o "P6", dimensiones y valor máximo 255).
+   *
+   * @param out Flujo de salida.
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param format P3 o P6.
+   */
+
+  void write_ppm_header(std::ostream & out, int width, int height, ImageFormat format) {
+    out << (format == ImageFormat::p6 ? "P6\n" : "P3\n") << width << ' ' << height << "\n255\n";
+  }
+
+  /**
+   * @brief Codifica píxeles como texto P3.
+   *
+   * Cada número se copia de la tabla como un bloque de 4 bytes ("7 " o "255 ") y el
+   * cursor avanza solo su longitud; el espacio tras el azul se cambia por el salto de
+   * línea. El resultado es el mismo que escribir cada canal con operator<<.
+   *
+   * @param rgb Píxeles entrelazados (3 bytes cada uno).
+   * @param n Número de píxeles.
+   * @param out Destino de al menos n * ppm_text_max_pixel_bytes + 4 bytes.
+   * @return Bytes escritos.
+   */
+
+  std::size_t encode_ppm_text(std::uint8_t const * rgb, std::size_t n, char * out) noexcept {
+    char * cursor = out;
+    for (std::size_t i = 0; i < 3 * n; i += 3) {
+      for (std::size_t channel = 0; channel < 3; ++channel) {
+        DecimalEntry const & entry = decimal_table[rgb[i + channel]];
+        std::memcpy(cursor, entry.text.data(), entry.text.size());
+        cursor += entry.length;
+      }
+      cursor[-1] = '\n';
+    }
+    return static_cast<std::size_t>(cursor - out);
+  }
+
+  /**
+   * @brief Entrelaza tres planos de color píxel a píxel.
+   *
+   * @param r Plano rojo.
+   * @param g Plano verde.
+   * @param b Plano azul.
+   * @param out Destino de 3 * n bytes.
+   * @param n Número de píxeles.
+   */
+
+  void interleave_rgb_scalar(std::uint8_t const * r, std::uint8_t const * g,
+                             std::uint8_t const * b, std::uint8_t * out, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[3 * i]     = r[i];
+      out[3 * i + 1] = g[i];
+      out[3 * i + 2] = b[i];
+    }
+  }
+
+  /**
+   * @brief Entrelaza tres planos de color con AVX2 si la CPU lo admite.
+   *
+   * Los grupos de 32 píxeles van por el núcleo AVX2 y el resto por la versión escalar.
+   *
+   * @param r Plano rojo.
+   * @param g Plano verde.
+   * @param b Plano azul.
+   * @param out Destino de 3 * n bytes.
+   * @param n Número de píxeles.
+   */
+
+  void interleave_rgb(std::uint8_t const * r, std::uint8_t const * g, std::uint8_t const * b,
+                      std::uint8_t * out, std::size_t n) noexcept {
+    std::size_t done = 0;
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+      done = interleave_avx2(r, g, b, out, n);
+    }
+#endif
+    interleave_rgb_scalar(r + done, g + done, b + done, out + 3 * done, n - done);
+  }
+
+  /**
+   * @brief Guarda una imagen con los píxeles entrelazados como PPM.
+   *
+   * En P6 el búfer se escribe tal cual, con una sola llamada. En P3 se codifica por
+   * bloques de chunk_pixels píxeles.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param rgb Píxeles en orden de filas (3 * width * height bytes).
+   * @param format P3 o P6.
+   * @param backend std::ofstream, write(2) o io_uring.
+   */
+
+  void write_image(std::string const & filename, int width, int height,
+                   std::span<std::uint8_t const> rgb, ImageFormat format, OutputBackend backend) {
+    if (format == ImageFormat::qoi or format == ImageFormat::png) {
+      save_encoded(filename, backend, [&] {
+        return format == ImageFormat::qoi ? encode_qoi(width, height, rgb)
+                                          : encode_png(width, height, rgb);
+      });
+      return;
+    }
+    if (backend != OutputBackend::ofstream) {
+      auto const chunk = [&](std::size_t first, std::size_t /*n*/, std::uint8_t * /*scratch*/) {
+        return rgb.data() + 3 * first;
+      };
+      if (write_buffered(filename, width, height, rgb.size() / 3, format, backend, chunk)) {
+        std::cout << "Image saved to " << filename << '\n';
+      }
+      return;
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+      std::cerr << "Error: cannot open output file: " << filename << '\n';
+      return;
+    }
+
+    write_ppm_header(out, width, height, format);
+    if (format == ImageFormat::p6) {
+      write_bytes(out, rgb.data(), rgb.size());
+    } else {
+      std::vector<char> text(chunk_pixels * ppm_text_max_pixel_bytes + 4);
+      std::size_t const pixels = rgb.size() / 3;
+      for (std::size_t first = 0; first < pixels; first += chunk_pixels) {
+        write_text_chunk(out, rgb.data() + 3 * first, std::min(chunk_pixels, pixels - first),
+                         text);
+      }
+    }
+
+    std::cout << "Image saved to " << filename << '\n';
+  }
+
+  /**
+   * @brief Guarda una imagen con un plano por canal como PPM.
+   *
+   * Cada bloque de chunk_pixels píxeles se entrelaza en un búfer intermedio (AVX2 si la
+   * CPU lo admite) y se escribe en binario o se codifica en texto.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param r Plano rojo (width * height bytes).
+   * @param g Plano verde.
+   * @param b Plano azul.
+   * @param format P3 o P6.
+   * @param backend std::ofstream, write(2) o io_uring.
+   */
+
+  void write_image_planar(std::string const & filename, int width, int height,
+                          std::span<std::uint8_t const> r, std::span<std::uint8_t const> g,
+                          std::span<std::uint8_t const> b, ImageFormat format,
+                          OutputBackend backend) {
+    if (format == ImageFormat::qoi or format == ImageFormat::png) {
+      save_encoded(filename, backend, [&] {
+        return format == ImageFormat::qoi ? encode_qoi_planar(width, height, r, g, b)
+                                          : encode_png_planar(width, height, r, g, b);
+      });
+      return;
+    }
+    std::size_t const pixels = std::min({r.size(), g.size(), b.size()});
+    if (backend != OutputBackend::ofstream) {
+      auto const chunk = [&](std::size_t first, std::size_t n, std::uint8_t * scratch) {
+        interleave_rgb(r.data() + first, g.data() + first, b.data() + first, scratch, n);
+        return static_cast<std::uint8_t const *>(scratch);
+      };
+      if (write_buffered(filename, width, height, pixels, format, backend, chunk)) {
+        std::cout << "Image saved to " << filename << '\n';
+      }
+      return;
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out.is_open()) {
+      std::cerr << "Error: cannot open output file: " << filename << '\n';
+      return;
+    }
+
+    write_ppm_header(out, width, height, format);
+    std::vector<std::uint8_t> rgb(3 * chunk_pixels);
+    std::vector<char> text;
+    if (format == ImageFormat::p3) {
+      text.resize(chunk_pixels * ppm_text_max_pixel_bytes + 4);
+    }
+    for (std::size_t first = 0; first < pixels; first += chunk_pixels) {
+      std::size_t const n = std::min(chunk_pixels, pixels - first);
+      interleave_rgb(r.data() + first, g.data() + first, b.data() + first, rgb.data(), n);
+      if (format == ImageFormat::p6) {
+        write_bytes(out, rgb.data(), 3 * n);
+      } else {
+        write_text_chunk(out, rgb.data(), n, text);
+      }
+    }
+
+    std::cout << "Image saved to " << filename << '\n';
+  }
+
+  /**
+   * @brief Guarda una imagen float con los píxeles entrelazados (ImageHdrAOS) como PFM.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param rgb Valores lineales en orden de filas (3 * width * height floats).
+   */
+
+  void write_pfm(std::string const & filename, int width, int height,
+                 std::span<float const> rgb) {
+    if (rgb.size() < 3 * static_cast<std::size_t>(width) * static_cast<std::size_t>(height)) {
+      throw std::runtime_error("write_pfm: buffer smaller than the image");
+    }
+    save_pfm(filename, width, height, [&](int y, float * /*scratch*/) {
+      return rgb.data() + 3 * static_cast<std::size_t>(y) * static_cast<std::size_t>(width);
+    });
+  }
+
+  /**
+   * @brief Guarda una imagen float con un plano por canal (ImageHdrSOA) como PFM.
+   *
+   * Cada fila se entrelaza en un búfer antes de escribirla.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param width Ancho en píxeles.
+   * @param height Alto en píxeles.
+   * @param r Plano rojo (width * height floats).
+   * @param g Plano verde.
+   * @param b Plano azul.
+   */
+
+  void write_pfm_planar(std::string const & filename, int width, int height,
+                        std::span<float const> r, std::span<float const> g,
+                        std::span<float const> b) {
+    auto const w = static_cast<std::size_t>(width);
+    if (std::min({r.size(), g.size(), b.size()}) < w * static_cast<std::size_t>(height)) {
+      throw std::runtime_error("write_pfm_planar: plane smaller than the image");
+    }
+    save_pfm(filename, width, height, [&](int y, float * scratch) {
+      std::size_t const first = static_cast<std::size_t>(y) * w;
+      for (std::size_t x = 0; x < w; ++x) {
+        scratch[3 * x]     = r[first + x];
+        scratch[3 * x + 1] = g[first + x];
+        scratch[3 * x + 2] = b[first + x];
+      }
+      return static_cast<float const *>(scratch);
+    });
+  }
+
+}  // namespace render
@@ -0,0 +1,109 @@
+/**
+ * @file prepared_scene.cpp
+ * @brief Valida los objetos de la escena y precalcula sus datos de intersección.
+ *
+ * hit_sphere e hit_cylinder comprobaban el radio, el material y el eje, y recalculaban el
+ * eje normalizado, la altura y r² en cada rayo. Aquí se hace una sola vez tras leer la
+ * escena, de modo que las rutinas de intersección no necesitan lanzar excepciones.
+ */
+
+#include "../include/prepared_scene.hpp"
+#include "../include/scene.hpp"
+#include "../include/vector.hpp"
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace render {
+
+  /**
+   * @brief Valida una esfera y calcula su centro y su radio al cuadrado.
+   *
+   * @param sphere Esfera tal y como se leyó de la escena.
+   * @return Esfera preparada.
+   * @throws std::runtime_error si el radio no es positivo o el material está vacío.
+   */
+
+  PreparedSphere prepare_sphere(Sphere const & sphere) {
+    if (sphere.r <= 0.0F) {
+      throw std::runtime_error("Error: Invalid sphere radius (must be > 0)");
+    }
+    if (sphere.material.empty()) {
+      throw std::runtime_error("Error: Sphere material name is empty");
+    }
+    return {.center      = vector(sphere.cx, sphere.cy, sphere.cz),
+            .radius_sq   = sphere.r * sphere.r,
+            .material_id = sphere.material_id};
+  }
+
+  /**
+   * @brief Valida un cilindro y calcula su eje unitario, su media altura y sus tapas.
+   *
+   * @param cylinder Cilindro tal y como se leyó de la escena.
+   * @return Cilindro preparado.
+   * @throws std::runtime_error si el radio no es positivo, el material está vacío o el eje
+   * tiene longitud nula o no válida.
+   */
+
+  PreparedCylinder prepare_cylinder(Cylinder const & cylinder) {
+    if (cylinder.r <= 0.0F) {
+      throw std::runtime_error("Error: Invalid cylinder radius (must be > 0)");
+    }
+    if (cylinder.material.empty()) {
+      throw std::runtime_error("Error: Cylinder material name is empty");
+    }
+    if (cylinder.ax == 0 and cylinder.ay == 0 and cylinder.az == 0) {
+      throw std::runtime_error("Error: Cylinder axis vector cannot be zero-length");
+    }
+    vector const axis_vector(cylinder.ax, cylinder.ay, cylinder.az);
+    float const height = axis_vector.magnitude();
+    if (std::isnan(height) or height <= 0.0F) {
+      throw std::runtime_error("Error: Cylinder height is invalid or zero");
+    }
+
+    PreparedCylinder prepared;
+    prepared.center      = vector(cylinder.cx, cylinder.cy, cylinder.cz);
+    prepared.axis        = axis_vector.normalized();
+    prepared.half_height = height / 2.0F;
+    prepared.radius_sq   = cylinder.r * cylinder.r;
+    prepared.top         = prepared.center + prepared.axis * prepared.half_height;
+    prepared.bottom      = prepared.center - prepared.axis * prepared.half_height;
+    prepared.material_id = cylinder.material_id;
+    return prepared;
+  }
+
+  /**
+   * @brief Prepara todos los objetos de la escena.
+   *
+   * Si un objeto no es válido, el mensaje de error añade su tipo y su posición en la
+   * escena (contando desde 1, en el orden del archivo).
+   *
+   * @param scene Escena cuyo campo 'prepared' se rellena.
+   * @throws std::runtime_error si algún objeto no es válido.
+   */
+
+  void prepare_scene(Scene & scene) {
+    PreparedScene prepared;
+    prepared.spheres.reserve(scene.spheres.size());
+    prepared.cylinders.reserve(scene.cylinders.size());
+
+    for (std::size_t i = 0; i < scene.spheres.size(); ++i) {
+      try {
+        prepared.spheres.push_back(prepare_sphere(scene.spheres[i]));
+      } catch (std::runtime_error const & e) {
+        throw std::runtime_error(std::string(e.what()) + "\nSphere " + std::to_string(i + 1));
+      }
+    }
+    for (std::size_t i = 0; i < scene.cylinders.size(); ++i) {
+      try {
+        prepared.cylinders.push_back(prepare_cylinder(scene.cylinders[i]));
+      } catch (std::runtime_error const & e) {
+        throw std::runtime_error(std::string(e.what()) + "\nCylinder " + std::to_string(i + 1));
+      }
+    }
+    scene.prepared = std::move(prepared);
+  }
+
+}  // namespace render
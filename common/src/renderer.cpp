@@ -9,21 +9,26 @@
 #include "../include/renderer.hpp"
 
 // Add other necessary includes that were used by the function bodies
+#include "../include/batch_rng.hpp"
 #include "../include/config.hpp"
 #include "../include/hittable.hpp"
 #include "../include/ray.hpp"
 #include "../include/rng.hpp"
+#include "../include/sampler.hpp"
 #include "../include/scene.hpp"
 #include "../include/vector.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <numbers>
 #include <optional>
 #include <sstream>
-#include <stdexcept>  // For std::out_of_range
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace render {
 
@@ -149,74 +154,68 @@ namespace render {
     return {m_camera_origin, (pixel_center - m_camera_origin).normalized()};
   }
 
-  /**
-   * @brief Calcula el color resultante de un rayo al interactuar con la escena.
-   *
-   * El color se obtiene de forma recursiva aplicando los modelos de material:
-   *  - **Matte:** reflexión difusa aleatoria.
-   *  - **Metal:** reflexión especular con rugosidad.
-   *  - **Refractive:** transmisión según índice de refracción.
-   *
-   * Si no hay intersección, devuelve el color de fondo interpolado.
-   *
-   * @param r Rayo lanzado desde la cámara o rebote previo.
-   * @param scene Escena con objetos y materiales.
-   * @param ctx Contexto de render con parámetros de iluminación y RNG.
-   * @param depth Profundidad máxima de recursión para los rebotes.
-   * @return Vector RGB con el color resultante.
-   */
-
-  vector ray_color(Ray const & r, render::Scene const & scene, RenderContext & ctx, int depth) {
-    // PROFUNDIDAD <= 0, NO HAY CONTRIBUCION AL COLOR
-    if (depth <= 0) {
-      return {0.F, 0.F, 0.F};
-    }
+  namespace {
 
-    float const infinity = std::numeric_limits<float>::infinity();
+    /**
+     * @brief Punto aleatorio dentro de la bola unidad.
+     *
+     * Con direct_ball usa el método sin rechazo de BasicRNG (random_in_unit_ball); si no,
+     * el original por rechazo. Los muestreadores solo tienen el directo.
+     */
 
-    // CONTRIBUCION AL COLOR CORRESPONDIENTE CON LA INTERSECCION
-    if (auto hit = render::hit_scene(scene, r, 0.001F, infinity)) {
-      try {
-        Material const & mat = scene.materials.at(hit->material_name);
-        vector albedo;
+    template <typename R>
+    vector random_in_ball(R & rng, bool direct_ball) {
+      if constexpr (requires { rng.random_in_unit_ball(); }) {
+        if (direct_ball) {
+          return rng.random_in_unit_ball();
+        }
+      }
+      return rng.random_in_unit_sphere();
+    }
 
+    /**
+     * @brief Calcula el rayo reflejado o refractado al impactar en un material.
+     *
+     * Consume los números aleatorios en el mismo orden que la versión recursiva de
+     * ray_color, de modo que la secuencia de rebotes no cambia.
+     *
+     * @param mat Material compilado del objeto alcanzado.
+     * @param r Rayo incidente.
+     * @param hit Intersección más cercana del rayo con la escena.
+     * @param rng Generador usado en los rebotes de material.
+     * @param direct_ball Muestrea la bola unidad sin rechazo (ver random_in_ball).
+     * @return Rayo que continúa el camino.
+     */
+
+    template <typename R>
+    Ray scatter(CompiledMaterial const & mat, Ray const & r, HitRecord const & hit, R & rng,
+                bool direct_ball) {
+      switch (mat.kind) {
         // --- LÓGICA DE MATERIAL 'MATTE' ---
-        if (mat.type == "matte" and mat.params.size() >= 3) {
-          albedo                  = {mat.params[0], mat.params[1], mat.params[2]};
-          vector bounce_direction = hit->normal + ctx.material_rng.random_in_unit_sphere();
+        case MaterialKind::matte: {
+          vector bounce_direction = hit.normal + random_in_ball(rng, direct_ball);
 
           if (std::fabs(bounce_direction.x()) < 1e-8F and
               std::fabs(bounce_direction.y()) < 1e-8F and
               std::fabs(bounce_direction.z()) < 1e-8F)
           {
-            bounce_direction = hit->normal;
+            bounce_direction = hit.normal;
           }
-          Ray bounced_ray(hit->point, bounce_direction.normalized());
-          return albedo * ray_color(bounced_ray, scene, ctx, depth - 1);
+          return {hit.point, bounce_direction.normalized()};
         }
 
         // --- LÓGICA DE MATERIAL 'METAL' ---
-        if (mat.type == "metal" and mat.params.size() >= 4) {
-          albedo           = {mat.params[0], mat.params[1], mat.params[2]};
-          float roughness  = mat.params[3];
-          vector reflected = reflect(r.direction(), hit->normal);
-          vector bounce_direction =
-              (reflected + roughness * ctx.material_rng.random_in_unit_sphere());
-          Ray bounced_ray(hit->point, bounce_direction);
-
-          /*           if (dot(bounced_ray.direction(), hit->normal) <= 0.F) {
-                      return {0.F, 0.F, 0.F};
-                    }  //////// ESTE IF ESTABA COMENTADO */
-          return albedo * ray_color(bounced_ray, scene, ctx, depth - 1);
+        case MaterialKind::metal: {
+          vector reflected        = reflect(r.direction(), hit.normal);
+          vector bounce_direction = reflected + mat.roughness * random_in_ball(rng, direct_ball);
+          return {hit.point, bounce_direction};
         }
 
         // --- LÓGICA DE MATERIAL 'REFRACTIVE' ---
-        if (mat.type == "refractive" and mat.params.size() >= 1) {
-          albedo                       = {1.0F, 1.0F, 1.0F};
-          float ior                    = mat.params[0];
-          bool const front_face        = dot(r.direction(), hit->normal) < 0.F;
-          vector const normal          = front_face ? hit->normal : -hit->normal;
-          float const refraction_ratio = front_face ? (1.0F / ior) : ior;
+        case MaterialKind::refractive: {
+          bool const front_face        = dot(r.direction(), hit.normal) < 0.F;
+          vector const normal          = front_face ? hit.normal : -hit.normal;
+          float const refraction_ratio = front_face ? (1.0F / mat.ior) : mat.ior;
           vector const unit_direction  = r.direction();
 
           auto refracted_opt = refract(unit_direction, normal, refraction_ratio);
@@ -227,19 +226,429 @@ namespace render {
           } else {
             direction = *refracted_opt;
           }
-          Ray bounced_ray(hit->point, direction);
-          return albedo * ray_color(bounced_ray, scene, ctx, depth - 1);
+          return {hit.point, direction};
         }
-      } catch (std::out_of_range const &) {
-        std::cerr << "Error: Material no encontrado: " << hit->material_name << '\n';
       }
-      return {1.F, 0.F, 1.F};  // Error: Pink
+      return r;
     }
 
-    // --- Background Color ---
-    float m = (r.direction().y() + 1.0F) * 0.5F;
+    // Media y varianza de la luminancia de las muestras de un píxel, actualizadas en
+    // cada muestra con el algoritmo de Welford
+    class SampleVariance {
+    public:
+      void add(vector const & color) noexcept {
+        float const luminance = 0.2126F * color.x() + 0.7152F * color.y() + 0.0722F * color.z();
+        ++m_count;
+        float const delta  = luminance - m_mean;
+        m_mean            += delta / static_cast<float>(m_count);
+        m_m2              += delta * (luminance - m_mean);
+      }
+
+      // El error estándar de la media (sqrt(varianza / n)) no supera 'tolerance'
+      [[nodiscard]] bool converged(float tolerance) const noexcept {
+        if (m_count < 2) {
+          return false;
+        }
+        auto const n         = static_cast<float>(m_count);
+        float const variance = m_m2 / (n - 1.0F);
+        return variance <= tolerance * tolerance * n;
+      }
 
-    return (1.0F - m) * ctx.bg_light + m * ctx.bg_dark;
+    private:
+      int m_count{};
+      float m_mean{};
+      float m_m2{};
+    };
+
+    // Añade una muestra al estimador si el muestreo es adaptativo y decide si el píxel
+    // ya tiene suficientes muestras
+    template <typename R>
+    bool enough_samples(BasicRenderContext<R> const & ctx, SampleVariance & variance,
+                        vector const & color, int taken) noexcept {
+      if (ctx.min_samples <= 0) {
+        return false;
+      }
+      variance.add(color);
+      return taken >= ctx.min_samples and variance.converged(ctx.sample_tolerance);
+    }
+
+    // Muestra que identifica el patrón de un píxel: todas sus muestras comparten clave
+    constexpr uint32_t pattern_sample = 0xFFFF'FFFFU;
+
+    // Generador para la muestra 'sample' del píxel (x, y): un flujo propio con StreamRNG,
+    // o la muestra 'sample' de 'count' del patrón del píxel con un muestreador
+    template <typename R>
+    R sample_generator(uint64_t seed, uint32_t x, uint32_t y, uint32_t sample, uint32_t count) {
+      if constexpr (std::is_same_v<R, StreamRNG>) {
+        return StreamRNG(pixel_stream_key(seed, x, y, sample));
+      } else {
+        return R(pixel_stream_key(seed, x, y, pattern_sample), sample, count);
+      }
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Sigue un camino desde path.ray hasta que sale de la escena o agota los rebotes.
+   *
+   * En cada rebote se aplica el modelo del material alcanzado:
+   *  - **Matte:** reflexión difusa aleatoria.
+   *  - **Metal:** reflexión especular con rugosidad.
+   *  - **Refractive:** transmisión según índice de refracción.
+   *
+   * El bucle acumula en path.throughput el producto de los albedos y guarda cada albedo
+   * en ctx.path_attenuation. El color final se compone de atrás hacia delante
+   * (albedo_1 * (albedo_2 * (... * fondo))), con las mismas multiplicaciones y en el
+   * mismo orden que la versión recursiva, así que la imagen es idéntica byte a byte.
+   *
+   * Si el contexto lo activa, tras cada rebote el camino puede terminar antes:
+   *  - Si la mayor componente del throughput es menor que ctx.throughput_threshold
+   *    (introduce un sesgo pequeño: se pierde lo que aportaría ese camino).
+   *  - A partir de ctx.roulette_depth rebotes, con ruleta rusa: sobrevive con
+   *    probabilidad p = min(1, max(throughput)) y su albedo se divide entre p, de modo
+   *    que el valor esperado del color no cambia. Consume un número de material_rng.
+   * En ambos casos el camino aporta negro, igual que al agotar la profundidad.
+   *
+   * @param path Estado del camino; al terminar contiene el último rayo, el throughput y el
+   * número de rebotes.
+   * @param scene Escena con objetos y materiales.
+   * @param ctx Contexto de render con parámetros de iluminación y RNG.
+   * @param max_depth Número máximo de segmentos del camino.
+   * @return Vector RGB con el color resultante.
+   */
+
+  template <typename R>
+  vector trace_path(PathState & path, Scene const & scene, BasicRenderContext<R> & ctx,
+                    int max_depth) {
+    float const infinity              = std::numeric_limits<float>::infinity();
+    std::vector<vector> & attenuation = ctx.path_attenuation;
+    attenuation.clear();
+
+    // SI SE AGOTA LA PROFUNDIDAD, EL ULTIMO SEGMENTO NO CONTRIBUYE AL COLOR
+    vector radiance(0.F, 0.F, 0.F);
+    int segments = 0;
+    for (int depth = max_depth; depth > 0; --depth) {
+      ++segments;
+      auto const hit = hit_scene(scene, path.ray, 0.001F, infinity);
+      if (not hit) {
+        // --- Background Color ---
+        float m  = (path.ray.direction().y() + 1.0F) * 0.5F;
+        radiance = (1.0F - m) * ctx.bg_light + m * ctx.bg_dark;
+        break;
+      }
+      if (hit->material_id >= scene.material_table.size()) {
+        std::cerr << "Error: Material no encontrado: " << hit->material_id << '\n';
+        radiance = {1.F, 0.F, 1.F};  // Error: Pink
+        break;
+      }
+      CompiledMaterial const & mat = scene.material_table[hit->material_id];
+
+      path.ray = scatter(mat, path.ray, *hit, ctx.material_rng, ctx.direct_ball);
+      attenuation.push_back(mat.albedo);
+      path.throughput = path.throughput * mat.albedo;
+      ++path.bounces;
+
+      // TERMINACION TEMPRANA (DESACTIVADA POR DEFECTO)
+      float const strength = std::max({path.throughput.x(), path.throughput.y(),
+                                       path.throughput.z()});
+      if (strength < ctx.throughput_threshold) {
+        ++ctx.stats.threshold_terminated;
+        break;
+      }
+      if (ctx.roulette_depth > 0 and path.bounces >= ctx.roulette_depth) {
+        float const survival = std::min(strength, 1.0F);
+        if (ctx.material_rng.random_float() >= survival) {
+          ++ctx.stats.roulette_terminated;
+          break;
+        }
+        attenuation.back() = attenuation.back() / survival;
+        path.throughput    = path.throughput / survival;
+      }
+    }
+    ++ctx.stats.paths;
+    ctx.stats.segments += static_cast<uint64_t>(segments);
+
+    for (auto it = attenuation.rbegin(); it != attenuation.rend(); ++it) {
+      radiance = *it * radiance;
+    }
+    return radiance;
   }
 
+  /**
+   * @brief Calcula el color resultante de un rayo al interactuar con la escena.
+   *
+   * Si no hay intersección, devuelve el color de fondo interpolado. Ver trace_path.
+   *
+   * @param r Rayo lanzado desde la cámara o rebote previo.
+   * @param scene Escena con objetos y materiales.
+   * @param ctx Contexto de render con parámetros de iluminación y RNG.
+   * @param depth Profundidad máxima de rebotes.
+   * @return Vector RGB con el color resultante.
+   */
+
+  template <typename R>
+  vector ray_color(Ray const & r, render::Scene const & scene, BasicRenderContext<R> & ctx,
+                   int depth) {
+    PathState path{.ray = r};
+    return trace_path(path, scene, ctx, depth);
+  }
+
+  // Instanciaciones explícitas para todos los tipos de generador
+  template vector ray_color<RNG>(Ray const &, Scene const &, RenderContext &, int);
+  template vector ray_color<XoshiroRNG>(Ray const &, Scene const &,
+                                        BasicRenderContext<XoshiroRNG> &, int);
+  template vector ray_color<PcgRNG>(Ray const &, Scene const &, BasicRenderContext<PcgRNG> &,
+                                    int);
+  template vector ray_color<BatchRNG>(Ray const &, Scene const &, BasicRenderContext<BatchRNG> &,
+                                      int);
+  template vector ray_color<StreamRNG>(Ray const &, Scene const &, StreamRenderContext &, int);
+  template vector trace_path<RNG>(PathState &, Scene const &, RenderContext &, int);
+  template vector trace_path<XoshiroRNG>(PathState &, Scene const &,
+                                         BasicRenderContext<XoshiroRNG> &, int);
+  template vector trace_path<PcgRNG>(PathState &, Scene const &, BasicRenderContext<PcgRNG> &,
+                                     int);
+  template vector trace_path<BatchRNG>(PathState &, Scene const &,
+                                       BasicRenderContext<BatchRNG> &, int);
+  template vector trace_path<StreamRNG>(PathState &, Scene const &, StreamRenderContext &, int);
+  template vector ray_color<StratifiedSampler>(Ray const &, Scene const &,
+                                               BasicRenderContext<StratifiedSampler> &, int);
+  template vector ray_color<SobolSampler>(Ray const &, Scene const &,
+                                          BasicRenderContext<SobolSampler> &, int);
+  template vector trace_path<StratifiedSampler>(PathState &, Scene const &,
+                                                BasicRenderContext<StratifiedSampler> &, int);
+  template vector trace_path<SobolSampler>(PathState &, Scene const &,
+                                           BasicRenderContext<SobolSampler> &, int);
+
+  /**
+   * @brief Construye el contexto de render (fondo, gamma y generadores) para un bucle de render.
+   *
+   * R es el generador del modo "legacy": RNG (Mersenne Twister), XoshiroRNG, PcgRNG o
+   * BatchRNG.
+   *
+   * @param cfg Configuración con colores de fondo, gamma y profundidad máxima.
+   * @param material_seed Semilla del generador usado en los rebotes de material.
+   * @param ray_seed Semilla del generador usado para el jitter de los rayos primarios.
+   * @return Contexto listo para usar en ray_color.
+   */
+
+  template <typename R>
+  BasicRenderContext<R> make_render_context(Config const & cfg, uint64_t material_seed,
+                                            uint64_t ray_seed) {
+    return BasicRenderContext<R>{
+      .bg_dark              = parse_vector_from_string(cfg.background_dark_color),
+      .bg_light             = parse_vector_from_string(cfg.background_light_color),
+      .inv_gamma            = 1.0F / cfg.gamma,
+      .max_depth            = cfg.max_depth,
+      .material_rng         = R(material_seed),
+      .ray_rng              = R(ray_seed),
+      .roulette_depth       = cfg.roulette_depth,
+      .throughput_threshold = cfg.throughput_threshold,
+      .min_samples          = cfg.adaptive_min_samples,
+      .sample_tolerance     = cfg.adaptive_tolerance,
+      .direct_ball          = cfg.ball_sampling == "direct"};
+  }
+
+  template RenderContext make_render_context<RNG>(Config const &, uint64_t, uint64_t);
+  template BasicRenderContext<XoshiroRNG> make_render_context<XoshiroRNG>(Config const &,
+                                                                          uint64_t, uint64_t);
+  template BasicRenderContext<PcgRNG> make_render_context<PcgRNG>(Config const &, uint64_t,
+                                                                  uint64_t);
+  template BasicRenderContext<BatchRNG> make_render_context<BatchRNG>(Config const &, uint64_t,
+                                                                      uint64_t);
+
+  /**
+   * @brief Construye un contexto para el modo "per_pixel" o para un muestreador.
+   *
+   * Los generadores se reinician en cada muestra con sample_pixel_streams, así que aquí
+   * solo se inicializan con una clave cualquiera.
+   *
+   * @param cfg Configuración con colores de fondo, gamma y profundidad máxima.
+   * @return Contexto con generadores basados en contador o muestreadores.
+   */
+
+  template <typename R>
+  BasicRenderContext<R> make_stream_context(Config const & cfg) {
+    return BasicRenderContext<R>{
+      .bg_dark              = parse_vector_from_string(cfg.background_dark_color),
+      .bg_light             = parse_vector_from_string(cfg.background_light_color),
+      .inv_gamma            = 1.0F / cfg.gamma,
+      .max_depth            = cfg.max_depth,
+      .material_rng         = R(0),
+      .ray_rng              = R(0),
+      .roulette_depth       = cfg.roulette_depth,
+      .throughput_threshold = cfg.throughput_threshold,
+      .min_samples          = cfg.adaptive_min_samples,
+      .sample_tolerance     = cfg.adaptive_tolerance,
+      .direct_ball          = cfg.ball_sampling == "direct"};
+  }
+
+  template StreamRenderContext make_stream_context<StreamRNG>(Config const &);
+  template BasicRenderContext<StratifiedSampler>
+      make_stream_context<StratifiedSampler>(Config const &);
+  template BasicRenderContext<SobolSampler> make_stream_context<SobolSampler>(Config const &);
+
+  /**
+   * @brief Muestra los contadores de caminos y su longitud media.
+   * @param out Flujo de salida.
+   * @param stats Contadores acumulados durante el render.
+   * @return El mismo flujo.
+   */
+
+  std::ostream & operator<<(std::ostream & out, PathStats const & stats) {
+    return out << "Paths: " << stats.paths << ", average length " << stats.average_length()
+               << " segments (" << stats.roulette_terminated << " ended by roulette, "
+               << stats.threshold_terminated << " below threshold)";
+  }
+
+  /**
+   * @brief Deriva una semilla para un flujo concreto (por ejemplo, una tesela).
+   *
+   * Usa el finalizador de SplitMix64 para que semillas y flujos consecutivos produzcan
+   * semillas sin correlación aparente.
+   *
+   * @param seed Semilla base de la configuración.
+   * @param stream Identificador del flujo.
+   * @return Semilla derivada.
+   */
+
+  uint64_t derive_seed(uint64_t seed, uint64_t stream) noexcept {
+    return splitmix64(seed + (stream + 1) * 0x9E37'79B9'7F4A'7C15ULL);
+  }
+
+  /**
+   * @brief Divide la imagen en teselas cuadradas recorridas en orden de filas.
+   *
+   * Las teselas del borde derecho e inferior se recortan al tamaño de la imagen.
+   *
+   * @param width Ancho de la imagen en píxeles.
+   * @param height Alto de la imagen en píxeles.
+   * @param tile_size Lado de la tesela en píxeles (> 0).
+   * @return Lista de teselas que cubren la imagen sin solaparse.
+   */
+
+  std::vector<Tile> make_tiles(int width, int height, int tile_size) {
+    std::vector<Tile> tiles;
+    for (int y = 0; y < height; y += tile_size) {
+      for (int x = 0; x < width; x += tile_size) {
+        tiles.push_back(Tile{.x0 = x,
+                             .y0 = y,
+                             .x1 = std::min(x + tile_size, width),
+                             .y1 = std::min(y + tile_size, height)});
+      }
+    }
+    return tiles;
+  }
+
+  /**
+   * @brief Calcula el color medio de un píxel lanzando varios rayos con jitter.
+   *
+   * Cada muestra desplaza el punto de la ventana un valor aleatorio en [-0.5, 0.5)
+   * en cada eje (antialiasing) y acumula el color devuelto por ray_color.
+   *
+   * Con muestreo adaptativo (ctx.min_samples > 0), tras min_samples muestras el píxel
+   * para en cuanto el error estándar de la luminancia media baja de ctx.sample_tolerance.
+   * El número de muestras tomadas queda en ctx.pixel_samples.
+   *
+   * @param camera Cámara de la escena.
+   * @param scene Escena a renderizar.
+   * @param ctx Contexto de render con los generadores aleatorios.
+   * @param x Columna del píxel.
+   * @param y Fila del píxel.
+   * @param samples_per_pixel Número de muestras a promediar.
+   * @return Color medio del píxel (sin corrección gamma).
+   */
+
+  template <typename R>
+  vector sample_pixel(Camera const & camera, Scene const & scene, BasicRenderContext<R> & ctx,
+                      int x, int y, int samples_per_pixel) {
+    vector accumulated_color(0, 0, 0);
+    SampleVariance variance;
+    int taken = 0;
+
+    while (taken < samples_per_pixel) {
+      float const delta_x = ctx.ray_rng.random_float() - 0.5F;  // Intervalo [-0,5;0,5]
+      float const delta_y = ctx.ray_rng.random_float() - 0.5F;  // Intervalo [-0,5;0,5]
+      float const x_jit   = static_cast<float>(x) + delta_x;
+      float const y_jit   = static_cast<float>(y) + delta_y;
+      Ray const r         = camera.get_ray(x_jit, y_jit);
+
+      vector const color  = ray_color(r, scene, ctx, ctx.max_depth);
+      accumulated_color  += color;
+      ++taken;
+      if (enough_samples(ctx, variance, color, taken)) {
+        break;
+      }
+    }
+    ctx.pixel_samples = taken;
+    return accumulated_color / static_cast<float>(taken);
+  }
+
+  template vector sample_pixel<RNG>(Camera const &, Scene const &, RenderContext &, int, int, int);
+  template vector sample_pixel<XoshiroRNG>(Camera const &, Scene const &,
+                                           BasicRenderContext<XoshiroRNG> &, int, int, int);
+  template vector sample_pixel<PcgRNG>(Camera const &, Scene const &,
+                                       BasicRenderContext<PcgRNG> &, int, int, int);
+  template vector sample_pixel<BatchRNG>(Camera const &, Scene const &,
+                                         BasicRenderContext<BatchRNG> &, int, int, int);
+
+  /**
+   * @brief Calcula el color medio de un píxel con un flujo aleatorio por muestra.
+   *
+   * Antes de cada muestra se reinician los dos generadores con una clave derivada de
+   * (semilla, x, y, muestra). Así el color de cada píxel solo depende de su posición y
+   * de las semillas, nunca del hilo que lo calcula ni del orden en que se recorren.
+   * Con un muestreador, los generadores dan la muestra correspondiente del patrón del
+   * píxel (el jitter es el primer par 2D y cada rebote toma nuevas dimensiones).
+   * El muestreo adaptativo funciona igual que en sample_pixel.
+   *
+   * @param camera Cámara de la escena.
+   * @param scene Escena a renderizar.
+   * @param ctx Contexto de render con generadores basados en contador o muestreadores.
+   * @param x Columna del píxel.
+   * @param y Fila del píxel.
+   * @param cfg Configuración con las semillas y el número de muestras.
+   * @return Color medio del píxel (sin corrección gamma).
+   */
+
+  template <typename R>
+  vector sample_pixel_streams(Camera const & camera, Scene const & scene,
+                              BasicRenderContext<R> & ctx, int x, int y, Config const & cfg) {
+    auto const material_seed = static_cast<uint64_t>(cfg.material_rng_seed);
+    auto const ray_seed      = static_cast<uint64_t>(cfg.ray_rng_seed);
+    auto const px            = static_cast<uint32_t>(x);
+    auto const py            = static_cast<uint32_t>(y);
+    auto const count         = static_cast<uint32_t>(cfg.samples_per_pixel);
+    vector accumulated_color(0, 0, 0);
+    SampleVariance variance;
+    int taken = 0;
+
+    while (taken < cfg.samples_per_pixel) {
+      auto const sample = static_cast<uint32_t>(taken);
+      ctx.ray_rng       = sample_generator<R>(ray_seed, px, py, sample, count);
+      ctx.material_rng  = sample_generator<R>(material_seed, px, py, sample, count);
+
+      float const x_jit = static_cast<float>(x) + (ctx.ray_rng.random_float() - 0.5F);
+      float const y_jit = static_cast<float>(y) + (ctx.ray_rng.random_float() - 0.5F);
+      Ray const r       = camera.get_ray(x_jit, y_jit);
+
+      vector const color  = ray_color(r, scene, ctx, ctx.max_depth);
+      accumulated_color  += color;
+      ++taken;
+      if (enough_samples(ctx, variance, color, taken)) {
+        break;
+      }
+    }
+    ctx.pixel_samples = taken;
+    return accumulated_color / static_cast<float>(taken);
+  }
+
+  template vector sample_pixel_streams<StreamRNG>(Camera const &, Scene const &,
+                                                  StreamRenderContext &, int, int, Config const &);
+  template vector sample_pixel_streams<StratifiedSampler>(Camera const &, Scene const &,
+                                                          BasicRenderContext<StratifiedSampler> &,
+                                                          int, int, Config const &);
+  template vector sample_pixel_streams<SobolSampler>(Camera const &, Scene const &,
+                                                     BasicRenderContext<SobolSampler> &, int, int,
+                                                     Config const &);
+
 }  // namespace render
@@ -0,0 +1,68 @@
+/**
+ * @file sample_map.cpp
+ * @brief Mapa con el número de muestras tomadas en cada píxel.
+ *
+ * Con muestreo adaptativo, cada píxel deja de muestrear cuando su varianza es baja. Este
+ * mapa permite ver dónde se han concentrado las muestras (bordes, vidrio, sombras).
+ */
+
+#include "../include/sample_map.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+
+namespace render {
+
+  /**
+   * @brief Crea un mapa de w x h píxeles con todas las cuentas a cero.
+   * @param w Ancho en píxeles.
+   * @param h Alto en píxeles.
+   */
+
+  SampleMap::SampleMap(int w, int h)
+      : width{w}, height{h}, counts(static_cast<std::size_t>(w) * static_cast<std::size_t>(h)) { }
+
+  /**
+   * @brief Suma el número de muestras de todos los píxeles.
+   * @return Total de muestras del render.
+   */
+
+  uint64_t SampleMap::total() const noexcept {
+    return std::accumulate(counts.begin(), counts.end(), uint64_t{0});
+  }
+
+  /**
+   * @brief Guarda el mapa como imagen PGM en texto (P2).
+   *
+   * El valor máximo de la cabecera es la mayor cuenta del mapa (al menos 1), así que cada
+   * valor es exactamente el número de muestras del píxel y el píxel más muestreado se ve
+   * blanco. El formato admite como mucho 65535; las cuentas mayores se recortan.
+   *
+   * @param filename Ruta del archivo de salida.
+   */
+
+  void SampleMap::save_to_pgm(std::string const & filename) const {
+    std::ofstream out(filename);
+    if (!out.is_open()) {
+      std::cerr << "Error: cannot open output file: " << filename << '\n';
+      return;
+    }
+
+    constexpr uint32_t pgm_max = 65'535;
+    uint32_t const max_count =
+        counts.empty() ? 1U : std::max(1U, *std::max_element(counts.begin(), counts.end()));
+    out << "P2\n" << width << ' ' << height << '\n' << std::min(max_count, pgm_max) << '\n';
+    for (int y = 0; y < height; ++y) {
+      for (int x = 0; x < width; ++x) {
+        out << std::min(at(x, y), pgm_max) << (x + 1 == width ? '\n' : ' ');
+      }
+    }
+
+    std::cout << "Sample map saved to " << filename << '\n';
+  }
+
+}  // namespace render
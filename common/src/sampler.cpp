@@ -0,0 +1,273 @@
+/**
+ * @file sampler.cpp
+ * @brief Patrones de muestreo estratificado y Sobol aleatorizado.
+ *
+ * Los dos patrones reparten las muestras de un píxel de forma más uniforme que números
+ * independientes, así que el error baja más deprisa al aumentar samples_per_pixel. Todo
+ * se calcula con hashes de la clave del píxel, sin estado compartido, así que el resultado
+ * no depende del hilo ni del orden de render.
+ */
+
+#include "../include/sampler.hpp"
+#include "../include/rng.hpp"
+#include "../include/vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace render {
+
+  namespace {
+
+    // Mayor float estrictamente menor que 1
+    constexpr float one_minus_epsilon = 0x1.fffffep-1F;
+
+    constexpr uint32_t reverse_bits(uint32_t x) noexcept {
+      x = ((x >> 1U) & 0x5555'5555U) | ((x & 0x5555'5555U) << 1U);
+      x = ((x >> 2U) & 0x3333'3333U) | ((x & 0x3333'3333U) << 2U);
+      x = ((x >> 4U) & 0x0F0F'0F0FU) | ((x & 0x0F0F'0F0FU) << 4U);
+      x = ((x >> 8U) & 0x00FF'00FFU) | ((x & 0x00FF'00FFU) << 8U);
+      return (x >> 16U) | (x << 16U);
+    }
+
+    // 24 bits altos -> [0, 1)
+    constexpr float to_unit_float(uint32_t bits) noexcept {
+      return static_cast<float>(bits >> 8U) * 0x1.0p-24F;
+    }
+
+    // Semilla derivada de otra (hash de 32 bits "lowbias32"); mucho más barato que splitmix64
+    constexpr uint32_t hash_combine(uint32_t seed, uint32_t value) noexcept {
+      uint32_t x = seed ^ (value * 0x9E37'79B9U + 0x7F4A'7C15U);
+      x ^= x >> 16U;
+      x *= 0x7FEB'352DU;
+      x ^= x >> 15U;
+      x *= 0x846C'A68BU;
+      x ^= x >> 16U;
+      return x;
+    }
+
+    // --- Sobol + Owen ---
+
+    // Permutación de Laine-Karras (versión de Burley): cada bit solo depende de los
+    // bits menos significativos, que tras invertir el orden son los más significativos
+    constexpr uint32_t laine_karras_permutation(uint32_t x, uint32_t seed) noexcept {
+      x += seed;
+      x ^= x * 0x6C50'B47CU;
+      x ^= x * 0xB82F'1E52U;
+      x ^= x * 0xC7AF'E638U;
+      x ^= x * 0x8D22'F6E6U;
+      return x;
+    }
+
+    // La aleatorización de Owen anidada es reverse(LK(reverse(x))). Para no invertir los
+    // bits dos veces seguidas, las dimensiones se calculan ya invertidas y solo se invierte
+    // el resultado final. La primera dimensión (van der Corput) invertida es el índice.
+
+    // Segunda dimensión de Sobol (polinomio x + 1, todos los m_i = 1), con los bits
+    // invertidos. Es el XOR de los números de dirección de los bits activos del índice;
+    // como el índice barajado ocupa los 32 bits, se precalcula el XOR de cada byte
+    using SobolTables = std::array<std::array<uint32_t, 256>, 4>;
+
+    constexpr SobolTables make_sobol_dimension_1_tables() noexcept {
+      std::array<uint32_t, 32> directions{};
+      uint32_t direction = 0x8000'0000U;
+      for (uint32_t & d : directions) {
+        d          = direction;
+        direction ^= direction >> 1U;
+      }
+      SobolTables tables{};
+      for (std::size_t byte = 0; byte < 4; ++byte) {
+        for (std::size_t value = 0; value < 256; ++value) {
+          uint32_t bits = 0;
+          for (std::size_t bit = 0; bit < 8; ++bit) {
+            if (((value >> bit) & 1U) != 0) {
+              bits ^= directions[byte * 8 + bit];
+            }
+          }
+          tables[byte][value] = reverse_bits(bits);
+        }
+      }
+      return tables;
+    }
+
+    constexpr SobolTables sobol_dimension_1_tables = make_sobol_dimension_1_tables();
+
+    constexpr uint32_t sobol_dimension_1_reversed(uint32_t index) noexcept {
+      return sobol_dimension_1_tables[0][index & 0xFFU] ^
+             sobol_dimension_1_tables[1][(index >> 8U) & 0xFFU] ^
+             sobol_dimension_1_tables[2][(index >> 16U) & 0xFFU] ^
+             sobol_dimension_1_tables[3][index >> 24U];
+    }
+
+    // --- Multi-jittered correlacionado (Kensler, "Correlated Multi-Jittered Sampling") ---
+
+    // Permutación pseudoaleatoria de [0, length) elegida por 'pattern'
+    constexpr uint32_t permute(uint32_t i, uint32_t length, uint32_t pattern) noexcept {
+      uint32_t w = length - 1;
+      w |= w >> 1U;
+      w |= w >> 2U;
+      w |= w >> 4U;
+      w |= w >> 8U;
+      w |= w >> 16U;
+      do {
+        i ^= pattern;
+        i *= 0xE170'893DU;
+        i ^= pattern >> 16U;
+        i ^= (i & w) >> 4U;
+        i ^= pattern >> 8U;
+        i *= 0x0929'EB3FU;
+        i ^= pattern >> 23U;
+        i ^= (i & w) >> 1U;
+        i *= 1U | pattern >> 27U;
+        i *= 0x6935'FA69U;
+        i ^= (i & w) >> 11U;
+        i *= 0x74DC'B303U;
+        i ^= (i & w) >> 2U;
+        i *= 0x9E50'1CC3U;
+        i ^= (i & w) >> 2U;
+        i *= 0xC860'A3DFU;
+        i &= w;
+        i ^= i >> 5U;
+      } while (i >= length);
+      return (i + pattern) % length;
+    }
+
+    // Valor pseudoaleatorio en [0, 1) para la muestra i del patrón
+    constexpr float jitter(uint32_t i, uint32_t pattern) noexcept {
+      i ^= pattern;
+      i ^= i >> 17U;
+      i ^= i >> 10U;
+      i *= 0xB365'34E5U;
+      i ^= i >> 12U;
+      i ^= i >> 21U;
+      i *= 0x93FC'4795U;
+      i ^= 0xDF6E'307FU;
+      i ^= i >> 17U;
+      i *= 1U | pattern >> 18U;
+      return to_unit_float(i);
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Punto 2D de la muestra 'sample' de un patrón multi-jittered de 'count' puntos.
+   *
+   * Los puntos forman una rejilla de m x n celdas (m = floor(sqrt(count))) con uno por
+   * celda, y sus proyecciones en cada eje caen en intervalos distintos de ancho 1/count.
+   *
+   * @param sample Índice de la muestra en [0, count).
+   * @param count Número total de muestras del píxel.
+   * @param seed Semilla del patrón (distinta por píxel y grupo de dimensiones).
+   * @param u Primera coordenada en [0, 1).
+   * @param v Segunda coordenada en [0, 1).
+   */
+
+  void StratifiedPattern::point_2d(uint32_t sample, uint32_t count, uint32_t seed, float & u,
+                                   float & v) noexcept {
+    auto const m = std::max(1U, static_cast<uint32_t>(std::sqrt(static_cast<float>(count))));
+    uint32_t const n = (count + m - 1) / m;
+
+    uint32_t const s  = permute(sample % count, count, seed * 0x5163'3E2DU);
+    uint32_t const sx = permute(s % m, m, seed * 0x68BC'21EBU);
+    uint32_t const sy = permute(s / m, n, seed * 0x02E5'BE93U);
+    float const jx    = jitter(s, seed * 0x967A'889BU);
+    float const jy    = jitter(s, seed * 0x368C'C8B7U);
+
+    auto const fm = static_cast<float>(m);
+    auto const fn = static_cast<float>(n);
+    u = std::min((static_cast<float>(s % m) + (static_cast<float>(sy) + jx) / fn) / fm,
+                 one_minus_epsilon);
+    v = std::min((static_cast<float>(s / m) + (static_cast<float>(sx) + jy) / fm) / fn,
+                 one_minus_epsilon);
+  }
+
+  /**
+   * @brief Valor 1D estratificado: un valor en cada intervalo [k/count, (k+1)/count).
+   * @param sample Índice de la muestra en [0, count).
+   * @param count Número total de muestras del píxel.
+   * @param seed Semilla del patrón.
+   * @return Valor en [0, 1).
+   */
+
+  float StratifiedPattern::point_1d(uint32_t sample, uint32_t count, uint32_t seed) noexcept {
+    uint32_t const stratum = permute(sample % count, count, seed * 0x5163'3E2DU);
+    float const offset     = jitter(sample, seed * 0x967A'889BU);
+    return std::min((static_cast<float>(stratum) + offset) / static_cast<float>(count),
+                    one_minus_epsilon);
+  }
+
+  /**
+   * @brief Punto 2D de Sobol aleatorizado con Owen.
+   *
+   * Primero se baraja el índice con una aleatorización anidada (conserva los bloques de
+   * 2^k muestras) y después se aleatoriza cada dimensión con su propia semilla. Los
+   * primeros 2^k puntos tienen exactamente uno en cada intervalo elemental de área 2^-k.
+   *
+   * @param sample Índice de la muestra.
+   * @param count No se usa: la secuencia es progresiva.
+   * @param seed Semilla del grupo de dimensiones.
+   * @param u Primera coordenada en [0, 1).
+   * @param v Segunda coordenada en [0, 1).
+   */
+
+  void SobolPattern::point_2d(uint32_t sample, [[maybe_unused]] uint32_t count, uint32_t seed,
+                              float & u, float & v) noexcept {
+    uint32_t const index = reverse_bits(laine_karras_permutation(reverse_bits(sample), seed));
+    u = to_unit_float(reverse_bits(laine_karras_permutation(index, hash_combine(seed, 0))));
+    v = to_unit_float(reverse_bits(
+        laine_karras_permutation(sobol_dimension_1_reversed(index), hash_combine(seed, 1))));
+  }
+
+  /**
+   * @brief Valor 1D de Sobol aleatorizado con Owen (van der Corput barajado).
+   * @param sample Índice de la muestra.
+   * @param count No se usa: la secuencia es progresiva.
+   * @param seed Semilla del grupo de dimensiones.
+   * @return Valor en [0, 1).
+   */
+
+  float SobolPattern::point_1d(uint32_t sample, [[maybe_unused]] uint32_t count,
+                               uint32_t seed) noexcept {
+    uint32_t const index = reverse_bits(laine_karras_permutation(reverse_bits(sample), seed));
+    return to_unit_float(reverse_bits(laine_karras_permutation(index, hash_combine(seed, 0))));
+  }
+
+  /**
+   * @brief Semilla del siguiente grupo de dimensiones de este píxel.
+   *
+   * Solo depende de la clave del píxel y del número de grupo, así que todas las muestras
+   * del píxel comparten el mismo patrón en cada grupo.
+   *
+   * @return Semilla de 32 bits.
+   */
+
+  template <typename Pattern>
+  uint32_t BasicSampler<Pattern>::next_seed() noexcept {
+    ++m_group;
+    return static_cast<uint32_t>(splitmix64(m_key + m_group * 0x9E37'79B9'7F4A'7C15ULL) >> 32U);
+  }
+
+  /**
+   * @brief Punto uniforme dentro de la esfera unitaria.
+   *
+   * El par 2D fija la dirección y un valor 1D el radio (ver unit_ball_point), de modo que
+   * el volumen queda cubierto de forma uniforme sin descartar muestras.
+   *
+   * @return Vector con longitud menor que 1.
+   */
+
+  template <typename Pattern>
+  render::vector BasicSampler<Pattern>::random_in_unit_sphere() noexcept {
+    float u{};
+    float v{};
+    Pattern::point_2d(m_sample, m_count, next_seed(), u, v);
+    float const w = Pattern::point_1d(m_sample, m_count, next_seed());
+    return unit_ball_point(u, v, w);
+  }
+
+  template class BasicSampler<StratifiedPattern>;
+  template class BasicSampler<SobolPattern>;
+
+}  // namespace render
@@ -8,6 +8,8 @@
  */
 
 #include "../include/scene.hpp"
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <istream>
@@ -128,6 +130,7 @@ namespace render {
       Material m;
       m.name = name;
       m.type = key.substr(0, key.size() - 1);
+      m.id   = static_cast<uint32_t>(ctx.scene->materials.size());
       if (m.type == "matte") {
         parse_matte_params(iss, m, ctx);
       } else if (m.type == "metal") {
@@ -171,12 +174,14 @@ namespace render {
             << *(ctx.line) << "\"";
         throw std::runtime_error(oss.str());
       }
-      if (!ctx.scene->materials.contains(s.material)) {
+      auto const material = ctx.scene->materials.find(s.material);
+      if (material == ctx.scene->materials.end()) {
         std::ostringstream oss;
         oss << "Error: Material not found: [\"" << s.material << "\"]\nLine "
             << std::to_string(ctx.line_num) << ": \"" << *(ctx.line) << "\"";
         throw std::runtime_error(oss.str());
       }
+      s.material_id = material->second.id;
 
       std::string extra = collect_extra(iss);
       if (!extra.empty()) {
@@ -214,12 +219,14 @@ namespace render {
         throw std::runtime_error(oss.str());
       }
 
-      if (!ctx.scene->materials.contains(c.material)) {
+      auto const material = ctx.scene->materials.find(c.material);
+      if (material == ctx.scene->materials.end()) {
         std::ostringstream oss;
         oss << "Error: Material not found: [\"" << c.material << "\"]\nLine "
             << std::to_string(ctx.line_num) << ": \"" << *(ctx.line) << "\"";
         throw std::runtime_error(oss.str());
       }
+      c.material_id = material->second.id;
 
       std::string extra = collect_extra(iss);
       if (!extra.empty()) {
@@ -249,8 +256,10 @@ namespace render {
    * Procesa materiales, esferas y cilindros, validando formato, duplicados y coherencia.
    *
    * @param filename Ruta al archivo de escena a leer.
-   * @return Estructura Scene completamente inicializada.
-   * @throws std::runtime_error si el archivo no puede abrirse o contiene errores de sintaxis.
+   * @return Estructura Scene completamente inicializada (materiales compilados y objetos
+   * preparados).
+   * @throws std::runtime_error si el archivo no puede abrirse, contiene errores de sintaxis o
+   * algún objeto no es válido.
    */
 
   Scene read_scene(std::string const & filename) {
@@ -292,7 +301,82 @@ namespace render {
         throw std::runtime_error(oss.str());
       }
     }
+    compile_materials(scene);
+    prepare_scene(scene);
     return scene;
   }
 
+  /**
+   * @brief Traduce un material leído a la forma que usa ray_color en cada rebote.
+   *
+   * El tipo pasa de cadena a MaterialKind y los parámetros a campos con nombre; el albedo
+   * queda precalculado (1, 1, 1 en los refractivos, como hacía ray_color).
+   *
+   * @param material Material tal y como se leyó del archivo de escena.
+   * @return Material compilado.
+   * @throws std::runtime_error si el tipo es desconocido o faltan parámetros.
+   */
+
+  CompiledMaterial compile_material(Material const & material) {
+    std::vector<float> const & p = material.params;
+    CompiledMaterial compiled;
+    if (material.type == "matte" and p.size() >= 3) {
+      compiled.kind   = MaterialKind::matte;
+      compiled.albedo = {p[0], p[1], p[2]};
+    } else if (material.type == "metal" and p.size() >= 4) {
+      compiled.kind      = MaterialKind::metal;
+      compiled.albedo    = {p[0], p[1], p[2]};
+      compiled.roughness = p[3];
+    } else if (material.type == "refractive" and p.size() >= 1) {
+      compiled.kind = MaterialKind::refractive;
+      compiled.ior  = p[0];
+    } else {
+      throw std::runtime_error("Error: Invalid material: [" + material.name + "]");
+    }
+    return compiled;
+  }
+
+  /**
+   * @brief Compila los materiales de la escena y enlaza cada objeto con el suyo.
+   *
+   * Los materiales se numeran por su id (orden de definición en read_scene) y, a igualdad,
+   * por nombre, de modo que las escenas construidas a mano también obtienen índices
+   * deterministas. Es la única búsqueda por nombre: después cada impacto lleva el índice.
+   *
+   * @param scene Escena cuyos materiales y objetos se actualizan.
+   * @throws std::runtime_error si un objeto usa un material inexistente o inválido.
+   */
+
+  void compile_materials(Scene & scene) {
+    std::vector<Material *> ordered;
+    ordered.reserve(scene.materials.size());
+    for (auto & entry : scene.materials) {
+      ordered.push_back(&entry.second);
+    }
+    std::ranges::sort(ordered, [](Material const * a, Material const * b) {
+      return a->id != b->id ? a->id < b->id : a->name < b->name;
+    });
+
+    scene.material_table.clear();
+    scene.material_table.reserve(ordered.size());
+    for (Material * material : ordered) {
+      material->id = static_cast<uint32_t>(scene.material_table.size());
+      scene.material_table.push_back(compile_material(*material));
+    }
+
+    auto const id_of = [&scene](std::string const & name) {
+      auto const material = scene.materials.find(name);
+      if (material == scene.materials.end()) {
+        throw std::runtime_error("Error: Material not found: [\"" + name + "\"]");
+      }
+      return material->second.id;
+    };
+    for (Sphere & sphere : scene.spheres) {
+      sphere.material_id = id_of(sphere.material);
+    }
+    for (Cylinder & cylinder : scene.cylinders) {
+      cylinder.material_id = id_of(cylinder.material);
+    }
+  }
+
 }  // namespace render
@@ -0,0 +1,541 @@
+/**
+ * @file scene_soa.cpp
+ * @brief Almacena los objetos de la escena por componentes y los intersecta con SIMD.
+ *
+ * El formato AOS de Scene::spheres y Scene::cylinders mezcla en cada elemento las
+ * coordenadas con un std::string; aquí los datos geométricos se guardan en arrays
+ * alineados para que los núcleos AVX2 carguen 8 objetos con una instrucción por
+ * componente y resuelvan todos los casos con máscaras en lugar de ramas.
+ */
+
+#include "../include/scene_soa.hpp"
+#include "../include/ray.hpp"
+#include "../include/scene.hpp"
+#include "../include/simd.hpp"
+#include "../include/vector.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+#if defined(__x86_64__)
+  #include <immintrin.h>
+#endif
+
+namespace render {
+
+  namespace {
+
+    /// @brief Mismos umbrales que hit_cylinder para descartar el cuerpo y las tapas.
+    constexpr float body_epsilon = 0.00001F;
+    constexpr float cap_epsilon  = 0.0001F;
+
+    /**
+     * @brief Parámetros del rayo comunes a todos los objetos.
+     */
+
+    struct KernelRay {
+      float ox, oy, oz;
+      float dx, dy, dz;
+      float dd;      // |d|² (A en hit_sphere)
+      float four_a;  // 4·|d|²
+      float two_a;   // 2·|d|²
+    };
+
+    KernelRay prepare_ray(Ray const & r) noexcept {
+      vector const o = r.origin();
+      vector const d = r.direction();
+      float const dd = d.length_squared();
+      return {.ox     = o.x(),
+              .oy     = o.y(),
+              .oz     = o.z(),
+              .dx     = d.x(),
+              .dy     = d.y(),
+              .dz     = d.z(),
+              .dd     = dd,
+              .four_a = 4.F * dd,
+              .two_a  = 2.0F * dd};
+    }
+
+    /**
+     * @brief Acepta un impacto si no es más lejano que el mejor: a igual distancia gana el
+     * objeto de índice mayor, igual que en el bucle lineal.
+     */
+
+    void keep_closest(SoAHit & best, float lambda, uint32_t index) noexcept {
+      if (lambda < best.lambda or (lambda == best.lambda and index > best.index)) {
+        best.lambda = lambda;
+        best.index  = index;
+      }
+    }
+
+#if defined(__x86_64__)
+
+    /**
+     * @brief Constantes de un rayo ya difundidas a los 8 carriles.
+     */
+
+    struct KernelRay8 {
+      __m256 ox, oy, oz;
+      __m256 dx, dy, dz;
+      __m256 l_min, l_max;
+    };
+
+    [[gnu::target("avx2")]] KernelRay8 broadcast(KernelRay const & ray, float lambda_min,
+                                                 float lambda_max) noexcept {
+      return {.ox    = _mm256_set1_ps(ray.ox),
+              .oy    = _mm256_set1_ps(ray.oy),
+              .oz    = _mm256_set1_ps(ray.oz),
+              .dx    = _mm256_set1_ps(ray.dx),
+              .dy    = _mm256_set1_ps(ray.dy),
+              .dz    = _mm256_set1_ps(ray.dz),
+              .l_min = _mm256_set1_ps(lambda_min),
+              .l_max = _mm256_set1_ps(lambda_max)};
+    }
+
+    /// @brief a·b en el orden de dot(): (x·x' + y·y') + z·z'.
+    [[gnu::target("avx2")]] inline __m256 dot8(__m256 ax, __m256 ay, __m256 az, __m256 bx,
+                                              __m256 by, __m256 bz) noexcept {
+      return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax, bx), _mm256_mul_ps(ay, by)),
+                           _mm256_mul_ps(az, bz));
+    }
+
+    /// @brief Componente de Q - P con Q = O + λd, en el orden de r.at(λ) - P.
+    [[gnu::target("avx2")]] inline __m256 offset8(__m256 o, __m256 d, __m256 lambda,
+                                                 __m256 p) noexcept {
+      return _mm256_sub_ps(_mm256_add_ps(o, _mm256_mul_ps(lambda, d)), p);
+    }
+
+    /// @brief Máscara de los carriles con 'lambda' en [l_min, l_max].
+    [[gnu::target("avx2")]] inline __m256 in_range(__m256 lambda, __m256 l_min,
+                                                  __m256 l_max) noexcept {
+      return _mm256_and_ps(_mm256_cmp_ps(lambda, l_min, _CMP_GE_OQ),
+                           _mm256_cmp_ps(lambda, l_max, _CMP_LE_OQ));
+    }
+
+    /// @brief |x| por carril.
+    [[gnu::target("avx2")]] inline __m256 abs8(__m256 x) noexcept {
+      return _mm256_andnot_ps(_mm256_set1_ps(-0.0F), x);
+    }
+
+    /**
+     * @brief Reduce el mejor impacto de cada carril al mejor global.
+     */
+
+    [[gnu::target("avx2")]] SoAHit reduce_lanes(__m256 best_lambda, __m256i best_index,
+                                                __m256 invalid) noexcept {
+      alignas(32) std::array<float, 8> lane_lambda{};
+      alignas(32) std::array<int32_t, 8> lane_index{};
+      _mm256_store_ps(lane_lambda.data(), best_lambda);
+      _mm256_store_si256(reinterpret_cast<__m256i *>(lane_index.data()), best_index);
+
+      SoAHit best;
+      best.invalid = _mm256_movemask_ps(invalid) != 0;
+      // GCC no limpia la mitad alta de los registros al volver de una función que recibe
+      // __m256 por valor; el código SSE del llamante pagaría la transición en cada rayo
+      _mm256_zeroupper();
+      for (std::size_t lane = 0; lane < 8; ++lane) {
+        if (lane_index[lane] >= 0) {
+          keep_closest(best, lane_lambda[lane], static_cast<uint32_t>(lane_index[lane]));
+        }
+      }
+      return best;
+    }
+
+    /**
+     * @brief Núcleo AVX2: prueba el rayo contra 8 esferas por iteración.
+     *
+     * Cada carril repite exactamente las operaciones de hit_sphere (mismo orden, sin FMA),
+     * así que las distancias coinciden bit a bit con el camino escalar. Cada carril guarda
+     * su mejor impacto y al final se reducen los 8.
+     */
+
+    [[gnu::target("avx2")]] SoAHit closest_sphere_hit_avx2(SphereSOA const & spheres,
+                                                           KernelRay const & kray,
+                                                           float lambda_min,
+                                                           float lambda_max) noexcept {
+      KernelRay8 const ray  = broadcast(kray, lambda_min, lambda_max);
+      __m256 const four_a   = _mm256_set1_ps(kray.four_a);
+      __m256 const two_a    = _mm256_set1_ps(kray.two_a);
+      __m256 const two      = _mm256_set1_ps(2.0F);
+      __m256 const zero     = _mm256_setzero_ps();
+      __m256 const infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+      __m256 const sign     = _mm256_set1_ps(-0.0F);
+      __m256i const count   = _mm256_set1_epi32(static_cast<int>(spheres.count));
+      __m256i const eight   = _mm256_set1_epi32(8);
+
+      __m256 best_lambda = infinity;
+      __m256i best_index = _mm256_set1_epi32(-1);
+      __m256i index      = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+      __m256 invalid     = zero;
+
+      for (std::size_t i = 0; i < spheres.cx.size(); i += SceneSOA::lanes) {
+        __m256 const rcx  = _mm256_sub_ps(ray.ox, _mm256_load_ps(&spheres.cx[i]));
+        __m256 const rcy  = _mm256_sub_ps(ray.oy, _mm256_load_ps(&spheres.cy[i]));
+        __m256 const rcz  = _mm256_sub_ps(ray.oz, _mm256_load_ps(&spheres.cz[i]));
+        __m256 const r_sq = _mm256_load_ps(&spheres.r_sq[i]);
+
+        // B = 2·dot(rc, d); C = |rc|² - r²; discriminante = B² - 4AC
+        __m256 const b    = _mm256_mul_ps(two, dot8(rcx, rcy, rcz, ray.dx, ray.dy, ray.dz));
+        __m256 const c    = _mm256_sub_ps(dot8(rcx, rcy, rcz, rcx, rcy, rcz), r_sq);
+        __m256 const disc = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(four_a, c));
+
+        // Carriles de relleno fuera; un discriminante NaN o INF se notifica como en hit_sphere
+        __m256 const real   = _mm256_castsi256_ps(_mm256_cmpgt_epi32(count, index));
+        __m256 const finite = _mm256_cmp_ps(abs8(disc), infinity, _CMP_LT_OQ);
+        invalid             = _mm256_or_ps(invalid, _mm256_andnot_ps(finite, real));
+
+        __m256 const sqrt_disc = _mm256_sqrt_ps(disc);
+        __m256 const minus_b   = _mm256_xor_ps(b, sign);
+        __m256 const near      = _mm256_div_ps(_mm256_sub_ps(minus_b, sqrt_disc), two_a);
+        __m256 const far       = _mm256_div_ps(_mm256_add_ps(minus_b, sqrt_disc), two_a);
+        __m256 const near_ok   = in_range(near, ray.l_min, ray.l_max);
+        __m256 const far_ok    = in_range(far, ray.l_min, ray.l_max);
+        __m256 const lambda    = _mm256_blendv_ps(far, near, near_ok);
+
+        // Dentro de un carril los índices crecen: a igual distancia gana el último
+        __m256 hit  = _mm256_and_ps(real, _mm256_cmp_ps(disc, zero, _CMP_GE_OQ));
+        hit         = _mm256_and_ps(hit, _mm256_or_ps(near_ok, far_ok));
+        hit         = _mm256_and_ps(hit, _mm256_cmp_ps(lambda, best_lambda, _CMP_LE_OQ));
+        best_lambda = _mm256_blendv_ps(best_lambda, lambda, hit);
+        best_index  = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(best_index),
+                                                           _mm256_castsi256_ps(index), hit));
+        index       = _mm256_add_epi32(index, eight);
+      }
+      return reduce_lanes(best_lambda, best_index, invalid);
+    }
+
+    /**
+     * @brief Núcleo AVX2: prueba el rayo contra 8 cilindros por iteración.
+     *
+     * Para cada carril se calculan los cuatro candidatos de hit_cylinder (cuerpo cercano,
+     * cuerpo lejano, tapa superior, tapa inferior) con las mismas operaciones, cada uno con
+     * su máscara de validez, y se reducen con mínimos enmascarados en el mismo orden en que
+     * hit_cylinder los acepta (a igual distancia gana el último). Así no hay ramas por
+     * cilindro y el resultado coincide bit a bit con el camino escalar.
+     */
+
+    [[gnu::target("avx2")]] SoAHit closest_cylinder_hit_avx2(CylinderSOA const & cylinders,
+                                                             KernelRay const & kray,
+                                                             float lambda_min,
+                                                             float lambda_max) noexcept {
+      KernelRay8 const ray  = broadcast(kray, lambda_min, lambda_max);
+      __m256 const dd       = _mm256_set1_ps(kray.dd);
+      __m256 const two      = _mm256_set1_ps(2.0F);
+      __m256 const four     = _mm256_set1_ps(4.F);
+      __m256 const zero     = _mm256_setzero_ps();
+      __m256 const infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+      __m256 const sign     = _mm256_set1_ps(-0.0F);
+      __m256 const body_eps = _mm256_set1_ps(body_epsilon);
+      __m256 const cap_eps  = _mm256_set1_ps(cap_epsilon);
+      __m256i const count   = _mm256_set1_epi32(static_cast<int>(cylinders.count));
+      __m256i const eight   = _mm256_set1_epi32(8);
+
+      __m256 best_lambda = infinity;
+      __m256i best_index = _mm256_set1_epi32(-1);
+      __m256i index      = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+      __m256 invalid     = zero;
+
+      for (std::size_t i = 0; i < cylinders.cx.size(); i += SceneSOA::lanes) {
+        __m256 const cx = _mm256_load_ps(&cylinders.cx[i]);
+        __m256 const cy = _mm256_load_ps(&cylinders.cy[i]);
+        __m256 const cz = _mm256_load_ps(&cylinders.cz[i]);
+        __m256 const ux = _mm256_load_ps(&cylinders.ux[i]);
+        __m256 const uy = _mm256_load_ps(&cylinders.uy[i]);
+        __m256 const uz = _mm256_load_ps(&cylinders.uz[i]);
+        __m256 const hh = _mm256_load_ps(&cylinders.half_height[i]);
+        __m256 const r2 = _mm256_load_ps(&cylinders.r_sq[i]);
+
+        // Cuerpo: A = d·d - (d·u)², B = 2(d·oc - (d·u)(oc·u)), C = oc·oc - (oc·u)² - r²
+        __m256 const ocx         = _mm256_sub_ps(ray.ox, cx);
+        __m256 const ocy         = _mm256_sub_ps(ray.oy, cy);
+        __m256 const ocz         = _mm256_sub_ps(ray.oz, cz);
+        __m256 const dr_dot_axis = dot8(ray.dx, ray.dy, ray.dz, ux, uy, uz);
+        __m256 const oc_dot_axis = dot8(ocx, ocy, ocz, ux, uy, uz);
+        __m256 const a           = _mm256_sub_ps(dd, _mm256_mul_ps(dr_dot_axis, dr_dot_axis));
+        __m256 const b           = _mm256_mul_ps(
+            two, _mm256_sub_ps(dot8(ray.dx, ray.dy, ray.dz, ocx, ocy, ocz),
+                               _mm256_mul_ps(dr_dot_axis, oc_dot_axis)));
+        __m256 const c = _mm256_sub_ps(
+            _mm256_sub_ps(dot8(ocx, ocy, ocz, ocx, ocy, ocz),
+                          _mm256_mul_ps(oc_dot_axis, oc_dot_axis)),
+            r2);
+        __m256 const disc = _mm256_sub_ps(_mm256_mul_ps(b, b),
+                                          _mm256_mul_ps(_mm256_mul_ps(four, a), c));
+
+        __m256 const real   = _mm256_castsi256_ps(_mm256_cmpgt_epi32(count, index));
+        __m256 const finite = _mm256_cmp_ps(abs8(disc), infinity, _CMP_LT_OQ);
+        invalid             = _mm256_or_ps(invalid, _mm256_andnot_ps(finite, real));
+
+        __m256 const body_ok = _mm256_and_ps(_mm256_cmp_ps(disc, zero, _CMP_GE_OQ),
+                                             _mm256_cmp_ps(abs8(a), body_eps, _CMP_GT_OQ));
+        __m256 const sqrt_disc = _mm256_sqrt_ps(disc);
+        __m256 const minus_b   = _mm256_xor_ps(b, sign);
+        __m256 const two_a     = _mm256_mul_ps(two, a);
+
+        // Cada candidato se acepta si cae en [lambda_min, mejor hasta ahora]
+        __m256 best = ray.l_max;
+        __m256 hit  = zero;
+        for (__m256 const lambda : {_mm256_div_ps(_mm256_sub_ps(minus_b, sqrt_disc), two_a),
+                                    _mm256_div_ps(_mm256_add_ps(minus_b, sqrt_disc), two_a)})
+        {
+          // Altura del punto de impacto sobre el eje: (Q - C)·u con Q = O + λd
+          __m256 const height = dot8(offset8(ray.ox, ray.dx, lambda, cx),
+                                     offset8(ray.oy, ray.dy, lambda, cy),
+                                     offset8(ray.oz, ray.dz, lambda, cz), ux, uy, uz);
+          __m256 ok = _mm256_and_ps(body_ok, in_range(lambda, ray.l_min, best));
+          ok        = _mm256_and_ps(ok, _mm256_cmp_ps(abs8(height), hh, _CMP_LE_OQ));
+          best      = _mm256_blendv_ps(best, lambda, ok);
+          hit       = _mm256_or_ps(hit, ok);
+        }
+
+        // Tapas: λ = (P - O)·u / (d·u); el impacto vale si |Q - P|² <= r². Con la normal -u
+        // de la tapa inferior numerador y denominador cambian de signo y λ es la misma.
+        __m256 const cap_ok = _mm256_cmp_ps(abs8(dr_dot_axis), cap_eps, _CMP_GE_OQ);
+        std::array<std::array<float const *, 3>, 2> const caps{
+            {{&cylinders.top_x[i], &cylinders.top_y[i], &cylinders.top_z[i]},
+             {&cylinders.bottom_x[i], &cylinders.bottom_y[i], &cylinders.bottom_z[i]}}};
+        for (auto const & cap : caps) {
+          __m256 const px     = _mm256_load_ps(cap[0]);
+          __m256 const py     = _mm256_load_ps(cap[1]);
+          __m256 const pz     = _mm256_load_ps(cap[2]);
+          __m256 const to_cap = dot8(_mm256_sub_ps(px, ray.ox), _mm256_sub_ps(py, ray.oy),
+                                     _mm256_sub_ps(pz, ray.oz), ux, uy, uz);
+          __m256 const lambda = _mm256_div_ps(to_cap, dr_dot_axis);
+          __m256 const qx     = offset8(ray.ox, ray.dx, lambda, px);
+          __m256 const qy     = offset8(ray.oy, ray.dy, lambda, py);
+          __m256 const qz     = offset8(ray.oz, ray.dz, lambda, pz);
+          __m256 ok = _mm256_and_ps(cap_ok, in_range(lambda, ray.l_min, best));
+          ok   = _mm256_and_ps(ok, _mm256_cmp_ps(dot8(qx, qy, qz, qx, qy, qz), r2, _CMP_LE_OQ));
+          best = _mm256_blendv_ps(best, lambda, ok);
+          hit  = _mm256_or_ps(hit, ok);
+        }
+
+        hit         = _mm256_and_ps(hit, real);
+        hit         = _mm256_and_ps(hit, _mm256_cmp_ps(best, best_lambda, _CMP_LE_OQ));
+        best_lambda = _mm256_blendv_ps(best_lambda, best, hit);
+        best_index  = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(best_index),
+                                                           _mm256_castsi256_ps(index), hit));
+        index       = _mm256_add_epi32(index, eight);
+      }
+      return reduce_lanes(best_lambda, best_index, invalid);
+    }
+
+#endif
+
+    std::size_t padded_size(std::size_t count) noexcept {
+      return (count + SceneSOA::lanes - 1) / SceneSOA::lanes * SceneSOA::lanes;
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Copia los objetos preparados de la escena en arrays alineados por componente.
+   *
+   * Los huecos de relleno valen 0, pero los núcleos los descartan por índice, así que
+   * nunca producen impactos. Los cilindros conservan el eje unitario, la media altura, el
+   * radio al cuadrado y los centros de las tapas que calculó prepare_scene.
+   *
+   * @param scene Escena con los objetos ya preparados (prepare_scene).
+   * @return Objetos en formato SoA.
+   */
+
+  SceneSOA make_scene_soa(Scene const & scene) {
+    SceneSOA soa;
+
+    SphereSOA & spheres      = soa.spheres;
+    spheres.count            = scene.prepared.spheres.size();
+    std::size_t const padded = padded_size(spheres.count);
+    for (auto * array : {&spheres.cx, &spheres.cy, &spheres.cz, &spheres.r_sq}) {
+      array->assign(padded, 0.0F);
+    }
+    spheres.material.reserve(spheres.count);
+    for (std::size_t i = 0; i < spheres.count; ++i) {
+      PreparedSphere const & s = scene.prepared.spheres[i];
+      spheres.cx[i]            = s.center.x();
+      spheres.cy[i]            = s.center.y();
+      spheres.cz[i]            = s.center.z();
+      spheres.r_sq[i]          = s.radius_sq;
+      spheres.material.push_back(s.material_id);
+    }
+
+    CylinderSOA & cylinders      = soa.cylinders;
+    cylinders.count              = scene.prepared.cylinders.size();
+    std::size_t const cyl_padded = padded_size(cylinders.count);
+    for (auto * array : {&cylinders.cx, &cylinders.cy, &cylinders.cz, &cylinders.ux,
+                         &cylinders.uy, &cylinders.uz, &cylinders.half_height, &cylinders.r_sq,
+                         &cylinders.top_x, &cylinders.top_y, &cylinders.top_z,
+                         &cylinders.bottom_x, &cylinders.bottom_y, &cylinders.bottom_z})
+    {
+      array->assign(cyl_padded, 0.0F);
+    }
+    cylinders.material.reserve(cylinders.count);
+    for (std::size_t i = 0; i < cylinders.count; ++i) {
+      PreparedCylinder const & c = scene.prepared.cylinders[i];
+      cylinders.cx[i]            = c.center.x();
+      cylinders.cy[i]            = c.center.y();
+      cylinders.cz[i]            = c.center.z();
+      cylinders.ux[i]            = c.axis.x();
+      cylinders.uy[i]            = c.axis.y();
+      cylinders.uz[i]            = c.axis.z();
+      cylinders.half_height[i]   = c.half_height;
+      cylinders.r_sq[i]          = c.radius_sq;
+      cylinders.top_x[i]         = c.top.x();
+      cylinders.top_y[i]         = c.top.y();
+      cylinders.top_z[i]         = c.top.z();
+      cylinders.bottom_x[i]      = c.bottom.x();
+      cylinders.bottom_y[i]      = c.bottom.y();
+      cylinders.bottom_z[i]      = c.bottom.z();
+      cylinders.material.push_back(c.material_id);
+    }
+    return soa;
+  }
+
+  /**
+   * @brief Esfera más cercana al origen del rayo dentro de [lambda_min, lambda_max].
+   *
+   * @param soa Objetos en formato SoA.
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return Impacto más cercano (index = SoAHit::none si no hay ninguno).
+   */
+
+  SoAHit closest_sphere_hit(SceneSOA const & soa, Ray const & r, float lambda_min,
+                            float lambda_max) noexcept {
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+      return closest_sphere_hit_avx2(soa.spheres, prepare_ray(r), lambda_min, lambda_max);
+    }
+#endif
+    return closest_sphere_hit_scalar(soa, r, lambda_min, lambda_max);
+  }
+
+  /**
+   * @brief Cilindro más cercano al origen del rayo dentro de [lambda_min, lambda_max].
+   *
+   * @param soa Objetos en formato SoA.
+   * @param r Rayo lanzado.
+   * @param lambda_min Límite inferior del rango válido.
+   * @param lambda_max Límite superior del rango válido.
+   * @return Impacto más cercano (index = SoAHit::none si no hay ninguno).
+   */
+
+  SoAHit closest_cylinder_hit(SceneSOA const & soa, Ray const & r, float lambda_min,
+                              float lambda_max) noexcept {
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+      return closest_cylinder_hit_avx2(soa.cylinders, prepare_ray(r), lambda_min, lambda_max);
+    }
+#endif
+    return closest_cylinder_hit_scalar(soa, r, lambda_min, lambda_max);
+  }
+
+  /**
+   * @brief Versión escalar de closest_sphere_hit, con los mismos cálculos que hit_sphere.
+   */
+
+  SoAHit closest_sphere_hit_scalar(SceneSOA const & soa, Ray const & r, float lambda_min,
+                                   float lambda_max) noexcept {
+    SphereSOA const & spheres = soa.spheres;
+    KernelRay const ray       = prepare_ray(r);
+    SoAHit best;
+    for (std::size_t i = 0; i < spheres.count; ++i) {
+      float const rcx          = ray.ox - spheres.cx[i];
+      float const rcy          = ray.oy - spheres.cy[i];
+      float const rcz          = ray.oz - spheres.cz[i];
+      float const b            = 2.0F * (rcx * ray.dx + rcy * ray.dy + rcz * ray.dz);
+      float const c            = (rcx * rcx + rcy * rcy + rcz * rcz) - spheres.r_sq[i];
+      float const discriminant = b * b - ray.four_a * c;
+      if (std::isnan(discriminant) or std::isinf(discriminant)) {
+        best.invalid = true;
+        continue;
+      }
+      if (discriminant < 0.F) {
+        continue;
+      }
+      float const sqrt_discriminant = std::sqrt(discriminant);
+      float lambda                  = (-b - sqrt_discriminant) / ray.two_a;
+      if (lambda < lambda_min or lambda > lambda_max) {
+        lambda = (-b + sqrt_discriminant) / ray.two_a;
+        if (lambda < lambda_min or lambda > lambda_max) {
+          continue;
+        }
+      }
+      keep_closest(best, lambda, static_cast<uint32_t>(i));
+    }
+    return best;
+  }
+
+  /**
+   * @brief Versión escalar de closest_cylinder_hit, con los mismos cálculos que hit_cylinder.
+   */
+
+  SoAHit closest_cylinder_hit_scalar(SceneSOA const & soa, Ray const & r, float lambda_min,
+                                     float lambda_max) noexcept {
+    CylinderSOA const & cyl = soa.cylinders;
+    KernelRay const ray     = prepare_ray(r);
+    SoAHit best;
+    for (std::size_t i = 0; i < cyl.count; ++i) {
+      float const ocx          = ray.ox - cyl.cx[i];
+      float const ocy          = ray.oy - cyl.cy[i];
+      float const ocz          = ray.oz - cyl.cz[i];
+      float const dr_dot_axis  = ray.dx * cyl.ux[i] + ray.dy * cyl.uy[i] + ray.dz * cyl.uz[i];
+      float const oc_dot_axis  = ocx * cyl.ux[i] + ocy * cyl.uy[i] + ocz * cyl.uz[i];
+      float const a            = ray.dd - dr_dot_axis * dr_dot_axis;
+      float const b            = 2.0F * ((ray.dx * ocx + ray.dy * ocy + ray.dz * ocz) -
+                                         dr_dot_axis * oc_dot_axis);
+      float const c            = (ocx * ocx + ocy * ocy + ocz * ocz) -
+                                 oc_dot_axis * oc_dot_axis - cyl.r_sq[i];
+      float const discriminant = b * b - 4.F * a * c;
+      if (std::isnan(discriminant) or std::isinf(discriminant)) {
+        best.invalid = true;
+        continue;
+      }
+
+      float closest = lambda_max;
+      bool hit      = false;
+      if (discriminant >= 0.F and std::fabs(a) > body_epsilon) {
+        float const sqrt_discriminant = std::sqrt(discriminant);
+        for (float const lambda :
+             {(-b - sqrt_discriminant) / (2.0F * a), (-b + sqrt_discriminant) / (2.0F * a)})
+        {
+          float const qx     = (ray.ox + lambda * ray.dx) - cyl.cx[i];
+          float const qy     = (ray.oy + lambda * ray.dy) - cyl.cy[i];
+          float const qz     = (ray.oz + lambda * ray.dz) - cyl.cz[i];
+          float const height = qx * cyl.ux[i] + qy * cyl.uy[i] + qz * cyl.uz[i];
+          if (std::fabs(height) <= cyl.half_height[i] and lambda >= lambda_min and
+              lambda <= closest)
+          {
+            closest = lambda;
+            hit     = true;
+          }
+        }
+      }
+      if (std::fabs(dr_dot_axis) >= cap_epsilon) {
+        std::array<std::array<float, 3>, 2> const caps{
+            {{cyl.top_x[i], cyl.top_y[i], cyl.top_z[i]},
+             {cyl.bottom_x[i], cyl.bottom_y[i], cyl.bottom_z[i]}}};
+        for (auto const & cap : caps) {
+          float const to_cap = (cap[0] - ray.ox) * cyl.ux[i] + (cap[1] - ray.oy) * cyl.uy[i] +
+                               (cap[2] - ray.oz) * cyl.uz[i];
+          float const lambda = to_cap / dr_dot_axis;
+          float const qx     = (ray.ox + lambda * ray.dx) - cap[0];
+          float const qy     = (ray.oy + lambda * ray.dy) - cap[1];
+          float const qz     = (ray.oz + lambda * ray.dz) - cap[2];
+          if (qx * qx + qy * qy + qz * qz <= cyl.r_sq[i] and lambda >= lambda_min and
+              lambda <= closest)
+          {
+            closest = lambda;
+            hit     = true;
+          }
+        }
+      }
+      if (hit) {
+        keep_closest(best, closest, static_cast<uint32_t>(i));
+      }
+    }
+    return best;
+  }
+
+}  // namespace render
@@ -0,0 +1,191 @@
+/**
+ * @file streaming_image.cpp
+ * @brief Imagen que se codifica y se escribe por filas mientras se renderiza.
+ *
+ * Con ImageAOS o ImageSOA, la imagen completa se guarda al final del render, y su
+ * formateo y escritura no se solapan con el trazado de rayos. StreamingImage guarda solo un
+ * anillo de filas: los hilos de render pintan en él y un hilo escritor vuelca cada fila en
+ * cuanto está terminada, en el orden del archivo. Así la escritura coincide con el render y
+ * la memoria no depende del alto de la imagen.
+ */
+
+#include "../include/streaming_image.hpp"
+#include "../include/ppm_writer.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace render {
+
+  namespace {
+
+    // Solo P3 y P6 se pueden escribir fila a fila (QOI y PNG se codifican en bloques)
+    ImageFormat streamable_format(ImageFormat format) {
+      if (format != ImageFormat::p3 and format != ImageFormat::p6) {
+        throw std::runtime_error("Error: streaming output only supports P3 and P6");
+      }
+      return format;
+    }
+
+  }  // namespace
+
+  /**
+   * @brief Abre el archivo de salida, escribe la cabecera y arranca el hilo escritor.
+   *
+   * @param filename Ruta del archivo de salida.
+   * @param w Ancho en píxeles.
+   * @param h Alto en píxeles.
+   * @param format P3 o P6.
+   * @param buffer_rows Filas del anillo (se limita a [1, h]).
+   * @throws std::runtime_error Si el formato no es P3 ni P6 o no se puede abrir el archivo.
+   */
+
+  StreamingImage::StreamingImage(std::string const & filename, int w, int h, ImageFormat format,
+                                 int buffer_rows)
+      : width{w}, height{h}, m_filename{filename}, m_format{streamable_format(format)},
+        m_row_pixels{static_cast<std::size_t>(std::max(w, 1))},
+        m_buffer_rows{static_cast<std::size_t>(std::clamp(buffer_rows, 1, std::max(h, 1)))},
+        m_rows(m_buffer_rows * m_row_pixels * 3), m_row_done(m_buffer_rows, 0),
+        m_out(filename, std::ios::binary) {
+    if (!m_out.is_open()) {
+      throw std::runtime_error("Error: cannot open output file: " + filename);
+    }
+    write_ppm_header(m_out, width, height, m_format);
+    m_writer = std::thread([this] { writer_loop(); });
+  }
+
+  /**
+   * @brief Detiene el hilo escritor si finish no llegó a llamarse.
+   */
+
+  StreamingImage::~StreamingImage() {
+    if (m_writer.joinable()) {
+      abort();
+      m_writer.join();
+    }
+  }
+
+  /**
+   * @brief Aborta el render: detiene el escritor y despierta a los hilos de begin_rows.
+   */
+
+  void StreamingImage::abort() {
+    {
+      std::scoped_lock const lock(m_mutex);
+      m_stop = true;
+    }
+    m_row_ready.notify_one();
+    m_row_written.notify_all();
+  }
+
+  /**
+   * @brief Espera a que las filas [y0, y1) quepan en el anillo.
+   *
+   * Una fila cabe cuando la que ocupaba su hueco ya está en el archivo.
+   *
+   * @param y0 Primera fila.
+   * @param y1 Fila siguiente a la última.
+   * @throws std::runtime_error Si las filas no caben en el anillo ni vacío, o si el render
+   * se abortó.
+   */
+
+  void StreamingImage::begin_rows(int y0, int y1) {
+    if (static_cast<std::size_t>(y1 - y0) > m_buffer_rows) {
+      throw std::runtime_error("Error: streaming buffer has fewer rows than a tile");
+    }
+    std::unique_lock lock(m_mutex);
+    m_row_written.wait(lock, [&] {
+      return m_stop or static_cast<std::size_t>(y1) <= static_cast<std::size_t>(m_written) +
+                                                           m_buffer_rows;
+    });
+    if (m_stop) {
+      throw std::runtime_error("Error: streaming render aborted");
+    }
+  }
+
+  /**
+   * @brief Cuenta como terminados los píxeles de una región y despierta al escritor.
+   *
+   * @param x0 Primera columna.
+   * @param y0 Primera fila.
+   * @param x1 Columna siguiente a la última.
+   * @param y1 Fila siguiente a la última.
+   */
+
+  void StreamingImage::finish_region(int x0, int y0, int x1, int y1) {
+    {
+      std::scoped_lock const lock(m_mutex);
+      for (int y = y0; y < y1; ++y) {
+        m_row_done[static_cast<std::size_t>(y) % m_buffer_rows] += x1 - x0;
+      }
+    }
+    m_row_ready.notify_one();
+  }
+
+  /**
+   * @brief Espera al hilo escritor y cierra el archivo.
+   *
+   * Debe llamarse cuando el render ha terminado todas las filas.
+   *
+   * @throws std::runtime_error Si falló alguna escritura.
+   */
+
+  void StreamingImage::finish() {
+    if (m_writer.joinable()) {
+      m_writer.join();
+    }
+    m_out.close();
+    if (m_out.fail()) {
+      throw std::runtime_error("Error: cannot write output file: " + m_filename);
+    }
+    std::cout << "Image saved to " << m_filename << '\n';
+  }
+
+  /**
+   * @brief Bucle del hilo escritor: escribe las filas en orden según se completan.
+   *
+   * La fila se codifica y se escribe sin el cerrojo; nadie la modifica mientras tanto,
+   * porque su hueco del anillo no se reutiliza hasta que m_written avanza.
+   */
+
+  void StreamingImage::writer_loop() {
+    std::vector<char> text;
+    if (m_format == ImageFormat::p3) {
+      text.resize(m_row_pixels * ppm_text_max_pixel_bytes + 4);
+    }
+
+    for (int y = 0; y < height; ++y) {
+      std::size_t const slot = static_cast<std::size_t>(y) % m_buffer_rows;
+      {
+        std::unique_lock lock(m_mutex);
+        m_row_ready.wait(lock, [&] { return m_stop or m_row_done[slot] >= width; });
+        if (m_stop) {
+          return;
+        }
+      }
+
+      std::uint8_t const * row = m_rows.data() + slot * m_row_pixels * 3;
+      auto const pixels        = static_cast<std::size_t>(width);
+      if (m_format == ImageFormat::p6) {
+        m_out.write(reinterpret_cast<char const *>(row), static_cast<std::streamsize>(3 * pixels));
+      } else {
+        std::size_t const size = encode_ppm_text(row, pixels, text.data());
+        m_out.write(text.data(), static_cast<std::streamsize>(size));
+      }
+
+      {
+        std::scoped_lock const lock(m_mutex);
+        m_row_done[slot] = 0;
+        ++m_written;
+      }
+      m_row_written.notify_all();
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,134 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementa el pool de hilos usado por el bucle de render en paralelo.
+ *
+ * Los hilos trabajadores se crean una sola vez y esperan a que se publique un nuevo
+ * trabajo. Cada trabajo es un rango de índices que se reparte con un contador atómico,
+ * de forma que las teselas más costosas no dejan hilos ociosos.
+ */
+
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+
+namespace render {
+
+  /**
+   * @brief Traduce el valor de configuración "threads:" al número de hilos a lanzar.
+   * @param requested Hilos pedidos (0 significa usar todos los núcleos).
+   * @return Número de hilos, siempre mayor o igual que 1.
+   */
+
+  int resolve_thread_count(int requested) noexcept {
+    if (requested > 0) {
+      return requested;
+    }
+    unsigned const hw = std::thread::hardware_concurrency();
+    return std::max(1, static_cast<int>(hw));
+  }
+
+  /**
+   * @brief Crea el pool con num_threads - 1 trabajadores (el hilo llamante también trabaja).
+   * @param num_threads Número total de hilos (0 = todos los núcleos disponibles).
+   */
+
+  ThreadPool::ThreadPool(int num_threads) {
+    int const total = resolve_thread_count(num_threads);
+    m_workers.reserve(static_cast<std::size_t>(total - 1));
+    for (int i = 1; i < total; ++i) {
+      m_workers.emplace_back([this] { worker_loop(); });
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::scoped_lock const lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv_start.notify_all();
+    for (auto & worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief Consume índices del trabajo actual hasta agotarlos.
+   *
+   * Si una tarea lanza una excepción se guarda la primera y se agota el contador para
+   * que el resto de hilos terminen cuanto antes.
+   */
+
+  void ThreadPool::drain() {
+    while (true) {
+      std::size_t const i = m_next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= m_count) {
+        return;
+      }
+      try {
+        (*m_task)(i);
+      } catch (...) {
+        std::scoped_lock const lock(m_mutex);
+        if (!m_error) {
+          m_error = std::current_exception();
+        }
+        m_next.store(m_count, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void ThreadPool::worker_loop() {
+    std::size_t seen_generation = 0;
+    while (true) {
+      {
+        std::unique_lock lock(m_mutex);
+        m_cv_start.wait(lock, [&] { return m_stop or m_generation != seen_generation; });
+        if (m_stop) {
+          return;
+        }
+        seen_generation = m_generation;
+      }
+      drain();
+      {
+        std::scoped_lock const lock(m_mutex);
+        if (--m_active == 0) {
+          m_cv_done.notify_one();
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Reparte task(0) ... task(count - 1) entre todos los hilos del pool.
+   * @param count Número de índices a procesar.
+   * @param task Función a ejecutar para cada índice.
+   * @throws Relanza la primera excepción producida por cualquiera de las tareas.
+   */
+
+  void ThreadPool::parallel_for(std::size_t count, std::function<void(std::size_t)> const & task) {
+    if (count == 0) {
+      return;
+    }
+    {
+      std::scoped_lock const lock(m_mutex);
+      m_task   = &task;
+      m_count  = count;
+      m_active = static_cast<int>(m_workers.size());
+      m_error  = nullptr;
+      m_next.store(0, std::memory_order_relaxed);
+      ++m_generation;
+    }
+    m_cv_start.notify_all();
+    drain();
+
+    std::exception_ptr error;
+    {
+      std::unique_lock lock(m_mutex);
+      m_cv_done.wait(lock, [&] { return m_active == 0; });
+      m_task = nullptr;
+      error  = m_error;
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+}  // namespace render
@@ -0,0 +1,291 @@
+/**
+ * @file tone_map.cpp
+ * @brief Paso de corrección gamma y cuantización de un framebuffer HDR a bytes.
+ *
+ * Al renderizar en 8 bits, cada píxel hace tres std::pow y se cuantiza en write_color. Con
+ * un framebuffer float el render guarda la radiancia lineal y este paso la convierte
+ * después, por bloques de filas en paralelo. La conversión usa una tabla de umbrales: como
+ * pow es creciente, el byte de un valor es el número de umbrales que no lo superan, y se
+ * encuentra en 8 pasos de búsqueda binaria. Con AVX2 se procesan 8 valores a la vez con
+ * gathers sobre la tabla.
+ *
+ * También están aquí las funciones que cuantizan colores ya corregidos, que usan las
+ * imágenes de 8 bits para escribir filas enteras (write_span): en grupos de 8 valores con
+ * AVX2 y, para los planos de ImageSOA, separando los canales con gathers de paso 3.
+ */
+
+#include "../include/tone_map.hpp"
+#include "../include/simd.hpp"
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+
+#if defined(__x86_64__)
+  #include <immintrin.h>
+#endif
+
+namespace render {
+
+  namespace {
+
+    // Filas de cada bloque de parallel_rows
+    constexpr int rows_per_block = 16;
+
+#if defined(__x86_64__)
+
+    /**
+     * @brief Convierte grupos de 8 valores con AVX2.
+     *
+     * @return Número de valores convertidos (múltiplo de 8); el resto queda para el bucle
+     * escalar.
+     */
+
+    [[gnu::target("avx2")]] std::size_t apply_avx2(float const * thresholds, float const * in,
+                                                   std::uint8_t * out, std::size_t n) noexcept {
+      std::size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 const value = _mm256_loadu_ps(in + i);
+        __m256i byte       = _mm256_setzero_si256();
+        for (int step = 128; step > 0; step >>= 1) {
+          __m256i const candidate = _mm256_add_epi32(byte, _mm256_set1_epi32(step));
+          __m256 const threshold  = _mm256_i32gather_ps(thresholds, candidate, 4);
+          __m256 const below      = _mm256_cmp_ps(threshold, value, _CMP_LE_OQ);
+          byte = _mm256_add_epi32(
+              byte, _mm256_and_si256(_mm256_castps_si256(below), _mm256_set1_epi32(step)));
+        }
+        __m128i const words = _mm_packus_epi32(_mm256_castsi256_si128(byte),
+                                               _mm256_extracti128_si256(byte, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(words, words));
+      }
+      _mm256_zeroupper();
+      return i;
+    }
+
+    // Bytes de 8 valores: clamp a [0, 1] (max_ps da 0 con NaN), escala y trunca como
+    // static_cast, y empaqueta los 8 enteros en los 8 bytes bajos
+    [[gnu::target("avx2")]] inline __m128i quantize8(__m256 value) noexcept {
+      value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0F));
+      __m256i const ints  = _mm256_cvttps_epi32(_mm256_mul_ps(value, _mm256_set1_ps(255.0F)));
+      __m128i const words = _mm_packus_epi32(_mm256_castsi256_si128(ints),
+                                             _mm256_extracti128_si256(ints, 1));
+      return _mm_packus_epi16(words, words);
+    }
+
+    /**
+     * @brief Cuantiza grupos de 8 valores con AVX2.
+     *
+     * @return Número de valores convertidos (múltiplo de 8).
+     */
+
+    [[gnu::target("avx2")]] std::size_t quantize_avx2(float const * in, std::uint8_t * out,
+                                                      std::size_t n) noexcept {
+      std::size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i),
+                         quantize8(_mm256_loadu_ps(in + i)));
+      }
+      _mm256_zeroupper();
+      return i;
+    }
+
+    /**
+     * @brief Cuantiza y separa en planos grupos de 8 píxeles con AVX2.
+     *
+     * Cada canal se lee con un gather de paso 3 sobre los 24 floats del grupo.
+     *
+     * @return Número de píxeles convertidos (múltiplo de 8).
+     */
+
+    [[gnu::target("avx2")]] std::size_t quantize_planar_avx2(float const * rgb, std::uint8_t * r,
+                                                             std::uint8_t * g, std::uint8_t * b,
+                                                             std::size_t n) noexcept {
+      __m256i const stride3 = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+      std::size_t i         = 0;
+      for (; i + 8 <= n; i += 8) {
+        float const * const block = rgb + 3 * i;
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(r + i),
+                         quantize8(_mm256_i32gather_ps(block, stride3, 4)));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(g + i),
+                         quantize8(_mm256_i32gather_ps(block + 1, stride3, 4)));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(b + i),
+                         quantize8(_mm256_i32gather_ps(block + 2, stride3, 4)));
+      }
+      _mm256_zeroupper();
+      return i;
+    }
+
+#endif
+
+  }  // namespace
+
+  /**
+   * @brief Byte de un valor lineal con la expresión de store_pixel y write_color.
+   *
+   * @param value Valor lineal de un canal.
+   * @param inv_gamma Inverso de la gamma.
+   * @return (uint8) clamp(pow(value, inv_gamma), 0, 1) * 255; 0 si el resultado es NaN.
+   */
+
+  std::uint8_t gamma_byte(float value, float inv_gamma) noexcept {
+    return quantize_byte(std::pow(value, inv_gamma));
+  }
+
+  /**
+   * @brief Byte de un color ya corregido con la expresión de write_color.
+   *
+   * @param value Valor de un canal con la gamma aplicada.
+   * @return (uint8) clamp(value, 0, 1) * 255; 0 si value es NaN.
+   */
+
+  std::uint8_t quantize_byte(float value) noexcept {
+    float const clamped = std::clamp(value, 0.0F, 1.0F);
+    if (std::isnan(clamped)) {
+      return 0;
+    }
+    return static_cast<std::uint8_t>(clamped * 255.0F);
+  }
+
+  /**
+   * @brief Cuantiza n valores seguidos.
+   *
+   * @param in Valores con la gamma aplicada.
+   * @param out Destino de n bytes.
+   * @param n Número de valores.
+   */
+
+  void quantize(float const * in, std::uint8_t * out, std::size_t n) noexcept {
+    std::size_t done = 0;
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+      done = quantize_avx2(in, out, n);
+    }
+#endif
+    for (std::size_t i = done; i < n; ++i) {
+      out[i] = quantize_byte(in[i]);
+    }
+  }
+
+  /**
+   * @brief Cuantiza n píxeles entrelazados en tres planos.
+   *
+   * @param rgb Píxeles (r, g, b) con la gamma aplicada, 3 * n floats.
+   * @param r Plano rojo de destino (n bytes).
+   * @param g Plano verde de destino.
+   * @param b Plano azul de destino.
+   * @param n Número de píxeles.
+   */
+
+  void quantize_planar(float const * rgb, std::uint8_t * r, std::uint8_t * g, std::uint8_t * b,
+                       std::size_t n) noexcept {
+    std::size_t done = 0;
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+      done = quantize_planar_avx2(rgb, r, g, b, n);
+    }
+#endif
+    for (std::size_t i = done; i < n; ++i) {
+      r[i] = quantize_byte(rgb[3 * i]);
+      g[i] = quantize_byte(rgb[3 * i + 1]);
+      b[i] = quantize_byte(rgb[3 * i + 2]);
+    }
+  }
+
+  /**
+   * @brief Calcula los umbrales de cada byte.
+   *
+   * El umbral de k es el menor float no negativo cuyo byte es k o más. Se busca por
+   * bisección sobre la representación del float, que para valores positivos crece con el
+   * valor.
+   *
+   * @param inv_gamma Inverso de la gamma.
+   */
+
+  GammaTable::GammaTable(float inv_gamma) {
+    m_thresholds[0] = -std::numeric_limits<float>::infinity();
+    for (std::size_t k = 1; k < m_thresholds.size(); ++k) {
+      std::uint32_t lo = 0;  // 0.0F
+      std::uint32_t hi = std::bit_cast<std::uint32_t>(std::numeric_limits<float>::infinity());
+      while (lo < hi) {
+        std::uint32_t const mid = lo + (hi - lo) / 2;
+        if (gamma_byte(std::bit_cast<float>(mid), inv_gamma) >= k) {
+          hi = mid;
+        } else {
+          lo = mid + 1;
+        }
+      }
+      m_thresholds[k] = std::bit_cast<float>(lo);
+    }
+  }
+
+  /**
+   * @brief Byte de un valor: cuántos umbrales (sin contar el 0) no lo superan.
+   */
+
+  std::uint8_t GammaTable::operator()(float value) const noexcept {
+    unsigned byte = 0;
+    for (unsigned step = 128; step > 0; step >>= 1) {
+      byte += m_thresholds[byte + step] <= value ? step : 0;
+    }
+    return static_cast<std::uint8_t>(byte);
+  }
+
+  /**
+   * @brief Convierte n valores lineales a bytes.
+   *
+   * @param in Valores lineales.
+   * @param out Destino de n bytes.
+   * @param n Número de valores.
+   */
+
+  void GammaTable::apply_scalar(float const * in, std::uint8_t * out,
+                                std::size_t n) const noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+      out[i] = (*this)(in[i]);
+    }
+  }
+
+  /**
+   * @brief Convierte n valores lineales a bytes con AVX2 si la CPU lo admite.
+   *
+   * @param in Valores lineales.
+   * @param out Destino de n bytes.
+   * @param n Número de valores.
+   */
+
+  void GammaTable::apply(float const * in, std::uint8_t * out, std::size_t n) const noexcept {
+    std::size_t done = 0;
+#if defined(__x86_64__)
+    if (simd::cpu_has_avx2()) {
+      done = apply_avx2(m_thresholds.data(), in, out, n);
+    }
+#endif
+    apply_scalar(in + done, out + done, n - done);
+  }
+
+  /**
+   * @brief Reparte bloques de rows_per_block filas entre un pool de hilos.
+   *
+   * @param height Filas de la imagen.
+   * @param threads Hilos (0 = todos los núcleos).
+   * @param body Función llamada con las filas [y0, y1) de cada bloque.
+   */
+
+  void parallel_rows(int height, int threads, std::function<void(int, int)> const & body) {
+    if (height <= 0) {
+      return;
+    }
+    auto const blocks = static_cast<std::size_t>((height + rows_per_block - 1) / rows_per_block);
+    ThreadPool pool(static_cast<int>(
+        std::min(static_cast<std::size_t>(resolve_thread_count(threads)), blocks)));
+    pool.parallel_for(blocks, [&](std::size_t block) {
+      int const y0 = static_cast<int>(block) * rows_per_block;
+      body(y0, std::min(y0 + rows_per_block, height));
+    });
+  }
+
+}  // namespace render
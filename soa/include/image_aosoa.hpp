@@ -0,0 +1,108 @@
+#pragma once
+#include "huge_page_allocator.hpp"
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // ImageAoSoA: bloques de 8 píxeles con sus canales separados (8 bytes r, 8 g, 8 b). Cada
+  // fila empieza en un bloque nuevo (la última se rellena), así que las teselas con ancho
+  // múltiplo de 8 no comparten bloques. write_span escribe cada bloque completo con un
+  // grupo AVX2 de quantize_planar. Un bloque ocupa 24 bytes, así que dos teselas vecinas
+  // de la misma fila sí pueden compartir la línea de caché de su borde (salvo con anchos
+  // múltiplos de 64 píxeles): rellenar cada bloque hasta 64 bytes casi triplicaría la
+  // memoria que se escribe.
+  class ImageAoSoA {
+  public:
+    static constexpr size_t block_pixels = 8;
+
+    // === Dimensiones de la imagen ===
+    int width{};
+    int height{};
+
+    // === Constructor ===
+    explicit ImageAoSoA(int w, int h)
+        : width(w), height(h),
+          m_blocks_x((static_cast<size_t>(w) + block_pixels - 1) / block_pixels),
+          m_data(m_blocks_x * static_cast<size_t>(h) * block_pixels * 3) { }
+
+    void set_r(size_t idx, std::uint8_t r) noexcept { m_data[offset(idx)] = r; }
+
+    void set_g(size_t idx, std::uint8_t g) noexcept { m_data[offset(idx) + block_pixels] = g; }
+
+    void set_b(size_t idx, std::uint8_t b) noexcept {
+      m_data[offset(idx) + 2 * block_pixels] = b;
+    }
+
+    // === Escribe n píxeles de la fila y desde x0 (rgb entrelazado, gamma aplicada) ===
+    // Cada tramo dentro de un bloque se cuantiza y separa en sus tres canales de una vez.
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      auto x         = static_cast<size_t>(x0);
+      auto const end = x + static_cast<size_t>(n);
+      while (x < end) {
+        size_t const count = std::min(end, (x / block_pixels + 1) * block_pixels) - x;
+        std::uint8_t * const r = m_data.data() + offset(x, static_cast<size_t>(y));
+        quantize_planar(rgb, r, r + block_pixels, r + 2 * block_pixels, count);
+        rgb += 3 * count;
+        x   += count;
+      }
+    }
+
+    [[nodiscard]] uint8_t get_r(size_t idx) const noexcept { return m_data[offset(idx)]; }
+
+    [[nodiscard]] uint8_t get_g(size_t idx) const noexcept {
+      return m_data[offset(idx) + block_pixels];
+    }
+
+    [[nodiscard]] uint8_t get_b(size_t idx) const noexcept {
+      return m_data[offset(idx) + 2 * block_pixels];
+    }
+
+    // === Copia la imagen en orden de filas, entrelazando cada bloque ===
+    [[nodiscard]] std::vector<std::uint8_t> to_interleaved() const {
+      auto const w = static_cast<size_t>(width);
+      std::vector<std::uint8_t> rgb(3 * w * static_cast<size_t>(height));
+      for (size_t y = 0; y < static_cast<size_t>(height); ++y) {
+        for (size_t x = 0; x < w; x += block_pixels) {
+          std::uint8_t const * const r = m_data.data() + offset(x, y);
+          interleave_rgb_scalar(r, r + block_pixels, r + 2 * block_pixels,
+                                rgb.data() + 3 * (y * w + x), std::min(block_pixels, w - x));
+        }
+      }
+      return rgb;
+    }
+
+    // === Guardar la imagen (P3 por defecto; se entrelaza antes en orden de filas) ===
+    void save_to_ppm(std::string const & filename, ImageFormat format = ImageFormat::p3,
+                     OutputBackend backend = OutputBackend::ofstream) const {
+      std::vector<std::uint8_t> const rgb = to_interleaved();
+      write_image(filename, width, height, rgb, format, backend);
+    }
+
+    // Alias de save_to_ppm con un nombre que no depende del formato
+    void save(std::string const & filename, ImageFormat format = ImageFormat::p3,
+              OutputBackend backend = OutputBackend::ofstream) const {
+      save_to_ppm(filename, format, backend);
+    }
+
+  private:
+    // Posición del byte r del píxel (x, y)
+    [[nodiscard]] size_t offset(size_t x, size_t y) const noexcept {
+      return ((y * m_blocks_x + x / block_pixels) * 3) * block_pixels + x % block_pixels;
+    }
+
+    [[nodiscard]] size_t offset(size_t idx) const noexcept {
+      auto const w = static_cast<size_t>(width);
+      return offset(idx % w, idx / w);
+    }
+
+    size_t m_blocks_x;
+    huge_vector<std::uint8_t> m_data;
+  };
+
+}  // namespace render
@@ -0,0 +1,73 @@
+#pragma once
+#include "huge_page_allocator.hpp"
+#include "image_soa.hpp"
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace render {
+
+  // ImageHdrSOA: framebuffer float con un plano por canal. Guarda la radiancia lineal, sin
+  // gamma ni recorte; tone_map la convierte después a ImageSOA.
+  class ImageHdrSOA {
+  public:
+    // === Dimensiones de la imagen ===
+    int width{};
+    int height{};
+
+    // === Canales de color independientes (valores lineales) ===
+    huge_vector<float> R;
+    huge_vector<float> G;
+    huge_vector<float> B;
+
+    // === Constructor ===
+    explicit ImageHdrSOA(int w, int h)
+        : width(w), height(h), R(static_cast<size_t>(w) * static_cast<size_t>(h)),
+          G(R.size()), B(R.size()) { }
+
+    // Color lineal de un píxel (lo usa store_pixel en lugar de set_r/g/b)
+    void set_linear(size_t idx, float r, float g, float b) noexcept {
+      R[idx] = r;
+      G[idx] = g;
+      B[idx] = b;
+    }
+
+    // === Colores lineales de n píxeles de la fila y desde x0 (rgb entrelazado) ===
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      size_t const first = static_cast<size_t>(y) * static_cast<size_t>(width) +
+                           static_cast<size_t>(x0);
+      for (size_t i = 0; i < static_cast<size_t>(n); ++i) {
+        R[first + i] = rgb[3 * i];
+        G[first + i] = rgb[3 * i + 1];
+        B[first + i] = rgb[3 * i + 2];
+      }
+    }
+
+    [[nodiscard]] float get_r(size_t idx) const noexcept { return R[idx]; }
+
+    [[nodiscard]] float get_g(size_t idx) const noexcept { return G[idx]; }
+
+    [[nodiscard]] float get_b(size_t idx) const noexcept { return B[idx]; }
+
+    // === Gamma y cuantización a 8 bits, plano a plano, por bloques de filas en paralelo ===
+    void tone_map(ImageSOA & out, float inv_gamma, int threads = 0) const {
+      GammaTable const table(inv_gamma);
+      auto const w = static_cast<size_t>(width);
+      parallel_rows(height, threads, [&](int y0, int y1) {
+        size_t const first = static_cast<size_t>(y0) * w;
+        size_t const n     = static_cast<size_t>(y1 - y0) * w;
+        table.apply(R.data() + first, out.R.data() + first, n);
+        table.apply(G.data() + first, out.G.data() + first, n);
+        table.apply(B.data() + first, out.B.data() + first, n);
+      });
+    }
+
+    // === Guardar como archivo PFM (las filas se entrelazan al escribir) ===
+    void save_to_pfm(std::string const & filename) const {
+      write_pfm_planar(filename, width, height, R, G, B);
+    }
+  };
+
+}  // namespace render
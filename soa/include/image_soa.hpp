@@ -1,7 +1,8 @@
 #pragma once
+#include "huge_page_allocator.hpp"
+#include "ppm_writer.hpp"
+#include "tone_map.hpp"
 #include <cstdint>
-#include <fstream>
-#include <iostream>
 #include <string>
 #include <vector>
 
@@ -14,14 +15,14 @@ namespace render {
     int height{};
 
     // === Canales de color independientes ===
-    std::vector<uint8_t> R;
-    std::vector<uint8_t> G;
-    std::vector<uint8_t> B;
+    huge_vector<uint8_t> R;
+    huge_vector<uint8_t> G;
+    huge_vector<uint8_t> B;
 
     // === Constructor ===
     explicit ImageSOA(int w, int h)
-        : width(w), height(h), R(static_cast<size_t>(w * h)), G(static_cast<size_t>(w * h)),
-          B(static_cast<size_t>(w * h)) { }
+        : width(w), height(h), R(static_cast<size_t>(w) * static_cast<size_t>(h)), G(R.size()),
+          B(R.size()) { }
 
     void set_r(size_t idx, std::uint8_t r) noexcept { R[idx] = r; }
 
@@ -29,33 +30,31 @@ namespace render {
 
     void set_b(size_t idx, std::uint8_t b) noexcept { B[idx] = b; }
 
+    // === Escribe n píxeles de la fila y desde x0 (rgb entrelazado, gamma aplicada) ===
+    // Los canales se separan y cuantizan directamente sobre los tres planos.
+    void write_span(int y, int x0, float const * rgb, int n) noexcept {
+      size_t const first = static_cast<size_t>(y) * static_cast<size_t>(width) +
+                           static_cast<size_t>(x0);
+      quantize_planar(rgb, R.data() + first, G.data() + first, B.data() + first,
+                      static_cast<size_t>(n));
+    }
+
     [[nodiscard]] uint8_t get_r(size_t idx) const noexcept { return R[idx]; }
 
     [[nodiscard]] uint8_t get_g(size_t idx) const noexcept { return G[idx]; }
 
     [[nodiscard]] uint8_t get_b(size_t idx) const noexcept { return B[idx]; }
 
-    // === Guardar como archivo PPM ===
-    void save_to_ppm(std::string const & filename) const {
-      std::ofstream out(filename);
-      if (!out.is_open()) {
-        std::cerr << "Error: cannot open output file: " << filename << '\n';
-        return;
-      }
-
-      out << "P3\n" << width << ' ' << height << "\n255\n";
-
-      for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-          auto const idx =
-              static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x);
-          // Actualizado para usar la nueva interfaz 'get'
-          out << static_cast<int>(get_r(idx)) << ' ' << static_cast<int>(get_g(idx)) << ' '
-              << static_cast<int>(get_b(idx)) << '\n';
-        }
-      }
-
-      std::cout << "Image saved to " << filename << '\n';
+    // === Guardar la imagen (P3 por defecto; los planos se entrelazan por bloques) ===
+    void save_to_ppm(std::string const & filename, ImageFormat format = ImageFormat::p3,
+                     OutputBackend backend = OutputBackend::ofstream) const {
+      write_image_planar(filename, width, height, R, G, B, format, backend);
+    }
+
+    // Alias de save_to_ppm con un nombre que no depende del formato
+    void save(std::string const & filename, ImageFormat format = ImageFormat::p3,
+              OutputBackend backend = OutputBackend::ofstream) const {
+      save_to_ppm(filename, format, backend);
     }
   };
 
@@ -2,7 +2,9 @@
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <string>
+#include <vector>
 
 using render::ImageAOS;
 
@@ -148,3 +150,53 @@ TEST(ImageAOSTest, SaveToPPMWritesHeaderAndDataInRowMajorOrder) {
   std::error_code ec;
   std::filesystem::remove(tmp, ec);  // limpia (ignora error)
 }
+
+TEST(ImageAOSTest, SaveToPPMBinaryDumpsThePixelBuffer) {
+  ImageAOS img(2, 1);
+  img.set_r(0, 1);
+  img.set_g(0, 2);
+  img.set_b(0, 3);
+  img.set_r(1, 250);
+  img.set_g(1, 10);
+  img.set_b(1, 0);
+
+  auto const tmp = std::filesystem::temp_directory_path() / "aos_test.pnm";
+  img.save_to_ppm(tmp.string(), render::ImageFormat::p6);
+
+  std::ifstream in(tmp, std::ios::binary);
+  ASSERT_TRUE(in.is_open());
+  std::string const contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  std::string expected = "P6\n2 1\n255\n";
+  for (int const value : {1, 2, 3, 250, 10, 0}) {
+    expected += static_cast<char>(value);
+  }
+  EXPECT_EQ(contents, expected);
+
+  in.close();
+  std::error_code ec;
+  std::filesystem::remove(tmp, ec);
+}
+
+TEST(ImageAOSTest, WriteSpanMatchesPerChannelSetters) {
+  // 11 píxeles desde (2,1): grupos de 8 valores y un resto, en mitad de la fila
+  ImageAOS img(16, 3);
+  ImageAOS expected(16, 3);
+  std::vector<float> rgb(3 * 11);
+  for (size_t i = 0; i < rgb.size(); ++i) {
+    rgb[i] = static_cast<float>(i) / 25.0F - 0.1F;  // Incluye valores fuera de [0, 1]
+  }
+  img.write_span(1, 2, rgb.data(), 11);
+  for (size_t i = 0; i < 11; ++i) {
+    size_t const idx = 16 + 2 + i;
+    expected.set_r(idx, render::quantize_byte(rgb[3 * i]));
+    expected.set_g(idx, render::quantize_byte(rgb[3 * i + 1]));
+    expected.set_b(idx, render::quantize_byte(rgb[3 * i + 2]));
+  }
+  for (size_t idx = 0; idx < 16 * 3; ++idx) {
+    EXPECT_EQ(img.get_r(idx), expected.get_r(idx)) << idx;
+    EXPECT_EQ(img.get_g(idx), expected.get_g(idx)) << idx;
+    EXPECT_EQ(img.get_b(idx), expected.get_b(idx)) << idx;
+  }
+  EXPECT_EQ(img.get_r(18), 0);    // -0.1
+  EXPECT_EQ(img.get_b(28), 255);  // 1.18
+}
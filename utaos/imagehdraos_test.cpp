@@ -0,0 +1,61 @@
+#include "../aos/include/image_hdr_aos.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+
+using render::ImageAOS;
+using render::ImageHdrAOS;
+
+TEST(ImageHdrAOSTest, StoresLinearValuesInterleaved) {
+  ImageHdrAOS img(3, 2);
+  EXPECT_EQ(img.data.size(), 18U);
+
+  img.set_linear(4, 0.25F, 3.5F, -1.0F);  // (1,1)
+  EXPECT_FLOAT_EQ(img.get_r(4), 0.25F);
+  EXPECT_FLOAT_EQ(img.get_g(4), 3.5F);
+  EXPECT_FLOAT_EQ(img.get_b(4), -1.0F);
+  EXPECT_FLOAT_EQ(img.data[12], 0.25F);
+  EXPECT_FLOAT_EQ(img.get_r(0), 0.0F);
+}
+
+TEST(ImageHdrAOSTest, ToneMapMatchesPowPerChannel) {
+  // 40 filas: varios bloques de filas
+  ImageHdrAOS img(7, 40);
+  for (size_t i = 0; i < 7 * 40; ++i) {
+    auto const v = static_cast<float>(i) / 200.0F;
+    img.set_linear(i, v, 1.5F - v, v * v);
+  }
+  float const inv_gamma = 1.0F / 2.2F;
+  for (int const threads : {1, 4}) {
+    ImageAOS out(7, 40);
+    img.tone_map(out, inv_gamma, threads);
+    for (size_t i = 0; i < 7 * 40; ++i) {
+      EXPECT_EQ(out.get_r(i), render::gamma_byte(img.get_r(i), inv_gamma));
+      EXPECT_EQ(out.get_g(i), render::gamma_byte(img.get_g(i), inv_gamma));
+      EXPECT_EQ(out.get_b(i), render::gamma_byte(img.get_b(i), inv_gamma));
+    }
+  }
+}
+
+TEST(ImageHdrAOSTest, SavesPfm) {
+  ImageHdrAOS img(2, 1);
+  img.set_linear(0, 1.0F, 2.0F, 3.0F);
+  img.set_linear(1, 4.0F, 5.0F, 6.0F);
+  auto const path = std::filesystem::temp_directory_path() / "hdr_aos.pfm";
+  img.save_to_pfm(path.string());
+
+  std::ifstream in(path, std::ios::binary);
+  std::string const file{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  std::string const header = "PF\n2 1\n-1.0\n";
+  ASSERT_EQ(file.size(), header.size() + 6 * sizeof(float));
+  EXPECT_EQ(file.substr(0, header.size()), header);
+  EXPECT_EQ(file.substr(header.size()),
+            std::string(reinterpret_cast<char const *>(img.data.data()), 6 * sizeof(float)));
+
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
@@ -0,0 +1,130 @@
+#include "../aos/include/image_aos.hpp"
+#include "../aos/include/image_tiled.hpp"
+#include "../common/include/config.hpp"
+#include "../common/include/renderer.hpp"
+#include "../common/include/scene.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using render::ImageAOS;
+using render::ImageTiled;
+
+namespace {
+
+  // Rellena las dos imágenes con el mismo patrón por píxel
+  void fill_pattern(ImageTiled & tiled, ImageAOS & aos) {
+    auto const n = static_cast<size_t>(aos.width) * static_cast<size_t>(aos.height);
+    for (size_t i = 0; i < n; ++i) {
+      auto const v = static_cast<std::uint8_t>(i * 7);
+      tiled.set_r(i, v);
+      tiled.set_g(i, static_cast<std::uint8_t>(v + 1));
+      tiled.set_b(i, static_cast<std::uint8_t>(v + 2));
+      aos.set_r(i, v);
+      aos.set_g(i, static_cast<std::uint8_t>(v + 1));
+      aos.set_b(i, static_cast<std::uint8_t>(v + 2));
+    }
+  }
+
+}  // namespace
+
+TEST(ImageTiledTest, SetAndGetUseRowMajorIndices) {
+  // 10x7 con teselas de 4: teselas incompletas en el borde derecho y en el de abajo
+  ImageTiled img(10, 7, 4);
+  ImageAOS reference(10, 7);
+  EXPECT_EQ(img.tile_size(), 4);
+  fill_pattern(img, reference);
+  for (size_t i = 0; i < 70; ++i) {
+    EXPECT_EQ(img.get_r(i), reference.get_r(i)) << i;
+    EXPECT_EQ(img.get_g(i), reference.get_g(i)) << i;
+    EXPECT_EQ(img.get_b(i), reference.get_b(i)) << i;
+  }
+  std::vector<std::uint8_t> const rgb = img.to_interleaved();
+  ASSERT_EQ(rgb.size(), reference.data.size() * 3);
+  EXPECT_EQ(0, std::memcmp(rgb.data(), reference.data.data(), rgb.size()));
+}
+
+TEST(ImageTiledTest, TilesStartOnCacheLines) {
+  // Con 4, 5, 10 o 12 píxeles de lado, tile * tile * 3 no es múltiplo de 64
+  for (int const tile : {4, 5, 10, 12, 32}) {
+    ImageTiled img(37, 23, tile);
+    ImageAOS reference(37, 23);
+    int const tiles_x = (37 + tile - 1) / tile;
+    int const tiles_y = (23 + tile - 1) / tile;
+    for (int ty = 0; ty < tiles_y; ++ty) {
+      for (int tx = 0; tx < tiles_x; ++tx) {
+        auto const address = reinterpret_cast<std::uintptr_t>(img.tile_data(tx, ty));
+        EXPECT_EQ(address % ImageTiled::cache_line, 0U) << tile << ' ' << tx << ' ' << ty;
+      }
+    }
+    fill_pattern(img, reference);
+    std::vector<std::uint8_t> const rgb = img.to_interleaved();
+    EXPECT_EQ(0, std::memcmp(rgb.data(), reference.data.data(), rgb.size())) << tile;
+  }
+}
+
+TEST(ImageTiledTest, WriteSpanCrossesTileBorders) {
+  ImageTiled img(10, 3, 4);
+  ImageAOS reference(10, 3);
+  std::vector<float> rgb(3 * 9);
+  for (size_t i = 0; i < rgb.size(); ++i) {
+    rgb[i] = static_cast<float>(i) / 26.0F;
+  }
+  img.write_span(2, 1, rgb.data(), 9);  // Columnas 1-9: tres teselas
+  reference.write_span(2, 1, rgb.data(), 9);
+  for (size_t i = 0; i < 30; ++i) {
+    EXPECT_EQ(img.get_r(i), reference.get_r(i)) << i;
+    EXPECT_EQ(img.get_g(i), reference.get_g(i)) << i;
+    EXPECT_EQ(img.get_b(i), reference.get_b(i)) << i;
+  }
+}
+
+TEST(ImageTiledTest, SaveMatchesImageAos) {
+  ImageTiled img(9, 5, 4);
+  ImageAOS reference(9, 5);
+  fill_pattern(img, reference);
+  auto const dir = std::filesystem::temp_directory_path();
+  img.save((dir / "tiled_test.pnm").string(), render::ImageFormat::p6);
+  reference.save((dir / "tiled_ref.pnm").string(), render::ImageFormat::p6);
+
+  auto const read = [](std::filesystem::path const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  };
+  EXPECT_EQ(read(dir / "tiled_test.pnm"), read(dir / "tiled_ref.pnm"));
+
+  std::error_code ec;
+  std::filesystem::remove(dir / "tiled_test.pnm", ec);
+  std::filesystem::remove(dir / "tiled_ref.pnm", ec);
+}
+
+TEST(ImageTiledTest, TiledRenderMatchesImageAos) {
+  render::Scene scene;
+  scene.materials.emplace("mat", render::Material{.name   = "mat",
+                                                  .type   = "matte",
+                                                  .params = {0.8F, 0.3F, 0.1F}});
+  scene.spheres.push_back(render::Sphere(0, 0, 0, 3.0F, "mat"));
+  render::compile_materials(scene);
+  render::prepare_scene(scene);
+  render::Config cfg;
+  cfg.image_width       = 24;
+  cfg.aspect_ratio      = {4, 3};
+  cfg.samples_per_pixel = 2;
+  cfg.max_depth         = 3;
+  cfg.tile_size         = 8;
+  cfg.threads           = 3;
+  cfg.rng_mode          = "per_pixel";
+
+  ImageAOS reference(24, 18);
+  ImageTiled img(24, 18, cfg.tile_size);
+  (void) render::run_render_loop(reference, cfg, scene);
+  (void) render::run_render_loop(img, cfg, scene);
+  std::vector<std::uint8_t> const rgb = img.to_interleaved();
+  EXPECT_EQ(0, std::memcmp(rgb.data(), reference.data.data(), rgb.size()));
+}
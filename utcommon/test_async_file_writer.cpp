@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../common/include/async_file_writer.hpp"
+#include "../common/include/ppm_writer.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+namespace {
+
+  // Escribe 'data' en bloques de 'block' bytes y devuelve lo que queda en el archivo
+  std::string write_in_blocks(OutputBackend backend, std::string const & data, std::size_t block) {
+    auto const path = std::filesystem::temp_directory_path() / "async_writer.bin";
+    {
+      AsyncFileWriter writer(path.string(), backend);
+      for (std::size_t first = 0; first < data.size(); first += block) {
+        std::size_t const n    = std::min(block, data.size() - first);
+        std::span<char> buffer = writer.next_buffer();
+        std::memcpy(buffer.data(), data.data() + first, n);
+        writer.submit(n);
+      }
+      writer.finish();
+    }
+    std::string contents = read_file(path);
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return contents;
+  }
+
+  std::string pattern(std::size_t size) {
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i < size; ++i) {
+      data[i] = static_cast<char>(i * 131 + i / 7);
+    }
+    return data;
+  }
+
+}  // namespace
+
+TEST(AsyncFileWriterTest, BackendFollowsSetting) {
+  EXPECT_EQ(output_backend_for("ofstream"), OutputBackend::ofstream);
+  EXPECT_EQ(output_backend_for("write"), OutputBackend::write);
+  EXPECT_EQ(output_backend_for("io_uring"), OutputBackend::io_uring);
+}
+
+TEST(AsyncFileWriterTest, WritesBlocksInOrderWithBothBackends) {
+  // Más bloques que búferes, para que se reutilicen mientras hay escrituras en curso
+  std::string const data = pattern(3 * AsyncFileWriter::buffer_count *
+                                   AsyncFileWriter::buffer_size / 2 + 123);
+  EXPECT_EQ(write_in_blocks(OutputBackend::write, data, AsyncFileWriter::buffer_size), data);
+  EXPECT_EQ(write_in_blocks(OutputBackend::io_uring, data, AsyncFileWriter::buffer_size), data);
+  EXPECT_EQ(write_in_blocks(OutputBackend::io_uring, data, 1'000), data);
+}
+
+TEST(AsyncFileWriterTest, WriteBackendNeverUsesTheRing) {
+  auto const path = std::filesystem::temp_directory_path() / "async_writer_plain.bin";
+  {
+    AsyncFileWriter writer(path.string(), OutputBackend::write);
+    EXPECT_FALSE(writer.uses_io_uring());
+    writer.finish();
+  }
+  EXPECT_EQ(read_file(path), "");
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  EXPECT_THROW(AsyncFileWriter("/nonexistent/dir/out.bin", OutputBackend::io_uring),
+               std::runtime_error);
+}
+
+TEST(AsyncFileWriterTest, PpmWritersProduceTheSameFilesWithEveryBackend) {
+  // 300 x 200 píxeles: en P3 son varios bloques de chunk_pixels
+  int const width         = 300;
+  int const height        = 200;
+  std::size_t const total = static_cast<std::size_t>(width * height);
+  std::vector<std::uint8_t> r(total), g(total), b(total), rgb(3 * total);
+  for (std::size_t i = 0; i < total; ++i) {
+    r[i]           = static_cast<std::uint8_t>(i);
+    g[i]           = static_cast<std::uint8_t>(i * 7 + 3);
+    b[i]           = static_cast<std::uint8_t>(255 - i % 256);
+    rgb[3 * i]     = r[i];
+    rgb[3 * i + 1] = g[i];
+    rgb[3 * i + 2] = b[i];
+  }
+
+  auto const path = std::filesystem::temp_directory_path() / "async_writer.ppm";
+  for (ImageFormat const format : {ImageFormat::p3, ImageFormat::p6}) {
+    write_image(path.string(), width, height, rgb, format, OutputBackend::ofstream);
+    std::string const expected = read_file(path);
+    for (OutputBackend const backend : {OutputBackend::write, OutputBackend::io_uring}) {
+      write_image(path.string(), width, height, rgb, format, backend);
+      EXPECT_EQ(read_file(path), expected);
+      write_image_planar(path.string(), width, height, r, g, b, format, backend);
+      EXPECT_EQ(read_file(path), expected);
+    }
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
@@ -0,0 +1,111 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <span>
+#include <vector>
+
+#include "../common/include/batch_rng.hpp"
+#include "../common/include/simd.hpp"
+
+using namespace render;
+
+namespace {
+
+  // Los n primeros valores de un generador recién creado, uno a uno
+  std::vector<float> one_by_one(uint64_t seed, std::size_t n) {
+    BatchEngine engine(seed);
+    std::vector<float> values(n);
+    for (float & v : values) {
+      v = engine.next_float();
+    }
+    return values;
+  }
+
+}  // namespace
+
+TEST(BatchRNGTest, AvxKernelMatchesScalarKernel) {
+  if (!simd::cpu_has_avx2()) {
+    GTEST_SKIP() << "CPU sin AVX2";
+  }
+  BatchState simd_state;
+  for (std::size_t i = 0; i < simd_state.words.size(); ++i) {
+    simd_state.words[i] = static_cast<uint32_t>(i * 0x9E37'79B9U + 1);
+  }
+  BatchState scalar_state = simd_state;
+
+  std::array<float, 5 * BatchEngine::block> simd_out{};
+  std::array<float, 5 * BatchEngine::block> scalar_out{};
+  generate_batch(simd_state, simd_out.data(), 5);
+  generate_batch_scalar(scalar_state, scalar_out.data(), 5);
+  EXPECT_EQ(simd_out, scalar_out);
+  EXPECT_EQ(simd_state.words, scalar_state.words);
+}
+
+TEST(BatchRNGTest, FillGivesTheSameSequenceAsNextFloat) {
+  std::vector<float> const expected = one_by_one(19, 200);
+
+  // Trozos de tamaños variados: restos del búfer, bloques completos y recargas
+  BatchEngine engine(19);
+  std::vector<float> values(200);
+  std::size_t offset = 0;
+  for (std::size_t const size : {3U, 13U, 40U, 1U, 16U, 127U}) {
+    engine.fill(std::span<float>(values).subspan(offset, size));
+    offset += size;
+  }
+  EXPECT_EQ(values, expected);
+}
+
+TEST(BatchRNGTest, NextLanesIsAlignedAndSkipsThePartialGroup) {
+  std::vector<float> const expected = one_by_one(7, 48);
+  BatchEngine engine(7);
+  for (int i = 0; i < 3; ++i) {
+    (void) engine.next_float();
+  }
+
+  // Se descartan los valores 3..7; el carril completo son los valores 8..15
+  auto const lanes = engine.next_lanes();
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(lanes.data()) % 32, 0U);
+  for (std::size_t i = 0; i < lanes.size(); ++i) {
+    EXPECT_EQ(lanes[i], expected[8 + i]);
+  }
+
+  // El siguiente carril necesita una recarga y después sigue la secuencia
+  auto const next = engine.next_lanes();
+  EXPECT_EQ(next[0], expected[16]);
+  EXPECT_EQ(engine.next_float(), expected[24]);
+}
+
+TEST(BatchRNGTest, ValuesAreUniformAndLanesDiffer) {
+  BatchRNG rng(13);
+  int const n = 160'000;
+  double sum  = 0.0;
+  std::array<int, 10> buckets{};
+  for (int i = 0; i < n; ++i) {
+    float const v = rng.random_float();
+    ASSERT_GE(v, 0.0F);
+    ASSERT_LT(v, 1.0F);
+    sum += v;
+    ++buckets[static_cast<std::size_t>(v * 10.0F)];
+  }
+  EXPECT_NEAR(sum / n, 0.5, 0.01);
+  for (int const count : buckets) {
+    EXPECT_NEAR(count, n / 10, n / 100);
+  }
+
+  // Cada carril es un generador distinto
+  auto const lanes = rng.engine().next_lanes();
+  for (std::size_t i = 1; i < lanes.size(); ++i) {
+    EXPECT_NE(lanes[i], lanes[0]);
+  }
+}
+
+TEST(BatchRNGTest, SeedsGiveReproducibleDistinctSequences) {
+  EXPECT_EQ(one_by_one(19, 64), one_by_one(19, 64));
+  EXPECT_NE(one_by_one(19, 64), one_by_one(13, 64));
+
+  BatchRNG rng(5);
+  for (int i = 0; i < 1'000; ++i) {
+    EXPECT_LT(rng.random_in_unit_sphere().length_squared(), 1.0F);
+  }
+}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "../common/include/bvh.hpp"
+#include "../common/include/config.hpp"
+#include "../common/include/hittable.hpp"
+#include "../common/include/scene.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+namespace {
+
+  // Semilla de las escenas aleatorias de este archivo
+  constexpr std::uint32_t scene_seed = 1'234;
+
+  bool inside(AABB const & box, float x, float y, float z) {
+    return x >= box.min[0] and x <= box.max[0] and y >= box.min[1] and y <= box.max[1] and
+           z >= box.min[2] and z <= box.max[2];
+  }
+
+}  // namespace
+
+TEST(BVHTest, SphereBoundsContainSphere) {
+  AABB const box = bounds_of(Sphere(1, 2, 3, 0.5F, "m"));
+  EXPECT_NEAR(box.min[0], 0.5F, 1e-3F);
+  EXPECT_NEAR(box.max[2], 3.5F, 1e-3F);
+}
+
+TEST(BVHTest, AxisAlignedCylinderBoundsAreTight) {
+  // Eje (0, 10, 0): altura 10 en Y, radio 1 en X y Z
+  AABB const box = bounds_of(Cylinder(0, 0, 0, 1.0F, 0, 10.0F, 0, "m"));
+  EXPECT_NEAR(box.min[0], -1.0F, 1e-2F);
+  EXPECT_NEAR(box.max[0], 1.0F, 1e-2F);
+  EXPECT_NEAR(box.min[1], -5.0F, 1e-2F);
+  EXPECT_NEAR(box.max[1], 5.0F, 1e-2F);
+  EXPECT_NEAR(box.min[2], -1.0F, 1e-2F);
+  EXPECT_NEAR(box.max[2], 1.0F, 1e-2F);
+}
+
+TEST(BVHTest, ObliqueCylinderBoundsContainCapRims) {
+  Cylinder const c(1, -2, 3, 0.5F, 4, 2.5F, -1.25F, "m");
+  AABB const box = bounds_of(c);
+
+  // Muestrea los bordes de ambas tapas: deben quedar dentro de la caja
+  float const h   = std::sqrt(c.ax * c.ax + c.ay * c.ay + c.az * c.az);
+  float const a[] = {c.ax / h, c.ay / h, c.az / h};
+  // Base ortonormal del plano de las tapas
+  float u[]      = {a[1], -a[0], 0.0F};
+  float const un = std::sqrt(u[0] * u[0] + u[1] * u[1]);
+  u[0] /= un;
+  u[1] /= un;
+  float const v[] = {a[1] * u[2] - a[2] * u[1], a[2] * u[0] - a[0] * u[2],
+                     a[0] * u[1] - a[1] * u[0]};
+  for (float side : {-0.5F, 0.5F}) {
+    for (int k = 0; k < 64; ++k) {
+      float const t  = static_cast<float>(k) * 0.0982F;
+      float const cs = std::cos(t) * c.r;
+      float const sn = std::sin(t) * c.r;
+      EXPECT_TRUE(inside(box, c.cx + side * c.ax + cs * u[0] + sn * v[0],
+                         c.cy + side * c.ay + cs * u[1] + sn * v[1],
+                         c.cz + side * c.az + cs * u[2] + sn * v[2]));
+    }
+  }
+  // Y es ajustada: más estrecha que la caja de una esfera que envuelva el cilindro
+  float const bound_radius = std::sqrt(0.25F * h * h + c.r * c.r);
+  EXPECT_LT(box.max[2] - box.min[2], 2.0F * bound_radius);
+}
+
+TEST(BVHTest, EmptySceneGivesEmptyTree) {
+  Scene const scene;
+  EXPECT_TRUE(build_bvh(scene).empty());
+}
+
+TEST(BVHTest, EveryPrimitiveIsReferencedOnce) {
+  Scene const scene = make_random_scene(100, 50, scene_seed);
+  BVH const bvh     = build_bvh(scene);
+  ASSERT_EQ(bvh.prims.size(), 150U);
+
+  std::vector<int> seen(150, 0);
+  for (uint32_t ref : bvh.prims) {
+    auto const idx = (ref & BVH::cylinder_flag) != 0 ? 100 + (ref & ~BVH::cylinder_flag) : ref;
+    ++seen[idx];
+  }
+  for (int s : seen) {
+    EXPECT_EQ(s, 1);
+  }
+}
+
+TEST(BVHTest, MatchesLinearTraversal) {
+  Scene scene = make_random_scene(300, 120, scene_seed);
+  scene.bvh   = build_bvh(scene);
+
+  std::mt19937 gen(99);
+  std::uniform_real_distribution<float> dir(-1.0F, 1.0F);
+  for (int i = 0; i < 2'000; ++i) {
+    Ray const r(vector(0, 0, -40), vector(dir(gen), dir(gen), 1.0F));
+    auto const expected = hit_scene_linear(scene, r, 0.001F, 1'000.0F);
+    auto const actual   = hit_scene_bvh(scene, r, 0.001F, 1'000.0F);
+    ASSERT_EQ(expected.has_value(), actual.has_value());
+    if (expected) {
+      EXPECT_EQ(expected->lambda, actual->lambda);
+      EXPECT_EQ(expected->material_id, actual->material_id);
+    }
+  }
+}
+
+TEST(BVHTest, AcceleratorFlagSelectsTraversal) {
+  Scene scene = make_random_scene(10, 10, scene_seed);
+  Config cfg;
+  EXPECT_EQ(cfg.accelerator, "bvh");
+  build_accelerator(scene, cfg);
+  EXPECT_FALSE(scene.bvh.empty());
+
+  cfg.accelerator = "linear";
+  build_accelerator(scene, cfg);
+  EXPECT_TRUE(scene.bvh.empty());
+}
+
+TEST(BVHTest, ParallelBuildMatchesSequential) {
+  Scene const scene    = make_random_scene(3'000, 1'000, scene_seed);
+  BVH const sequential = build_bvh(scene, 1);
+  BVH const parallel   = build_bvh(scene, 4);
+
+  ASSERT_EQ(sequential.nodes.size(), parallel.nodes.size());
+  EXPECT_EQ(sequential.prims, parallel.prims);
+  for (std::size_t i = 0; i < sequential.nodes.size(); ++i) {
+    EXPECT_EQ(sequential.nodes[i].right_or_first, parallel.nodes[i].right_or_first);
+    EXPECT_EQ(sequential.nodes[i].count, parallel.nodes[i].count);
+    EXPECT_EQ(sequential.nodes[i].bounds.min, parallel.nodes[i].bounds.min);
+    EXPECT_EQ(sequential.nodes[i].bounds.max, parallel.nodes[i].bounds.max);
+  }
+}
+
+TEST(BVHTest, StatsDescribeTree) {
+  Scene const scene      = make_random_scene(500, 200, scene_seed);
+  BVH const bvh          = build_bvh(scene, 2);
+  BVHStats const & stats = bvh.stats;
+
+  EXPECT_EQ(stats.nodes, bvh.nodes.size());
+  EXPECT_EQ(stats.nodes, 2 * stats.leaves - 1);
+  EXPECT_GE(stats.min_leaf_size, 1U);
+  EXPECT_LE(stats.max_leaf_size, 8U);
+  EXPECT_NEAR(stats.avg_leaf_size, 700.0 / static_cast<double>(stats.leaves), 1e-9);
+  EXPECT_LT(stats.max_depth, 64);
+  EXPECT_GE(stats.build_ms, 0.0);
+  // La raíz siempre cuesta una visita; el árbol debe ser mucho mejor que probar todo
+  EXPECT_GT(stats.sah_cost, 1.0F);
+  EXPECT_LT(stats.sah_cost, 700.0F / 4.0F);
+}
+
+TEST(BVHTest, CoincidentCentroidsStillSplit) {
+  // Todas las esferas en el mismo punto: no hay eje por el que dividir con la SAH
+  Scene scene;
+  for (int i = 0; i < 40; ++i) {
+    scene.spheres.push_back(Sphere(1, 1, 1, 0.5F, "m"));
+  }
+  BVH const bvh = build_bvh(scene);
+  EXPECT_EQ(bvh.prims.size(), 40U);
+  EXPECT_LE(bvh.stats.max_leaf_size, 8U);
+}
@@ -0,0 +1,155 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../common/include/bvh.hpp"
+#include "../common/include/bvh_wide.hpp"
+#include "../common/include/config.hpp"
+#include "../common/include/hittable.hpp"
+#include "../common/include/scene.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+namespace {
+
+  // Semilla de las escenas aleatorias de este archivo
+  constexpr std::uint32_t scene_seed = 4'321;
+
+  // Cuenta cuántas veces aparece cada primitiva en las hojas alcanzables desde la raíz
+  template <std::size_t W>
+  void count_leaf_prims(WideBVH<W> const & bvh, uint32_t node, std::vector<int> & seen,
+                        std::size_t n_spheres) {
+    for (std::size_t i = 0; i < W; ++i) {
+      if (bvh.nodes[node].child[i] == WideBVHNode<W>::empty_slot) {
+        continue;
+      }
+      if (bvh.nodes[node].count[i] == 0) {
+        EXPECT_GT(bvh.nodes[node].child[i], node);  // Orden de profundidad
+        count_leaf_prims(bvh, bvh.nodes[node].child[i], seen, n_spheres);
+        continue;
+      }
+      for (uint32_t k = 0; k < bvh.nodes[node].count[i]; ++k) {
+        uint32_t const ref = bvh.prims[bvh.nodes[node].child[i] + k];
+        auto const idx     = (ref & BVH::cylinder_flag) != 0
+                                 ? n_spheres + (ref & ~BVH::cylinder_flag)
+                                 : static_cast<std::size_t>(ref);
+        ++seen[idx];
+      }
+    }
+  }
+
+  template <std::size_t W>
+  void expect_matches_linear(Scene const & scene) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dir(-1.0F, 1.0F);
+    for (int i = 0; i < 2'000; ++i) {
+      Ray const r(vector(0, 0, -40), vector(dir(gen), dir(gen), 1.0F));
+      auto const expected = hit_scene_linear(scene, r, 0.001F, 1'000.0F);
+      auto const actual   = W == 4 ? hit_scene_bvh4(scene, r, 0.001F, 1'000.0F)
+                                   : hit_scene_bvh8(scene, r, 0.001F, 1'000.0F);
+      ASSERT_EQ(expected.has_value(), actual.has_value());
+      if (expected) {
+        EXPECT_EQ(expected->lambda, actual->lambda);
+        EXPECT_EQ(expected->material_id, actual->material_id);
+      }
+    }
+  }
+
+}  // namespace
+
+TEST(WideBVHTest, NodesFillWholeCacheLines) {
+  EXPECT_EQ(alignof(WideBVHNode<4>), 64U);
+  EXPECT_EQ(sizeof(WideBVHNode<4>), 128U);
+  EXPECT_EQ(sizeof(WideBVHNode<8>), 256U);
+
+  Scene const scene = make_random_scene(200, 0, scene_seed);
+  BVH4 const bvh4   = build_wide_bvh<4>(build_bvh(scene));
+  for (auto const & node : bvh4.nodes) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&node) % 64, 0U);
+  }
+}
+
+TEST(WideBVHTest, EmptyBinaryTreeGivesEmptyWideTree) {
+  EXPECT_TRUE(build_wide_bvh<4>(BVH{}).empty());
+  EXPECT_TRUE(build_wide_bvh<8>(BVH{}).empty());
+}
+
+TEST(WideBVHTest, EveryPrimitiveIsReferencedOnce) {
+  Scene const scene = make_random_scene(300, 100, scene_seed);
+  BVH const bvh     = build_bvh(scene);
+  BVH4 const bvh4   = build_wide_bvh<4>(bvh);
+  BVH8 const bvh8   = build_wide_bvh<8>(bvh);
+  EXPECT_LT(bvh4.nodes.size(), bvh.nodes.size() / 2);
+  EXPECT_LT(bvh8.nodes.size(), bvh4.nodes.size());
+
+  std::vector<int> seen4(400, 0);
+  std::vector<int> seen8(400, 0);
+  count_leaf_prims(bvh4, 0, seen4, 300);
+  count_leaf_prims(bvh8, 0, seen8, 300);
+  for (std::size_t i = 0; i < 400; ++i) {
+    EXPECT_EQ(seen4[i], 1);
+    EXPECT_EQ(seen8[i], 1);
+  }
+}
+
+TEST(WideBVHTest, SingleLeafRoot) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, 0, 1.0F, "m"));
+  prepare_scene(scene);
+  scene.bvh4 = build_wide_bvh<4>(build_bvh(scene));
+  ASSERT_EQ(scene.bvh4.nodes.size(), 1U);
+  EXPECT_EQ(scene.bvh4.nodes[0].count[0], 1U);
+
+  Ray const r(vector(0, 0, -5), vector(0, 0, 1));
+  auto const hit = hit_scene_bvh4(scene, r, 0.001F, 100.0F);
+  ASSERT_TRUE(hit.has_value());
+  EXPECT_FLOAT_EQ(hit->lambda, 4.0F);
+}
+
+TEST(WideBVHTest, Bvh4MatchesLinearTraversal) {
+  Scene scene = make_random_scene(300, 120, scene_seed);
+  scene.bvh4  = build_wide_bvh<4>(build_bvh(scene));
+  expect_matches_linear<4>(scene);
+}
+
+TEST(WideBVHTest, Bvh8MatchesLinearTraversal) {
+  Scene scene = make_random_scene(300, 120, scene_seed);
+  scene.bvh8  = build_wide_bvh<8>(build_bvh(scene));
+  expect_matches_linear<8>(scene);
+}
+
+TEST(WideBVHTest, AxisAlignedRaysHitThroughZeroDirections) {
+  // Direcciones con componentes nulas: la inversa es ±inf en esos ejes
+  Scene scene = make_random_scene(100, 40, scene_seed);
+  scene.bvh8  = build_wide_bvh<8>(build_bvh(scene));
+  for (float sign : {1.0F, -1.0F}) {
+    for (int k = -20; k <= 20; k += 2) {
+      Ray const r(vector(static_cast<float>(k), 0.5F, sign * -40.0F), vector(0, 0, sign));
+      auto const expected = hit_scene_linear(scene, r, 0.001F, 1'000.0F);
+      auto const actual   = hit_scene_bvh8(scene, r, 0.001F, 1'000.0F);
+      ASSERT_EQ(expected.has_value(), actual.has_value());
+      if (expected) {
+        EXPECT_EQ(expected->lambda, actual->lambda);
+      }
+    }
+  }
+}
+
+TEST(WideBVHTest, AcceleratorFlagSelectsWideTree) {
+  Scene scene = make_random_scene(10, 10, scene_seed);
+  Config cfg;
+  cfg.accelerator = "bvh4";
+  build_accelerator(scene, cfg);
+  EXPECT_FALSE(scene.bvh4.empty());
+  EXPECT_TRUE(scene.bvh.empty());
+  EXPECT_TRUE(scene.bvh8.empty());
+
+  cfg.accelerator = "bvh8";
+  build_accelerator(scene, cfg);
+  EXPECT_FALSE(scene.bvh8.empty());
+  EXPECT_TRUE(scene.bvh4.empty());
+}
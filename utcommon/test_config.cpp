@@ -172,6 +172,192 @@ namespace {
     EXPECT_THROW((void) read_config(p4), std::runtime_error);
   }
 
+  TEST(ConfigRead, ThreadsAndTileSize) {
+    auto p = writeTmp("threads.cfg", "threads: 8\n"
+                                     "tile_size: 16\n");
+    Config c = read_config(p);
+    EXPECT_EQ(c.threads, 8);
+    EXPECT_EQ(c.tile_size, 16);
+
+    Config def{};
+    EXPECT_EQ(def.threads, 1);  // por defecto se conserva el bucle secuencial
+
+    auto p1 = writeTmp("threads_neg.cfg", "threads: -2\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+
+    auto p2 = writeTmp("tile_zero.cfg", "tile_size: 0\n");
+    EXPECT_THROW((void) read_config(p2), std::runtime_error);
+  }
+
+  TEST(ConfigRead, RngMode) {
+    Config def{};
+    EXPECT_EQ(def.rng_mode, "legacy");
+
+    auto p = writeTmp("rng_mode.cfg", "rng_mode: per_pixel\n");
+    EXPECT_EQ(read_config(p).rng_mode, "per_pixel");
+
+    auto p1 = writeTmp("rng_mode_bad.cfg", "rng_mode: random\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, Accelerator) {
+    Config def{};
+    EXPECT_EQ(def.accelerator, "bvh");
+
+    for (std::string const value : {"bvh", "bvh4", "bvh8", "simd", "linear"}) {
+      auto p = writeTmp("accel.cfg", "accelerator: " + value + "\n");
+      EXPECT_EQ(read_config(p).accelerator, value);
+    }
+
+    auto p1 = writeTmp("accel_bad.cfg", "accelerator: bvh16\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, PathTermination) {
+    Config def{};
+    EXPECT_EQ(def.roulette_depth, 0);  // por defecto los caminos no se cortan
+    EXPECT_EQ(def.throughput_threshold, 0.0F);
+
+    auto p = writeTmp("roulette.cfg", "roulette_depth: 3\nthroughput_threshold: 0.01\n");
+    Config const c = read_config(p);
+    EXPECT_EQ(c.roulette_depth, 3);
+    EXPECT_FLOAT_EQ(c.throughput_threshold, 0.01F);
+
+    auto p1 = writeTmp("roulette_neg.cfg", "roulette_depth: -1\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+
+    auto p2 = writeTmp("threshold_one.cfg", "throughput_threshold: 1\n");
+    EXPECT_THROW((void) read_config(p2), std::runtime_error);
+  }
+
+  TEST(ConfigRead, AdaptiveSampling) {
+    Config def{};
+    EXPECT_EQ(def.adaptive_min_samples, 0);  // por defecto todas las muestras
+    EXPECT_TRUE(def.sample_map.empty());
+
+    auto p = writeTmp("adaptive.cfg", "adaptive_min_samples: 8\nadaptive_tolerance: 0.005\n"
+                                      "sample_map: muestras.pgm\n");
+    Config const c = read_config(p);
+    EXPECT_EQ(c.adaptive_min_samples, 8);
+    EXPECT_FLOAT_EQ(c.adaptive_tolerance, 0.005F);
+    EXPECT_EQ(c.sample_map, "muestras.pgm");
+
+    auto p1 = writeTmp("adaptive_neg.cfg", "adaptive_min_samples: -4\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+
+    auto p2 = writeTmp("adaptive_tol.cfg", "adaptive_tolerance: 0\n");
+    EXPECT_THROW((void) read_config(p2), std::runtime_error);
+  }
+
+  TEST(ConfigRead, Sampler) {
+    Config def{};
+    EXPECT_EQ(def.sampler, "random");
+
+    for (std::string const value : {"random", "stratified", "sobol"}) {
+      auto p = writeTmp("sampler.cfg", "sampler: " + value + "\n");
+      EXPECT_EQ(read_config(p).sampler, value);
+    }
+
+    auto p1 = writeTmp("sampler_bad.cfg", "sampler: halton\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, BallSampling) {
+    Config def{};
+    EXPECT_EQ(def.ball_sampling, "rejection");
+
+    for (std::string const value : {"rejection", "direct"}) {
+      auto p = writeTmp("ball_sampling.cfg", "ball_sampling: " + value + "\n");
+      EXPECT_EQ(read_config(p).ball_sampling, value);
+    }
+
+    auto p1 = writeTmp("ball_sampling_bad.cfg", "ball_sampling: gaussian\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, ImageFormat) {
+    Config def{};
+    EXPECT_EQ(def.image_format, "auto");
+
+    for (std::string const value : {"auto", "p3", "p6", "qoi", "png"}) {
+      auto p = writeTmp("image_format.cfg", "image_format: " + value + "\n");
+      EXPECT_EQ(read_config(p).image_format, value);
+    }
+
+    auto p1 = writeTmp("image_format_bad.cfg", "image_format: jpeg\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, PpmFormatIsAnotherSpellingOfImageFormat) {
+    auto p = writeTmp("ppm_format.cfg", "ppm_format: p6\n");
+    EXPECT_EQ(read_config(p).image_format, "p6");
+
+    auto p1 = writeTmp("ppm_format_bad.cfg", "ppm_format: jpeg\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, StreamRows) {
+    Config def{};
+    EXPECT_EQ(def.stream_rows, 0);
+
+    auto p = writeTmp("stream_rows.cfg", "stream_rows: 64\n");
+    EXPECT_EQ(read_config(p).stream_rows, 64);
+
+    auto p1 = writeTmp("stream_rows_bad.cfg", "stream_rows: -1\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, OutputBackend) {
+    Config def{};
+    EXPECT_EQ(def.output_backend, "ofstream");
+
+    for (std::string const value : {"ofstream", "write", "io_uring"}) {
+      auto p = writeTmp("output_backend.cfg", "output_backend: " + value + "\n");
+      EXPECT_EQ(read_config(p).output_backend, value);
+    }
+
+    auto p1 = writeTmp("output_backend_bad.cfg", "output_backend: aio\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, Framebuffer) {
+    Config def{};
+    EXPECT_EQ(def.framebuffer, "ldr");
+
+    auto p = writeTmp("framebuffer.cfg", "framebuffer: hdr\n");
+    EXPECT_EQ(read_config(p).framebuffer, "hdr");
+
+    auto p2 = writeTmp("framebuffer_mapped.cfg", "framebuffer: mapped\n");
+    EXPECT_EQ(read_config(p2).framebuffer, "mapped");
+
+    auto p1 = writeTmp("framebuffer_bad.cfg", "framebuffer: float\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, HugePages) {
+    Config def{};
+    EXPECT_EQ(def.huge_pages, "off");
+
+    auto p = writeTmp("huge_pages.cfg", "huge_pages: hugetlb\n");
+    EXPECT_EQ(read_config(p).huge_pages, "hugetlb");
+
+    auto p1 = writeTmp("huge_pages_bad.cfg", "huge_pages: 1g\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
+  TEST(ConfigRead, RngEngine) {
+    Config def{};
+    EXPECT_EQ(def.rng_engine, "mt19937");
+
+    for (std::string const value : {"mt19937", "xoshiro", "pcg", "batch"}) {
+      auto p = writeTmp("rng_engine.cfg", "rng_engine: " + value + "\n");
+      EXPECT_EQ(read_config(p).rng_engine, value);
+    }
+
+    auto p1 = writeTmp("rng_engine_bad.cfg", "rng_engine: minstd\n");
+    EXPECT_THROW((void) read_config(p1), std::runtime_error);
+  }
+
   // AJUSTADO: si faltan, se mantienen los valores por defecto del struct.
   TEST(ConfigRead, BackgroundColorsNotRequiredWhenMissing) {
     auto p = writeTmp("bg_missing.cfg", "aspect_ratio: 4 3\n"
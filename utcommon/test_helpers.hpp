@@ -0,0 +1,94 @@
+#pragma once
+
+// Utilidades compartidas por las pruebas de utcommon: una imagen en memoria, una escena y
+// una configuración pequeñas para renderizar, escenas aleatorias reproducibles y archivos
+// temporales
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../common/include/config.hpp"
+#include "../common/include/prepared_scene.hpp"
+#include "../common/include/scene.hpp"
+
+namespace render::testing {
+
+  // Imagen mínima con la misma interfaz que ImageAOS / ImageSOA: la imagen completa en
+  // memoria, entrelazada, que sirve de referencia
+  struct TestImage {
+    int width{};
+    int height{};
+    std::vector<std::uint8_t> rgb;
+
+    TestImage(int w, int h)
+        : width{w}, height{h}, rgb(static_cast<size_t>(w) * static_cast<size_t>(h) * 3) { }
+
+    void set_r(size_t idx, std::uint8_t v) noexcept { rgb[idx * 3] = v; }
+
+    void set_g(size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 1] = v; }
+
+    void set_b(size_t idx, std::uint8_t v) noexcept { rgb[idx * 3 + 2] = v; }
+  };
+
+  // Una esfera mate en el origen
+  inline Scene make_small_scene() {
+    Scene scene;
+    scene.materials.emplace(
+        "mat", Material{.name = "mat", .type = "matte", .params = {0.8F, 0.3F, 0.1F}});
+    scene.spheres.push_back(Sphere(0, 0, 0, 3.0F, "mat"));
+    compile_materials(scene);
+    prepare_scene(scene);
+    return scene;
+  }
+
+  // Imagen de 24 x 18 con pocas muestras y teselas de 5 píxeles
+  inline Config make_small_config(int threads = 1) {
+    Config cfg;
+    cfg.image_width       = 24;
+    cfg.aspect_ratio      = {4, 3};
+    cfg.samples_per_pixel = 3;
+    cfg.max_depth         = 3;
+    cfg.tile_size         = 5;
+    cfg.threads           = threads;
+    return cfg;
+  }
+
+  // Escena aleatoria reproducible (la misma para cada semilla) con esferas y cilindros de
+  // ejes arbitrarios. Cada objeto tiene su propio material para identificar el impacto por
+  // material_id: i para la esfera i y n_spheres + i para el cilindro i.
+  inline Scene make_random_scene(int n_spheres, int n_cylinders, std::uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> pos(-20.0F, 20.0F);
+    std::uniform_real_distribution<float> rad(0.2F, 1.5F);
+    std::uniform_real_distribution<float> ax(-3.0F, 3.0F);
+
+    Scene scene;
+    for (int i = 0; i < n_spheres; ++i) {
+      scene.spheres.push_back(Sphere(pos(gen), pos(gen), pos(gen), rad(gen),
+                                     "s" + std::to_string(i), static_cast<std::uint32_t>(i)));
+    }
+    for (int i = 0; i < n_cylinders; ++i) {
+      scene.cylinders.push_back(Cylinder(pos(gen), pos(gen), pos(gen), rad(gen), ax(gen), ax(gen),
+                                         ax(gen), "c" + std::to_string(i),
+                                         static_cast<std::uint32_t>(n_spheres + i)));
+    }
+    prepare_scene(scene);
+    return scene;
+  }
+
+  inline std::filesystem::path temp_file(std::string const & name) {
+    return std::filesystem::temp_directory_path() / name;
+  }
+
+  inline std::string read_file(std::filesystem::path const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+}  // namespace render::testing
@@ -24,7 +24,7 @@ namespace {
 }  // namespace
 
 TEST(HitSphereTest, RayHitsCenter) {
-  Sphere s(0, 0, 0, 1.0F, "test_mat");
+  Sphere s(0, 0, 0, 1.0F, "test_mat", 7);
   Ray r(vector(0, 0, -5), vector(0, 0, 1));
 
   auto hit = hit_sphere(s, r, 0.001F, 100.0F);
@@ -33,7 +33,7 @@ TEST(HitSphereTest, RayHitsCenter) {
   EXPECT_NEAR(hit->lambda, 4.0F, epsilon);
   EXPECT_VEC_NEAR(hit->point, vector(0, 0, -1));
   EXPECT_VEC_NEAR(hit->normal, vector(0, 0, -1));
-  EXPECT_EQ(hit->material_name, "test_mat");
+  EXPECT_EQ(hit->material_id, 7U);
 }
 
 TEST(HitSphereTest, RayMisses) {
@@ -167,9 +167,10 @@ TEST(HitCylinderTest, RayFromInsideCapNormalCheck) {
 TEST(HitSceneTest, SphereOccludesCylinder) {
   Scene scene;
   // Cilindro al fondo
-  scene.cylinders.push_back(Cylinder(0, 0, 0, 1.0F, 0, 10.0F, 0, "cyl_far"));
+  scene.cylinders.push_back(Cylinder(0, 0, 0, 1.0F, 0, 10.0F, 0, "cyl_far", 1));
   // Esfera delante
-  scene.spheres.push_back(Sphere(0, 0, -3.0F, 1.0F, "sphere_near"));
+  scene.spheres.push_back(Sphere(0, 0, -3.0F, 1.0F, "sphere_near", 2));
+  prepare_scene(scene);
 
   Ray r(vector(0, 0, -10), vector(0, 0, 1));
 
@@ -179,15 +180,16 @@ TEST(HitSceneTest, SphereOccludesCylinder) {
   // El rayo golpea la esfera en lambda=6 (punto 0,0,-4)
   // El rayo golpea el cilindro en lambda=9 (punto 0,0,-1)
   EXPECT_NEAR(hit->lambda, 6.0F, epsilon);
-  EXPECT_EQ(hit->material_name, "sphere_near");
+  EXPECT_EQ(hit->material_id, 2U);  // sphere_near
 }
 
 TEST(HitSceneTest, CylinderOccludesSphere) {
   Scene scene;
   // Esfera al fondo
-  scene.spheres.push_back(Sphere(0, 0, 0, 1.0F, "sphere_far"));
+  scene.spheres.push_back(Sphere(0, 0, 0, 1.0F, "sphere_far", 1));
   // Cilindro delante
-  scene.cylinders.push_back(Cylinder(0, 0, -3.0F, 1.0F, 0, 10.0F, 0, "cyl_near"));
+  scene.cylinders.push_back(Cylinder(0, 0, -3.0F, 1.0F, 0, 10.0F, 0, "cyl_near", 2));
+  prepare_scene(scene);
 
   Ray r(vector(0, 0, -10), vector(0, 0, 1));
 
@@ -197,13 +199,14 @@ TEST(HitSceneTest, CylinderOccludesSphere) {
   // El rayo golpea el cilindro en lambda=6 (punto 0,0,-4)
   // El rayo golpea la esfera en lambda=9 (punto 0,0,-1)
   EXPECT_NEAR(hit->lambda, 6.0F, epsilon);
-  EXPECT_EQ(hit->material_name, "cyl_near");
+  EXPECT_EQ(hit->material_id, 2U);  // cyl_near
 }
 
 TEST(HitSceneTest, RayMissesAll) {
   Scene scene;
   scene.spheres.push_back(Sphere(100, 0, 0, 1.0F, "sphere_far"));
   scene.cylinders.push_back(Cylinder(-100, 0, 0, 1.0F, 0, 10.0F, 0, "cyl_far"));
+  prepare_scene(scene);
 
   Ray r(vector(0, 0, -10), vector(0, 0, 1));
 
@@ -0,0 +1,97 @@
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "../common/include/huge_page_allocator.hpp"
+
+using namespace render;
+
+namespace {
+
+  // Restaura la política al salir de cada prueba
+  struct PolicyGuard {
+    HugePagePolicy saved = huge_page_policy();
+
+    PolicyGuard()                                = default;
+    PolicyGuard(PolicyGuard const &)             = delete;
+    PolicyGuard & operator=(PolicyGuard const &) = delete;
+
+    ~PolicyGuard() { set_huge_page_policy(saved); }
+  };
+
+  bool is_aligned(void const * p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+  }
+
+}  // namespace
+
+TEST(HugePageAllocatorTest, PolicyFromSetting) {
+  EXPECT_EQ(huge_page_policy_for("off"), HugePagePolicy::off);
+  EXPECT_EQ(huge_page_policy_for("thp"), HugePagePolicy::thp);
+  EXPECT_EQ(huge_page_policy_for("hugetlb"), HugePagePolicy::hugetlb);
+  EXPECT_EQ(huge_page_policy_for("other"), HugePagePolicy::off);
+}
+
+TEST(HugePageAllocatorTest, SmallBlocksAreCacheLineAligned) {
+  huge_vector<float> small(100, 1.5F);
+  EXPECT_TRUE(is_aligned(small.data(), 64));
+  EXPECT_FLOAT_EQ(small[99], 1.5F);
+}
+
+TEST(HugePageAllocatorTest, LargeBlocksAreAlignedToHugePagesWithHugePagePolicies) {
+  PolicyGuard const guard;
+  for (HugePagePolicy const policy : {HugePagePolicy::thp, HugePagePolicy::hugetlb}) {
+    set_huge_page_policy(policy);
+    HugePageStats const before = huge_page_stats();
+
+    // Algo más de 2 MB: el bloque se redondea a 4 MB
+    huge_vector<std::uint32_t> values(huge_page_size / sizeof(std::uint32_t) + 1);
+    std::iota(values.begin(), values.end(), 0U);
+    EXPECT_TRUE(is_aligned(values.data(), huge_page_size));
+    EXPECT_EQ(values.back(), values.size() - 1);
+
+    // hugetlb sin páginas reservadas sigue como thp
+    HugePageStats const after = huge_page_stats();
+    EXPECT_EQ((after.hugetlb_bytes - before.hugetlb_bytes) +
+                  (after.advised_bytes - before.advised_bytes),
+              2 * huge_page_size);
+    EXPECT_EQ(after.regular_bytes, before.regular_bytes);
+  }
+}
+
+TEST(HugePageAllocatorTest, OffKeepsLargeBlocksOnOperatorNew) {
+  PolicyGuard const guard;
+  set_huge_page_policy(HugePagePolicy::off);
+  HugePageStats const before = huge_page_stats();
+
+  std::size_t const count = huge_page_size / sizeof(std::uint32_t) + 1;
+  huge_vector<std::uint32_t> values(count);
+  std::iota(values.begin(), values.end(), 0U);
+  EXPECT_TRUE(is_aligned(values.data(), 64));
+  EXPECT_EQ(values.back(), count - 1);
+
+  // Ni mmap propio ni MADV_HUGEPAGE: solo el tamaño pedido, sin redondear a 2 MB
+  HugePageStats const after = huge_page_stats();
+  EXPECT_EQ(after.hugetlb_bytes, before.hugetlb_bytes);
+  EXPECT_EQ(after.advised_bytes, before.advised_bytes);
+  EXPECT_EQ(after.regular_bytes - before.regular_bytes, count * sizeof(std::uint32_t));
+}
+
+TEST(HugePageAllocatorTest, BlocksSurvivePolicyChangesAndGrowth) {
+  PolicyGuard const guard;
+  set_huge_page_policy(HugePagePolicy::thp);
+  huge_vector<std::uint8_t> bytes(huge_page_size, 7);
+  set_huge_page_policy(HugePagePolicy::off);
+  bytes.resize(3 * huge_page_size, 9);  // Bloque de operator new; libera el de mmap
+  EXPECT_EQ(bytes[huge_page_size - 1], 7);
+  EXPECT_EQ(bytes[huge_page_size], 9);
+  set_huge_page_policy(HugePagePolicy::thp);
+  bytes.resize(5 * huge_page_size, 3);  // Vuelve a mmap; libera el de operator new
+  EXPECT_EQ(bytes[3 * huge_page_size - 1], 9);
+  EXPECT_EQ(bytes[3 * huge_page_size], 3);
+  bytes.clear();
+  bytes.shrink_to_fit();
+  EXPECT_TRUE(bytes.empty());
+}
@@ -0,0 +1,242 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../common/include/image_codecs.hpp"
+#include "../common/include/ppm_writer.hpp"
+
+using namespace render;
+
+namespace {
+
+  // Imagen de prueba con zonas lisas (QOI_OP_RUN), degradados (DIFF y LUMA), colores que se
+  // repiten (INDEX) y ruido (RGB)
+  struct TestImage {
+    int width{};
+    int height{};
+    std::vector<std::uint8_t> r, g, b, rgb;
+
+    TestImage(int w, int h) : width{w}, height{h} {
+      auto const n = static_cast<std::size_t>(w) * static_cast<std::size_t>(h);
+      r.resize(n);
+      g.resize(n);
+      b.resize(n);
+      rgb.resize(3 * n);
+      std::uint32_t state = 12'345;
+      auto const set      = [&](std::size_t i, unsigned red, unsigned green, unsigned blue) {
+        r[i]           = static_cast<std::uint8_t>(red);
+        g[i]           = static_cast<std::uint8_t>(green);
+        b[i]           = static_cast<std::uint8_t>(blue);
+        rgb[3 * i]     = r[i];
+        rgb[3 * i + 1] = g[i];
+        rgb[3 * i + 2] = b[i];
+      };
+      for (std::size_t i = 0; i < n; ++i) {
+        auto const x = static_cast<unsigned>(i % static_cast<std::size_t>(w));
+        auto const y = static_cast<unsigned>(i / static_cast<std::size_t>(w));
+        state        = state * 1'664'525U + 1'013'904'223U;
+        if (y < 10) {
+          set(i, 20, 40, 60);
+        } else if (y < 40) {
+          set(i, x, x + y, 2 * x);
+        } else if (y < 80) {
+          set(i, (x / 3 % 4) * 60, 90, 200);
+        } else {
+          set(i, state >> 8, state >> 16, state >> 24);
+        }
+      }
+    }
+  };
+
+  std::uint32_t read_u32_be(std::uint8_t const * data) {
+    return static_cast<std::uint32_t>(data[0]) << 24 | static_cast<std::uint32_t>(data[1]) << 16 |
+           static_cast<std::uint32_t>(data[2]) << 8 | static_cast<std::uint32_t>(data[3]);
+  }
+
+  // Decodificador QOI de referencia (como qoi.h, solo RGB)
+  std::vector<std::uint8_t> decode_qoi(std::vector<std::uint8_t> const & file, int & width,
+                                       int & height) {
+    if (file.size() < 22 or std::memcmp(file.data(), "qoif", 4) != 0) {
+      throw std::runtime_error("not a QOI file");
+    }
+    width  = static_cast<int>(read_u32_be(file.data() + 4));
+    height = static_cast<int>(read_u32_be(file.data() + 8));
+    std::size_t const n = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    std::vector<std::uint8_t> out(3 * n);
+
+    std::uint8_t index[64][4] = {};
+    std::uint8_t px[4]        = {0, 0, 0, 255};
+    std::size_t pos           = 14;
+    int run                   = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (run > 0) {
+        --run;
+      } else {
+        std::uint8_t const b1 = file.at(pos++);
+        if (b1 == 0xfe) {
+          px[0] = file.at(pos++), px[1] = file.at(pos++), px[2] = file.at(pos++);
+        } else if ((b1 & 0xc0) == 0x00) {
+          std::memcpy(px, index[b1], 4);
+        } else if ((b1 & 0xc0) == 0x40) {
+          px[0] = static_cast<std::uint8_t>(px[0] + ((b1 >> 4) & 3) - 2);
+          px[1] = static_cast<std::uint8_t>(px[1] + ((b1 >> 2) & 3) - 2);
+          px[2] = static_cast<std::uint8_t>(px[2] + (b1 & 3) - 2);
+        } else if ((b1 & 0xc0) == 0x80) {
+          std::uint8_t const b2 = file.at(pos++);
+          int const vg          = (b1 & 0x3f) - 32;
+          px[0] = static_cast<std::uint8_t>(px[0] + vg - 8 + ((b2 >> 4) & 0x0f));
+          px[1] = static_cast<std::uint8_t>(px[1] + vg);
+          px[2] = static_cast<std::uint8_t>(px[2] + vg - 8 + (b2 & 0x0f));
+        } else {
+          run = b1 & 0x3f;
+        }
+        std::memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+      }
+      std::memcpy(out.data() + 3 * i, px, 3);
+    }
+    std::vector<std::uint8_t> const end{0, 0, 0, 0, 0, 0, 0, 1};
+    if (file.size() != pos + end.size() or
+        not std::equal(end.begin(), end.end(), file.begin() + static_cast<std::ptrdiff_t>(pos))) {
+      throw std::runtime_error("bad QOI end marker");
+    }
+    return out;
+  }
+
+  // Lee un PNG de bloques almacenados: comprueba los CRC, la cabecera zlib y el Adler-32 y
+  // devuelve las filas sin el byte de filtro
+  std::vector<std::uint8_t> decode_stored_png(std::vector<std::uint8_t> const & file, int & width,
+                                              int & height) {
+    std::vector<std::uint8_t> const signature{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    if (not std::equal(signature.begin(), signature.end(), file.begin())) {
+      throw std::runtime_error("bad PNG signature");
+    }
+    std::vector<std::uint8_t> zlib;
+    std::size_t pos = signature.size();
+    bool ended      = false;
+    while (pos < file.size()) {
+      std::size_t const size = read_u32_be(&file.at(pos));
+      std::string_view const type(reinterpret_cast<char const *>(&file.at(pos + 4)), 4);
+      std::span<std::uint8_t const> const data(&file.at(pos + 8), size);
+      if (crc32({&file.at(pos + 4), size + 4}) != read_u32_be(&file.at(pos + 8 + size))) {
+        throw std::runtime_error("bad CRC");
+      }
+      if (type == "IHDR") {
+        width  = static_cast<int>(read_u32_be(data.data()));
+        height = static_cast<int>(read_u32_be(data.data() + 4));
+        EXPECT_EQ(data[8], 8);
+        EXPECT_EQ(data[9], 2);
+      } else if (type == "IDAT") {
+        zlib.insert(zlib.end(), data.begin(), data.end());
+      } else if (type == "IEND") {
+        ended = true;
+      }
+      pos += 12 + size;
+    }
+    EXPECT_TRUE(ended);
+    EXPECT_EQ((zlib.at(0) * 256 + zlib.at(1)) % 31, 0);
+
+    std::vector<std::uint8_t> raw;
+    std::size_t cursor = 2;
+    bool final         = false;
+    while (not final) {
+      final                 = (zlib.at(cursor) & 1) != 0;
+      EXPECT_EQ(zlib.at(cursor) >> 1, 0);  // BTYPE = 00
+      std::size_t const len = zlib.at(cursor + 1) | zlib.at(cursor + 2) << 8;
+      std::size_t const nlen = zlib.at(cursor + 3) | zlib.at(cursor + 4) << 8;
+      EXPECT_EQ(len ^ 0xffffU, nlen);
+      raw.insert(raw.end(), zlib.begin() + static_cast<std::ptrdiff_t>(cursor + 5),
+                 zlib.begin() + static_cast<std::ptrdiff_t>(cursor + 5 + len));
+      cursor += 5 + len;
+    }
+    EXPECT_EQ(read_u32_be(&zlib.at(cursor)), adler32(raw));
+    EXPECT_EQ(zlib.size(), cursor + 4);
+
+    std::vector<std::uint8_t> pixels;
+    std::size_t const row_bytes = 1 + 3 * static_cast<std::size_t>(width);
+    EXPECT_EQ(raw.size(), row_bytes * static_cast<std::size_t>(height));
+    for (std::size_t row = 0; row + row_bytes <= raw.size(); row += row_bytes) {
+      EXPECT_EQ(raw[row], 0);
+      pixels.insert(pixels.end(), raw.begin() + static_cast<std::ptrdiff_t>(row + 1),
+                    raw.begin() + static_cast<std::ptrdiff_t>(row + row_bytes));
+    }
+    return pixels;
+  }
+
+  std::span<std::uint8_t const> bytes_of(std::string_view text) {
+    return {reinterpret_cast<std::uint8_t const *>(text.data()), text.size()};
+  }
+
+}  // namespace
+
+TEST(ImageCodecsTest, ChecksumsMatchKnownValues) {
+  EXPECT_EQ(crc32(bytes_of("123456789")), 0xCBF43926U);
+  EXPECT_EQ(crc32(bytes_of("6789"), crc32(bytes_of("12345"))), 0xCBF43926U);
+  EXPECT_EQ(adler32(bytes_of("Wikipedia")), 0x11E60398U);
+
+  std::vector<std::uint8_t> data(20'000);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::uint8_t>(i * 7 + i / 255);
+  }
+  std::span<std::uint8_t const> const all(data);
+  EXPECT_EQ(adler32_combine(adler32(all.first(12'345)), adler32(all.subspan(12'345)),
+                            data.size() - 12'345),
+            adler32(all));
+}
+
+TEST(ImageCodecsTest, QoiRoundTripsAndDoesNotDependOnThreads) {
+  // 150 filas: tres bloques de codec_block_rows, el último incompleto
+  TestImage const image(97, 150);
+  std::vector<std::uint8_t> const file = encode_qoi(image.width, image.height, image.rgb, 1);
+  EXPECT_EQ(encode_qoi(image.width, image.height, image.rgb, 4), file);
+  EXPECT_EQ(encode_qoi_planar(image.width, image.height, image.r, image.g, image.b, 3), file);
+  EXPECT_LT(file.size(), image.rgb.size());
+
+  int width  = 0;
+  int height = 0;
+  EXPECT_EQ(decode_qoi(file, width, height), image.rgb);
+  EXPECT_EQ(width, 97);
+  EXPECT_EQ(height, 150);
+}
+
+TEST(ImageCodecsTest, StoredPngRoundTripsAcrossDeflateBlocks) {
+  // Filas de 3 * 800 + 1 bytes: cada bloque de filas ocupa varios bloques almacenados
+  TestImage const image(800, 130);
+  std::vector<std::uint8_t> const file = encode_png(image.width, image.height, image.rgb, 2);
+  EXPECT_EQ(encode_png_planar(image.width, image.height, image.r, image.g, image.b, 1), file);
+
+  int width  = 0;
+  int height = 0;
+  EXPECT_EQ(decode_stored_png(file, width, height), image.rgb);
+  EXPECT_EQ(width, 800);
+  EXPECT_EQ(height, 130);
+}
+
+TEST(ImageCodecsTest, RejectsEmptyOrShortImages) {
+  std::vector<std::uint8_t> const rgb(3 * 4);
+  EXPECT_THROW((void) encode_qoi(0, 4, rgb), std::runtime_error);
+  EXPECT_THROW((void) encode_png(2, 3, rgb), std::runtime_error);
+}
+
+TEST(ImageCodecsTest, SaveWritesTheEncodedFile) {
+  TestImage const image(40, 70);
+  auto const path = std::filesystem::temp_directory_path() / "codec_save.qoi";
+  for (OutputBackend const backend : {OutputBackend::ofstream, OutputBackend::io_uring}) {
+    write_image_planar(path.string(), image.width, image.height, image.r, image.g, image.b,
+                       ImageFormat::qoi, backend);
+    std::ifstream in(path, std::ios::binary);
+    std::vector<std::uint8_t> const file{std::istreambuf_iterator<char>(in),
+                                         std::istreambuf_iterator<char>()};
+    EXPECT_EQ(file, encode_qoi(image.width, image.height, image.rgb));
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../common/include/config.hpp"
+#include "../common/include/mapped_image.hpp"
+#include "../common/include/ppm_writer.hpp"
+#include "../common/include/renderer.hpp"
+#include "../common/include/scene.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+TEST(MappedImageTest, RenderWritesTheSameFileAsSavingAtTheEnd) {
+  Scene const scene = make_small_scene();
+  for (int const threads : {1, 4}) {
+    Config const cfg  = make_small_config(threads);
+    auto const saved  = temp_file("mapped_saved.pnm");
+    auto const mapped = temp_file("mapped_mapped.pnm");
+
+    TestImage image(24, 18);
+    (void) run_render_loop(image, cfg, scene);
+    write_image(saved.string(), 24, 18, image.rgb, ImageFormat::p6);
+
+    MappedImage output(mapped.string(), 24, 18);
+    (void) run_render_loop(output, cfg, scene);
+    EXPECT_EQ(output.released_bytes(), std::filesystem::file_size(mapped));
+    output.finish();
+
+    EXPECT_EQ(read_file(mapped), read_file(saved)) << threads << " threads";
+    std::error_code ec;
+    std::filesystem::remove(saved, ec);
+    std::filesystem::remove(mapped, ec);
+  }
+}
+
+TEST(MappedImageTest, ReleasesOnlyCompletePages) {
+  auto const path = temp_file("mapped_pages.pnm");
+  {
+    // Una sola página: no se libera hasta que todas las regiones han terminado
+    MappedImage image(path.string(), 2, 3);
+    for (std::size_t idx = 0; idx < 6; ++idx) {
+      image.set_r(idx, static_cast<std::uint8_t>(idx));
+      image.set_g(idx, static_cast<std::uint8_t>(10 + idx));
+      image.set_b(idx, static_cast<std::uint8_t>(20 + idx));
+    }
+    image.finish_region(1, 0, 2, 3);  // Columna derecha
+    EXPECT_EQ(image.released_bytes(), 0U);
+    image.finish_region(0, 2, 1, 3);  // Fila 2 completa, pero no la 0
+    EXPECT_EQ(image.released_bytes(), 0U);
+    image.finish_region(0, 0, 1, 2);
+    EXPECT_EQ(image.released_bytes(), std::string("P6\n2 3\n255\n").size() + 18);
+    EXPECT_EQ(image.get_g(4), 14);  // Las páginas liberadas se vuelven a leer del archivo
+    image.finish();
+  }
+
+  std::string expected = "P6\n2 3\n255\n";
+  for (int idx = 0; idx < 6; ++idx) {
+    expected += static_cast<char>(idx);
+    expected += static_cast<char>(10 + idx);
+    expected += static_cast<char>(20 + idx);
+  }
+  EXPECT_EQ(read_file(path), expected);
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
+
+TEST(MappedImageTest, ReleasesThePagesOfOutOfOrderTiles) {
+  // Filas de 6 páginas: la mitad izquierda de cada fila cubre al menos 2 páginas enteras,
+  // y con page_size() / 1024 * 1024 filas esas páginas suman más de 4 MiB (un lote)
+  auto const page   = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  int const width   = static_cast<int>(2 * page);
+  int const height  = static_cast<int>((std::size_t{4} << 20) / page);
+  auto const path   = temp_file("mapped_tiles.pnm");
+  auto const expect = static_cast<char>(quantize_byte(0.5F));
+  {
+    MappedImage image(path.string(), width, height);
+    std::vector<float> const gray(3 * static_cast<std::size_t>(width), 0.5F);
+    for (int y = 0; y < height; ++y) {
+      image.write_span(y, 0, gray.data(), width);
+    }
+    // Teselas de la mitad izquierda, de abajo arriba: ninguna fila está completa
+    for (int y = height; y > 0; y -= 16) {
+      image.finish_region(0, std::max(y - 16, 0), width / 2, y);
+    }
+    std::size_t const bytes = image.released_bytes();
+    EXPECT_GE(bytes, 2 * page * static_cast<std::size_t>(height));
+    EXPECT_EQ(bytes % page, 0U);
+    // Las páginas liberadas se vuelven a leer del archivo
+    EXPECT_EQ(static_cast<char>(image.get_r(static_cast<std::size_t>(width) / 4)), expect);
+
+    image.finish_region(width / 2, 0, width, height);
+    EXPECT_EQ(image.released_bytes(), std::filesystem::file_size(path));
+    image.finish();
+  }
+  std::string const contents = read_file(path);
+  EXPECT_EQ(contents.back(), expect);
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
+
+TEST(MappedImageTest, SizesTheFileWithSixtyFourBitOffsets) {
+  // 40000 x 20000 píxeles: 2.4 GB, más de lo que cabe en int. El espacio se reserva sin
+  // escribirlo (si el disco no tiene sitio, la prueba se salta) y solo se toca la última fila.
+  auto const path = temp_file("mapped_large.pnm");
+  {
+    std::unique_ptr<MappedImage> reserved;
+    try {
+      reserved = std::make_unique<MappedImage>(path.string(), 40'000, 20'000);
+    } catch (std::runtime_error const & e) {
+      GTEST_SKIP() << e.what();
+    }
+    MappedImage & image = *reserved;
+    std::vector<float> const white(3 * 4, 1.0F);
+    image.write_span(19'999, 39'996, white.data(), 4);
+    std::size_t const last = std::size_t{40'000} * 20'000 - 1;
+    EXPECT_EQ(image.get_b(last), 255);
+    EXPECT_EQ(image.get_r(last - 4), 0);
+  }
+  std::error_code ec;
+  std::string const header = "P6\n40000 20000\n255\n";
+  EXPECT_EQ(std::filesystem::file_size(path, ec), header.size() + 3ULL * 40'000 * 20'000);
+  std::filesystem::remove(path, ec);
+}
+
+TEST(MappedImageTest, ThrowsIfTheFileCannotBeCreated) {
+  EXPECT_THROW(MappedImage("/nonexistent-dir/out.pnm", 4, 4), std::runtime_error);
+}
+
+TEST(MappedImageTest, ThrowsIfTheSpaceCannotBeReserved) {
+  // /dev/full se abre, pero no admite posix_fallocate
+  if (!std::filesystem::exists("/dev/full")) {
+    GTEST_SKIP() << "no /dev/full";
+  }
+  EXPECT_THROW(MappedImage("/dev/full", 4, 4), std::runtime_error);
+  EXPECT_TRUE(std::filesystem::exists("/dev/full"));  // Un dispositivo no se borra
+}
+
+TEST(MappedImageTest, RemovesTheFileIfTheSpaceCannotBeReserved) {
+  // 2e9 x 2e9 píxeles no caben en un off_t: la reserva falla después de crear el archivo
+  auto const path = temp_file("mapped_too_large.pnm");
+  EXPECT_THROW(MappedImage(path.string(), 2'000'000'000, 2'000'000'000), std::runtime_error);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
@@ -0,0 +1,138 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../common/include/ppm_writer.hpp"
+#include "../common/include/simd.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+namespace {
+
+  // Imagen de prueba con planos separados y su versión entrelazada
+  struct Planes {
+    std::vector<std::uint8_t> r, g, b, rgb;
+
+    explicit Planes(std::size_t n) : r(n), g(n), b(n), rgb(3 * n) {
+      for (std::size_t i = 0; i < n; ++i) {
+        r[i]           = static_cast<std::uint8_t>(i);
+        g[i]           = static_cast<std::uint8_t>(255 - i % 256);
+        b[i]           = static_cast<std::uint8_t>(i * 37 + 11);
+        rgb[3 * i]     = r[i];
+        rgb[3 * i + 1] = g[i];
+        rgb[3 * i + 2] = b[i];
+      }
+    }
+  };
+
+}  // namespace
+
+TEST(PpmWriterTest, TextEncodingMatchesStreamOutput) {
+  Planes const image(256);
+  std::ostringstream expected;
+  for (std::size_t i = 0; i < 256; ++i) {
+    expected << static_cast<int>(image.r[i]) << ' ' << static_cast<int>(image.g[i]) << ' '
+             << static_cast<int>(image.b[i]) << '\n';
+  }
+
+  std::vector<char> text(256 * ppm_text_max_pixel_bytes + 4);
+  std::size_t const size = encode_ppm_text(image.rgb.data(), 256, text.data());
+  EXPECT_EQ(std::string(text.data(), size), expected.str());
+}
+
+TEST(PpmWriterTest, AvxInterleaveMatchesScalar) {
+  if (!simd::cpu_has_avx2()) {
+    GTEST_SKIP() << "CPU sin AVX2";
+  }
+  // 100 píxeles: tres grupos de 32 y un resto escalar
+  Planes const image(100);
+  std::vector<std::uint8_t> simd_out(300);
+  std::vector<std::uint8_t> scalar_out(300);
+  interleave_rgb(image.r.data(), image.g.data(), image.b.data(), simd_out.data(), 100);
+  interleave_rgb_scalar(image.r.data(), image.g.data(), image.b.data(), scalar_out.data(), 100);
+  EXPECT_EQ(simd_out, image.rgb);
+  EXPECT_EQ(scalar_out, image.rgb);
+}
+
+TEST(PpmWriterTest, FormatFollowsSettingAndExtension) {
+  EXPECT_EQ(image_format_for("out.ppm", "auto"), ImageFormat::p3);
+  EXPECT_EQ(image_format_for("out.pnm", "auto"), ImageFormat::p6);
+  EXPECT_EQ(image_format_for("out.pnm", "p3"), ImageFormat::p3);
+  EXPECT_EQ(image_format_for("out.ppm", "p6"), ImageFormat::p6);
+  EXPECT_EQ(image_format_for("out.qoi", "auto"), ImageFormat::qoi);
+  EXPECT_EQ(image_format_for("out.png", "auto"), ImageFormat::png);
+  EXPECT_EQ(image_format_for("out.ppm", "qoi"), ImageFormat::qoi);
+  EXPECT_EQ(image_format_for("out.ppm", "png"), ImageFormat::png);
+}
+
+TEST(PpmWriterTest, InterleavedAndPlanarWritersProduceTheSameFiles) {
+  // 200 x 100 píxeles: más de un bloque de escritura
+  int const width  = 200;
+  int const height = 100;
+  Planes const image(static_cast<std::size_t>(width * height));
+  auto const dir = std::filesystem::temp_directory_path();
+
+  write_image((dir / "ppm_aos.pnm").string(), width, height, image.rgb, ImageFormat::p6);
+  write_image_planar((dir / "ppm_soa.pnm").string(), width, height, image.r, image.g, image.b,
+                     ImageFormat::p6);
+  std::string const binary = read_file(dir / "ppm_aos.pnm");
+  EXPECT_EQ(binary, "P6\n200 100\n255\n" + std::string(image.rgb.begin(), image.rgb.end()));
+  EXPECT_EQ(read_file(dir / "ppm_soa.pnm"), binary);
+
+  write_image((dir / "ppm_aos.ppm").string(), width, height, image.rgb, ImageFormat::p3);
+  write_image_planar((dir / "ppm_soa.ppm").string(), width, height, image.r, image.g, image.b,
+                     ImageFormat::p3);
+  std::ostringstream expected;
+  expected << "P3\n200 100\n255\n";
+  for (std::size_t i = 0; i < image.r.size(); ++i) {
+    expected << static_cast<int>(image.r[i]) << ' ' << static_cast<int>(image.g[i]) << ' '
+             << static_cast<int>(image.b[i]) << '\n';
+  }
+  EXPECT_EQ(read_file(dir / "ppm_aos.ppm"), expected.str());
+  EXPECT_EQ(read_file(dir / "ppm_soa.ppm"), expected.str());
+
+  std::error_code ec;
+  for (char const * name : {"ppm_aos.pnm", "ppm_soa.pnm", "ppm_aos.ppm", "ppm_soa.ppm"}) {
+    std::filesystem::remove(dir / name, ec);
+  }
+}
+
+TEST(PpmWriterTest, PfmStoresRowsBottomUpAsLittleEndianFloats) {
+  int const width  = 3;
+  int const height = 2;
+  std::vector<float> rgb(3 * width * height);
+  std::vector<float> r(width * height), g(r.size()), b(r.size());
+  for (std::size_t i = 0; i < r.size(); ++i) {
+    r[i]           = 0.5F * static_cast<float>(i);
+    g[i]           = 10.0F + static_cast<float>(i);
+    b[i]           = -1.0F - static_cast<float>(i);
+    rgb[3 * i]     = r[i];
+    rgb[3 * i + 1] = g[i];
+    rgb[3 * i + 2] = b[i];
+  }
+  auto const dir = std::filesystem::temp_directory_path();
+  write_pfm((dir / "pfm_aos.pfm").string(), width, height, rgb);
+  write_pfm_planar((dir / "pfm_soa.pfm").string(), width, height, r, g, b);
+
+  // Fila de abajo (y = 1) primero
+  std::string expected = "PF\n3 2\n-1.0\n";
+  expected.append(reinterpret_cast<char const *>(rgb.data() + 9), 9 * sizeof(float));
+  expected.append(reinterpret_cast<char const *>(rgb.data()), 9 * sizeof(float));
+  std::string const file = read_file(dir / "pfm_aos.pfm");
+  EXPECT_EQ(file, expected);
+  EXPECT_EQ(read_file(dir / "pfm_soa.pfm"), file);
+
+  EXPECT_THROW(write_pfm((dir / "pfm_short.pfm").string(), 4, 2, rgb), std::runtime_error);
+
+  std::error_code ec;
+  for (char const * name : {"pfm_aos.pfm", "pfm_soa.pfm", "pfm_short.pfm"}) {
+    std::filesystem::remove(dir / name, ec);
+  }
+}
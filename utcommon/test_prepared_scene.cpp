@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../common/include/hittable.hpp"
+#include "../common/include/prepared_scene.hpp"
+#include "../common/include/scene.hpp"
+
+using namespace render;
+
+namespace {
+
+  // Mensaje de la excepción lanzada por prepare_scene (vacío si no lanza)
+  std::string prepare_error(Scene & scene) {
+    try {
+      prepare_scene(scene);
+    } catch (std::runtime_error const & e) {
+      return e.what();
+    }
+    return {};
+  }
+
+}  // namespace
+
+TEST(PreparedSceneTest, PrecomputesDerivedData) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(1, 2, 3, 0.5F, "s", 4));
+  scene.cylinders.push_back(Cylinder(0, 1, 0, 2.0F, 0, 6, 0, "c", 5));
+  prepare_scene(scene);
+
+  ASSERT_EQ(scene.prepared.spheres.size(), 1U);
+  PreparedSphere const & s = scene.prepared.spheres[0];
+  EXPECT_EQ(s.center.z(), 3.0F);
+  EXPECT_EQ(s.radius_sq, 0.25F);
+  EXPECT_EQ(s.material_id, 4U);
+
+  ASSERT_EQ(scene.prepared.cylinders.size(), 1U);
+  PreparedCylinder const & c = scene.prepared.cylinders[0];
+  EXPECT_EQ(c.axis.y(), 1.0F);
+  EXPECT_EQ(c.half_height, 3.0F);
+  EXPECT_EQ(c.radius_sq, 4.0F);
+  EXPECT_EQ(c.top.y(), 4.0F);
+  EXPECT_EQ(c.bottom.y(), -2.0F);
+  EXPECT_EQ(c.material_id, 5U);
+}
+
+TEST(PreparedSceneTest, ErrorsNameTheInvalidObject) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, 0, 1.0F, "s"));
+  scene.spheres.push_back(Sphere(0, 0, 0, 0.0F, "s"));
+  EXPECT_EQ(prepare_error(scene), "Error: Invalid sphere radius (must be > 0)\nSphere 2");
+
+  scene.spheres.pop_back();
+  scene.cylinders.push_back(Cylinder(0, 0, 0, 1.0F, 0, 0, 0, "c"));
+  EXPECT_EQ(prepare_error(scene),
+            "Error: Cylinder axis vector cannot be zero-length\nCylinder 1");
+
+  scene.cylinders[0] = Cylinder(0, 0, 0, 1.0F, 0, 1, 0, "");
+  EXPECT_EQ(prepare_error(scene), "Error: Cylinder material name is empty\nCylinder 1");
+
+  scene.cylinders[0] = Cylinder(0, 0, 0, 1.0F, 0, 1, 0, "c");
+  EXPECT_EQ(prepare_error(scene), "");
+}
+
+TEST(PreparedSceneTest, IntersectionRoutinesDoNotThrow) {
+  static_assert(noexcept(hit_sphere(std::declval<PreparedSphere const &>(),
+                                    std::declval<Ray const &>(), 0.0F, 1.0F,
+                                    std::declval<HitFault &>())));
+  static_assert(noexcept(hit_cylinder(std::declval<PreparedCylinder const &>(),
+                                      std::declval<Ray const &>(), 0.0F, 1.0F,
+                                      std::declval<HitFault &>())));
+
+  // Un discriminante INF se anota en lugar de lanzar
+  PreparedSphere const far = prepare_sphere(Sphere(3e30F, 0, 0, 1.0F, "m"));
+  HitFault fault           = HitFault::none;
+  Ray const r(vector(0, 0, 0), vector(1, 0, 0));
+  EXPECT_FALSE(hit_sphere(far, r, 0.001F, 100.0F, fault).has_value());
+  EXPECT_EQ(fault, HitFault::sphere_discriminant);
+}
+
+TEST(PreparedSceneTest, NumericFaultsAreReportedOncePerRay) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, 5, 1.0F, "m"));
+  scene.spheres.push_back(Sphere(3e30F, 0, 0, 1.0F, "m"));
+  prepare_scene(scene);
+
+  Ray const r(vector(0, 0, 0), vector(1, 0, 0));
+  try {
+    (void) hit_scene_linear(scene, r, 0.001F, 100.0F);
+    FAIL() << "Se esperaba std::runtime_error";
+  } catch (std::runtime_error const & e) {
+    EXPECT_STREQ(e.what(), "Error: Sphere discriminant produced NaN or INF");
+  }
+}
+
+TEST(PreparedSceneTest, SceneHitsMatchStandaloneObjects) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, -3.0F, 1.0F, "s", 1));
+  scene.cylinders.push_back(Cylinder(0, 0, 0, 1.0F, 0, 10.0F, 0, "c", 2));
+  prepare_scene(scene);
+
+  Ray const r(vector(0, 0, -10), vector(0, 0, 1));
+  auto const from_scene = hit_scene(scene, r, 0.001F, 100.0F);
+  auto const standalone = hit_sphere(scene.spheres[0], r, 0.001F, 100.0F);
+  ASSERT_TRUE(from_scene.has_value());
+  ASSERT_TRUE(standalone.has_value());
+  EXPECT_EQ(from_scene->lambda, standalone->lambda);
+  EXPECT_EQ(from_scene->normal.z(), standalone->normal.z());
+  EXPECT_EQ(from_scene->material_id, 1U);
+}
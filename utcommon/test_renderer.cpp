@@ -1,17 +1,27 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <gtest/gtest.h>
+#include <limits>
 #include <optional>
 #include <string>
+#include <vector>
 
 // Incluye las cabeceras de las funciones/clases que queremos probar
 #include "../common/include/config.hpp"
+#include "../common/include/hittable.hpp"
 #include "../common/include/ray.hpp"  // Necesario para crear objetos Ray en los tests
 #include "../common/include/renderer.hpp"
 #include "../common/include/rng.hpp"  // Necesario para inicializar RNG
+#include "../common/include/sample_map.hpp"
+#include "../common/include/scene.hpp"
+#include "../common/include/tone_map.hpp"
 #include "../common/include/vector.hpp"
+#include "test_helpers.hpp"
 
 // Usar el namespace de tu proyecto
 using namespace render;
+using namespace render::testing;
 
 constexpr float epsilon = 1e-5F;
 
@@ -280,3 +290,428 @@ TEST(RayColorTest, DepthLimitStopsRecursion) {
 
   EXPECT_VEC_NEAR(color, vector(0.0F, 0.0F, 0.0F));
 }
+
+namespace {
+
+  // Versión recursiva original de ray_color, como referencia para el bucle iterativo
+  vector recursive_ray_color(Ray const & r, Scene const & scene, RenderContext & ctx,
+                             int depth) {
+    if (depth <= 0) {
+      return {0.F, 0.F, 0.F};
+    }
+    auto hit = hit_scene(scene, r, 0.001F, std::numeric_limits<float>::infinity());
+    if (not hit) {
+      float m = (r.direction().y() + 1.0F) * 0.5F;
+      return (1.0F - m) * ctx.bg_light + m * ctx.bg_dark;
+    }
+    CompiledMaterial const & mat = scene.material_table[hit->material_id];
+    switch (mat.kind) {
+      case MaterialKind::matte: {
+        vector bounce_direction = hit->normal + ctx.material_rng.random_in_unit_sphere();
+        if (std::fabs(bounce_direction.x()) < 1e-8F and
+            std::fabs(bounce_direction.y()) < 1e-8F and std::fabs(bounce_direction.z()) < 1e-8F)
+        {
+          bounce_direction = hit->normal;
+        }
+        Ray bounced_ray(hit->point, bounce_direction.normalized());
+        return mat.albedo * recursive_ray_color(bounced_ray, scene, ctx, depth - 1);
+      }
+      case MaterialKind::metal: {
+        vector reflected = reflect(r.direction(), hit->normal);
+        vector bounce_direction =
+            (reflected + mat.roughness * ctx.material_rng.random_in_unit_sphere());
+        return mat.albedo *
+               recursive_ray_color(Ray(hit->point, bounce_direction), scene, ctx, depth - 1);
+      }
+      case MaterialKind::refractive: {
+        bool const front_face        = dot(r.direction(), hit->normal) < 0.F;
+        vector const normal          = front_face ? hit->normal : -hit->normal;
+        float const refraction_ratio = front_face ? (1.0F / mat.ior) : mat.ior;
+        auto refracted_opt           = refract(r.direction(), normal, refraction_ratio);
+        vector const direction =
+            refracted_opt ? *refracted_opt : reflect(r.direction(), normal);
+        return mat.albedo * recursive_ray_color(Ray(hit->point, direction), scene, ctx, depth - 1);
+      }
+    }
+    return {1.F, 0.F, 1.F};
+  }
+
+  // Escena con los tres tipos de material para recorrer caminos largos
+  Scene make_mixed_scene() {
+    Scene scene;
+    scene.materials.emplace(
+        "mate", Material{.name = "mate", .type = "matte", .params = {0.8F, 0.3F, 0.1F}});
+    scene.materials.emplace(
+        "metal", Material{.name = "metal", .type = "metal", .params = {0.9F, 0.7F, 0.6F, 0.2F}});
+    scene.materials.emplace(
+        "vidrio", Material{.name = "vidrio", .type = "refractive", .params = {1.5F}});
+    scene.spheres.push_back(Sphere(0, -101.0F, -3.0F, 100.0F, "mate"));
+    scene.spheres.push_back(Sphere(-1.2F, 0, -3.0F, 0.6F, "metal"));
+    scene.spheres.push_back(Sphere(0, 0, -3.0F, 0.6F, "vidrio"));
+    scene.cylinders.push_back(Cylinder(1.2F, 0, -3.0F, 0.5F, 0, 1.0F, 0, "mate"));
+    compile_materials(scene);
+    prepare_scene(scene);
+    return scene;
+  }
+
+}  // namespace
+
+TEST(RayColorTest, IterativePathMatchesRecursiveBitForBit) {
+  Scene const scene = make_mixed_scene();
+  Config cfg;
+  cfg.max_depth = 9;
+  RenderContext iterative = make_render_context(cfg, 7, 11);
+  RenderContext recursive = make_render_context(cfg, 7, 11);
+
+  for (int i = 0; i < 2'000; ++i) {
+    float const u = iterative.ray_rng.random_float() * 2.F - 1.F;
+    float const v = iterative.ray_rng.random_float() * 2.F - 1.F;
+    Ray const r(vector(0, 0, 0), vector(u, v * 0.5F, -1.0F));
+
+    vector const a = ray_color(r, scene, iterative, cfg.max_depth);
+    vector const b = recursive_ray_color(r, scene, recursive, cfg.max_depth);
+    ASSERT_EQ(a.x(), b.x()) << "rayo " << i;
+    ASSERT_EQ(a.y(), b.y()) << "rayo " << i;
+    ASSERT_EQ(a.z(), b.z()) << "rayo " << i;
+  }
+}
+
+TEST(RayColorTest, TracePathReportsThroughputAndBounces) {
+  Scene const scene = make_mixed_scene();
+  Config cfg;
+  RenderContext ctx = make_render_context(cfg, 1, 2);
+
+  // Hacia arriba no hay nada: el camino termina sin rebotar
+  PathState sky{.ray = Ray(vector(0, 0, 0), vector(0, 1, 0))};
+  (void) trace_path(sky, scene, ctx, 5);
+  EXPECT_EQ(sky.bounces, 0);
+  EXPECT_VEC_NEAR(sky.throughput, vector(1.F, 1.F, 1.F));
+
+  // Hacia el suelo mate: al menos un rebote y el throughput incluye su albedo
+  PathState ground{.ray = Ray(vector(0, 0, 0), vector(0, -1, 0))};
+  (void) trace_path(ground, scene, ctx, 5);
+  ASSERT_GE(ground.bounces, 1);
+  EXPECT_LE(ground.bounces, 5);
+  EXPECT_LE(ground.throughput.x(), 0.8F);
+  EXPECT_LE(ground.throughput.z(), 0.1F);
+}
+
+namespace {
+
+  // Color medio de 'samples' caminos lanzados con el mismo rayo
+  vector mean_path_color(Scene const & scene, RenderContext & ctx, Ray const & r, int samples) {
+    vector sum(0, 0, 0);
+    for (int i = 0; i < samples; ++i) {
+      sum += ray_color(r, scene, ctx, 9);
+    }
+    return sum / static_cast<float>(samples);
+  }
+
+}  // namespace
+
+TEST(RayColorTest, RussianRouletteKeepsTheExpectedColor) {
+  Scene const scene = make_mixed_scene();
+  Ray const r(vector(0, 0, 0), vector(0.2F, -0.4F, -1.0F));
+
+  RenderContext plain     = make_render_context(Config{}, 3, 5);
+  RenderContext roulette  = make_render_context(Config{}, 4, 6);
+  roulette.roulette_depth = 1;
+
+  vector const expected = mean_path_color(scene, plain, r, 40'000);
+  vector const actual   = mean_path_color(scene, roulette, r, 40'000);
+  EXPECT_VEC_NEAR(actual, expected, 0.01F);
+
+  // La ruleta acorta los caminos
+  EXPECT_GT(roulette.stats.roulette_terminated, 0U);
+  EXPECT_LT(roulette.stats.average_length(), plain.stats.average_length());
+  EXPECT_EQ(plain.stats.paths, 40'000U);
+  EXPECT_EQ(plain.stats.roulette_terminated, 0U);
+}
+
+TEST(RayColorTest, ThroughputThresholdEndsDarkPaths) {
+  Scene const scene        = make_mixed_scene();
+  RenderContext ctx        = make_render_context(Config{}, 1, 2);
+  ctx.throughput_threshold = 0.9F;
+
+  // El suelo mate tiene albedo máximo 0.8: el camino termina tras el primer rebote
+  PathState ground{.ray = Ray(vector(0, 0, 0), vector(0, -1, 0))};
+  vector const color = trace_path(ground, scene, ctx, 9);
+  EXPECT_EQ(ground.bounces, 1);
+  EXPECT_VEC_NEAR(color, vector(0, 0, 0));
+  EXPECT_EQ(ctx.stats.threshold_terminated, 1U);
+  EXPECT_EQ(ctx.stats.segments, 1U);
+}
+
+// ----------------------------------------------------------------------
+// --- Pruebas para el render por teselas ---
+// ----------------------------------------------------------------------
+
+namespace {
+
+  // Imagen con escritura por filas: el bucle de render le pasa cada fila de tesela con
+  // write_span en lugar de llamar a set_r/g/b por píxel
+  struct TestSpanImage {
+    int width{};
+    int height{};
+    std::vector<std::uint8_t> rgb;
+    int spans{};
+
+    TestSpanImage(int w, int h)
+        : width{w}, height{h}, rgb(static_cast<size_t>(w) * static_cast<size_t>(h) * 3) { }
+
+    void write_span(int y, int x0, float const * values, int n) noexcept {
+      auto const first = static_cast<size_t>(y) * static_cast<size_t>(width) +
+                         static_cast<size_t>(x0);
+      quantize(values, rgb.data() + 3 * first, 3 * static_cast<size_t>(n));
+      ++spans;
+    }
+  };
+
+  // Framebuffer float: store_pixel guarda el color lineal con set_linear
+  struct TestHdrImage {
+    int width{};
+    int height{};
+    std::vector<float> rgb;
+
+    TestHdrImage(int w, int h)
+        : width{w}, height{h}, rgb(static_cast<size_t>(w) * static_cast<size_t>(h) * 3) { }
+
+    void set_linear(size_t idx, float r, float g, float b) noexcept {
+      rgb[idx * 3]     = r;
+      rgb[idx * 3 + 1] = g;
+      rgb[idx * 3 + 2] = b;
+    }
+  };
+
+  TestImage render_with_threads(int threads, std::string const & rng_mode = "legacy",
+                                int tile_size = 5) {
+    Config cfg    = make_small_config();
+    cfg.threads   = threads;
+    cfg.rng_mode  = rng_mode;
+    cfg.tile_size = tile_size;
+    TestImage image(24, 18);
+    run_render_loop(image, cfg, make_small_scene());
+    return image;
+  }
+
+}  // namespace
+
+TEST(TileTest, TilesCoverImageWithoutOverlap) {
+  auto const tiles = make_tiles(10, 7, 4);
+  ASSERT_EQ(tiles.size(), 6U);  // 3 columnas x 2 filas
+
+  std::vector<int> covered(70, 0);
+  for (auto const & t : tiles) {
+    for (int y = t.y0; y < t.y1; ++y) {
+      for (int x = t.x0; x < t.x1; ++x) {
+        ++covered[static_cast<size_t>(y * 10 + x)];
+      }
+    }
+  }
+  for (int c : covered) {
+    EXPECT_EQ(c, 1);
+  }
+  EXPECT_EQ(tiles.back().x1, 10);
+  EXPECT_EQ(tiles.back().y1, 7);
+}
+
+TEST(TileTest, TiledRenderDoesNotDependOnThreadCount) {
+  TestImage const two  = render_with_threads(2);
+  TestImage const four = render_with_threads(4);
+  EXPECT_EQ(two.rgb, four.rgb);
+}
+
+TEST(TileTest, RowSpansMatchPerPixelWrites) {
+  Scene const scene = make_small_scene();
+  for (std::string const rng_mode : {"legacy", "per_pixel"}) {
+    for (int const threads : {1, 3}) {
+      Config cfg   = make_small_config();
+      cfg.threads  = threads;
+      cfg.rng_mode = rng_mode;
+      TestImage pixels(24, 18);
+      TestSpanImage spans(24, 18);
+      (void) run_render_loop(pixels, cfg, scene);
+      (void) run_render_loop(spans, cfg, scene);
+      EXPECT_EQ(spans.rgb, pixels.rgb) << rng_mode << ", " << threads << " threads";
+      // Una llamada por fila (de la imagen o de cada tesela de 5 columnas)
+      bool const sequential = threads == 1 and rng_mode == "legacy";
+      EXPECT_EQ(spans.spans, sequential ? 18 : 18 * 5) << rng_mode;
+    }
+  }
+}
+
+TEST(TileTest, HdrRenderToneMapsToTheSameBytes) {
+  Config cfg        = make_small_config();
+  cfg.threads       = 2;
+  cfg.rng_mode      = "per_pixel";
+  Scene const scene = make_small_scene();
+  TestImage ldr(24, 18);
+  TestHdrImage hdr(24, 18);
+  (void) run_render_loop(ldr, cfg, scene);
+  (void) run_render_loop(hdr, cfg, scene);
+
+  std::vector<std::uint8_t> mapped(hdr.rgb.size());
+  GammaTable(1.0F / cfg.gamma).apply(hdr.rgb.data(), mapped.data(), hdr.rgb.size());
+  EXPECT_EQ(mapped, ldr.rgb);
+}
+
+TEST(TileTest, SequentialRenderMatchesLegacyLoop) {
+  TestImage const image = render_with_threads(1);
+
+  // Reproduce a mano el recorrido secuencial original
+  Config const cfg   = make_small_config();
+  Scene const scene  = make_small_scene();
+  Camera const cam(cfg);
+  RenderContext ctx = make_render_context(cfg, static_cast<uint64_t>(cfg.material_rng_seed),
+                                          static_cast<uint64_t>(cfg.ray_rng_seed));
+  TestImage expected(24, 18);
+  for (int y = 0; y < 18; ++y) {
+    for (int x = 0; x < 24; ++x) {
+      render_pixel(expected, cam, scene, ctx, x, y, cfg.samples_per_pixel);
+    }
+  }
+  EXPECT_EQ(image.rgb, expected.rgb);
+}
+
+TEST(TileTest, RngEngineSelectsTheLegacyGenerator) {
+  Config cfg        = make_small_config();
+  Scene const scene = make_small_scene();
+  TestImage mersenne(24, 18);
+  (void) run_render_loop(mersenne, cfg, scene);
+
+  for (std::string const engine : {"xoshiro", "pcg", "batch"}) {
+    cfg.rng_engine = engine;
+    cfg.threads    = 1;
+    TestImage sequential(24, 18);
+    (void) run_render_loop(sequential, cfg, scene);
+    EXPECT_NE(sequential.rgb, mersenne.rgb) << engine;
+
+    // Por teselas también es reproducible con el mismo número de hilos
+    cfg.threads = 3;
+    TestImage first(24, 18);
+    TestImage second(24, 18);
+    (void) run_render_loop(first, cfg, scene);
+    (void) run_render_loop(second, cfg, scene);
+    EXPECT_EQ(first.rgb, second.rgb) << engine;
+  }
+
+  // El recorrido secuencial con "xoshiro" es el original con XoshiroRNG
+  cfg.rng_engine = "xoshiro";
+  cfg.threads    = 1;
+  TestImage image(24, 18);
+  (void) run_render_loop(image, cfg, scene);
+  Camera const cam(cfg);
+  auto ctx = make_render_context<XoshiroRNG>(cfg, static_cast<uint64_t>(cfg.material_rng_seed),
+                                             static_cast<uint64_t>(cfg.ray_rng_seed));
+  TestImage expected(24, 18);
+  for (int y = 0; y < 18; ++y) {
+    for (int x = 0; x < 24; ++x) {
+      render_pixel(expected, cam, scene, ctx, x, y, cfg.samples_per_pixel);
+    }
+  }
+  EXPECT_EQ(image.rgb, expected.rgb);
+}
+
+TEST(TileTest, DirectBallSamplingIsOptIn) {
+  Config cfg        = make_small_config();
+  Scene const scene = make_small_scene();
+  TestImage rejection(24, 18);
+  (void) run_render_loop(rejection, cfg, scene);
+
+  cfg.ball_sampling = "direct";
+  TestImage direct(24, 18);
+  TestImage again(24, 18);
+  (void) run_render_loop(direct, cfg, scene);
+  (void) run_render_loop(again, cfg, scene);
+  EXPECT_NE(direct.rgb, rejection.rgb);
+  EXPECT_EQ(direct.rgb, again.rgb);
+
+  // Con flujos por píxel sigue sin depender de hilos ni teselas
+  cfg.rng_mode = "per_pixel";
+  TestImage one_thread(24, 18);
+  (void) run_render_loop(one_thread, cfg, scene);
+  cfg.threads   = 3;
+  cfg.tile_size = 7;
+  TestImage three_threads(24, 18);
+  (void) run_render_loop(three_threads, cfg, scene);
+  EXPECT_EQ(one_thread.rgb, three_threads.rgb);
+}
+
+TEST(TileTest, RenderLoopCountsOnePathPerSample) {
+  Config cfg = make_small_config();
+  for (int threads : {1, 3}) {
+    cfg.threads = threads;
+    TestImage image(24, 18);
+    PathStats const stats = run_render_loop(image, cfg, make_small_scene());
+    EXPECT_EQ(stats.paths, 24U * 18U * 3U);
+    EXPECT_GE(stats.average_length(), 1.0);
+    EXPECT_LE(stats.average_length(), 3.0);
+  }
+}
+
+TEST(TileTest, AdaptiveSamplingSpendsSamplesOnNoisyPixels) {
+  Config cfg               = make_small_config();
+  cfg.samples_per_pixel    = 32;
+  cfg.adaptive_min_samples = 4;
+  cfg.adaptive_tolerance   = 0.01F;
+  cfg.max_depth            = 5;
+
+  for (std::string const mode : {"legacy", "per_pixel"}) {
+    cfg.rng_mode = mode;
+    TestImage image(24, 18);
+    SampleMap map(24, 18);
+    PathStats const stats = run_render_loop(image, cfg, make_small_scene(), &map);
+
+    EXPECT_EQ(map.total(), stats.paths);
+    EXPECT_LT(map.total(), 24U * 18U * 32U);
+    uint32_t fewest = 32;
+    uint32_t most   = 0;
+    for (uint32_t const n : map.counts) {
+      EXPECT_GE(n, 4U);
+      EXPECT_LE(n, 32U);
+      fewest = std::min(fewest, n);
+      most   = std::max(most, n);
+    }
+    EXPECT_EQ(fewest, 4U);  // El fondo converge con el mínimo de muestras
+    EXPECT_EQ(most, 32U);   // La esfera mate necesita todas
+  }
+}
+
+TEST(TileTest, FixedSamplingTakesEverySample) {
+  Config const cfg = make_small_config();
+  TestImage image(24, 18);
+  SampleMap map(24, 18);
+  (void) run_render_loop(image, cfg, make_small_scene(), &map);
+  for (uint32_t const n : map.counts) {
+    EXPECT_EQ(n, 3U);
+  }
+}
+
+TEST(TileTest, SamplersAreIndependentOfThreadsAndTiles) {
+  for (std::string const sampler : {"stratified", "sobol"}) {
+    Config cfg  = make_small_config();
+    cfg.sampler = sampler;
+    TestImage reference(24, 18);
+    (void) run_render_loop(reference, cfg, make_small_scene());
+
+    cfg.threads   = 3;
+    cfg.tile_size = 7;
+    TestImage other(24, 18);
+    (void) run_render_loop(other, cfg, make_small_scene());
+    EXPECT_EQ(other.rgb, reference.rgb) << sampler;
+
+    // El patrón cambia la imagen respecto a los flujos independientes
+    cfg.sampler  = "random";
+    cfg.rng_mode = "per_pixel";
+    TestImage random(24, 18);
+    (void) run_render_loop(random, cfg, make_small_scene());
+    EXPECT_NE(random.rgb, reference.rgb) << sampler;
+  }
+}
+
+TEST(TileTest, PerPixelStreamsAreIndependentOfThreadsAndTiles) {
+  TestImage const reference = render_with_threads(1, "per_pixel", 5);
+  EXPECT_EQ(render_with_threads(3, "per_pixel", 5).rgb, reference.rgb);
+  EXPECT_EQ(render_with_threads(2, "per_pixel", 7).rgb, reference.rgb);
+  EXPECT_EQ(render_with_threads(4, "per_pixel", 64).rgb, reference.rgb);
+}
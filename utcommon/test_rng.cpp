@@ -0,0 +1,167 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <set>
+
+#include "../common/include/rng.hpp"
+
+using namespace render;
+
+namespace {
+
+  // Media 0.5 y los valores repartidos por igual en diez intervalos de [0, 1)
+  template <typename R>
+  void expect_uniform(R rng) {
+    int const n = 100'000;
+    double sum  = 0.0;
+    std::array<int, 10> buckets{};
+    for (int i = 0; i < n; ++i) {
+      float const v = rng.random_float();
+      ASSERT_GE(v, 0.0F);
+      ASSERT_LT(v, 1.0F);
+      sum += v;
+      ++buckets[static_cast<std::size_t>(v * 10.0F)];
+    }
+    EXPECT_NEAR(sum / n, 0.5, 0.01);
+    for (int const count : buckets) {
+      EXPECT_NEAR(count, n / 10, n / 100);
+    }
+  }
+
+}  // namespace
+
+TEST(RNGTest, MersenneSequenceIsReproducible) {
+  RNG a(19);
+  RNG b(19);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(a.random_float(), b.random_float());
+  }
+}
+
+TEST(RNGTest, CounterEngineStaysInUnitInterval) {
+  StreamRNG rng(pixel_stream_key(13, 4, 5, 0));
+  for (int i = 0; i < 10'000; ++i) {
+    float const v = rng.random_float();
+    EXPECT_GE(v, 0.0F);
+    EXPECT_LT(v, 1.0F);
+  }
+}
+
+TEST(RNGTest, CounterEngineMeanIsCentered) {
+  StreamRNG rng(pixel_stream_key(7, 0, 0, 0));
+  double sum    = 0.0;
+  int const n   = 100'000;
+  for (int i = 0; i < n; ++i) {
+    sum += rng.random_float();
+  }
+  EXPECT_NEAR(sum / n, 0.5, 0.01);
+}
+
+TEST(RNGTest, PixelStreamKeysAreDistinct) {
+  std::set<uint64_t> keys;
+  for (uint32_t y = 0; y < 16; ++y) {
+    for (uint32_t x = 0; x < 16; ++x) {
+      for (uint32_t s = 0; s < 4; ++s) {
+        keys.insert(pixel_stream_key(19, x, y, s));
+      }
+    }
+  }
+  EXPECT_EQ(keys.size(), 16U * 16U * 4U);
+  // Semillas distintas producen claves distintas para la misma muestra
+  EXPECT_NE(pixel_stream_key(19, 1, 2, 3), pixel_stream_key(13, 1, 2, 3));
+}
+
+TEST(RNGTest, SameStreamKeyGivesSameSequence) {
+  StreamRNG a(pixel_stream_key(19, 10, 20, 2));
+  StreamRNG b(pixel_stream_key(19, 10, 20, 2));
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_EQ(a.random_float(), b.random_float());
+  }
+}
+
+TEST(RNGTest, RandomInUnitSphereIsInside) {
+  StreamRNG rng(pixel_stream_key(1, 2, 3, 4));
+  for (int i = 0; i < 1'000; ++i) {
+    EXPECT_LT(rng.random_in_unit_sphere().length_squared(), 1.0F);
+  }
+}
+
+TEST(RNGTest, BitTrickConversionCoversTheInterval) {
+  EXPECT_EQ(bits_to_unit_float(0), 0.0F);
+  EXPECT_EQ(bits_to_unit_float(0x8000'0000U), 0.5F);
+  EXPECT_EQ(bits_to_unit_float(0xFFFF'FFFFU), 1.0F - 0x1.0p-23F);
+}
+
+TEST(RNGTest, FastEnginesAreReproducibleAndDependOnTheSeed) {
+  XoshiroRNG xa(19);
+  XoshiroRNG xb(19);
+  XoshiroRNG xc(13);
+  PcgRNG pa(19);
+  PcgRNG pb(19);
+  PcgRNG pc(13);
+  int x_differences = 0;
+  int p_differences = 0;
+  for (int i = 0; i < 100; ++i) {
+    float const x = xa.random_float();
+    float const p = pa.random_float();
+    EXPECT_EQ(x, xb.random_float());
+    EXPECT_EQ(p, pb.random_float());
+    x_differences += x != xc.random_float() ? 1 : 0;
+    p_differences += p != pc.random_float() ? 1 : 0;
+  }
+  EXPECT_GT(x_differences, 90);
+  EXPECT_GT(p_differences, 90);
+}
+
+TEST(RNGTest, FastEnginesAreUniform) {
+  expect_uniform(XoshiroRNG(7));
+  expect_uniform(PcgRNG(7));
+}
+
+TEST(RNGTest, FastEnginesHaveSmallState) {
+  EXPECT_LE(sizeof(XoshiroRNG), 32U);
+  EXPECT_LE(sizeof(PcgRNG), 16U);
+  EXPECT_GT(sizeof(RNG), 2'000U);
+}
+
+TEST(RNGTest, FastCbrtMatchesStd) {
+  EXPECT_EQ(fast_cbrt(0.0F), 0.0F);
+  EXPECT_NEAR(fast_cbrt(1.0F), 1.0F, 1e-6F);
+  for (int i = 1; i <= 1'000; ++i) {
+    float const x = static_cast<float>(i) / 1'000.0F;
+    EXPECT_NEAR(fast_cbrt(x), std::cbrt(x), 1e-6F * std::cbrt(x)) << x;
+  }
+}
+
+TEST(RNGTest, DirectBallSamplingIsUniform) {
+  XoshiroRNG rng(11);
+  int const n         = 200'000;
+  double radius_cubed = 0.0;
+  std::array<double, 3> mean{};
+  std::array<double, 3> square{};
+  std::array<int, 8> octants{};
+  for (int i = 0; i < n; ++i) {
+    vector const p = rng.random_in_unit_ball();
+    ASSERT_LT(p.length_squared(), 1.0F);
+    radius_cubed += std::pow(static_cast<double>(p.magnitude()), 3.0);
+    std::array<float, 3> const c{p.x(), p.y(), p.z()};
+    std::size_t octant = 0;
+    for (std::size_t k = 0; k < 3; ++k) {
+      mean[k]   += c[k];
+      square[k] += static_cast<double>(c[k]) * c[k];
+      octant    |= (c[k] < 0.0F ? 1U : 0U) << k;
+    }
+    ++octants[octant];
+  }
+  // En la bola uniforme r^3 es uniforme, la media es 0 y E[x^2] = 1/5
+  EXPECT_NEAR(radius_cubed / n, 0.5, 0.005);
+  for (std::size_t k = 0; k < 3; ++k) {
+    EXPECT_NEAR(mean[k] / n, 0.0, 0.005);
+    EXPECT_NEAR(square[k] / n, 0.2, 0.005);
+  }
+  for (int const count : octants) {
+    EXPECT_NEAR(count, n / 8, n / 80);
+  }
+}
@@ -0,0 +1,52 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../common/include/sample_map.hpp"
+
+using render::SampleMap;
+
+TEST(SampleMapTest, StoresCountsInRowMajorOrder) {
+  SampleMap map(3, 2);
+  EXPECT_EQ(map.counts.size(), 6U);
+  EXPECT_EQ(map.total(), 0U);
+
+  map.set(2, 0, 7);
+  map.set(0, 1, 5);
+  EXPECT_EQ(map.at(2, 0), 7U);
+  EXPECT_EQ(map.at(0, 1), 5U);
+  EXPECT_EQ(map.counts[2], 7U);
+  EXPECT_EQ(map.counts[3], 5U);
+  EXPECT_EQ(map.total(), 12U);
+}
+
+TEST(SampleMapTest, SavesExactCountsAsPgm) {
+  SampleMap map(2, 2);
+  map.set(0, 0, 4);
+  map.set(1, 0, 16);
+  map.set(0, 1, 9);
+  map.set(1, 1, 4);
+
+  auto const tmp = std::filesystem::temp_directory_path() / "sample_map_test.pgm";
+  map.save_to_pgm(tmp.string());
+
+  std::ifstream in(tmp);
+  ASSERT_TRUE(in.is_open());
+  std::string magic;
+  int w = 0, h = 0, maxval = 0;
+  in >> magic >> w >> h >> maxval;
+  EXPECT_EQ(magic, "P2");
+  EXPECT_EQ(w, 2);
+  EXPECT_EQ(h, 2);
+  EXPECT_EQ(maxval, 16);
+
+  int a = 0, b = 0, c = 0, d = 0;
+  in >> a >> b >> c >> d;
+  EXPECT_EQ(a, 4);
+  EXPECT_EQ(b, 16);
+  EXPECT_EQ(c, 9);
+  EXPECT_EQ(d, 4);
+
+  std::filesystem::remove(tmp);
+}
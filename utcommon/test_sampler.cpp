@@ -0,0 +1,139 @@
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <set>
+#include <vector>
+
+#include "../common/include/sampler.hpp"
+
+using namespace render;
+
+namespace {
+
+  struct Point {
+    float u{};
+    float v{};
+  };
+
+  // Primer par 2D (el jitter del píxel) de todas las muestras de un píxel
+  template <typename Sampler>
+  std::vector<Point> first_pair(uint64_t key, uint32_t count) {
+    std::vector<Point> points;
+    for (uint32_t s = 0; s < count; ++s) {
+      Sampler sampler(key, s, count);
+      float const u = sampler.random_float();
+      float const v = sampler.random_float();
+      points.push_back({u, v});
+    }
+    return points;
+  }
+
+  // Cuántos puntos caen en cada celda de una rejilla cols x rows
+  std::vector<int> cell_counts(std::vector<Point> const & points, int cols, int rows) {
+    std::vector<int> counts(static_cast<std::size_t>(cols * rows), 0);
+    for (Point const & p : points) {
+      auto const cx = static_cast<int>(p.u * static_cast<float>(cols));
+      auto const cy = static_cast<int>(p.v * static_cast<float>(rows));
+      ++counts[static_cast<std::size_t>(cy * cols + cx)];
+    }
+    return counts;
+  }
+
+  void expect_one_per_cell(std::vector<Point> const & points, int cols, int rows) {
+    for (int const n : cell_counts(points, cols, rows)) {
+      EXPECT_EQ(n, 1);
+    }
+  }
+
+}  // namespace
+
+TEST(SamplerTest, ValuesStayInUnitInterval) {
+  for (uint32_t s = 0; s < 64; ++s) {
+    StratifiedSampler strat(123, s, 64);
+    SobolSampler sobol(123, s, 64);
+    for (int d = 0; d < 50; ++d) {
+      for (float const v : {strat.random_float(), sobol.random_float()}) {
+        EXPECT_GE(v, 0.0F);
+        EXPECT_LT(v, 1.0F);
+      }
+    }
+  }
+}
+
+TEST(SamplerTest, StratifiedPairsCoverEveryCellAndRow) {
+  auto const points = first_pair<StratifiedSampler>(77, 16);
+  expect_one_per_cell(points, 4, 4);   // Jittered: un punto por celda
+  expect_one_per_cell(points, 16, 1);  // N-rooks: un punto por columna
+  expect_one_per_cell(points, 1, 16);  // y por fila
+
+  // Con un número no cuadrado, cada proyección sigue estratificada
+  auto const twelve = first_pair<StratifiedSampler>(5, 12);
+  expect_one_per_cell(twelve, 3, 4);
+  expect_one_per_cell(twelve, 12, 1);
+}
+
+TEST(SamplerTest, SobolPairsAreNets) {
+  auto const points = first_pair<SobolSampler>(91, 64);
+  for (int k = 0; k <= 6; ++k) {
+    // Intervalos elementales de 2^k x 2^(6-k): exactamente un punto en cada uno
+    expect_one_per_cell(points, 1 << k, 1 << (6 - k));
+  }
+
+  // Cualquier prefijo de potencia de dos también es una red
+  auto const prefix = std::vector<Point>(points.begin(), points.begin() + 16);
+  expect_one_per_cell(prefix, 4, 4);
+}
+
+TEST(SamplerTest, PatternsDependOnPixelKeyAndDimension) {
+  auto const a = first_pair<SobolSampler>(1, 8);
+  auto const b = first_pair<SobolSampler>(2, 8);
+  EXPECT_NE(a[0].u, b[0].u);
+
+  // Dimensiones posteriores usan otra aleatorización
+  SobolSampler sampler(1, 0, 8);
+  float const first  = sampler.random_float();
+  (void) sampler.random_float();
+  float const second = sampler.random_float();
+  EXPECT_NE(first, second);
+
+  // Mismas entradas, mismos valores
+  EXPECT_EQ(first_pair<StratifiedSampler>(9, 8)[3].v, first_pair<StratifiedSampler>(9, 8)[3].v);
+}
+
+TEST(SamplerTest, UnitSphereSamplesAreInsideAndUniform) {
+  uint32_t const count = 4'096;
+  double radius_cubed  = 0.0;
+  double mean_x        = 0.0;
+  for (uint32_t s = 0; s < count; ++s) {
+    SobolSampler sampler(17, s, count);
+    vector const p = sampler.random_in_unit_sphere();
+    ASSERT_LT(p.length_squared(), 1.0F);
+    radius_cubed += std::pow(static_cast<double>(p.magnitude()), 3.0);
+    mean_x       += p.x();
+  }
+  // En una bola uniforme r^3 es uniforme en [0, 1) y la media de x es 0
+  EXPECT_NEAR(radius_cubed / count, 0.5, 0.01);
+  EXPECT_NEAR(mean_x / count, 0.0, 0.01);
+}
+
+TEST(SamplerTest, StratifiedMeanConvergesFasterThanIndependent) {
+  // Integral de u*v en [0,1)^2 = 0.25 con 64 muestras por "píxel", promediando el error
+  // cuadrático sobre muchos píxeles
+  double strat_error = 0.0;
+  double sobol_error = 0.0;
+  for (uint64_t key = 0; key < 200; ++key) {
+    double strat = 0.0;
+    double sobol = 0.0;
+    for (Point const & p : first_pair<StratifiedSampler>(key, 64)) {
+      strat += static_cast<double>(p.u * p.v);
+    }
+    for (Point const & p : first_pair<SobolSampler>(key, 64)) {
+      sobol += static_cast<double>(p.u * p.v);
+    }
+    strat_error += std::pow(strat / 64.0 - 0.25, 2.0);
+    sobol_error += std::pow(sobol / 64.0 - 0.25, 2.0);
+  }
+  // Con muestras independientes el error cuadrático medio sería Var(uv)/64 ~ 7.6e-4
+  EXPECT_LT(strat_error / 200.0, 1e-4);
+  EXPECT_LT(sobol_error / 200.0, 1e-4);
+}
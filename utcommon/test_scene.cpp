@@ -74,6 +74,59 @@ TEST_F(ReadSceneTest, ParseValidScene) {
   EXPECT_NEAR(scene.spheres[0].cx, 0.0F, 1e-5F);
 }
 
+TEST_F(ReadSceneTest, MaterialsAreCompiledInDefinitionOrder) {
+  static std::string const filename = "compiled_scene.scn";
+  CreateTestFile(filename, "matte: mat_white 1.0 0.5 0.25\n"
+                           "metal: mat_gold 1.0 0.8 0.1 0.2\n"
+                           "refractive: mat_glass 1.5\n"
+                           "sphere: 0 0 -1 0.5 mat_gold\n"
+                           "cylinder: 1 1 1 0.5 0 1 0 mat_white\n"
+                           "sphere: 0 -100.5 -1 100 mat_glass\n");
+
+  Scene const scene = read_scene(filename);
+  ASSERT_EQ(scene.material_table.size(), 3U);
+  EXPECT_EQ(scene.spheres[0].material_id, 1U);
+  EXPECT_EQ(scene.cylinders[0].material_id, 0U);
+  EXPECT_EQ(scene.spheres[1].material_id, 2U);
+
+  CompiledMaterial const & white = scene.material_table[0];
+  EXPECT_EQ(white.kind, MaterialKind::matte);
+  EXPECT_FLOAT_EQ(white.albedo.y(), 0.5F);
+
+  CompiledMaterial const & gold = scene.material_table[1];
+  EXPECT_EQ(gold.kind, MaterialKind::metal);
+  EXPECT_FLOAT_EQ(gold.albedo.z(), 0.1F);
+  EXPECT_FLOAT_EQ(gold.roughness, 0.2F);
+
+  CompiledMaterial const & glass = scene.material_table[2];
+  EXPECT_EQ(glass.kind, MaterialKind::refractive);
+  EXPECT_FLOAT_EQ(glass.ior, 1.5F);
+  EXPECT_FLOAT_EQ(glass.albedo.x(), 1.0F);
+}
+
+TEST(CompileMaterialsTest, HandBuiltScenesGetDeterministicIds) {
+  Scene scene;
+  scene.materials.emplace("b", Material{.name = "b", .type = "matte", .params = {1, 1, 1}});
+  scene.materials.emplace("a", Material{.name = "a", .type = "refractive", .params = {1.5F}});
+  scene.spheres.push_back(Sphere(0, 0, 0, 1.0F, "b"));
+  scene.cylinders.push_back(Cylinder(0, 0, 0, 1.0F, 0, 1, 0, "a"));
+
+  compile_materials(scene);
+  EXPECT_EQ(scene.cylinders[0].material_id, 0U);
+  EXPECT_EQ(scene.spheres[0].material_id, 1U);
+  EXPECT_EQ(scene.material_table[0].kind, MaterialKind::refractive);
+
+  scene.spheres.push_back(Sphere(0, 0, 0, 1.0F, "missing"));
+  EXPECT_THROW(compile_materials(scene), std::runtime_error);
+}
+
+TEST(CompileMaterialsTest, MissingParametersAreRejected) {
+  EXPECT_THROW((void) compile_material(Material{.name = "m", .type = "metal", .params = {1, 1}}),
+               std::runtime_error);
+  EXPECT_THROW((void) compile_material(Material{.name = "m", .type = "plastic", .params = {}}),
+               std::runtime_error);
+}
+
 // --- Tests de Errores de Archivo y Sintaxis ---
 
 TEST_F(ReadSceneTest, FileNotFound) {
@@ -0,0 +1,236 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "../common/include/config.hpp"
+#include "../common/include/hittable.hpp"
+#include "../common/include/scene.hpp"
+#include "../common/include/scene_soa.hpp"
+#include "../common/include/simd.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+namespace {
+
+  // Semilla de las escenas aleatorias de este archivo
+  constexpr std::uint32_t scene_seed = 2'468;
+
+}  // namespace
+
+TEST(SceneSOATest, ArraysArePaddedAndAligned) {
+  Scene const scene  = make_random_scene(13, 3, scene_seed);
+  SceneSOA const soa = make_scene_soa(scene);
+  EXPECT_EQ(soa.spheres.count, 13U);
+  EXPECT_EQ(soa.spheres.cx.size(), 16U);
+  EXPECT_EQ(soa.spheres.r_sq.size(), 16U);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.spheres.cx.data()) % 64, 0U);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.spheres.r_sq.data()) % 64, 0U);
+  EXPECT_EQ(soa.spheres.cy[12], scene.spheres[12].cy);
+
+  EXPECT_EQ(soa.cylinders.count, 3U);
+  EXPECT_EQ(soa.cylinders.ux.size(), 8U);
+  EXPECT_EQ(soa.cylinders.bottom_z.size(), 8U);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.cylinders.half_height.data()) % 64, 0U);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(soa.cylinders.top_x.data()) % 64, 0U);
+}
+
+TEST(SceneSOATest, CylinderDataIsPrecomputed) {
+  Scene scene;
+  scene.cylinders.push_back(Cylinder(1, 2, 3, 0.5F, 0, 4, 0, "c"));
+  prepare_scene(scene);
+  SceneSOA const soa = make_scene_soa(scene);
+  EXPECT_FLOAT_EQ(soa.cylinders.ux[0], 0.0F);
+  EXPECT_FLOAT_EQ(soa.cylinders.uy[0], 1.0F);
+  EXPECT_FLOAT_EQ(soa.cylinders.half_height[0], 2.0F);
+  EXPECT_FLOAT_EQ(soa.cylinders.r_sq[0], 0.25F);
+  EXPECT_FLOAT_EQ(soa.cylinders.top_y[0], 4.0F);
+  EXPECT_FLOAT_EQ(soa.cylinders.bottom_y[0], 0.0F);
+  EXPECT_FLOAT_EQ(soa.cylinders.bottom_x[0], 1.0F);
+}
+
+TEST(SceneSOATest, MaterialIdsAreCopied) {
+  Scene const scene  = make_random_scene(12, 4, scene_seed);
+  SceneSOA const soa = make_scene_soa(scene);
+  for (std::size_t i = 0; i < scene.spheres.size(); ++i) {
+    EXPECT_EQ(soa.spheres.material[i], scene.spheres[i].material_id);
+  }
+  for (std::size_t i = 0; i < scene.cylinders.size(); ++i) {
+    EXPECT_EQ(soa.cylinders.material[i], scene.cylinders[i].material_id);
+  }
+}
+
+TEST(SceneSOATest, InvalidSpheresAreRejectedUpFront) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, 0, -1.0F, "m"));
+  EXPECT_THROW(prepare_scene(scene), std::runtime_error);
+
+  scene.spheres[0] = Sphere(0, 0, 0, 1.0F, "");
+  EXPECT_THROW(prepare_scene(scene), std::runtime_error);
+}
+
+TEST(SceneSOATest, InvalidCylindersAreRejectedUpFront) {
+  Scene scene;
+  scene.cylinders.push_back(Cylinder(0, 0, 0, -1.0F, 0, 1, 0, "c"));
+  EXPECT_THROW(prepare_scene(scene), std::runtime_error);
+
+  scene.cylinders[0] = Cylinder(0, 0, 0, 1.0F, 0, 1, 0, "");
+  EXPECT_THROW(prepare_scene(scene), std::runtime_error);
+
+  scene.cylinders[0] = Cylinder(0, 0, 0, 1.0F, 0, 0, 0, "c");
+  EXPECT_THROW(prepare_scene(scene), std::runtime_error);
+}
+
+TEST(SceneSOATest, EmptySceneNeverHits) {
+  SceneSOA const soa = make_scene_soa(Scene{});
+  EXPECT_TRUE(soa.empty());
+  Ray const r(vector(0, 0, 0), vector(0, 0, 1));
+  EXPECT_EQ(closest_sphere_hit(soa, r, 0.001F, 100.0F).index, SoAHit::none);
+  EXPECT_EQ(closest_cylinder_hit(soa, r, 0.001F, 100.0F).index, SoAHit::none);
+}
+
+TEST(SceneSOATest, KernelMatchesScalarAndLinear) {
+  Scene scene = make_random_scene(61, 0, scene_seed);
+  scene.soa   = make_scene_soa(scene);
+
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<float> dir(-1.0F, 1.0F);
+  for (int i = 0; i < 3'000; ++i) {
+    Ray const r(vector(dir(gen), dir(gen), -40), vector(dir(gen), dir(gen), 1.0F));
+    SoAHit const fast   = closest_sphere_hit(scene.soa, r, 0.001F, 1'000.0F);
+    SoAHit const scalar = closest_sphere_hit_scalar(scene.soa, r, 0.001F, 1'000.0F);
+    EXPECT_EQ(fast.index, scalar.index);
+    EXPECT_EQ(fast.lambda, scalar.lambda);
+    EXPECT_FALSE(fast.invalid);
+
+    auto const expected = hit_scene_linear(scene, r, 0.001F, 1'000.0F);
+    ASSERT_EQ(expected.has_value(), fast.index != SoAHit::none);
+    if (expected) {
+      EXPECT_EQ(expected->lambda, fast.lambda);
+    }
+  }
+}
+
+TEST(SceneSOATest, CylinderKernelMatchesScalarAndLinear) {
+  Scene scene = make_random_scene(0, 45, scene_seed);
+  scene.soa   = make_scene_soa(scene);
+
+  std::mt19937 gen(17);
+  std::uniform_real_distribution<float> dir(-1.0F, 1.0F);
+  for (int i = 0; i < 3'000; ++i) {
+    Ray const r(vector(dir(gen), dir(gen), -40), vector(dir(gen), dir(gen), 1.0F));
+    SoAHit const fast   = closest_cylinder_hit(scene.soa, r, 0.001F, 1'000.0F);
+    SoAHit const scalar = closest_cylinder_hit_scalar(scene.soa, r, 0.001F, 1'000.0F);
+    EXPECT_EQ(fast.index, scalar.index);
+    EXPECT_EQ(fast.lambda, scalar.lambda);
+    EXPECT_FALSE(fast.invalid);
+
+    auto const expected = hit_scene_linear(scene, r, 0.001F, 1'000.0F);
+    ASSERT_EQ(expected.has_value(), fast.index != SoAHit::none);
+    if (expected) {
+      EXPECT_EQ(expected->lambda, fast.lambda);
+      EXPECT_EQ(expected->material_id, fast.index);  // Sin esferas, el cilindro i tiene i
+    }
+  }
+}
+
+TEST(SceneSOATest, AxisParallelRaysHitTheCaps) {
+  // Cilindro vertical de altura 2 y radio 1 centrado en el origen
+  Scene scene;
+  scene.cylinders.push_back(Cylinder(0, 0, 0, 1.0F, 0, 2, 0, "c"));
+  prepare_scene(scene);
+  scene.soa = make_scene_soa(scene);
+
+  Ray const down(vector(0.5F, 5, 0), vector(0, -1, 0));
+  SoAHit const top = closest_cylinder_hit(scene.soa, down, 0.001F, 100.0F);
+  EXPECT_EQ(top.index, 0U);
+  EXPECT_FLOAT_EQ(top.lambda, 4.0F);
+
+  Ray const up(vector(0, -5, 0.5F), vector(0, 1, 0));
+  SoAHit const bottom = closest_cylinder_hit(scene.soa, up, 0.001F, 100.0F);
+  EXPECT_EQ(bottom.index, 0U);
+  EXPECT_FLOAT_EQ(bottom.lambda, 4.0F);
+
+  // Fuera del radio: ni tapas ni cuerpo
+  Ray const miss(vector(1.5F, 5, 0), vector(0, -1, 0));
+  EXPECT_EQ(closest_cylinder_hit(scene.soa, miss, 0.001F, 100.0F).index, SoAHit::none);
+}
+
+TEST(SceneSOATest, CylinderTiesWithSphereGoToCylinder) {
+  // La esfera y la tapa del cilindro están a la misma distancia: el bucle lineal prueba
+  // los cilindros después y se queda con el cilindro
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, 6, 1.0F, "s", 0));
+  scene.cylinders.push_back(Cylinder(0, 0, 6, 1.0F, 0, 0, 2, "c", 1));
+  prepare_scene(scene);
+  scene.soa = make_scene_soa(scene);
+  Ray const r(vector(0, 0, 0), vector(0, 0, 1));
+  auto const expected = hit_scene_linear(scene, r, 0.001F, 100.0F);
+  auto const actual   = hit_scene_simd(scene, r, 0.001F, 100.0F);
+  ASSERT_TRUE(expected.has_value());
+  ASSERT_TRUE(actual.has_value());
+  EXPECT_EQ(expected->material_id, 1U);
+  EXPECT_EQ(actual->material_id, expected->material_id);
+  EXPECT_EQ(actual->lambda, expected->lambda);
+}
+
+TEST(SceneSOATest, RaysFromInsideUseFarRoot) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(0, 0, 0, 2.0F, "m"));
+  prepare_scene(scene);
+  scene.soa = make_scene_soa(scene);
+  Ray const r(vector(0, 0, 0), vector(1, 0, 0));
+  SoAHit const hit = closest_sphere_hit(scene.soa, r, 0.001F, 100.0F);
+  EXPECT_EQ(hit.index, 0U);
+  EXPECT_FLOAT_EQ(hit.lambda, 2.0F);
+}
+
+TEST(SceneSOATest, EqualDistancesKeepLastSphereLikeLinear) {
+  // Dos esferas idénticas: el bucle lineal se queda con la última
+  Scene scene;
+  for (int i = 0; i < 10; ++i) {
+    scene.spheres.push_back(
+        Sphere(0, 0, 5, 1.0F, "m" + std::to_string(i), static_cast<uint32_t>(i)));
+  }
+  prepare_scene(scene);
+  scene.soa = make_scene_soa(scene);
+  Ray const r(vector(0, 0, 0), vector(0, 0, 1));
+  EXPECT_EQ(closest_sphere_hit(scene.soa, r, 0.001F, 100.0F).index, 9U);
+  EXPECT_EQ(hit_scene_simd(scene, r, 0.001F, 100.0F)->material_id, 9U);
+}
+
+TEST(SceneSOATest, HitSceneSimdMatchesLinearWithCylinders) {
+  Scene scene = make_random_scene(40, 20, scene_seed);
+  Config cfg;
+  cfg.accelerator = "simd";
+  build_accelerator(scene, cfg);
+  ASSERT_FALSE(scene.soa.empty());
+  EXPECT_TRUE(scene.bvh.empty());
+
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<float> dir(-1.0F, 1.0F);
+  for (int i = 0; i < 2'000; ++i) {
+    Ray const r(vector(0, 0, -40), vector(dir(gen), dir(gen), 1.0F));
+    auto const expected = hit_scene_linear(scene, r, 0.001F, 1'000.0F);
+    auto const actual   = hit_scene(scene, r, 0.001F, 1'000.0F);
+    ASSERT_EQ(expected.has_value(), actual.has_value());
+    if (expected) {
+      EXPECT_EQ(expected->lambda, actual->lambda);
+      EXPECT_EQ(expected->material_id, actual->material_id);
+      EXPECT_EQ(expected->normal.x(), actual->normal.x());
+    }
+  }
+}
+
+TEST(SceneSOATest, NonFiniteDiscriminantIsReported) {
+  Scene scene;
+  scene.spheres.push_back(Sphere(3e30F, 0, 0, 1.0F, "m"));
+  prepare_scene(scene);
+  scene.soa = make_scene_soa(scene);
+  Ray const r(vector(0, 0, 0), vector(1, 0, 0));
+  EXPECT_TRUE(closest_sphere_hit(scene.soa, r, 0.001F, 100.0F).invalid);
+  EXPECT_THROW((void) hit_scene_simd(scene, r, 0.001F, 100.0F), std::runtime_error);
+}
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../common/include/config.hpp"
+#include "../common/include/ppm_writer.hpp"
+#include "../common/include/renderer.hpp"
+#include "../common/include/scene.hpp"
+#include "../common/include/streaming_image.hpp"
+#include "test_helpers.hpp"
+
+using namespace render;
+using namespace render::testing;
+
+namespace {
+
+  // Renderiza la imagen en memoria y a la vez con StreamingImage, y devuelve los dos archivos
+  std::pair<std::string, std::string> render_both(int threads, ImageFormat format,
+                                                  int buffer_rows) {
+    Config const cfg  = make_small_config(threads);
+    Scene const scene = make_small_scene();
+    auto const saved  = temp_file("stream_saved.ppm");
+    auto const stream = temp_file("stream_streamed.ppm");
+
+    TestImage image(24, 18);
+    run_render_loop(image, cfg, scene);
+    write_image(saved.string(), 24, 18, image.rgb, format);
+
+    StreamingImage streamed(stream.string(), 24, 18, format, buffer_rows);
+    run_render_loop(streamed, cfg, scene);
+    streamed.finish();
+
+    std::pair<std::string, std::string> files{read_file(saved), read_file(stream)};
+    std::error_code ec;
+    std::filesystem::remove(saved, ec);
+    std::filesystem::remove(stream, ec);
+    return files;
+  }
+
+  // StreamingImage cuya primera tesela lanza al escribir, cuando los demás hilos ya esperan
+  // en begin_rows a que se escriban sus filas
+  struct ThrowingStreamingImage {
+    StreamingImage & target;
+    int width{target.width};
+    int height{target.height};
+
+    void set_r(size_t idx, std::uint8_t v) noexcept { target.set_r(idx, v); }
+
+    void set_g(size_t idx, std::uint8_t v) noexcept { target.set_g(idx, v); }
+
+    void set_b(size_t idx, std::uint8_t v) noexcept { target.set_b(idx, v); }
+
+    void write_span(int y, int x0, float const * rgb, int n) {
+      if (y == 0 and x0 == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        throw std::runtime_error("tile failed");
+      }
+      target.write_span(y, x0, rgb, n);
+    }
+
+    void begin_rows(int y0, int y1) { target.begin_rows(y0, y1); }
+
+    void finish_region(int x0, int y0, int x1, int y1) {
+      target.finish_region(x0, y0, x1, y1);
+    }
+
+    void abort() { target.abort(); }
+  };
+
+}  // namespace
+
+TEST(StreamingImageTest, SequentialRenderWritesTheSameFileAsSavingAtTheEnd) {
+  auto const [saved, streamed] = render_both(1, ImageFormat::p3, 2);
+  EXPECT_EQ(streamed, saved);
+}
+
+TEST(StreamingImageTest, TiledRenderWithOneTileOfRowsWritesTheSameFile) {
+  // Anillo de 5 filas (el alto de una tesela) y 4 hilos: los hilos esperan al escritor
+  auto const [saved, streamed] = render_both(4, ImageFormat::p6, 5);
+  EXPECT_EQ(streamed, saved);
+}
+
+TEST(StreamingImageTest, RegionsFinishedOutOfOrderAreWrittenInOrder) {
+  auto const path = temp_file("stream_order.pnm");
+  {
+    StreamingImage image(path.string(), 2, 3, ImageFormat::p6, 3);
+    image.begin_rows(0, 3);
+    for (std::size_t idx = 0; idx < 6; ++idx) {
+      image.set_r(idx, static_cast<std::uint8_t>(idx));
+      image.set_g(idx, static_cast<std::uint8_t>(10 + idx));
+      image.set_b(idx, static_cast<std::uint8_t>(20 + idx));
+    }
+    image.finish_region(1, 0, 2, 3);  // Columna derecha
+    image.finish_region(0, 2, 1, 3);
+    image.finish_region(0, 0, 1, 2);
+    image.finish();
+  }
+
+  std::string expected = "P6\n2 3\n255\n";
+  for (int idx = 0; idx < 6; ++idx) {
+    expected += static_cast<char>(idx);
+    expected += static_cast<char>(10 + idx);
+    expected += static_cast<char>(20 + idx);
+  }
+  EXPECT_EQ(read_file(path), expected);
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
+
+TEST(StreamingImageTest, TileThatThrowsAbortsTheRenderInsteadOfHanging) {
+  auto const path = temp_file("stream_throw.ppm");
+  {
+    Config cfg        = make_small_config(3);
+    cfg.image_width   = 8;
+    cfg.aspect_ratio  = {1, 1};
+    cfg.tile_size     = 2;
+    Scene const scene = make_small_scene();
+    StreamingImage image(path.string(), 8, 8, ImageFormat::p6, 2);
+    ThrowingStreamingImage throwing{.target = image};
+    EXPECT_THROW((void) run_tiled_loop(throwing, cfg, scene), std::runtime_error);
+
+    cfg.threads = 1;
+    StreamingImage sequential(path.string(), 8, 8, ImageFormat::p6, 2);
+    ThrowingStreamingImage throwing_sequential{.target = sequential};
+    EXPECT_THROW((void) run_sequential_loop(throwing_sequential, cfg, scene), std::runtime_error);
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
+
+TEST(StreamingImageTest, RejectsTilesTallerThanTheBufferAndStopsWithoutFinish) {
+  auto const path = temp_file("stream_abort.ppm");
+  {
+    StreamingImage image(path.string(), 4, 8, ImageFormat::p3, 2);
+    EXPECT_EQ(image.buffer_rows(), 2);
+    EXPECT_THROW(image.begin_rows(0, 3), std::runtime_error);
+    image.begin_rows(0, 2);
+    // Sin finish: el destructor no debe esperar a las filas que faltan
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  EXPECT_THROW(StreamingImage("/nonexistent/dir/out.ppm", 4, 4, ImageFormat::p3, 2),
+               std::runtime_error);
+}
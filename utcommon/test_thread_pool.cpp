@@ -0,0 +1,59 @@
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+#include "../common/include/thread_pool.hpp"
+
+using namespace render;
+
+TEST(ThreadPoolTest, ResolvesThreadCount) {
+  EXPECT_EQ(resolve_thread_count(3), 3);
+  // 0 significa "todos los núcleos": al menos un hilo
+  EXPECT_GE(resolve_thread_count(0), 1);
+}
+
+TEST(ThreadPoolTest, RunsEveryIndexExactlyOnce) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+
+  std::vector<std::atomic<int>> hits(1'000);
+  pool.parallel_for(hits.size(), [&](std::size_t i) { hits[i].fetch_add(1); });
+
+  for (auto const & h : hits) {
+    EXPECT_EQ(h.load(), 1);
+  }
+}
+
+TEST(ThreadPoolTest, CanBeReusedForSeveralJobs) {
+  ThreadPool pool(3);
+  std::atomic<int> total{0};
+  for (int job = 0; job < 10; ++job) {
+    pool.parallel_for(100, [&](std::size_t) { total.fetch_add(1); });
+  }
+  EXPECT_EQ(total.load(), 1'000);
+}
+
+TEST(ThreadPoolTest, RethrowsTaskException) {
+  ThreadPool pool(2);
+  EXPECT_THROW(pool.parallel_for(50,
+                                 [](std::size_t i) {
+                                   if (i == 7) {
+                                     throw std::runtime_error("Error: tile failed");
+                                   }
+                                 }),
+               std::runtime_error);
+
+  // El pool sigue siendo utilizable después de un error
+  std::atomic<int> total{0};
+  pool.parallel_for(10, [&](std::size_t) { total.fetch_add(1); });
+  EXPECT_EQ(total.load(), 10);
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsOnCaller) {
+  ThreadPool pool(1);
+  EXPECT_EQ(pool.size(), 1);
+  int total = 0;  // sin hilos trabajadores no hay carreras
+  pool.parallel_for(5, [&](std::size_t) { ++total; });
+  EXPECT_EQ(total, 5);
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+#include "../common/include/simd.hpp"
+#include "../common/include/tone_map.hpp"
+
+using namespace render;
+
+namespace {
+
+  // Valores de prueba: un barrido de [0, 1.2], los umbrales de la tabla y sus vecinos
+  // (donde un error de redondeo cambiaría el byte) y valores especiales
+  std::vector<float> test_values(GammaTable const & table) {
+    std::vector<float> values;
+    for (int i = 0; i <= 12'000; ++i) {
+      values.push_back(static_cast<float>(i) * 1e-4F);
+    }
+    for (std::size_t k = 1; k < 256; ++k) {
+      float const t = table.thresholds()[k];
+      values.push_back(t);
+      values.push_back(std::nextafter(t, 0.0F));
+      values.push_back(std::nextafter(t, 2.0F));
+    }
+    values.push_back(std::numeric_limits<float>::infinity());
+    values.push_back(std::numeric_limits<float>::quiet_NaN());
+    values.push_back(-0.0F);
+    values.push_back(1e30F);
+    return values;
+  }
+
+}  // namespace
+
+TEST(ToneMapTest, TableMatchesPowForEveryByte) {
+  for (float const gamma : {1.0F, 2.2F, 0.5F}) {
+    GammaTable const table(1.0F / gamma);
+    for (float const value : test_values(table)) {
+      EXPECT_EQ(table(value), gamma_byte(value, 1.0F / gamma)) << "gamma " << gamma
+                                                               << ", value " << value;
+    }
+  }
+}
+
+TEST(ToneMapTest, ThresholdsAreIncreasing) {
+  GammaTable const table(1.0F / 2.2F);
+  for (std::size_t k = 1; k < 256; ++k) {
+    EXPECT_LT(table.thresholds()[k - 1], table.thresholds()[k]);
+  }
+  EXPECT_EQ(table(1.0F), 255);
+  EXPECT_EQ(table(0.0F), 0);
+  // Los negativos dan 0 (con pow, el resultado dependería de la gamma)
+  EXPECT_EQ(table(-0.5F), 0);
+  EXPECT_EQ(table(-std::numeric_limits<float>::infinity()), 0);
+}
+
+TEST(ToneMapTest, AvxPathMatchesScalar) {
+  if (!simd::cpu_has_avx2()) {
+    GTEST_SKIP() << "CPU sin AVX2";
+  }
+  GammaTable const table(1.0F / 2.2F);
+  // Tamaño que no es múltiplo de 8: grupos AVX2 y un resto escalar
+  std::vector<float> values = test_values(table);
+  values.resize(values.size() / 8 * 8 + 5, 0.25F);
+  std::vector<std::uint8_t> simd_out(values.size());
+  std::vector<std::uint8_t> scalar_out(values.size());
+  table.apply(values.data(), simd_out.data(), values.size());
+  table.apply_scalar(values.data(), scalar_out.data(), values.size());
+  EXPECT_EQ(simd_out, scalar_out);
+}
+
+TEST(ToneMapTest, ParallelRowsCoversEveryRowOnce) {
+  for (int const threads : {1, 3, 0}) {
+    std::vector<std::atomic<int>> hits(101);
+    parallel_rows(static_cast<int>(hits.size()), threads, [&](int y0, int y1) {
+      EXPECT_LT(y0, y1);
+      for (int y = y0; y < y1; ++y) {
+        hits[static_cast<std::size_t>(y)].fetch_add(1);
+      }
+    });
+    for (auto const & h : hits) {
+      EXPECT_EQ(h.load(), 1);
+    }
+  }
+  parallel_rows(0, 2, [](int, int) { FAIL() << "no rows"; });
+}
+
+TEST(ToneMapTest, QuantizeMatchesWriteColorExpression) {
+  GammaTable const table(1.0F / 2.2F);
+  // Tamaño que no es múltiplo de 8: grupos AVX2 (si hay) y un resto escalar
+  std::vector<float> values = test_values(table);
+  values.push_back(-0.25F);
+  values.push_back(-std::numeric_limits<float>::infinity());
+  values.resize(values.size() / 24 * 24 + 7, 0.5F);
+  std::vector<std::uint8_t> out(values.size());
+  quantize(values.data(), out.data(), values.size());
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    float const clamped = std::clamp(values[i], 0.0F, 1.0F);
+    std::uint8_t const expected =
+        std::isnan(clamped) ? 0 : static_cast<std::uint8_t>(clamped * 255.0F);
+    EXPECT_EQ(out[i], expected) << "value " << values[i];
+    EXPECT_EQ(quantize_byte(values[i]), expected);
+  }
+
+  // Los planos son los mismos bytes separados por canal
+  std::size_t const pixels = values.size() / 3;
+  std::vector<std::uint8_t> r(pixels), g(pixels), b(pixels);
+  quantize_planar(values.data(), r.data(), g.data(), b.data(), pixels);
+  for (std::size_t i = 0; i < pixels; ++i) {
+    EXPECT_EQ(r[i], out[3 * i]);
+    EXPECT_EQ(g[i], out[3 * i + 1]);
+    EXPECT_EQ(b[i], out[3 * i + 2]);
+  }
+}
@@ -0,0 +1,110 @@
+#include "../common/include/config.hpp"
+#include "../common/include/renderer.hpp"
+#include "../common/include/scene.hpp"
+#include "../soa/include/image_aosoa.hpp"
+#include "../soa/include/image_soa.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using render::ImageAoSoA;
+using render::ImageSOA;
+
+namespace {
+
+  // Rellena las dos imágenes con el mismo patrón por píxel
+  void fill_pattern(ImageAoSoA & aosoa, ImageSOA & soa) {
+    auto const n = static_cast<size_t>(soa.width) * static_cast<size_t>(soa.height);
+    for (size_t i = 0; i < n; ++i) {
+      auto const v = static_cast<std::uint8_t>(i * 5);
+      aosoa.set_r(i, v);
+      aosoa.set_g(i, static_cast<std::uint8_t>(v + 1));
+      aosoa.set_b(i, static_cast<std::uint8_t>(v + 2));
+      soa.set_r(i, v);
+      soa.set_g(i, static_cast<std::uint8_t>(v + 1));
+      soa.set_b(i, static_cast<std::uint8_t>(v + 2));
+    }
+  }
+
+  std::string read_file(std::filesystem::path const & path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  }
+
+}  // namespace
+
+TEST(ImageAoSoATest, SetAndGetUseRowMajorIndices) {
+  // 11 columnas: un bloque completo y otro de 3 píxeles por fila
+  ImageAoSoA img(11, 4);
+  ImageSOA reference(11, 4);
+  fill_pattern(img, reference);
+  for (size_t i = 0; i < 44; ++i) {
+    EXPECT_EQ(img.get_r(i), reference.get_r(i)) << i;
+    EXPECT_EQ(img.get_g(i), reference.get_g(i)) << i;
+    EXPECT_EQ(img.get_b(i), reference.get_b(i)) << i;
+  }
+}
+
+TEST(ImageAoSoATest, WriteSpanFillsWholeAndPartialBlocks) {
+  ImageAoSoA img(27, 3);
+  ImageSOA reference(27, 3);
+  std::vector<float> rgb(3 * 22);
+  for (size_t i = 0; i < rgb.size(); ++i) {
+    rgb[i] = static_cast<float>(i) / 60.0F - 0.02F;
+  }
+  // Columnas 3-24: tramo de 5, dos bloques completos y tramo de 1
+  img.write_span(1, 3, rgb.data(), 22);
+  reference.write_span(1, 3, rgb.data(), 22);
+  for (size_t i = 0; i < 27 * 3; ++i) {
+    EXPECT_EQ(img.get_r(i), reference.get_r(i)) << i;
+    EXPECT_EQ(img.get_g(i), reference.get_g(i)) << i;
+    EXPECT_EQ(img.get_b(i), reference.get_b(i)) << i;
+  }
+}
+
+TEST(ImageAoSoATest, SaveMatchesImageSoa) {
+  ImageAoSoA img(13, 3);
+  ImageSOA reference(13, 3);
+  fill_pattern(img, reference);
+  auto const dir = std::filesystem::temp_directory_path();
+  img.save((dir / "aosoa_test.ppm").string());
+  reference.save((dir / "aosoa_ref.ppm").string());
+  EXPECT_EQ(read_file(dir / "aosoa_test.ppm"), read_file(dir / "aosoa_ref.ppm"));
+
+  std::error_code ec;
+  std::filesystem::remove(dir / "aosoa_test.ppm", ec);
+  std::filesystem::remove(dir / "aosoa_ref.ppm", ec);
+}
+
+TEST(ImageAoSoATest, TiledRenderMatchesImageSoa) {
+  render::Scene scene;
+  scene.materials.emplace("mat", render::Material{.name   = "mat",
+                                                  .type   = "matte",
+                                                  .params = {0.8F, 0.3F, 0.1F}});
+  scene.spheres.push_back(render::Sphere(0, 0, 0, 3.0F, "mat"));
+  render::compile_materials(scene);
+  render::prepare_scene(scene);
+  render::Config cfg;
+  cfg.image_width       = 24;
+  cfg.aspect_ratio      = {4, 3};
+  cfg.samples_per_pixel = 2;
+  cfg.max_depth         = 3;
+  cfg.tile_size         = 7;  // Teselas que empiezan a mitad de bloque
+  cfg.threads           = 3;
+  cfg.rng_mode          = "per_pixel";
+
+  ImageSOA reference(24, 18);
+  ImageAoSoA img(24, 18);
+  (void) render::run_render_loop(reference, cfg, scene);
+  (void) render::run_render_loop(img, cfg, scene);
+  for (size_t i = 0; i < 24 * 18; ++i) {
+    EXPECT_EQ(img.get_r(i), reference.get_r(i)) << i;
+    EXPECT_EQ(img.get_g(i), reference.get_g(i)) << i;
+    EXPECT_EQ(img.get_b(i), reference.get_b(i)) << i;
+  }
+}
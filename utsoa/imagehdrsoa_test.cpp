@@ -0,0 +1,68 @@
+#include "../soa/include/image_hdr_soa.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+
+using render::ImageHdrSOA;
+using render::ImageSOA;
+
+TEST(ImageHdrSOATest, StoresLinearValuesInPlanes) {
+  ImageHdrSOA img(3, 2);
+  EXPECT_EQ(img.R.size(), 6U);
+  EXPECT_EQ(img.G.size(), 6U);
+  EXPECT_EQ(img.B.size(), 6U);
+
+  img.set_linear(5, 0.5F, 7.0F, 0.0F);  // (2,1)
+  EXPECT_FLOAT_EQ(img.R[5], 0.5F);
+  EXPECT_FLOAT_EQ(img.G[5], 7.0F);
+  EXPECT_FLOAT_EQ(img.get_b(5), 0.0F);
+}
+
+TEST(ImageHdrSOATest, ToneMapMatchesPowPerChannel) {
+  // 37 píxeles por fila: cada plano tiene grupos de 8 y un resto escalar
+  ImageHdrSOA img(37, 20);
+  for (size_t i = 0; i < 37 * 20; ++i) {
+    auto const v = static_cast<float>(i) / 500.0F;
+    img.set_linear(i, v, 1.5F - v, v * v);
+  }
+  float const inv_gamma = 1.0F / 2.2F;
+  for (int const threads : {1, 3}) {
+    ImageSOA out(37, 20);
+    img.tone_map(out, inv_gamma, threads);
+    for (size_t i = 0; i < 37 * 20; ++i) {
+      EXPECT_EQ(out.get_r(i), render::gamma_byte(img.R[i], inv_gamma));
+      EXPECT_EQ(out.get_g(i), render::gamma_byte(img.G[i], inv_gamma));
+      EXPECT_EQ(out.get_b(i), render::gamma_byte(img.B[i], inv_gamma));
+    }
+  }
+}
+
+TEST(ImageHdrSOATest, SavesPfmInterleaved) {
+  ImageHdrSOA img(2, 2);
+  for (size_t i = 0; i < 4; ++i) {
+    img.set_linear(i, static_cast<float>(i), 10.0F + static_cast<float>(i), -1.0F);
+  }
+  auto const path = std::filesystem::temp_directory_path() / "hdr_soa.pfm";
+  img.save_to_pfm(path.string());
+
+  std::ifstream in(path, std::ios::binary);
+  std::string const file{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  std::string const header = "PF\n2 2\n-1.0\n";
+  ASSERT_EQ(file.size(), header.size() + 12 * sizeof(float));
+  EXPECT_EQ(file.substr(0, header.size()), header);
+
+  // La primera fila del archivo es la de abajo: píxeles 2 y 3
+  float values[12];
+  file.copy(reinterpret_cast<char *>(values), sizeof(values), header.size());
+  float const expected[12] = {2, 12, -1, 3, 13, -1, 0, 10, -1, 1, 11, -1};
+  for (size_t i = 0; i < 12; ++i) {
+    EXPECT_FLOAT_EQ(values[i], expected[i]);
+  }
+
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+}
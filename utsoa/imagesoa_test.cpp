@@ -2,7 +2,9 @@
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <string>
+#include <vector>
 
 using render::ImageSOA;
 
@@ -178,3 +180,49 @@ TEST(ImageSOATest, SaveToPPMWritesHeaderAndDataInRowMajorOrder) {
   std::error_code ec;
   std::filesystem::remove(tmp, ec);
 }
+
+TEST(ImageSOATest, SaveToPPMBinaryInterleavesTheChannels) {
+  // 40 píxeles: un grupo de 32 para el entrelazado SIMD y un resto escalar
+  ImageSOA img(8, 5);
+  for (size_t i = 0; i < 40; ++i) {
+    img.set_r(i, static_cast<uint8_t>(i));
+    img.set_g(i, static_cast<uint8_t>(100 + i));
+    img.set_b(i, static_cast<uint8_t>(200 + i));
+  }
+
+  auto const tmp = std::filesystem::temp_directory_path() / "soa_test.pnm";
+  img.save_to_ppm(tmp.string(), render::ImageFormat::p6);
+
+  std::ifstream in(tmp, std::ios::binary);
+  ASSERT_TRUE(in.is_open());
+  std::string const contents{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  std::string const header = "P6\n8 5\n255\n";
+  ASSERT_EQ(contents.size(), header.size() + 120);
+  EXPECT_EQ(contents.substr(0, header.size()), header);
+  for (size_t i = 0; i < 40; ++i) {
+    EXPECT_EQ(static_cast<uint8_t>(contents[header.size() + 3 * i]), i);
+    EXPECT_EQ(static_cast<uint8_t>(contents[header.size() + 3 * i + 1]), 100 + i);
+    EXPECT_EQ(static_cast<uint8_t>(contents[header.size() + 3 * i + 2]), 200 + i);
+  }
+
+  in.close();
+  std::error_code ec;
+  std::filesystem::remove(tmp, ec);
+}
+
+TEST(ImageSOATest, WriteSpanDeinterleavesIntoThePlanes) {
+  // 19 píxeles desde (3,2): dos grupos de 8 y un resto escalar
+  ImageSOA img(24, 4);
+  std::vector<float> rgb(3 * 19);
+  for (size_t i = 0; i < rgb.size(); ++i) {
+    rgb[i] = static_cast<float>(i) / 50.0F - 0.05F;
+  }
+  img.write_span(2, 3, rgb.data(), 19);
+  for (size_t idx = 0; idx < 24 * 4; ++idx) {
+    bool const inside = idx >= 2 * 24 + 3 and idx < 2 * 24 + 3 + 19;
+    size_t const i    = inside ? idx - (2 * 24 + 3) : 0;
+    EXPECT_EQ(img.R[idx], inside ? render::quantize_byte(rgb[3 * i]) : 0) << idx;
+    EXPECT_EQ(img.G[idx], inside ? render::quantize_byte(rgb[3 * i + 1]) : 0) << idx;
+    EXPECT_EQ(img.B[idx], inside ? render::quantize_byte(rgb[3 * i + 2]) : 0) << idx;
+  }
+}